@@ -0,0 +1,314 @@
+/**
+ * @file amp_cmd.c
+ * @brief Schickt Kommandos über die Kommando-Queue an Core 3 und wartet
+ *        auf die Completions (rpi3_amp_core3/cmd.h)
+ *
+ * Die Kommandos landen im submit-Ring, Core 3 arbeitet pro Runde der
+ * Hauptschleife bis zu CMD_BATCH davon ab und antwortet im done-Ring mit
+ * Ergebnis, Laufzeit auf Core 3 und bis zu vier Werten. Mit -n werden
+ * mehrere Kommandos gleichzeitig eingereiht (so viele wie der Ring fasst),
+ * am Ende steht eine Zusammenfassung der Round-Trip-Zeiten.
+ *
+ * Offsets beziehen sich auf SHARED_MEM_BASE, der Job-Puffer für eigene
+ * Daten liegt bei 0x1BC000 (192 KB). Durchsatz gegen Linux: offload_bench.
+ *
+ * Die Ringe sind SPSC: immer nur ein amp_cmd gleichzeitig starten.
+ *
+ * Kompilieren (auf dem RPi3):
+ *   make amp_cmd
+ *
+ * Ausführen:
+ *   sudo ./amp_cmd nop
+ *   sudo ./amp_cmd -n 1000 nop             # Latenz der Queue
+ *   sudo ./amp_cmd heartbeat 250
+ *   sudo ./amp_cmd memtest                 # ganzes Memtest-Fenster
+ *   sudo ./amp_cmd memtest 0x1C0000 0x10000
+ *   sudo ./amp_cmd bench timer
+ *   sudo ./amp_cmd fill 0x1BC000 0x10000 0xA5A5A5A5
+ *   sudo ./amp_cmd crc32c 0x1BC000 0x10000
+ *   sudo ./amp_cmd compare 0x1BC000 0x1CC000 0x10000
+ *   sudo ./amp_cmd stats
+ *
+ * @author RPi3 AMP Project
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "amp_ipc.h"
+
+#define DEFAULT_TIMEOUT_SEC     10.0
+#define MAX_COUNT               1000000
+
+static const char *const g_phases[BENCH_PHASES] = { "memory", "ipc", "printf", "timer", "dma", "memlib" };
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static const char *result_name(int32_t result) {
+    switch (result) {
+        case CMD_OK:        return "ok";
+        case CMD_E_UNKNOWN: return "unknown op";
+        case CMD_E_INVAL:   return "invalid argument";
+        case CMD_E_FAILED:  return "failed";
+        default:            return "?";
+    }
+}
+
+static void usage(const char *prog) {
+    printf("Usage: %s [-n count] [-t sec] <command> [args]\n", prog);
+    printf("  -n count   Submit the command count times (default 1)\n");
+    printf("  -t sec     Timeout for all completions (default %.0f)\n", DEFAULT_TIMEOUT_SEC);
+    printf("Commands:\n");
+    printf("  nop                     Empty command (queue latency)\n");
+    printf("  memtest [offset size]   Memory test, offsets into shared memory\n");
+    printf("                          (default: memtest window 0x%X + 0x%X)\n",
+           SHARED_MEMTEST_ADDR - SHARED_MEM_BASE, SHARED_MEMTEST_SIZE);
+    printf("  heartbeat <ms>          Change the heartbeat period\n");
+    printf("  bench <phase>           memory | ipc | printf | timer | dma | memlib | all\n");
+    printf("  crc32 <offset> <len> [crc]        CRC32 (start value 0)\n");
+    printf("  crc32c <offset> <len> [crc]       CRC32C (start value 0)\n");
+    printf("  adler32 <offset> <len> [adler]    Adler-32 (start value 1)\n");
+    printf("  fill <offset> <len> <pattern>     Fill with a 32-bit pattern\n");
+    printf("  compare <offset> <offset> <len>   First differing byte\n");
+    printf("  stats                   Show queue counters\n");
+}
+
+static void print_done(const cmd_done_t *d, uint32_t phase, double rtt_us) {
+    printf("#%u %-16s elapsed %u us, round trip %.1f us",
+           d->id, result_name(d->result), d->elapsed_us, rtt_us);
+
+    switch (d->op) {
+        case CMD_OP_MEMTEST:
+            printf(", %u bytes, %u errors", d->value[1], d->value[0]);
+            break;
+        case CMD_OP_SET_HEARTBEAT:
+            if (d->result == CMD_OK) {
+                printf(", previous %u ms", d->value[0]);
+            }
+            break;
+        case CMD_OP_CRC32:
+        case CMD_OP_CRC32C:
+        case CMD_OP_ADLER32:
+            if (d->result == CMD_OK) {
+                printf(", %u bytes: 0x%08X", d->value[1], d->value[0]);
+            }
+            break;
+        case CMD_OP_COMPARE:
+            if (d->result == CMD_OK && d->value[0] == d->value[1]) {
+                printf(", %u bytes equal", d->value[1]);
+            } else if (d->result == CMD_OK) {
+                printf(", first difference at +0x%X", d->value[0]);
+            }
+            break;
+        case CMD_OP_RUN_BENCH:
+            if (d->result != CMD_OK) {
+                break;
+            }
+            if (phase == BENCH_PHASES) {
+                printf("\n  memory %u / %u MB/s, ipc %u msg/s, printf %u lines/s",
+                       d->value[0], d->value[1], d->value[2], d->value[3]);
+            } else if (phase == BENCH_PHASE_MEMORY) {
+                printf("\n  scalar %u MB/s, wide %u MB/s", d->value[0], d->value[1]);
+            } else if (phase == BENCH_PHASE_IPC) {
+                printf("\n  %u msg/s", d->value[0]);
+            } else if (phase == BENCH_PHASE_PRINTF) {
+                printf("\n  %u lines/s, %u cycles/line (legacy %u)",
+                       d->value[0], d->value[1], d->value[2]);
+            } else if (phase == BENCH_PHASE_DMA) {
+                printf("\n  dma / cpu MB/s: 2 MB shm -> ram %u / %u, 64 KB ram -> shm %u / %u",
+                       d->value[0], d->value[1], d->value[2], d->value[3]);
+            } else if (phase == BENCH_PHASE_MEMLIB) {
+                printf("\n  4 KB MB/s: memcpy %u (byte loop %u), memset %u, zero %u",
+                       d->value[0], d->value[1], d->value[2], d->value[3]);
+            } else {
+                printf("\n  cycles per read: systimer %u, counter %u, timer_get_ticks %u",
+                       d->value[0], d->value[1], d->value[2]);
+            }
+            break;
+        default:
+            break;
+    }
+    printf("\n");
+}
+
+static void print_stats(volatile const cmd_shared_t *shm) {
+    printf("Command queue: %u slots\n", shm->slot_count);
+    printf("  executed   %u\n", shm->executed);
+    printf("  failed     %u\n", shm->failed);
+    printf("  batches    %u (max %u per loop)\n", shm->batches, shm->max_batch);
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t count = 1;
+    double timeout = DEFAULT_TIMEOUT_SEC;
+    cmd_req_t req;
+    uint32_t phase = 0;
+    int stats = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:t:h")) != -1) {
+        switch (opt) {
+            case 'n': count = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 't': timeout = atof(optarg); break;
+            case 'h': usage(argv[0]); return 0;
+            default:  usage(argv[0]); return 1;
+        }
+    }
+    if (optind >= argc || count == 0 || count > MAX_COUNT) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    memset(&req, 0, sizeof(req));
+    const char *name = argv[optind];
+    int nargs = argc - optind - 1;
+    char **args = &argv[optind + 1];
+
+    if (!strcmp(name, "nop") && nargs == 0) {
+        req.op = CMD_OP_NOP;
+    } else if (!strcmp(name, "memtest") && (nargs == 0 || nargs == 2)) {
+        req.op = CMD_OP_MEMTEST;
+        req.arg[0] = nargs ? (uint32_t)strtoul(args[0], NULL, 0) :
+                             SHARED_MEMTEST_ADDR - SHARED_MEM_BASE;
+        req.arg[1] = nargs ? (uint32_t)strtoul(args[1], NULL, 0) : SHARED_MEMTEST_SIZE;
+    } else if (!strcmp(name, "heartbeat") && nargs == 1) {
+        req.op = CMD_OP_SET_HEARTBEAT;
+        req.arg[0] = (uint32_t)strtoul(args[0], NULL, 0);
+    } else if (!strcmp(name, "bench") && nargs == 1) {
+        req.op = CMD_OP_RUN_BENCH;
+        for (phase = 0; phase < BENCH_PHASES; phase++) {
+            if (!strcmp(args[0], g_phases[phase])) {
+                break;
+            }
+        }
+        if (phase == BENCH_PHASES && strcmp(args[0], "all")) {
+            fprintf(stderr, "Unknown bench phase '%s'\n", args[0]);
+            return 1;
+        }
+        req.arg[0] = phase;
+    } else if ((!strcmp(name, "crc32") || !strcmp(name, "crc32c") || !strcmp(name, "adler32")) &&
+               (nargs == 2 || nargs == 3)) {
+        req.op = !strcmp(name, "crc32") ? CMD_OP_CRC32 :
+                 !strcmp(name, "crc32c") ? CMD_OP_CRC32C : CMD_OP_ADLER32;
+        req.arg[0] = (uint32_t)strtoul(args[0], NULL, 0);
+        req.arg[1] = (uint32_t)strtoul(args[1], NULL, 0);
+        req.arg[2] = nargs == 3 ? (uint32_t)strtoul(args[2], NULL, 0) :
+                     req.op == CMD_OP_ADLER32 ? 1 : 0;
+    } else if (!strcmp(name, "fill") && nargs == 3) {
+        req.op = CMD_OP_FILL;
+        for (int i = 0; i < 3; i++) {
+            req.arg[i] = (uint32_t)strtoul(args[i], NULL, 0);
+        }
+    } else if (!strcmp(name, "compare") && nargs == 3) {
+        req.op = CMD_OP_COMPARE;
+        for (int i = 0; i < 3; i++) {
+            req.arg[i] = (uint32_t)strtoul(args[i], NULL, 0);
+        }
+    } else if (!strcmp(name, "stats") && nargs == 0) {
+        stats = 1;  /* Nur lesen, nichts einreihen */
+    } else {
+        usage(argv[0]);
+        return 1;
+    }
+
+    amp_ipc_t ipc;
+    if (amp_ipc_open(&ipc) < 0) {
+        return 1;
+    }
+
+    amp_cmd_t cmd;
+    if (amp_cmd_open(&ipc, &cmd) < 0) {
+        amp_ipc_close(&ipc);
+        return 1;
+    }
+    if (stats) {
+        print_stats(cmd.shm);
+        amp_ipc_close(&ipc);
+        return 0;
+    }
+
+    /* Completions eines abgebrochenen Laufs verwerfen */
+    cmd_done_t d;
+    while (amp_cmd_receive(&cmd, &d) == 0) {
+    }
+
+    double *sent = calloc(count, sizeof(double));
+    if (!sent) {
+        perror("calloc");
+        amp_ipc_close(&ipc);
+        return 1;
+    }
+
+    /* IDs pro Lauf verschieden, damit verspätete Completions nicht passen */
+    uint32_t base = ((uint32_t)getpid() << 20) ^ (uint32_t)time(NULL);
+    uint32_t submitted = 0, completed = 0, failed = 0;
+    double rtt_min = 1e9, rtt_max = 0, rtt_sum = 0;
+    uint64_t elapsed_sum = 0;
+    double start = now_sec();
+    int rc = 0;
+
+    while (completed < count) {
+        /* So viele einreihen wie Platz ist, dann einmal klingeln */
+        uint32_t queued = 0;
+        while (submitted < count) {
+            double t = now_sec();
+            req.id = base + submitted;
+            if (amp_cmd_submit(&cmd, &req) < 0) {
+                break;
+            }
+            sent[submitted++] = t;
+            queued++;
+        }
+        if (queued) {
+            amp_ipc_kick(&ipc);
+        }
+
+        while (amp_cmd_receive(&cmd, &d) == 0) {
+            double t = now_sec();
+            uint32_t idx = d.id - base;
+            if (idx >= submitted) {
+                continue;   /* Fremde ID */
+            }
+            double rtt = (t - sent[idx]) * 1e6;
+            completed++;
+            elapsed_sum += d.elapsed_us;
+            rtt_sum += rtt;
+            if (rtt < rtt_min) rtt_min = rtt;
+            if (rtt > rtt_max) rtt_max = rtt;
+            if (d.result != CMD_OK) {
+                failed++;
+            }
+            if (count == 1 || d.result != CMD_OK) {
+                print_done(&d, phase, rtt);
+            }
+        }
+
+        if (completed < count && now_sec() - start > timeout) {
+            fprintf(stderr, "Timeout: %u of %u commands completed (%u submitted)\n",
+                    completed, count, submitted);
+            rc = 1;
+            break;
+        }
+    }
+
+    if (count > 1 && completed) {
+        double total = now_sec() - start;
+        printf("%u commands, %u failed, %.0f cmd/s\n", completed, failed, completed / total);
+        printf("round trip us: min %.1f avg %.1f max %.1f, core 3 avg %.1f us\n",
+               rtt_min, rtt_sum / completed, rtt_max, (double)elapsed_sum / completed);
+    }
+    if (failed) {
+        rc = 1;
+    }
+
+    free(sent);
+    amp_ipc_close(&ipc);
+    return rc;
+}
@@ -0,0 +1,514 @@
+/**
+ * @file amp_ipc.c
+ * @brief Linux-seitige IPC API Implementierung
+ *
+ * @author RPi3 AMP Project
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "amp_ipc.h"
+
+#define LOAD_ACQUIRE(p)     __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+/*============================================================================
+ * Kopierfunktionen (Device Memory tauglich)
+ *============================================================================*/
+
+void amp_copy_to_shared(volatile void *dst, const void *src, uint32_t len) {
+    volatile uint32_t *d = (volatile uint32_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+    uint32_t word;
+
+    while (len >= 4) {
+        memcpy(&word, s, 4);
+        *d++ = word;
+        s += 4;
+        len -= 4;
+    }
+    if (len) {
+        word = 0;
+        memcpy(&word, s, len);
+        *d = word;
+    }
+}
+
+void amp_copy_from_shared(void *dst, const volatile void *src, uint32_t len) {
+    const volatile uint32_t *s = (const volatile uint32_t *)src;
+    uint8_t *d = (uint8_t *)dst;
+    uint32_t word;
+
+    while (len >= 4) {
+        word = *s++;
+        memcpy(d, &word, 4);
+        d += 4;
+        len -= 4;
+    }
+    if (len) {
+        word = *s;
+        memcpy(d, &word, len);
+    }
+}
+
+/*============================================================================
+ * Mapping
+ *============================================================================*/
+
+int amp_mem_open(int flags, off_t *shared_offset) {
+    const char *path = getenv(AMP_MEM_PATH_ENV);
+    int fd;
+
+    if (path && *path) {
+        /* Host-Build: memfd von core3_host, Shared Memory ab Offset 0 */
+        fd = open(path, flags);
+        *shared_offset = 0;
+    } else {
+        fd = open("/dev/mem", flags | O_SYNC);
+        *shared_offset = SHARED_MEM_BASE;
+        path = "/dev/mem";
+    }
+    if (fd < 0) {
+        fprintf(stderr, "Failed to open %s: ", path);
+        perror(NULL);
+    }
+    return fd;
+}
+
+int amp_ipc_open(amp_ipc_t *ipc) {
+    volatile ipc_shared_t *shm;
+    off_t offset;
+
+    memset(ipc, 0, sizeof(*ipc));
+
+    ipc->fd = amp_mem_open(O_RDWR, &offset);
+    if (ipc->fd < 0) {
+        return -1;
+    }
+
+    ipc->map = mmap(NULL, SHARED_MEM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED,
+                    ipc->fd, offset);
+    if (ipc->map == MAP_FAILED) {
+        perror("Failed to mmap shared memory");
+        close(ipc->fd);
+        ipc->fd = -1;
+        return -1;
+    }
+
+    /* Doorbell ist optional - ohne sie pollt die Firmware weiterhin per Timer */
+    if (offset == SHARED_MEM_BASE) {
+        void *local = mmap(NULL, ARM_LOCAL_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED,
+                           ipc->fd, ARM_LOCAL_BASE);
+        if (local == MAP_FAILED) {
+            perror("Warning: failed to mmap ARM local registers (no doorbell)");
+        } else {
+            ipc->local = (volatile uint32_t *)local;
+        }
+    }
+
+    ipc->status = (volatile shared_status_t *)amp_ipc_phys(ipc, SHARED_STATUS_ADDR);
+    if (ipc->status->magic != FIRMWARE_MAGIC) {
+        fprintf(stderr, "Invalid magic 0x%08X - Core 3 not running?\n",
+                ipc->status->magic);
+        amp_ipc_close(ipc);
+        return -1;
+    }
+
+    shm = (volatile ipc_shared_t *)amp_ipc_phys(ipc, SHARED_DATA_ADDR);
+    if (amp_ring_attach(ipc, &ipc->tx, &shm->to_core3, 1) < 0 ||
+        amp_ring_attach(ipc, &ipc->rx, &shm->to_linux, 0) < 0) {
+        fprintf(stderr, "IPC rings not initialized by Core 3\n");
+        amp_ipc_close(ipc);
+        return -1;
+    }
+
+    return 0;
+}
+
+void amp_ipc_close(amp_ipc_t *ipc) {
+    if (ipc->map && ipc->map != MAP_FAILED) {
+        munmap(ipc->map, SHARED_MEM_SIZE);
+    }
+    if (ipc->local) {
+        munmap((void *)ipc->local, ARM_LOCAL_SIZE);
+    }
+    if (ipc->fd >= 0) {
+        close(ipc->fd);
+    }
+    ipc->map = NULL;
+    ipc->local = NULL;
+    ipc->fd = -1;
+}
+
+volatile void *amp_ipc_phys(amp_ipc_t *ipc, uint32_t phys_addr) {
+    if (phys_addr < SHARED_MEM_BASE || phys_addr >= SHARED_MEM_BASE + SHARED_MEM_SIZE) {
+        return NULL;
+    }
+    return (volatile uint8_t *)ipc->map + (phys_addr - SHARED_MEM_BASE);
+}
+
+/*============================================================================
+ * Ringe
+ *============================================================================*/
+
+int amp_ring_attach(amp_ipc_t *ipc, amp_ring_t *ring,
+                    volatile ipc_ring_ctrl_t *ctrl, int as_producer) {
+    if (LOAD_ACQUIRE(&ctrl->magic) != IPC_RING_MAGIC) {
+        return -1;
+    }
+
+    uint32_t count = ctrl->slot_count;
+    if (count == 0 || (count & (count - 1)) != 0 ||
+        ctrl->slots_offset + (uint64_t)count * ctrl->slot_size > SHARED_MEM_SIZE) {
+        return -1;
+    }
+
+    ring->ctrl = ctrl;
+    ring->slots = (volatile uint8_t *)ipc->map + ctrl->slots_offset;
+    ring->slot_size = ctrl->slot_size;
+    ring->mask = count - 1;
+
+    /* An den aktuellen Stand anknüpfen */
+    if (as_producer) {
+        ring->local = LOAD_ACQUIRE(&ctrl->head);
+        ring->peer_cache = LOAD_ACQUIRE(&ctrl->tail);
+    } else {
+        ring->local = LOAD_ACQUIRE(&ctrl->tail);
+        ring->peer_cache = LOAD_ACQUIRE(&ctrl->head);
+    }
+    return 0;
+}
+
+volatile void *amp_ring_reserve(amp_ring_t *ring) {
+    if (ring->local - ring->peer_cache > ring->mask) {
+        ring->peer_cache = LOAD_ACQUIRE(&ring->ctrl->tail);
+        if (ring->local - ring->peer_cache > ring->mask) {
+            return NULL;
+        }
+    }
+    return ring->slots + (ring->local & ring->mask) * ring->slot_size;
+}
+
+void amp_ring_commit(amp_ring_t *ring) {
+    ring->local++;
+    STORE_RELEASE(&ring->ctrl->head, ring->local);
+}
+
+volatile void *amp_ring_peek(amp_ring_t *ring) {
+    if (ring->local == ring->peer_cache) {
+        ring->peer_cache = LOAD_ACQUIRE(&ring->ctrl->head);
+        if (ring->local == ring->peer_cache) {
+            return NULL;
+        }
+    }
+    return ring->slots + (ring->local & ring->mask) * ring->slot_size;
+}
+
+void amp_ring_release(amp_ring_t *ring) {
+    ring->local++;
+    STORE_RELEASE(&ring->ctrl->tail, ring->local);
+}
+
+/*============================================================================
+ * Nachrichten
+ *============================================================================*/
+
+uint32_t amp_ipc_max_payload(amp_ipc_t *ipc) {
+    return ipc->tx.slot_size - IPC_MSG_HDR_SIZE;
+}
+
+int amp_ipc_send(amp_ipc_t *ipc, uint32_t type, const void *data, uint32_t len) {
+    volatile uint32_t *slot;
+
+    if (len > amp_ipc_max_payload(ipc)) {
+        return -1;
+    }
+
+    slot = (volatile uint32_t *)amp_ring_reserve(&ipc->tx);
+    if (!slot) {
+        return -1;
+    }
+
+    slot[0] = type;
+    slot[1] = len;
+    if (len) {
+        amp_copy_to_shared(&slot[2], data, len);
+    }
+    amp_ring_commit(&ipc->tx);
+    return 0;
+}
+
+int amp_ipc_recv(amp_ipc_t *ipc, uint32_t *type, void *buf, uint32_t buf_size) {
+    volatile uint32_t *slot = (volatile uint32_t *)amp_ring_peek(&ipc->rx);
+    uint32_t len;
+
+    if (!slot) {
+        return -1;
+    }
+
+    *type = slot[0];
+    len = slot[1];
+    if (len > ipc->rx.slot_size - IPC_MSG_HDR_SIZE) {
+        len = ipc->rx.slot_size - IPC_MSG_HDR_SIZE;
+    }
+    if (len > buf_size) {
+        len = buf_size;
+    }
+    if (len) {
+        amp_copy_from_shared(buf, &slot[2], len);
+    }
+    amp_ring_release(&ipc->rx);
+    return (int)len;
+}
+
+/*============================================================================
+ * Buffer-Pool
+ *============================================================================*/
+
+static void write_desc(volatile pool_desc_t *d, uint32_t buf, uint32_t length, uint32_t tag) {
+    d->buf = buf;
+    d->length = length;
+    d->tag = tag;
+    d->flags = 0;
+}
+
+/* Gehört der Puffer zur Richtung dir? Untere Hälfte to_core3, obere to_linux */
+static int pool_buf_valid(amp_pool_t *pool, uint32_t buf, uint32_t dir) {
+    uint32_t cls = POOL_BUF_CLASS(buf);
+    uint32_t idx = POOL_BUF_INDEX(buf);
+    uint32_t count;
+
+    if (cls >= POOL_CLASSES) {
+        return 0;
+    }
+    count = pool->shm->buf_count[cls];
+    if (idx >= count) {
+        return 0;
+    }
+    return (idx >= count / 2) == (dir == POOL_DIR_TO_LINUX);
+}
+
+int amp_pool_open(amp_ipc_t *ipc, amp_pool_t *pool) {
+    volatile pool_shared_t *shm;
+
+    memset(pool, 0, sizeof(*pool));
+    shm = (volatile pool_shared_t *)amp_ipc_phys(ipc, SHARED_POOL_ADDR);
+    if (LOAD_ACQUIRE(&shm->magic) != POOL_MAGIC || shm->class_count != POOL_CLASSES) {
+        fprintf(stderr, "Buffer pool not initialized by Core 3\n");
+        return -1;
+    }
+
+    for (uint32_t cls = 0; cls < POOL_CLASSES; cls++) {
+        uint64_t end = shm->buf_offset[cls] + (uint64_t)shm->buf_count[cls] * shm->buf_size[cls];
+        if (shm->buf_count[cls] > 0xFFFF || end > SHARED_MEM_SIZE) {
+            fprintf(stderr, "Buffer pool layout mismatch (class %u)\n", cls);
+            return -1;
+        }
+    }
+
+    pool->ipc = ipc;
+    pool->shm = shm;
+    if (amp_ring_attach(ipc, &pool->tx_submit, &shm->dir[POOL_DIR_TO_CORE3].submit, 1) < 0 ||
+        amp_ring_attach(ipc, &pool->rx_submit, &shm->dir[POOL_DIR_TO_LINUX].submit, 0) < 0) {
+        return -1;
+    }
+    for (uint32_t cls = 0; cls < POOL_CLASSES; cls++) {
+        if (amp_ring_attach(ipc, &pool->tx_free[cls], &shm->dir[POOL_DIR_TO_CORE3].free[cls], 0) < 0 ||
+            amp_ring_attach(ipc, &pool->rx_free[cls], &shm->dir[POOL_DIR_TO_LINUX].free[cls], 1) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+volatile void *amp_pool_buf(amp_pool_t *pool, uint32_t buf) {
+    uint32_t cls = POOL_BUF_CLASS(buf);
+
+    if (cls >= POOL_CLASSES || POOL_BUF_INDEX(buf) >= pool->shm->buf_count[cls]) {
+        return NULL;
+    }
+    return (volatile uint8_t *)pool->ipc->map + pool->shm->buf_offset[cls] +
+           (size_t)POOL_BUF_INDEX(buf) * pool->shm->buf_size[cls];
+}
+
+uint32_t amp_pool_buf_size(amp_pool_t *pool, uint32_t buf) {
+    uint32_t cls = POOL_BUF_CLASS(buf);
+
+    if (cls >= POOL_CLASSES || POOL_BUF_INDEX(buf) >= pool->shm->buf_count[cls]) {
+        return 0;
+    }
+    return pool->shm->buf_size[cls];
+}
+
+int amp_pool_alloc(amp_pool_t *pool, uint32_t cls, uint32_t *buf) {
+    volatile pool_desc_t *d;
+
+    if (cls >= POOL_CLASSES) {
+        return -1;
+    }
+
+    while ((d = (volatile pool_desc_t *)amp_ring_peek(&pool->tx_free[cls])) != NULL) {
+        uint32_t id = d->buf;
+        amp_ring_release(&pool->tx_free[cls]);
+
+        if (POOL_BUF_CLASS(id) == cls && pool_buf_valid(pool, id, POOL_DIR_TO_CORE3)) {
+            *buf = id;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+int amp_pool_submit(amp_pool_t *pool, uint32_t buf, uint32_t length, uint32_t tag) {
+    volatile pool_desc_t *d;
+
+    if (!pool_buf_valid(pool, buf, POOL_DIR_TO_CORE3) || length > amp_pool_buf_size(pool, buf)) {
+        return -1;
+    }
+
+    d = (volatile pool_desc_t *)amp_ring_reserve(&pool->tx_submit);
+    if (!d) {
+        return -1;
+    }
+    write_desc(d, buf, length, tag);
+    amp_ring_commit(&pool->tx_submit);
+    return 0;
+}
+
+int amp_pool_receive(amp_pool_t *pool, pool_desc_t *desc) {
+    volatile pool_desc_t *d = (volatile pool_desc_t *)amp_ring_peek(&pool->rx_submit);
+
+    if (!d) {
+        return -1;
+    }
+    desc->buf = d->buf;
+    desc->length = d->length;
+    desc->tag = d->tag;
+    desc->flags = d->flags;
+    amp_ring_release(&pool->rx_submit);
+    return 0;
+}
+
+int amp_pool_release(amp_pool_t *pool, uint32_t buf) {
+    volatile pool_desc_t *d;
+    uint32_t cls = POOL_BUF_CLASS(buf);
+
+    if (!pool_buf_valid(pool, buf, POOL_DIR_TO_LINUX)) {
+        return -1;
+    }
+
+    d = (volatile pool_desc_t *)amp_ring_reserve(&pool->rx_free[cls]);
+    if (!d) {
+        return -1;
+    }
+    write_desc(d, buf, 0, 0);
+    amp_ring_commit(&pool->rx_free[cls]);
+    return 0;
+}
+
+/*============================================================================
+ * Kommando-Queue
+ *============================================================================*/
+
+int amp_cmd_open(amp_ipc_t *ipc, amp_cmd_t *cmd) {
+    volatile cmd_shared_t *shm;
+
+    memset(cmd, 0, sizeof(*cmd));
+    shm = (volatile cmd_shared_t *)amp_ipc_phys(ipc, SHARED_CMD_ADDR);
+    if (LOAD_ACQUIRE(&shm->magic) != CMD_MAGIC || shm->req_size != sizeof(cmd_req_t) ||
+        shm->done_size != sizeof(cmd_done_t)) {
+        fprintf(stderr, "Command queue not initialized by Core 3\n");
+        return -1;
+    }
+
+    cmd->ipc = ipc;
+    cmd->shm = shm;
+    if (amp_ring_attach(ipc, &cmd->submit, &shm->submit, 1) < 0 ||
+        amp_ring_attach(ipc, &cmd->done, &shm->done, 0) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+int amp_cmd_submit(amp_cmd_t *cmd, const cmd_req_t *req) {
+    volatile void *slot = amp_ring_reserve(&cmd->submit);
+
+    if (!slot) {
+        return -1;
+    }
+    amp_copy_to_shared(slot, req, sizeof(*req));
+    amp_ring_commit(&cmd->submit);
+    return 0;
+}
+
+int amp_cmd_receive(amp_cmd_t *cmd, cmd_done_t *done) {
+    volatile void *slot = amp_ring_peek(&cmd->done);
+
+    if (!slot) {
+        return -1;
+    }
+    amp_copy_from_shared(done, slot, sizeof(*done));
+    amp_ring_release(&cmd->done);
+    return 0;
+}
+
+/*============================================================================
+ * Doorbell
+ *============================================================================*/
+
+uint64_t amp_counter(void) {
+#if defined(__aarch64__)
+    uint64_t cnt;
+    __asm__ volatile("isb; mrs %0, cntvct_el0" : "=r"(cnt) :: "memory");
+    return cnt;
+#else
+    return 0;
+#endif
+}
+
+int amp_ipc_doorbell(amp_ipc_t *ipc, uint32_t bits) {
+    if (!ipc->local) {
+        return -1;
+    }
+
+    ipc->status->doorbell_stamp = amp_counter();
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    ipc->local[ARM_LOCAL_MBOX_SET_OFF(DOORBELL_CORE, DOORBELL_MBOX) / 4] = bits;
+    return 0;
+}
+
+int amp_ipc_kick(amp_ipc_t *ipc) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (!ipc->status->core3_idle) {
+        return 0;
+    }
+    return amp_ipc_doorbell(ipc, DOORBELL_BIT_IPC) == 0;
+}
+
+/*============================================================================
+ * Status Snapshot (Seqlock Leser)
+ *============================================================================*/
+
+int amp_status_snapshot(const volatile shared_status_t *status, shared_status_t *out,
+                        uint32_t max_retries) {
+    for (uint32_t retry = 0; retry <= max_retries; retry++) {
+        uint32_t seq = LOAD_ACQUIRE(&status->seq);
+        if (seq & 1) {
+            continue;   /* Core 3 ist mitten in einem Update */
+        }
+
+        amp_copy_from_shared(out, status, sizeof(*out));
+
+        /* Alle Daten-Loads vor dem zweiten Lesen von seq */
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (status->seq == seq) {
+            return (int)retry;
+        }
+    }
+    return -1;
+}
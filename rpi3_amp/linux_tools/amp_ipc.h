@@ -0,0 +1,285 @@
+/**
+ * @file amp_ipc.h
+ * @brief Linux-seitige API für das Core 3 Shared Memory und die IPC Ringe
+ *
+ * Beispiel:
+ *   amp_ipc_t ipc;
+ *   if (amp_ipc_open(&ipc) == 0) {
+ *       amp_ipc_send(&ipc, IPC_MSG_TEXT, "hello", 6);
+ *       amp_ipc_close(&ipc);
+ *   }
+ *
+ * Zugriffe auf das Shared Memory laufen ausschließlich über ausgerichtete
+ * 32-bit Wörter: /dev/mem mit O_SYNC wird auf arm64 als Device Memory
+ * gemappt, unausgerichtete Zugriffe (z.B. durch memcpy) enden dort mit SIGBUS.
+ *
+ * Mit AMP_MEM_PATH=/proc/<pid>/fd/<n> laufen alle Tools gegen den Host-Build
+ * der Firmware (make host in rpi3_amp_core3) - ohne Doorbell.
+ *
+ * @author RPi3 AMP Project
+ */
+
+#ifndef AMP_IPC_H
+#define AMP_IPC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include "amp_shared.h"
+
+/* Host-Build: Pfad zum memfd von core3_host statt /dev/mem */
+#define AMP_MEM_PATH_ENV    "AMP_MEM_PATH"
+
+/*============================================================================
+ * Typen
+ *============================================================================*/
+
+/* Lokaler Ring-Handle */
+typedef struct {
+    volatile ipc_ring_ctrl_t *ctrl;
+    volatile uint8_t *slots;
+    uint32_t slot_size;
+    uint32_t mask;
+    uint32_t local;         /* head (Producer) bzw. tail (Consumer) */
+    uint32_t peer_cache;    /* Zuletzt gelesener Index der Gegenseite */
+} amp_ring_t;
+
+typedef struct {
+    int fd;
+    void *map;                          /* gesamtes Shared Memory (2 MB) */
+    volatile uint32_t *local;           /* ARM Local Page (Doorbell), NULL wenn nicht gemappt */
+    volatile shared_status_t *status;
+    amp_ring_t tx;                      /* to_core3: Linux ist Producer */
+    amp_ring_t rx;                      /* to_linux: Linux ist Consumer */
+} amp_ipc_t;
+
+/* Zero-Copy Buffer-Pool (SHARED_POOL_ADDR), siehe amp_pool_open() */
+typedef struct {
+    amp_ipc_t *ipc;
+    volatile pool_shared_t *shm;
+    amp_ring_t tx_submit;               /* to_core3 submit: Linux ist Producer */
+    amp_ring_t tx_free[POOL_CLASSES];   /* to_core3 free: Linux holt Puffer */
+    amp_ring_t rx_submit;               /* to_linux submit: Linux ist Consumer */
+    amp_ring_t rx_free[POOL_CLASSES];   /* to_linux free: Linux gibt Puffer zurück */
+} amp_pool_t;
+
+/* Kommando-Queue (SHARED_CMD_ADDR), siehe amp_cmd_open() */
+typedef struct {
+    amp_ipc_t *ipc;
+    volatile cmd_shared_t *shm;
+    amp_ring_t submit;                  /* Linux ist Producer */
+    amp_ring_t done;                    /* Linux ist Consumer */
+} amp_cmd_t;
+
+/*============================================================================
+ * Funktionen
+ *============================================================================*/
+
+/**
+ * @brief Öffnet /dev/mem oder, wenn AMP_MEM_PATH gesetzt ist, den memfd
+ *        des Host-Builds (rpi3_amp_core3/host)
+ * @param flags O_RDONLY oder O_RDWR
+ * @param shared_offset Output: mmap-Offset von SHARED_MEM_BASE in der Datei
+ * @return File Descriptor, -1 bei Fehler (Meldung auf stderr)
+ */
+int amp_mem_open(int flags, off_t *shared_offset);
+
+/**
+ * @brief Mappt das Shared Memory und verbindet sich mit beiden Ringen
+ * @return 0 bei Erfolg, -1 bei Fehler (errno / Meldung auf stderr)
+ */
+int amp_ipc_open(amp_ipc_t *ipc);
+
+/**
+ * @brief Löst das Mapping
+ */
+void amp_ipc_close(amp_ipc_t *ipc);
+
+/**
+ * @brief Gibt einen Pointer auf eine physikalische Adresse im Shared Memory zurück
+ * @return Pointer oder NULL wenn außerhalb des Bereichs
+ */
+volatile void *amp_ipc_phys(amp_ipc_t *ipc, uint32_t phys_addr);
+
+/**
+ * @brief Initialisiert einen Ring-Handle aus einem Steuerblock
+ * @param as_producer 1 = wir schreiben head, 0 = wir schreiben tail
+ * @return 0 bei Erfolg, -1 wenn der Ring (noch) nicht initialisiert ist
+ */
+int amp_ring_attach(amp_ipc_t *ipc, amp_ring_t *ring,
+                    volatile ipc_ring_ctrl_t *ctrl, int as_producer);
+
+/**
+ * @brief Producer: nächster freier Slot oder NULL wenn voll
+ */
+volatile void *amp_ring_reserve(amp_ring_t *ring);
+
+/**
+ * @brief Producer: Slot veröffentlichen (Store-Release auf head)
+ */
+void amp_ring_commit(amp_ring_t *ring);
+
+/**
+ * @brief Consumer: ältester Slot oder NULL wenn leer
+ */
+volatile void *amp_ring_peek(amp_ring_t *ring);
+
+/**
+ * @brief Consumer: Slot freigeben (Store-Release auf tail)
+ */
+void amp_ring_release(amp_ring_t *ring);
+
+/**
+ * @brief Sendet eine Nachricht an Core 3
+ * @return 0 bei Erfolg, -1 wenn der Ring voll ist oder len zu groß
+ */
+int amp_ipc_send(amp_ipc_t *ipc, uint32_t type, const void *data, uint32_t len);
+
+/**
+ * @brief Holt eine Nachricht von Core 3
+ * @param type Output: Nachrichten-Typ
+ * @param buf Output-Puffer für die Nutzdaten
+ * @param buf_size Größe des Puffers
+ * @return Länge der Nutzdaten, -1 wenn keine Nachricht da ist
+ */
+int amp_ipc_recv(amp_ipc_t *ipc, uint32_t *type, void *buf, uint32_t buf_size);
+
+/**
+ * @brief Maximale Nutzdaten pro Nachricht
+ */
+uint32_t amp_ipc_max_payload(amp_ipc_t *ipc);
+
+/**
+ * @brief Klingelt bei Core 3 (Mailbox 0 Set-Register)
+ *
+ * Legt vorher den aktuellen Zählerstand in status->doorbell_stamp ab,
+ * damit die Firmware die Wake-Latenz messen kann.
+ *
+ * @param bits DOORBELL_BIT_*
+ * @return 0 bei Erfolg, -1 wenn die ARM Local Page nicht gemappt ist
+ */
+int amp_ipc_doorbell(amp_ipc_t *ipc, uint32_t bits);
+
+/**
+ * @brief Nach amp_ipc_send(): klingelt nur wenn Core 3 im WFI schläft
+ *
+ * Voller Barrier zwischen Commit und dem Lesen von core3_idle - Gegenstück
+ * zur Firmware, die erst core3_idle setzt und dann die Ringe prüft.
+ *
+ * @return 1 wenn geklingelt wurde, sonst 0
+ */
+int amp_ipc_kick(amp_ipc_t *ipc);
+
+/**
+ * @brief Verbindet sich mit dem Buffer-Pool von Core 3
+ *
+ * Nur ein Prozess darf den Pool gleichzeitig benutzen (SPSC Ringe).
+ * Puffer, die ein Prozess beim Beenden noch hält, fehlen bis zum
+ * nächsten pool_init() der Firmware.
+ *
+ * @return 0 bei Erfolg, -1 wenn der Pool nicht initialisiert ist
+ */
+int amp_pool_open(amp_ipc_t *ipc, amp_pool_t *pool);
+
+/**
+ * @brief Pointer auf die Nutzdaten eines Puffers (NULL bei ungültiger ID)
+ *
+ * Zugriff nur über ausgerichtete 32-bit Wörter, siehe oben.
+ */
+volatile void *amp_pool_buf(amp_pool_t *pool, uint32_t buf);
+
+/**
+ * @brief Größe eines Puffers in Bytes (0 bei ungültiger ID)
+ */
+uint32_t amp_pool_buf_size(amp_pool_t *pool, uint32_t buf);
+
+/**
+ * @brief Holt einen freien Puffer für Linux -> Core 3
+ * @param cls POOL_CLASS_*
+ * @param buf Output: Puffer-ID
+ * @return 0 bei Erfolg, -1 wenn alle Puffer der Klasse bei Core 3 liegen
+ */
+int amp_pool_alloc(amp_pool_t *pool, uint32_t cls, uint32_t *buf);
+
+/**
+ * @brief Übergibt einen mit amp_pool_alloc() geholten Puffer an Core 3
+ *
+ * Danach amp_ipc_kick(), falls Core 3 schlafen könnte.
+ *
+ * @return 0 bei Erfolg, -1 bei ungültiger ID/Länge oder vollem Ring
+ */
+int amp_pool_submit(amp_pool_t *pool, uint32_t buf, uint32_t length, uint32_t tag);
+
+/**
+ * @brief Holt den nächsten Puffer von Core 3
+ * @return 0 bei Erfolg, -1 wenn keiner ansteht
+ */
+int amp_pool_receive(amp_pool_t *pool, pool_desc_t *desc);
+
+/**
+ * @brief Gibt einen mit amp_pool_receive() erhaltenen Puffer an Core 3 zurück
+ * @return 0 bei Erfolg, -1 bei ungültiger ID
+ */
+int amp_pool_release(amp_pool_t *pool, uint32_t buf);
+
+/**
+ * @brief Verbindet sich mit der Kommando-Queue von Core 3
+ *
+ * Nur ein Prozess darf die Queue gleichzeitig benutzen (SPSC Ringe).
+ * Completions eines früheren Prozesses stehen evtl. noch im done-Ring,
+ * IDs deshalb pro Lauf verschieden wählen.
+ *
+ * @return 0 bei Erfolg, -1 wenn die Queue nicht initialisiert ist
+ */
+int amp_cmd_open(amp_ipc_t *ipc, amp_cmd_t *cmd);
+
+/**
+ * @brief Reiht ein Kommando ein
+ *
+ * Danach amp_ipc_kick(), falls Core 3 schlafen könnte.
+ *
+ * @return 0 bei Erfolg, -1 wenn der submit-Ring voll ist
+ */
+int amp_cmd_submit(amp_cmd_t *cmd, const cmd_req_t *req);
+
+/**
+ * @brief Holt die nächste Completion
+ * @return 0 bei Erfolg, -1 wenn keine ansteht
+ */
+int amp_cmd_receive(amp_cmd_t *cmd, cmd_done_t *done);
+
+/**
+ * @brief Konsistente Kopie des Status-Blocks (Seqlock Leser)
+ *
+ * Kopiert die ganze Struktur und wiederholt, solange Core 3 gerade
+ * schreibt (seq ungerade) oder seq sich während der Kopie geändert hat.
+ * Die Kopie läuft wie amp_copy_from_shared() über 32-bit Wörter.
+ *
+ * @param status Status-Block im Shared Memory
+ * @param out Ziel (lokaler Speicher)
+ * @param max_retries Maximale Wiederholungen
+ * @return Anzahl Wiederholungen, -1 wenn keine konsistente Kopie gelang
+ *         (Inhalt von out ist dann undefiniert)
+ */
+int amp_status_snapshot(const volatile shared_status_t *status, shared_status_t *out,
+                        uint32_t max_retries);
+
+/* Standard für max_retries */
+#define AMP_STATUS_SNAPSHOT_RETRIES 1000
+
+/**
+ * @brief Zählerstand der Generic Timer (CNTVCT_EL0), 0 auf anderen Architekturen
+ */
+uint64_t amp_counter(void);
+
+/**
+ * @brief Kopiert nach Shared Memory (nur ausgerichtete 32-bit Zugriffe)
+ */
+void amp_copy_to_shared(volatile void *dst, const void *src, uint32_t len);
+
+/**
+ * @brief Kopiert aus Shared Memory (nur ausgerichtete 32-bit Zugriffe)
+ */
+void amp_copy_from_shared(void *dst, const volatile void *src, uint32_t len);
+
+#endif /* AMP_IPC_H */
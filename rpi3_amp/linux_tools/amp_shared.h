@@ -0,0 +1,557 @@
+/**
+ * @file amp_shared.h
+ * @brief Shared Memory Layout aus Linux-Sicht
+ *
+ * Spiegel der Definitionen aus rpi3_amp_core3/common.h, memory.h und ipc.h.
+ * Alles hier MUSS mit der Core 3 Firmware übereinstimmen!
+ *
+ * @author RPi3 AMP Project
+ */
+
+#ifndef AMP_SHARED_H
+#define AMP_SHARED_H
+
+#include <stdint.h>
+
+/*============================================================================
+ * Adressen
+ *============================================================================*/
+
+#define SHARED_MEM_BASE         0x20A00000
+#define SHARED_MEM_SIZE         0x00200000  /* 2 MB */
+
+#define SHARED_STATUS_ADDR      (SHARED_MEM_BASE + 0x0000)
+#define SHARED_STATUS_SIZE      0x1000
+#define SHARED_DATA_ADDR        (SHARED_MEM_BASE + 0x1000)
+#define SHARED_DATA_SIZE        0x1000
+#define SHARED_MEMTEST_ADDR     (SHARED_MEM_BASE + 0x2000)
+#define SHARED_MEMTEST_SIZE     0x10000
+#define SHARED_IPC_SLOTS_ADDR   (SHARED_MEM_BASE + 0x12000)
+#define SHARED_IPC_SLOTS_SIZE   0x40000
+#define SHARED_SCRUB_ADDR       (SHARED_MEM_BASE + 0x52000)
+#define SHARED_SCRUB_SIZE       0x1000
+#define SHARED_TRACE_ADDR       (SHARED_MEM_BASE + 0x53000)
+#define SHARED_TRACE_SIZE       0x10000
+#define SHARED_POOL_ADDR        (SHARED_MEM_BASE + 0x63000)
+#define SHARED_POOL_SIZE        0x142000
+#define SHARED_TELEM_ADDR       (SHARED_MEM_BASE + 0x1A5000)
+#define SHARED_TELEM_SIZE       0x3000
+#define SHARED_PROBE_ADDR       (SHARED_MEM_BASE + 0x1A8000)
+#define SHARED_PROBE_SIZE       0x1000
+#define SHARED_PROF_ADDR        (SHARED_MEM_BASE + 0x1A9000)
+#define SHARED_PROF_SIZE        0x11000
+#define SHARED_CMD_ADDR         (SHARED_MEM_BASE + 0x1BA000)
+#define SHARED_CMD_SIZE         0x2000
+#define SHARED_JOB_ADDR         (SHARED_MEM_BASE + 0x1BC000)
+#define SHARED_JOB_SIZE         0x30000
+#define SHARED_DSP_ADDR         (SHARED_MEM_BASE + 0x1EC000)
+#define SHARED_DSP_SIZE         0x10000
+#define SHARED_FREE_ADDR        (SHARED_MEM_BASE + 0x1FC000)
+
+#define FIRMWARE_MAGIC          0x52503341  /* "RP3A" */
+
+/* ARM Local Peripherals: Mailbox-Set Register von Core 3 (Doorbell) */
+#define ARM_LOCAL_BASE          0x40000000
+#define ARM_LOCAL_SIZE          0x1000
+#define ARM_LOCAL_MBOX_SET_OFF(c, m)    (0x80 + 16 * (c) + 4 * (m))
+#define DOORBELL_CORE           3
+#define DOORBELL_MBOX           0
+#define DOORBELL_BIT_IPC        (1u << 0)
+
+/*============================================================================
+ * Status-Struktur
+ *============================================================================*/
+
+/* Core 3 Zustände */
+#define CORE3_STATE_BOOT        0
+#define CORE3_STATE_INIT        1
+#define CORE3_STATE_RUNNING     2
+#define CORE3_STATE_MEMTEST     3
+#define CORE3_STATE_ERROR       4
+#define CORE3_STATE_HALTED      5
+
+/* mmu_flags Bits */
+#define MMU_FLAG_ENABLED        (1 << 0)
+#define MMU_FLAG_DCACHE         (1 << 1)
+#define MMU_FLAG_ICACHE         (1 << 2)
+#define MMU_FLAG_SHARED_CACHED  (1 << 3)
+
+/* Memory Test (rpi3_amp_core3/memtest.h) */
+#define MEMTEST_NUM_TESTS       6
+#define MEMTEST_MAX_FAIL_ADDRS  4
+
+/* Scheduler Task-Statistik (rpi3_amp_core3/sched.h) */
+#define SCHED_MAX_TASKS         8
+#define SCHED_NAME_LEN          16
+
+/* Seqlock Stresstest (rpi3_amp_core3/memory.h) */
+#define STATUS_STRESS_WORDS     8
+
+typedef struct {
+    char     name[SCHED_NAME_LEN];
+    uint32_t period_us;
+    uint32_t deadline_us;
+    uint32_t priority;
+    uint32_t runs;
+    uint32_t misses;
+    uint32_t exec_min_ns;
+    uint32_t exec_avg_ns;
+    uint32_t exec_max_ns;
+} sched_stats_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t core3_state;
+    uint32_t boot_count;
+    uint64_t boot_time;
+    uint64_t uptime_ticks;
+    uint32_t heartbeat_counter;
+    uint32_t heartbeat_interval_ms;
+    uint32_t memtest_status;
+    uint32_t memtest_errors;
+    uint32_t memtest_bytes;
+    uint32_t messages_sent;
+    uint32_t messages_received;
+    volatile uint32_t seq;      /* Seqlock, ungerade = Core 3 schreibt */
+    uint32_t reserved[7];
+    char debug_message[128];
+    uint32_t mmu_flags;
+    uint32_t perf_kips_uncached;
+    uint32_t perf_kips_cached;
+    uint32_t perf_mem_mbps_uncached;
+    uint32_t perf_mem_mbps_cached;
+    uint32_t ipc_rx_rate;
+    uint32_t ipc_tx_rate;
+    uint64_t doorbell_stamp;
+    uint32_t core3_idle;
+    uint32_t doorbell_count;
+    uint32_t wake_lat_min_ns;
+    uint32_t wake_lat_avg_ns;
+    uint32_t wake_lat_max_ns;
+    uint32_t uart_tx_dropped;
+    uint32_t uart_tx_peak;
+    uint32_t sched_task_count;
+    uint32_t _pad0;
+    sched_stats_t sched_tasks[SCHED_MAX_TASKS];
+    uint32_t memtest_impl;
+    uint32_t memtest_mbps[MEMTEST_NUM_TESTS];
+    uint32_t memtest_fail_count;
+    uint32_t memtest_fail_addr[MEMTEST_MAX_FAIL_ADDRS];
+    uint32_t scrub_pass;
+    uint32_t scrub_bytes_done;
+    uint32_t scrub_pass_bytes;
+    uint32_t scrub_errors;
+    uint32_t scrub_bad_pages;
+    uint32_t scrub_cur_addr;
+    uint32_t stress_words[STATUS_STRESS_WORDS];
+    uint32_t bench_done;        /* Boot-Benchmark (make qemu-bench) */
+    uint32_t bench_mem_scalar_mbps;
+    uint32_t bench_mem_wide_mbps;
+    uint32_t bench_ipc_rate;
+    uint32_t bench_printf_rate;
+    uint32_t pool_rx_bufs;      /* Buffer-Pool (rpi3_amp_core3/pool.h) */
+    uint32_t pool_rx_kb;
+    uint32_t pool_rx_errors;
+    uint32_t pool_tx_bufs;
+    uint32_t pool_tx_kb;
+    uint32_t bench_printf_cycles;   /* Zyklen pro Aufruf (Boot-Benchmark) */
+    uint32_t bench_legacy_cycles;
+    uint32_t uart_clock_hz;     /* UART0 Referenztakt (Mailbox oder Default) */
+    uint32_t uart_baud;         /* Tatsächliche Baudrate */
+    uint32_t bench_timer_systimer_cycles;   /* Zyklen pro Zeitquellen-Read */
+    uint32_t bench_timer_counter_cycles;
+    uint32_t bench_timer_ticks_cycles;
+} shared_status_t;
+
+/*============================================================================
+ * Scrubber Bitmap (SHARED_SCRUB_ADDR, rpi3_amp_core3/scrub.h)
+ *============================================================================*/
+
+#define SCRUB_MAGIC             0x42524353  /* "SCRB" */
+#define SCRUB_BITMAP_WORDS      96          /* 12 MB / 4 KB / 32 */
+
+typedef struct {
+    uint32_t magic;
+    uint32_t base;              /* Adresse von Bit 0 */
+    uint32_t page_size;
+    uint32_t page_count;
+    uint32_t bitmap[SCRUB_BITMAP_WORDS];
+} scrub_shared_t;
+
+/*============================================================================
+ * Trace-Ring (SHARED_TRACE_ADDR, rpi3_amp_core3/trace.h)
+ *============================================================================*/
+
+#define TRACE_MAGIC             0x45435254  /* "TRCE" */
+#define TRACE_RECORDS           2048
+
+#define TRACE_TYPE_BEGIN        0
+#define TRACE_TYPE_END          1
+#define TRACE_TYPE_INSTANT      2
+#define TRACE_TYPE_COUNTER      3
+
+#define TRACE_EV_TASK           1
+#define TRACE_EV_IPC_POLL       2
+#define TRACE_EV_IDLE           3
+#define TRACE_EV_DOORBELL       4
+#define TRACE_EV_BENCH          5
+#define TRACE_EV_USER           0x100
+
+typedef struct {
+    uint64_t ts;
+    uint16_t id;
+    uint16_t type;
+    uint32_t arg0;
+    uint32_t arg1;
+    uint32_t seq;
+} trace_rec_t;
+
+typedef struct {
+    volatile uint32_t head;
+    uint8_t  _pad0[60];
+    uint32_t magic;
+    uint32_t rec_size;
+    uint32_t rec_count;
+    uint32_t counter_freq;
+    uint8_t  _pad1[48];
+    trace_rec_t rec[TRACE_RECORDS];
+} trace_shared_t;
+
+/*============================================================================
+ * IPC Ringe (SHARED_DATA_ADDR)
+ *============================================================================*/
+
+#define IPC_CACHE_LINE          64
+#define IPC_RING_MAGIC          0x474E4952  /* "RING" */
+
+typedef struct {
+    volatile uint32_t head;
+    uint8_t  _pad0[IPC_CACHE_LINE - 4];
+    volatile uint32_t tail;
+    uint8_t  _pad1[IPC_CACHE_LINE - 4];
+    uint32_t magic;
+    uint32_t slot_size;
+    uint32_t slot_count;
+    uint32_t slots_offset;
+    uint8_t  _pad2[IPC_CACHE_LINE - 16];
+} ipc_ring_ctrl_t;
+
+/* Ping-Pong Latenztest (pingpong.c) */
+typedef struct {
+    volatile uint32_t ping;
+    volatile uint32_t spin;
+    uint8_t  _pad0[IPC_CACHE_LINE - 8];
+    volatile uint32_t pong;
+    uint8_t  _pad1[IPC_CACHE_LINE - 4];
+} ipc_ping_t;
+
+typedef struct {
+    ipc_ring_ctrl_t to_core3;
+    ipc_ring_ctrl_t to_linux;
+    ipc_ping_t ping;
+} ipc_shared_t;
+
+#define IPC_MSG_HDR_SIZE        8
+
+/* Nachrichten-Typen */
+#define IPC_MSG_NOP             0
+#define IPC_MSG_ECHO            1
+#define IPC_MSG_TEXT            2
+#define IPC_MSG_BENCH_RX        3
+#define IPC_MSG_BENCH_TX        4
+#define IPC_MSG_BENCH_DATA      5
+#define IPC_MSG_BENCH_DONE      6
+#define IPC_MSG_STATUS_STRESS   7
+#define IPC_MSG_STATUS_STRESS_DONE  8
+#define IPC_MSG_BULK_TX         9
+#define IPC_MSG_BULK_TX_DONE    10
+#define IPC_MSG_SET_BAUD        11
+#define IPC_MSG_SET_BAUD_DONE   12
+
+/*============================================================================
+ * Zero-Copy Buffer-Pool (SHARED_POOL_ADDR, rpi3_amp_core3/pool.h)
+ *============================================================================*/
+
+#define POOL_MAGIC              0x4C4F4F50  /* "POOL" */
+
+#define POOL_CLASSES            2
+#define POOL_CLASS_SMALL        0
+#define POOL_CLASS_LARGE        1
+
+#define POOL_SMALL_COUNT        128
+#define POOL_LARGE_COUNT        16
+#define POOL_SUBMIT_SLOTS       128
+
+#define POOL_DIR_TO_CORE3       0
+#define POOL_DIR_TO_LINUX       1
+
+#define POOL_BUF_ID(cls, idx)   (((uint32_t)(cls) << 16) | (uint32_t)(idx))
+#define POOL_BUF_CLASS(id)      ((id) >> 16)
+#define POOL_BUF_INDEX(id)      ((id) & 0xFFFF)
+
+typedef struct {
+    uint32_t buf;
+    uint32_t length;
+    uint32_t tag;
+    uint32_t flags;
+} pool_desc_t;
+
+typedef struct {
+    ipc_ring_ctrl_t submit;
+    ipc_ring_ctrl_t free[POOL_CLASSES];
+} pool_dir_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t class_count;
+    uint32_t buf_size[POOL_CLASSES];
+    uint32_t buf_count[POOL_CLASSES];
+    uint32_t buf_offset[POOL_CLASSES];
+    uint8_t  _pad0[IPC_CACHE_LINE - 8 - 12 * POOL_CLASSES];
+    pool_dir_t dir[2];
+    pool_desc_t submit_slots[2][POOL_SUBMIT_SLOTS];
+    pool_desc_t small_free_slots[2][POOL_SMALL_COUNT / 2];
+    pool_desc_t large_free_slots[2][POOL_LARGE_COUNT / 2];
+} pool_shared_t;
+
+/*============================================================================
+ * SoC-Telemetrie (SHARED_TELEM_ADDR, rpi3_amp_core3/telem.h)
+ *============================================================================*/
+
+#define TELEM_MAGIC             0x4D4C4554  /* "TELM" */
+#define TELEM_SAMPLES           256
+
+#define TELEM_SOURCE_LINUX      0       /* telem_feed schreibt den Ring */
+#define TELEM_SOURCE_CORE3      1       /* Firmware mit TELEM_MS=n */
+
+#define TELEM_VALID_ARM         (1U << 0)
+#define TELEM_VALID_CORE        (1U << 1)
+#define TELEM_VALID_TEMP        (1U << 2)
+#define TELEM_VALID_THROTTLED   (1U << 3)
+
+/* GET_THROTTLED Bits (rpi3_amp_core3/mbox.h), ab Bit 16 seit dem Boot */
+#define THROTTLED_UNDERVOLT     (1U << 0)
+#define THROTTLED_ARM_CAPPED    (1U << 1)
+#define THROTTLED_THROTTLED     (1U << 2)
+#define THROTTLED_SOFT_TEMP     (1U << 3)
+#define THROTTLED_STICKY_SHIFT  16
+
+typedef struct {
+    uint64_t ts_us;
+    uint32_t arm_hz;
+    uint32_t core_hz;
+    uint32_t temp_mc;
+    uint32_t throttled;
+    uint32_t valid;
+    uint32_t seq;
+} telem_sample_t;
+
+typedef struct {
+    volatile uint32_t head;
+    volatile uint32_t errors;
+    uint8_t  _pad0[56];
+    uint32_t magic;
+    uint32_t sample_size;
+    uint32_t sample_count;
+    uint32_t period_ms;
+    uint32_t max_temp_mc;
+    uint32_t source;
+    uint8_t  _pad1[40];
+    telem_sample_t samples[TELEM_SAMPLES];
+} telem_shared_t;
+
+/*============================================================================
+ * Zyklen-Messpunkte (SHARED_PROBE_ADDR, rpi3_amp_core3/probe.h)
+ *============================================================================*/
+
+#define PROBE_MAGIC             0x424F5250  /* "PROB" */
+#define PROBE_MAX_SITES         64
+#define PROBE_NAME_LEN          24
+
+typedef struct {
+    char     name[PROBE_NAME_LEN];
+    uint32_t seq;
+    uint32_t count;
+    uint64_t total;
+    uint32_t min;
+    uint32_t max;
+} probe_entry_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t entry_size;
+    uint32_t max_entries;
+    volatile uint32_t used;
+    volatile uint32_t dropped;
+    uint32_t overhead_cycles;
+    uint8_t  _pad0[40];
+    probe_entry_t entries[PROBE_MAX_SITES];
+} probe_shared_t;
+
+/*============================================================================
+ * PC-Sampling Profiler (SHARED_PROF_ADDR, rpi3_amp_core3/prof.h)
+ *============================================================================*/
+
+#define PROF_MAGIC              0x464F5250  /* "PROF" */
+#define PROF_SAMPLES            1024
+#define PROF_STACK_DEPTH        6
+
+typedef struct {
+    uint64_t pc;
+    uint64_t stack[PROF_STACK_DEPTH];
+    uint32_t depth;
+    uint32_t seq;
+} prof_sample_t;
+
+typedef struct {
+    volatile uint32_t head;
+    volatile uint32_t handler_max_cycles;
+    volatile uint64_t busy_cycles;
+    volatile uint64_t elapsed_cycles;
+    uint8_t  _pad0[40];
+
+    uint32_t magic;
+    uint32_t sample_size;
+    uint32_t sample_count;
+    uint32_t rate_hz;
+    uint32_t stack_depth;
+    uint8_t  _pad1[44];
+
+    prof_sample_t samples[PROF_SAMPLES];
+} prof_shared_t;
+
+/*============================================================================
+ * Kommando-Queue (SHARED_CMD_ADDR, rpi3_amp_core3/cmd.h)
+ *============================================================================*/
+
+#define CMD_MAGIC               0x51444D43  /* "CMDQ" */
+#define CMD_SLOTS               64
+#define CMD_ARGS                6
+#define CMD_VALUES              4
+
+#define CMD_OP_NOP              0
+#define CMD_OP_MEMTEST          1
+#define CMD_OP_SET_HEARTBEAT    2
+#define CMD_OP_RUN_BENCH        3
+#define CMD_OP_CRC32            4
+#define CMD_OP_CRC32C           5
+#define CMD_OP_ADLER32          6
+#define CMD_OP_FILL             7
+#define CMD_OP_COMPARE          8
+
+#define CMD_OK                  0
+#define CMD_E_UNKNOWN           (-1)
+#define CMD_E_INVAL             (-2)
+#define CMD_E_FAILED            (-3)
+
+/* Argument für CMD_OP_RUN_BENCH (rpi3_amp_core3/bench.h) */
+#define BENCH_PHASE_MEMORY      0
+#define BENCH_PHASE_IPC         1
+#define BENCH_PHASE_PRINTF      2
+#define BENCH_PHASE_TIMER       3
+#define BENCH_PHASE_DMA         4
+#define BENCH_PHASE_MEMLIB      5
+#define BENCH_PHASES            6
+
+typedef struct {
+    uint32_t id;
+    uint32_t op;
+    uint32_t arg[CMD_ARGS];
+} cmd_req_t;
+
+typedef struct {
+    uint32_t id;
+    uint32_t op;
+    int32_t  result;
+    uint32_t elapsed_us;
+    uint32_t value[CMD_VALUES];
+} cmd_done_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t req_size;
+    uint32_t done_size;
+    uint32_t slot_count;
+    volatile uint32_t executed;
+    volatile uint32_t failed;
+    volatile uint32_t batches;
+    volatile uint32_t max_batch;
+    uint8_t  _pad0[IPC_CACHE_LINE - 32];
+    ipc_ring_ctrl_t submit;
+    ipc_ring_ctrl_t done;
+    cmd_req_t  submit_slots[CMD_SLOTS];
+    cmd_done_t done_slots[CMD_SLOTS];
+} cmd_shared_t;
+
+/*============================================================================
+ * DSP-Pipeline (SHARED_DSP_ADDR, rpi3_amp_core3/dsp.h)
+ *============================================================================*/
+
+#define DSP_MAGIC               0x20505344  /* "DSP " */
+#define DSP_SLOTS               16
+#define DSP_BLOCK_BYTES         1024
+#define DSP_MAX_STAGES          4
+#define DSP_MAX_TAPS            64
+
+#define DSP_FMT_F32             0
+#define DSP_FMT_Q15             1
+
+#define DSP_STAGE_FIR           1
+#define DSP_STAGE_BIQUAD        2
+
+#define DSP_OK                  0
+#define DSP_E_FORMAT            (-1)
+#define DSP_E_STAGE             (-2)
+#define DSP_E_RANGE             (-3)
+
+typedef struct {
+    uint32_t seq;
+    uint32_t count;
+    uint32_t format;
+    uint32_t config;
+    uint32_t proc_ns;
+    uint8_t  _pad[44];
+    uint8_t  data[DSP_BLOCK_BYTES];
+} dsp_block_t;
+
+typedef struct {
+    uint32_t type;
+    uint32_t taps;
+    float    coeff[DSP_MAX_TAPS];
+} dsp_stage_t;
+
+typedef struct {
+    uint32_t format;
+    uint32_t stage_count;
+    dsp_stage_t stages[DSP_MAX_STAGES];
+} dsp_config_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t slot_size;
+    uint32_t slot_count;
+    uint32_t block_bytes;
+    uint32_t max_stages;
+    uint32_t max_taps;
+    uint8_t  _pad0[IPC_CACHE_LINE - 24];
+    volatile uint32_t config_seq;
+    uint8_t  _pad1[IPC_CACHE_LINE - 4];
+    volatile uint32_t config_ack;
+    volatile int32_t  config_result;
+    volatile uint32_t blocks;
+    volatile uint32_t errors;
+    volatile uint32_t stalls;
+    volatile uint32_t proc_max_ns;
+    volatile uint64_t samples;
+    volatile uint64_t busy_ns;
+    uint8_t  _pad2[IPC_CACHE_LINE - 40];
+    dsp_config_t config;
+    uint8_t  _pad3[IPC_CACHE_LINE - sizeof(dsp_config_t) % IPC_CACHE_LINE];
+    ipc_ring_ctrl_t in;
+    ipc_ring_ctrl_t out;
+    dsp_block_t in_slots[DSP_SLOTS];
+    dsp_block_t out_slots[DSP_SLOTS];
+} dsp_shared_t;
+
+#endif /* AMP_SHARED_H */
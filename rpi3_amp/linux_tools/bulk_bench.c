@@ -0,0 +1,240 @@
+/**
+ * @file bulk_bench.c
+ * @brief Durchsatz-Benchmark des Zero-Copy Buffer-Pools (MB/s)
+ *
+ * Linux -> Core 3: Puffer holen, direkt im Shared Memory füllen, Index
+ * übergeben; Core 3 prüft die Summe (tag) und gibt den Puffer zurück.
+ * Core 3 -> Linux: IPC_MSG_BULK_TX anfordern, Core 3 füllt die Puffer,
+ * Linux prüft und gibt zurück. In beiden Richtungen werden die Nutzdaten
+ * genau einmal geschrieben und einmal gelesen - keine Kopie in Slots.
+ *
+ * Kompilieren (auf dem RPi3):
+ *   make bulk_bench
+ *
+ * Ausführen:
+ *   sudo ./bulk_bench                # 1000 x 64 KB pro Richtung
+ *   sudo ./bulk_bench -c small -n 20000
+ *   sudo ./bulk_bench -q             # ohne Prüfung auf Linux-Seite
+ *
+ * @author RPi3 AMP Project
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "amp_ipc.h"
+
+#define DEFAULT_COUNT   1000
+#define TIMEOUT_SEC     5.0
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double mb_per_sec(uint64_t bytes, double sec) {
+    return sec > 0.0 ? bytes / sec / (1024.0 * 1024.0) : 0.0;
+}
+
+/* Wort i = seq ^ i, wie pool_bulk_tx() in der Firmware */
+static uint32_t buf_fill(volatile uint32_t *p, uint32_t len, uint32_t seq) {
+    uint32_t sum = 0;
+
+    for (uint32_t i = 0; i < len / 4; i++) {
+        uint32_t w = seq ^ i;
+        p[i] = w;
+        sum += w;
+    }
+    return sum;
+}
+
+static uint32_t buf_sum(const volatile uint32_t *p, uint32_t len) {
+    uint32_t sum = 0;
+
+    for (uint32_t i = 0; i < len / 4; i++) {
+        sum += p[i];
+    }
+    return sum;
+}
+
+static void drain(amp_ipc_t *ipc, amp_pool_t *pool) {
+    uint8_t buf[256];
+    uint32_t type;
+    pool_desc_t desc;
+
+    while (amp_ipc_recv(ipc, &type, buf, sizeof(buf)) >= 0) {
+        /* alte Nachrichten verwerfen */
+    }
+    while (amp_pool_receive(pool, &desc) == 0) {
+        amp_pool_release(pool, desc.buf);
+    }
+}
+
+static int bench_linux_to_core3(amp_ipc_t *ipc, amp_pool_t *pool, uint32_t cls,
+                                uint32_t count) {
+    uint32_t bufs_before = ipc->status->pool_rx_bufs;
+    uint32_t errors_before = ipc->status->pool_rx_errors;
+    uint64_t bytes = 0;
+    double start = now_sec();
+    double last_progress = start;
+
+    for (uint32_t i = 0; i < count; ) {
+        uint32_t buf;
+        if (amp_pool_alloc(pool, cls, &buf) < 0) {
+            if (now_sec() - last_progress > TIMEOUT_SEC) {
+                fprintf(stderr, "Timeout: Core 3 does not return buffers (sent %u)\n", i);
+                return -1;
+            }
+            continue;
+        }
+
+        uint32_t len = amp_pool_buf_size(pool, buf);
+        uint32_t tag = buf_fill((volatile uint32_t *)amp_pool_buf(pool, buf), len, i);
+        if (amp_pool_submit(pool, buf, len, tag) < 0) {
+            fprintf(stderr, "Submit of buffer 0x%x failed\n", buf);
+            return -1;
+        }
+        amp_ipc_kick(ipc);
+        bytes += len;
+        i++;
+        last_progress = now_sec();
+    }
+
+    /* Warten bis Core 3 alles geprüft hat */
+    while ((int32_t)(ipc->status->pool_rx_bufs - (bufs_before + count)) < 0) {
+        if (now_sec() - last_progress > TIMEOUT_SEC) {
+            fprintf(stderr, "Timeout waiting for Core 3 statistics\n");
+            return -1;
+        }
+    }
+    double elapsed = now_sec() - start;
+    uint32_t errors = ipc->status->pool_rx_errors - errors_before;
+
+    printf("Linux -> Core 3 : %u buffers, %llu KB\n", count, (unsigned long long)(bytes >> 10));
+    printf("  Throughput    : %10.1f MB/s\n", mb_per_sec(bytes, elapsed));
+    printf("  Core 3 errors : %10u\n", errors);
+    return errors ? -1 : 0;
+}
+
+static int bench_core3_to_linux(amp_ipc_t *ipc, amp_pool_t *pool, uint32_t cls,
+                                uint32_t count, int verify) {
+    uint32_t args[2] = { cls, count };
+    uint32_t done[2] = { 0, 0 };
+    uint32_t received = 0, errors = 0;
+    int have_done = 0;
+    uint64_t bytes = 0;
+    double start = now_sec();
+    double last_progress = start;
+    uint8_t msg[256];
+    uint32_t type;
+
+    while (amp_ipc_send(ipc, IPC_MSG_BULK_TX, args, sizeof(args)) != 0) {
+        if (now_sec() - start > TIMEOUT_SEC) {
+            fprintf(stderr, "Timeout: cannot submit BULK_TX\n");
+            return -1;
+        }
+    }
+    amp_ipc_kick(ipc);
+
+    while (!have_done || received < done[0]) {
+        pool_desc_t desc;
+
+        if (amp_pool_receive(pool, &desc) == 0) {
+            uint32_t len = desc.length;
+            volatile uint32_t *p = (volatile uint32_t *)amp_pool_buf(pool, desc.buf);
+            if (!p || len > amp_pool_buf_size(pool, desc.buf) ||
+                (verify && buf_sum(p, len) != desc.tag)) {
+                errors++;
+            }
+            if (p) {
+                amp_pool_release(pool, desc.buf);
+            }
+            bytes += len;
+            received++;
+            last_progress = now_sec();
+            continue;
+        }
+
+        int len = amp_ipc_recv(ipc, &type, msg, sizeof(msg));
+        if (len >= (int)sizeof(done) && type == IPC_MSG_BULK_TX_DONE) {
+            memcpy(done, msg, sizeof(done));
+            have_done = 1;
+            last_progress = now_sec();
+        } else if (len < 0 && now_sec() - last_progress > TIMEOUT_SEC) {
+            fprintf(stderr, "Timeout: received %u of %u buffers\n", received, count);
+            return -1;
+        }
+    }
+    double elapsed = now_sec() - start;
+
+    printf("Core 3 -> Linux : %u buffers, %llu KB (Core 3 sent %u)\n",
+           received, (unsigned long long)(bytes >> 10), done[0]);
+    printf("  Throughput    : %10.1f MB/s%s\n", mb_per_sec(bytes, elapsed),
+           verify ? "" : " (not verified)");
+    if (done[1]) {
+        printf("  Core 3 send   : %10.1f MB/s\n", mb_per_sec(bytes, done[1] * 1e-6));
+    }
+    printf("  Linux errors  : %10u\n", errors);
+    return errors || received < count ? -1 : 0;
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t count = DEFAULT_COUNT;
+    uint32_t cls = POOL_CLASS_LARGE;
+    int verify = 1;
+    amp_ipc_t ipc;
+    amp_pool_t pool;
+    int opt, rc = 0;
+
+    while ((opt = getopt(argc, argv, "c:n:qh")) != -1) {
+        switch (opt) {
+            case 'c':
+                if (strcmp(optarg, "small") == 0) {
+                    cls = POOL_CLASS_SMALL;
+                } else if (strcmp(optarg, "large") == 0) {
+                    cls = POOL_CLASS_LARGE;
+                } else {
+                    fprintf(stderr, "Unknown buffer class '%s'\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'n':
+                count = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'q':
+                verify = 0;
+                break;
+            default:
+                printf("Usage: %s [-c small|large] [-n count] [-q]\n", argv[0]);
+                printf("  -c class   Buffer class (default large)\n");
+                printf("  -n count   Buffers per direction (default %u)\n", DEFAULT_COUNT);
+                printf("  -q         Do not verify received buffers on Linux\n");
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if (amp_ipc_open(&ipc) < 0) {
+        return 1;
+    }
+    if (amp_pool_open(&ipc, &pool) < 0) {
+        amp_ipc_close(&ipc);
+        return 1;
+    }
+
+    printf("RPi3 AMP - Buffer Pool Benchmark\n");
+    printf("Class: %u x %u KB per direction\n\n",
+           pool.shm->buf_count[cls] / 2, pool.shm->buf_size[cls] / 1024);
+
+    drain(&ipc, &pool);
+    if (bench_linux_to_core3(&ipc, &pool, cls, count) < 0) rc = 1;
+    printf("\n");
+    drain(&ipc, &pool);
+    if (bench_core3_to_linux(&ipc, &pool, cls, count, verify) < 0) rc = 1;
+
+    amp_ipc_close(&ipc);
+    return rc;
+}
@@ -0,0 +1,514 @@
+/**
+ * @file dsp_stream.c
+ * @brief Generator + Prüfer für die DSP-Pipeline auf Core 3
+ *
+ * Lädt eine Filterkette (FIR und/oder Biquads) nach SHARED_DSP_ADDR,
+ * erzeugt ein Testsignal (zwei Sinus + Rauschen), schickt es blockweise
+ * über den in-Ring an Core 3 und holt die gefilterten Blöcke aus dem
+ * out-Ring. Jeder Block wird gegen eine skalare Referenz auf diesem Core
+ * geprüft: Q15 bitgenau, float mit Toleranz (FMA / Rechenreihenfolge).
+ *
+ * Gemessen werden:
+ *   - Durchsatz in Samples/s (Wanduhr, inkl. Kopieren ins Shared Memory)
+ *   - Latenz pro Block vom Commit in den in-Ring bis zur Abholung
+ *     (min/avg/p99/max, mit -q 1 ohne Warteschlange)
+ *   - Rechenzeit pro Block auf Core 3 (proc_ns) und der reine
+ *     Durchsatz der Kernels (samples / busy_ns)
+ *
+ * Kompilieren (auf dem RPi3):
+ *   make dsp_stream
+ *
+ * Ausführen:
+ *   sudo ./dsp_stream                        # float, FIR + 2 Biquads
+ *   sudo ./dsp_stream -f q15 -c fir -t 64
+ *   sudo ./dsp_stream -q 1 -w poll           # Latenz statt Durchsatz
+ *
+ * @author RPi3 AMP Project
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "amp_ipc.h"
+
+#define DEFAULT_BLOCKS      2000
+#define DEFAULT_TAPS        31
+#define TIMEOUT_SEC         10.0
+#define SLEEP_NS            20000
+#define F32_TOLERANCE       1e-3
+
+typedef enum { C_NONE, C_FIR, C_IIR, C_BOTH, C_COUNT } chain_t;
+
+static const char *const g_chains[C_COUNT] = { "none", "fir", "iir", "both" };
+
+static int g_sleep = 1;
+
+/*============================================================================
+ * Zeit
+ *============================================================================*/
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return x < y ? -1 : x > y;
+}
+
+/*============================================================================
+ * Filterentwurf
+ *============================================================================*/
+
+/* Gefensterter Sinc-Tiefpass (Hamming), Summe = 1 */
+static void design_fir(dsp_stage_t *st, uint32_t taps, double fc) {
+    double sum = 0.0;
+
+    st->type = DSP_STAGE_FIR;
+    st->taps = taps;
+    for (uint32_t i = 0; i < taps; i++) {
+        double m = i - (taps - 1) / 2.0;
+        double sinc = m == 0.0 ? 2.0 * fc : sin(2.0 * M_PI * fc * m) / (M_PI * m);
+        double win = taps > 1 ? 0.54 - 0.46 * cos(2.0 * M_PI * i / (taps - 1)) : 1.0;
+        st->coeff[i] = (float)(sinc * win);
+        sum += st->coeff[i];
+    }
+    for (uint32_t i = 0; i < taps; i++) {
+        st->coeff[i] = (float)(st->coeff[i] / sum);
+    }
+}
+
+/* RBJ Audio-EQ Cookbook, f0 relativ zur Abtastrate */
+static void design_biquad(dsp_stage_t *st, double f0, double q, int highpass) {
+    double w0 = 2.0 * M_PI * f0;
+    double c = cos(w0), alpha = sin(w0) / (2.0 * q);
+    double a0 = 1.0 + alpha;
+    double b1 = highpass ? -(1.0 + c) : 1.0 - c;
+
+    st->type = DSP_STAGE_BIQUAD;
+    st->taps = 5;
+    st->coeff[0] = (float)((highpass ? -b1 : b1) / 2.0 / a0);
+    st->coeff[1] = (float)(b1 / a0);
+    st->coeff[2] = st->coeff[0];
+    st->coeff[3] = (float)(-2.0 * c / a0);
+    st->coeff[4] = (float)((1.0 - alpha) / a0);
+}
+
+static void build_config(dsp_config_t *cfg, uint32_t format, chain_t chain, uint32_t taps) {
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->format = format;
+    if (chain == C_FIR || chain == C_BOTH) {
+        design_fir(&cfg->stages[cfg->stage_count++], taps, 0.125);
+    }
+    if (chain == C_IIR || chain == C_BOTH) {
+        design_biquad(&cfg->stages[cfg->stage_count++], 0.01, M_SQRT1_2, 1);
+        design_biquad(&cfg->stages[cfg->stage_count++], 0.1, M_SQRT1_2, 0);
+    }
+}
+
+/*============================================================================
+ * Referenz (gleiche Rundung wie rpi3_amp_core3/dsp.c)
+ *============================================================================*/
+
+typedef struct {
+    uint32_t type;
+    uint32_t taps;
+    float    hf[DSP_MAX_TAPS];
+    int16_t  hq[DSP_MAX_TAPS];
+    float    bf[5];
+    int32_t  bq[5];
+    float    ext_f[DSP_MAX_TAPS - 1 + DSP_BLOCK_BYTES / 4];
+    int16_t  ext_q[DSP_MAX_TAPS - 1 + DSP_BLOCK_BYTES / 2];
+    float    s1, s2;
+    int32_t  x1, x2, y1, y2;
+} ref_stage_t;
+
+static ref_stage_t g_ref[DSP_MAX_STAGES];
+static uint32_t g_ref_count;
+
+static int32_t to_fixed(float c, float one) {
+    float v = c * one;
+    v += v >= 0 ? 0.5f : -0.5f;
+    if (v > 32767.0f) {
+        v = 32767.0f;
+    } else if (v < -32768.0f) {
+        v = -32768.0f;
+    }
+    return (int32_t)v;
+}
+
+static int16_t sat_q15(int64_t acc, uint32_t shift) {
+    acc = (acc + (1LL << (shift - 1))) >> shift;
+    return acc > 32767 ? 32767 : acc < -32768 ? -32768 : (int16_t)acc;
+}
+
+static void ref_init(const dsp_config_t *cfg) {
+    memset(g_ref, 0, sizeof(g_ref));
+    g_ref_count = cfg->stage_count;
+    for (uint32_t s = 0; s < g_ref_count; s++) {
+        const dsp_stage_t *src = &cfg->stages[s];
+        ref_stage_t *st = &g_ref[s];
+        st->type = src->type;
+        st->taps = src->taps;
+        for (uint32_t k = 0; k < src->taps && src->type == DSP_STAGE_FIR; k++) {
+            st->hf[k] = src->coeff[k];
+            st->hq[k] = (int16_t)to_fixed(src->coeff[k], 32768.0f);
+        }
+        for (uint32_t k = 0; k < 5 && src->type == DSP_STAGE_BIQUAD; k++) {
+            st->bf[k] = src->coeff[k];
+            st->bq[k] = to_fixed(src->coeff[k], 16384.0f);
+        }
+    }
+}
+
+static void ref_f32(float *x, uint32_t n) {
+    for (uint32_t s = 0; s < g_ref_count; s++) {
+        ref_stage_t *st = &g_ref[s];
+        if (st->type == DSP_STAGE_FIR) {
+            uint32_t h = st->taps - 1;
+            memcpy(&st->ext_f[h], x, n * sizeof(float));
+            for (uint32_t i = 0; i < n; i++) {
+                float acc = 0;
+                for (uint32_t j = 0; j < st->taps; j++) {
+                    acc += st->hf[st->taps - 1 - j] * st->ext_f[i + j];
+                }
+                x[i] = acc;
+            }
+            memmove(st->ext_f, &st->ext_f[n], h * sizeof(float));
+        } else {
+            for (uint32_t i = 0; i < n; i++) {
+                float in = x[i];
+                float out = st->bf[0] * in + st->s1;
+                st->s1 = st->bf[1] * in - st->bf[3] * out + st->s2;
+                st->s2 = st->bf[2] * in - st->bf[4] * out;
+                x[i] = out;
+            }
+        }
+    }
+}
+
+static void ref_q15(int16_t *x, uint32_t n) {
+    for (uint32_t s = 0; s < g_ref_count; s++) {
+        ref_stage_t *st = &g_ref[s];
+        if (st->type == DSP_STAGE_FIR) {
+            uint32_t h = st->taps - 1;
+            memcpy(&st->ext_q[h], x, n * sizeof(int16_t));
+            for (uint32_t i = 0; i < n; i++) {
+                int32_t acc = 0;
+                for (uint32_t j = 0; j < st->taps; j++) {
+                    acc += (int32_t)st->hq[st->taps - 1 - j] * st->ext_q[i + j];
+                }
+                x[i] = sat_q15(acc, 15);
+            }
+            memmove(st->ext_q, &st->ext_q[n], h * sizeof(int16_t));
+        } else {
+            const int32_t *b = st->bq;
+            for (uint32_t i = 0; i < n; i++) {
+                int32_t in = x[i];
+                int64_t acc = (int64_t)b[0] * in + (int64_t)b[1] * st->x1 +
+                              (int64_t)b[2] * st->x2 - (int64_t)b[3] * st->y1 -
+                              (int64_t)b[4] * st->y2;
+                int32_t out = sat_q15(acc, 14);
+                st->x2 = st->x1;
+                st->x1 = in;
+                st->y2 = st->y1;
+                st->y1 = out;
+                x[i] = (int16_t)out;
+            }
+        }
+    }
+}
+
+/*============================================================================
+ * Generator
+ *============================================================================*/
+
+static uint32_t g_lcg = 12345;
+static uint64_t g_phase = 0;
+
+static float next_sample(void) {
+    double t = (double)g_phase++;
+    g_lcg = g_lcg * 1664525 + 1013904223;
+    return (float)(0.4 * sin(2.0 * M_PI * 0.003 * t) + 0.3 * sin(2.0 * M_PI * 0.2 * t) +
+                   0.2 * ((int32_t)g_lcg / 2147483648.0));
+}
+
+/*============================================================================
+ * Shared Memory
+ *============================================================================*/
+
+static uint64_t read_u64(const volatile uint64_t *p) {
+    const volatile uint32_t *w = (const volatile uint32_t *)p;
+    return w[0] | (uint64_t)w[1] << 32;
+}
+
+static int load_config(amp_ipc_t *ipc, volatile dsp_shared_t *shm, const dsp_config_t *cfg) {
+    uint32_t seq = shm->config_seq + 1;
+    double start = now_sec();
+
+    amp_copy_to_shared(&shm->config, cfg, sizeof(*cfg));
+    __atomic_store_n(&shm->config_seq, seq, __ATOMIC_RELEASE);
+    amp_ipc_kick(ipc);
+
+    while (__atomic_load_n(&shm->config_ack, __ATOMIC_ACQUIRE) != seq) {
+        if (now_sec() - start > TIMEOUT_SEC) {
+            fprintf(stderr, "Core 3 did not acknowledge the configuration\n");
+            return -1;
+        }
+        usleep(100);
+    }
+    if (shm->config_result != DSP_OK) {
+        fprintf(stderr, "Configuration rejected (result %d)\n", shm->config_result);
+        return -1;
+    }
+    return 0;
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+static void usage(const char *prog) {
+    printf("Usage: %s [-f f32|q15] [-c chain] [-t taps] [-b samples] [-n blocks] [-q inflight] [-w poll|sleep]\n", prog);
+    printf("  -f format  f32 or q15 (default f32)\n");
+    printf("  -c chain   none | fir | iir | both (default both)\n");
+    printf("  -t taps    FIR taps, 1 .. %u (default %u)\n", DSP_MAX_TAPS, DEFAULT_TAPS);
+    printf("  -b n       Samples per block (default max: %u f32 / %u q15)\n",
+           DSP_BLOCK_BYTES / 4, DSP_BLOCK_BYTES / 2);
+    printf("  -n count   Blocks (default %u)\n", DEFAULT_BLOCKS);
+    printf("  -q n       Blocks in flight, 1 .. %u (default %u)\n", DSP_SLOTS, DSP_SLOTS);
+    printf("  -w mode    Wait for blocks: poll or sleep (default sleep)\n");
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t format = DSP_FMT_F32;
+    int chain = C_BOTH;
+    uint32_t taps = DEFAULT_TAPS;
+    uint32_t bs = 0;
+    uint32_t blocks = DEFAULT_BLOCKS;
+    uint32_t inflight = DSP_SLOTS;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "f:c:t:b:n:q:w:h")) != -1) {
+        switch (opt) {
+            case 'f': format = strcmp(optarg, "q15") == 0 ? DSP_FMT_Q15 : DSP_FMT_F32; break;
+            case 'c':
+                for (chain = 0; chain < C_COUNT && strcmp(optarg, g_chains[chain]); chain++) {
+                }
+                if (chain == C_COUNT) {
+                    fprintf(stderr, "Unknown chain '%s'\n", optarg);
+                    return 1;
+                }
+                break;
+            case 't': taps = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'b': bs = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'n': blocks = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'q': inflight = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'w': g_sleep = strcmp(optarg, "poll") != 0; break;
+            case 'h': usage(argv[0]); return 0;
+            default:  usage(argv[0]); return 1;
+        }
+    }
+
+    uint32_t size = format == DSP_FMT_F32 ? 4 : 2;
+    if (bs == 0) {
+        bs = DSP_BLOCK_BYTES / size;
+    }
+    if (bs * size > DSP_BLOCK_BYTES || taps == 0 || taps > DSP_MAX_TAPS || blocks == 0 ||
+        inflight == 0 || inflight > DSP_SLOTS) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    amp_ipc_t ipc;
+    if (amp_ipc_open(&ipc) < 0) {
+        return 1;
+    }
+
+    volatile dsp_shared_t *shm = (volatile dsp_shared_t *)amp_ipc_phys(&ipc, SHARED_DSP_ADDR);
+    amp_ring_t in, out;
+    if (__atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) != DSP_MAGIC ||
+        shm->slot_size != sizeof(dsp_block_t) ||
+        amp_ring_attach(&ipc, &in, &shm->in, 1) < 0 ||
+        amp_ring_attach(&ipc, &out, &shm->out, 0) < 0) {
+        fprintf(stderr, "DSP pipeline not initialized by Core 3\n");
+        amp_ipc_close(&ipc);
+        return 1;
+    }
+
+    /* Kette laden, Referenz mit denselben Koeffizienten aufsetzen */
+    dsp_config_t cfg;
+    build_config(&cfg, format, (chain_t)chain, taps);
+    if (load_config(&ipc, shm, &cfg) < 0) {
+        amp_ipc_close(&ipc);
+        return 1;
+    }
+    ref_init(&cfg);
+    uint32_t config = shm->config_ack;
+
+    double *t_submit = calloc(blocks, sizeof(double));
+    double *lat = calloc(blocks, sizeof(double));
+    uint8_t *input = malloc((size_t)blocks * DSP_BLOCK_BYTES);
+    if (!t_submit || !lat || !input) {
+        fprintf(stderr, "Out of memory\n");
+        amp_ipc_close(&ipc);
+        return 1;
+    }
+
+    /* Signal vorab erzeugen, damit der Generator nicht mitgemessen wird */
+    for (uint32_t b = 0; b < blocks; b++) {
+        uint8_t *blk = input + (size_t)b * DSP_BLOCK_BYTES;
+        for (uint32_t i = 0; i < bs; i++) {
+            float v = next_sample();
+            if (format == DSP_FMT_F32) {
+                ((float *)blk)[i] = v;
+            } else {
+                ((int16_t *)blk)[i] = (int16_t)lrintf(v * 32767.0f);
+            }
+        }
+    }
+
+    uint32_t blocks0 = shm->blocks, errors0 = shm->errors, stalls0 = shm->stalls;
+    uint64_t samples0 = read_u64(&shm->samples), busy0 = read_u64(&shm->busy_ns);
+
+    /* seq pro Lauf verschieden, alte Blöcke im out-Ring werden übersprungen */
+    uint32_t base = (uint32_t)time(NULL) << 12;
+    uint32_t submitted = 0, received = 0, mismatches = 0, stale = 0;
+    uint64_t proc_sum = 0;
+    uint32_t proc_max = 0;
+    double max_err = 0.0;
+    uint8_t result[DSP_BLOCK_BYTES] __attribute__((aligned(4)));
+    double start = now_sec(), last = start;
+
+    while (received < blocks) {
+        int queued = 0;
+        volatile dsp_block_t *slot;
+
+        while (submitted < blocks && submitted - received < inflight &&
+               (slot = (volatile dsp_block_t *)amp_ring_reserve(&in)) != NULL) {
+            slot->seq = base + submitted;
+            slot->count = bs;
+            slot->format = format;
+            amp_copy_to_shared(slot->data, input + (size_t)submitted * DSP_BLOCK_BYTES, bs * size);
+            amp_ring_commit(&in);
+            t_submit[submitted++] = now_sec();
+            queued = 1;
+        }
+        if (queued) {
+            amp_ipc_kick(&ipc);
+        }
+
+        int got = 0;
+        while ((slot = (volatile dsp_block_t *)amp_ring_peek(&out)) != NULL) {
+            uint32_t seq = slot->seq - base;
+            uint32_t count = slot->count;
+            uint32_t ns = slot->proc_ns;
+
+            if (seq >= submitted || slot->config != config) {
+                amp_ring_release(&out);
+                stale++;
+                continue;
+            }
+            if (count == bs) {
+                amp_copy_from_shared(result, slot->data, bs * size);
+            }
+            amp_ring_release(&out);
+            last = now_sec();
+            got = 1;
+
+            if (seq != received || count != bs) {
+                fprintf(stderr, "block %u: got seq %u, %u samples\n", received, seq, count);
+                mismatches++;
+                lat[received++] = last - t_submit[seq < submitted ? seq : 0];
+                continue;
+            }
+            lat[received] = last - t_submit[received];
+            proc_sum += ns;
+            if (ns > proc_max) {
+                proc_max = ns;
+            }
+
+            /* Referenz auf dem Eingangsblock rechnen und vergleichen */
+            uint8_t *ref = input + (size_t)received * DSP_BLOCK_BYTES;
+            if (format == DSP_FMT_F32) {
+                float *r = (float *)ref, *y = (float *)result;
+                double err = 0.0;
+                ref_f32(r, bs);
+                for (uint32_t i = 0; i < bs; i++) {
+                    err = fmax(err, fabs((double)y[i] - r[i]));
+                }
+                max_err = fmax(max_err, err);
+                if (err > F32_TOLERANCE) {
+                    mismatches++;
+                }
+            } else {
+                ref_q15((int16_t *)ref, bs);
+                if (memcmp(ref, result, bs * size) != 0) {
+                    mismatches++;
+                }
+            }
+            received++;
+        }
+
+        if (!got) {
+            if (now_sec() - last > TIMEOUT_SEC) {
+                fprintf(stderr, "Timeout, %u of %u blocks received\n", received, blocks);
+                break;
+            }
+            if (g_sleep) {
+                struct timespec ts = { 0, SLEEP_NS };
+                nanosleep(&ts, NULL);
+            }
+        }
+    }
+
+    double elapsed = last - start;
+    uint64_t samples = read_u64(&shm->samples) - samples0;
+    uint64_t busy = read_u64(&shm->busy_ns) - busy0;
+
+    printf("DSP stream: %s, chain %s", format == DSP_FMT_F32 ? "f32" : "q15", g_chains[chain]);
+    if (chain == C_FIR || chain == C_BOTH) {
+        printf(" (FIR %u taps)", taps);
+    }
+    printf(", %u blocks x %u samples\n", blocks, bs);
+
+    if (received) {
+        double sum = 0.0;
+        for (uint32_t i = 0; i < received; i++) {
+            sum += lat[i];
+        }
+        qsort(lat, received, sizeof(double), cmp_double);
+
+        printf("  throughput : %.2f Msamples/s, %.1f MB/s (wall)\n",
+               (double)received * bs / elapsed / 1e6,
+               (double)received * bs * size / elapsed / (1024.0 * 1024.0));
+        printf("  latency    : min %.1f  avg %.1f  p99 %.1f  max %.1f us (in-ring -> out-ring, %u in flight)\n",
+               lat[0] * 1e6, sum / received * 1e6, lat[(received - 1) * 99 / 100] * 1e6,
+               lat[received - 1] * 1e6, inflight);
+        printf("  core3 proc : avg %.1f  max %.1f us per block, %.2f Msamples/s while busy\n",
+               proc_sum / 1e3 / received, proc_max / 1e3,
+               busy ? samples * 1e3 / busy : 0.0);
+    }
+    printf("  core3      : %u blocks, %u errors, %u stalls (out-ring full)\n",
+           shm->blocks - blocks0, shm->errors - errors0, shm->stalls - stalls0);
+    if (stale) {
+        printf("  skipped    : %u stale blocks from an earlier run\n", stale);
+    }
+    if (format == DSP_FMT_F32) {
+        printf("  verify     : %s, max error %.3g\n", mismatches ? "FAILED" : "ok", max_err);
+    } else {
+        printf("  verify     : %s (bit-exact)\n", mismatches ? "FAILED" : "ok");
+    }
+
+    free(t_submit);
+    free(lat);
+    free(input);
+    amp_ipc_close(&ipc);
+    return mismatches || received < blocks ? 1 : 0;
+}
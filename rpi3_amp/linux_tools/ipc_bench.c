@@ -0,0 +1,151 @@
+/**
+ * @file ipc_bench.c
+ * @brief Durchsatz-Benchmark der SPSC IPC Ringe (Nachrichten/s)
+ *
+ * Misst beide Richtungen und gibt jeweils die Rate auf Linux-Seite und
+ * die von Core 3 gemessene Rate (aus dem Status-Block) aus.
+ *
+ * Kompilieren (auf dem RPi3):
+ *   make ipc_bench
+ *
+ * Ausführen:
+ *   sudo ./ipc_bench             # 100000 Nachrichten pro Richtung
+ *   sudo ./ipc_bench -n 1000000
+ *
+ * @author RPi3 AMP Project
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "amp_ipc.h"
+
+#define DEFAULT_COUNT   100000
+#define TIMEOUT_SEC     5.0
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void drain(amp_ipc_t *ipc) {
+    uint8_t buf[256];
+    uint32_t type;
+    while (amp_ipc_recv(ipc, &type, buf, sizeof(buf)) >= 0) {
+        /* alte Nachrichten verwerfen */
+    }
+}
+
+static int bench_linux_to_core3(amp_ipc_t *ipc, uint32_t count) {
+    uint32_t expected = ipc->status->messages_received + count;
+    double start = now_sec();
+
+    for (uint32_t i = 0; i < count; ) {
+        uint32_t args[2] = { i, count };
+        if (amp_ipc_send(ipc, IPC_MSG_BENCH_RX, args, sizeof(args)) == 0) {
+            amp_ipc_kick(ipc);
+            i++;
+        } else if (now_sec() - start > TIMEOUT_SEC) {
+            fprintf(stderr, "Timeout: Core 3 does not consume (sent %u)\n", i);
+            return -1;
+        }
+    }
+    double elapsed = now_sec() - start;
+
+    /* Warten bis Core 3 alles verarbeitet hat */
+    while ((int32_t)(ipc->status->messages_received - expected) < 0) {
+        if (now_sec() - start > TIMEOUT_SEC) {
+            fprintf(stderr, "Timeout waiting for Core 3 statistics\n");
+            return -1;
+        }
+    }
+
+    printf("Linux -> Core 3 : %u msgs\n", count);
+    printf("  Linux  send   : %10.0f msgs/s\n", count / elapsed);
+    printf("  Core 3 recv   : %10u msgs/s\n", ipc->status->ipc_rx_rate);
+    return 0;
+}
+
+static int bench_core3_to_linux(amp_ipc_t *ipc, uint32_t count) {
+    uint8_t buf[256];
+    uint32_t type;
+    uint32_t received = 0;
+    uint32_t done[2] = { 0, 0 };
+    double start = now_sec();
+    double first = 0.0, last = 0.0;
+
+    while (amp_ipc_send(ipc, IPC_MSG_BENCH_TX, &count, sizeof(count)) != 0) {
+        if (now_sec() - start > TIMEOUT_SEC) {
+            fprintf(stderr, "Timeout: cannot submit BENCH_TX\n");
+            return -1;
+        }
+    }
+    amp_ipc_kick(ipc);
+
+    for (;;) {
+        int len = amp_ipc_recv(ipc, &type, buf, sizeof(buf));
+        if (len < 0) {
+            if (now_sec() - start > TIMEOUT_SEC + count / 100000.0) {
+                fprintf(stderr, "Timeout: received %u of %u\n", received, count);
+                return -1;
+            }
+            continue;
+        }
+        if (type == IPC_MSG_BENCH_DATA) {
+            if (received == 0) first = now_sec();
+            received++;
+            last = now_sec();
+        } else if (type == IPC_MSG_BENCH_DONE && len >= (int)sizeof(done)) {
+            memcpy(done, buf, sizeof(done));
+            break;
+        }
+    }
+
+    printf("Core 3 -> Linux : %u msgs (Core 3 sent %u)\n", received, done[0]);
+    if (last > first) {
+        printf("  Linux  recv   : %10.0f msgs/s\n", received / (last - first));
+    }
+    if (done[1]) {
+        printf("  Core 3 send   : %10.0f msgs/s\n", done[0] * 1e6 / done[1]);
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t count = DEFAULT_COUNT;
+    amp_ipc_t ipc;
+    int opt, rc = 0;
+
+    while ((opt = getopt(argc, argv, "n:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                count = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            default:
+                printf("Usage: %s [-n count]\n", argv[0]);
+                printf("  -n count   Messages per direction (default %u)\n", DEFAULT_COUNT);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if (amp_ipc_open(&ipc) < 0) {
+        return 1;
+    }
+
+    printf("RPi3 AMP - IPC Ring Benchmark\n");
+    printf("Slots: %u x %u bytes per direction\n\n",
+           ipc.tx.mask + 1, ipc.tx.slot_size);
+
+    drain(&ipc);
+    if (bench_linux_to_core3(&ipc, count) < 0) rc = 1;
+    printf("\n");
+    drain(&ipc);
+    if (bench_core3_to_linux(&ipc, count) < 0) rc = 1;
+
+    amp_ipc_close(&ipc);
+    return rc;
+}
@@ -0,0 +1,406 @@
+/**
+ * @file log_decode.c
+ * @brief Dekodiert das Binär-Log von Core 3 (make LOG_BINARY=1)
+ *
+ * Core 3 schickt statt Text Frames mit Format-ID und rohen Argumenten
+ * (Format siehe rpi3_amp_core3/binlog.h). Die Format-Strings stehen in der
+ * Section "logfmt" des Firmware-ELFs, die ID ist der Offset darin. Dieses
+ * Tool liest die Section, sucht im Byte-Strom nach Frames, prüft die
+ * Fletcher-16 Summe und gibt den formatierten Text aus. Alles außerhalb
+ * gültiger Frames (normale uart_puts Ausgabe) wird unverändert
+ * durchgereicht.
+ *
+ * Das ELF muss zum laufenden Image passen - nach jedem Build neu angeben.
+ *
+ * Kompilieren:
+ *   make log_decode
+ *
+ * Ausführen (auf dem Entwicklungsrechner am UART-Adapter):
+ *   stty -F /dev/ttyUSB0 115200 raw
+ *   ./log_decode -e ../rpi3_amp_core3/kernel8.elf -i /dev/ttyUSB0
+ *
+ *   # Host-Build: make host LOG_BINARY=1
+ *   ./core3_host -t 10 | ../linux_tools/log_decode -e core3_host -s
+ *
+ * @author RPi3 AMP Project
+ */
+
+#include <elf.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Muss mit rpi3_amp_core3/binlog.h übereinstimmen */
+#define LOG_FRAME_SYNC      0x1E
+#define LOG_SECTION         "logfmt"
+
+#define DEFAULT_ELF         "../rpi3_amp_core3/kernel8.elf"
+
+typedef struct {
+    const char *fmts;           /* Inhalt der Section logfmt */
+    uint32_t    fmts_size;
+    uint64_t    wire_bytes;     /* Alle gelesenen Bytes */
+    uint64_t    frames;
+    uint64_t    frame_bytes;    /* Davon in gültigen Frames */
+    uint64_t    text_bytes;     /* Text, den die Frames ersetzen (inkl. \r) */
+    uint64_t    passthrough;    /* Bytes außerhalb von Frames */
+    uint64_t    bad;            /* Sync ohne gültige Prüfsumme */
+} decoder_t;
+
+typedef struct {
+    const uint8_t *p;
+    uint32_t       len;
+    uint32_t       pos;
+    int            short_read;  /* Payload zu kurz (Frame war voll) */
+} payload_t;
+
+/*============================================================================
+ * ELF
+ *============================================================================*/
+
+static int load_formats(decoder_t *dec, const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *elf = malloc(size);
+    if (!elf || fread(elf, 1, size, f) != (size_t)size) {
+        fprintf(stderr, "%s: read failed\n", path);
+        fclose(f);
+        free(elf);
+        return -1;
+    }
+    fclose(f);
+
+    const Elf64_Ehdr *eh = (const Elf64_Ehdr *)elf;
+    if (size < (long)sizeof(*eh) || memcmp(eh->e_ident, ELFMAG, SELFMAG) != 0 ||
+        eh->e_ident[EI_CLASS] != ELFCLASS64 ||
+        eh->e_shoff + (uint64_t)eh->e_shnum * sizeof(Elf64_Shdr) > (uint64_t)size ||
+        eh->e_shstrndx >= eh->e_shnum) {
+        fprintf(stderr, "%s: not a 64-bit ELF file\n", path);
+        free(elf);
+        return -1;
+    }
+
+    const Elf64_Shdr *sh = (const Elf64_Shdr *)(elf + eh->e_shoff);
+    const char *names = (const char *)elf + sh[eh->e_shstrndx].sh_offset;
+
+    for (uint32_t i = 0; i < eh->e_shnum; i++) {
+        if (strcmp(names + sh[i].sh_name, LOG_SECTION) != 0) {
+            continue;
+        }
+        if (sh[i].sh_type == SHT_NOBITS || sh[i].sh_offset + sh[i].sh_size > (uint64_t)size) {
+            break;
+        }
+        char *fmts = malloc(sh[i].sh_size + 1);
+        memcpy(fmts, elf + sh[i].sh_offset, sh[i].sh_size);
+        fmts[sh[i].sh_size] = '\0';
+        dec->fmts = fmts;
+        dec->fmts_size = (uint32_t)sh[i].sh_size;
+        free(elf);
+        return 0;
+    }
+
+    fprintf(stderr, "%s: no '%s' section (firmware built with LOG_BINARY=1?)\n",
+            path, LOG_SECTION);
+    free(elf);
+    return -1;
+}
+
+/*============================================================================
+ * Frames
+ *============================================================================*/
+
+static uint16_t fletcher16(const uint8_t *p, uint32_t len) {
+    uint32_t a = 0, b = 0;
+
+    for (uint32_t i = 0; i < len; i++) {
+        a = (a + p[i]) % 255;
+        b = (b + a) % 255;
+    }
+    return (uint16_t)((b << 8) | a);
+}
+
+static uint64_t get_varint(payload_t *pl) {
+    uint64_t v = 0;
+
+    for (uint32_t shift = 0; shift < 64; shift += 7) {
+        if (pl->pos >= pl->len) {
+            pl->short_read = 1;
+            return 0;
+        }
+        uint8_t b = pl->p[pl->pos++];
+        v |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            break;
+        }
+    }
+    return v;
+}
+
+static int64_t get_signed(payload_t *pl) {
+    uint64_t v = get_varint(pl);
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+/*
+ * Text eines Frames ausgeben. Gibt zurück, wie viele Bytes derselbe Text
+ * im Textmodus auf der Leitung gekostet hätte ('\n' als "\r\n").
+ */
+static size_t format_frame(decoder_t *dec, payload_t *pl, FILE *out) {
+    char text[8192];
+    size_t n = 0, newlines = 0;
+    uint64_t id = get_varint(pl);
+
+#define EMIT(...)                                                           \
+    do {                                                                    \
+        int r_ = snprintf(text + n, sizeof(text) - n, __VA_ARGS__);         \
+        if (r_ > 0) n += (size_t)r_ < sizeof(text) - n ? (size_t)r_ : sizeof(text) - n - 1; \
+    } while (0)
+
+    if (pl->short_read || id >= dec->fmts_size) {
+        EMIT("[log: unknown format id %llu]\n", (unsigned long long)id);
+        fwrite(text, 1, n, out);
+        return 0;
+    }
+
+    const char *fmt = dec->fmts + id;
+    while (*fmt && n < sizeof(text) - 1) {
+        if (*fmt != '%') {
+            newlines += *fmt == '\n';
+            text[n++] = *fmt++;
+            continue;
+        }
+
+        /* Spezifikation für das Host-printf nachbauen, Länge immer ll */
+        char spec[32];
+        size_t s = 0;
+        spec[s++] = *fmt++;
+        while (*fmt && strchr("-0#+ ", *fmt) && s < 8) {
+            spec[s++] = *fmt++;
+        }
+        if (*fmt == '*') {
+            s += snprintf(spec + s, sizeof(spec) - s, "%lld", (long long)get_signed(pl));
+            fmt++;
+        }
+        while (*fmt >= '0' && *fmt <= '9' && s < 16) {
+            spec[s++] = *fmt++;
+        }
+        if (*fmt == '.') {
+            spec[s++] = *fmt++;
+            if (*fmt == '*') {
+                s += snprintf(spec + s, sizeof(spec) - s, "%lld", (long long)get_signed(pl));
+                fmt++;
+            }
+            while (*fmt >= '0' && *fmt <= '9' && s < 24) {
+                spec[s++] = *fmt++;
+            }
+        }
+        while (*fmt == 'h' || *fmt == 'l' || *fmt == 'z') {
+            fmt++;
+        }
+
+        char conv = *fmt;
+        if (conv) {
+            fmt++;
+        }
+        if (pl->short_read && conv != '%') {
+            EMIT("<?>");
+            continue;
+        }
+
+        switch (conv) {
+            case 'd':
+            case 'i': {
+                long long v = (long long)get_signed(pl);
+                memcpy(spec + s, "lld", 4);
+                if (!pl->short_read) EMIT(spec, v);
+                break;
+            }
+            case 'u':
+            case 'x':
+            case 'X': {
+                unsigned long long v = get_varint(pl);
+                spec[s++] = 'l';
+                spec[s++] = 'l';
+                spec[s++] = conv;
+                spec[s] = '\0';
+                if (!pl->short_read) EMIT(spec, v);
+                break;
+            }
+            case 'p': {
+                unsigned long long v = get_varint(pl);
+                if (!pl->short_read) EMIT("0x%016llx", v);
+                break;
+            }
+            case 'c': {
+                if (pl->pos >= pl->len) {
+                    pl->short_read = 1;
+                    break;
+                }
+                memcpy(spec + s, "c", 2);
+                EMIT(spec, pl->p[pl->pos++]);
+                break;
+            }
+            case 's': {
+                char str[256];
+                uint64_t len = get_varint(pl);
+                if (pl->short_read || len > pl->len - pl->pos) {
+                    pl->short_read = 1;
+                    break;
+                }
+                memcpy(str, pl->p + pl->pos, len);
+                str[len] = '\0';
+                pl->pos += (uint32_t)len;
+                memcpy(spec + s, "s", 2);
+                EMIT(spec, str);
+                break;
+            }
+            case '%':
+                EMIT("%%");
+                break;
+            default:
+                EMIT("%%%c", conv);
+                break;
+        }
+        if (pl->short_read) {
+            EMIT("<?>");
+        }
+    }
+#undef EMIT
+
+    if (n) {
+        fwrite(text, 1, n, out);
+    }
+    return n + newlines;
+}
+
+/*
+ * Verarbeitet buf[0..len), gibt die Anzahl verbrauchter Bytes zurück.
+ * Ein unvollständiger Frame am Ende bleibt liegen (außer bei eof).
+ */
+static size_t process(decoder_t *dec, const uint8_t *buf, size_t len, int eof, FILE *out) {
+    size_t i = 0;
+
+    while (i < len) {
+        if (buf[i] != LOG_FRAME_SYNC) {
+            /* Text: \r aus "\r\n" weglassen */
+            if (buf[i] != '\r') {
+                fputc(buf[i], out);
+            }
+            dec->passthrough++;
+            i++;
+            continue;
+        }
+
+        if (len - i < 2 || len - i < (size_t)buf[i + 1] + 4) {
+            if (!eof) {
+                break;      /* Rest kommt mit dem nächsten read() */
+            }
+            dec->bad++;
+            dec->passthrough++;
+            i++;
+            continue;
+        }
+
+        uint32_t plen = buf[i + 1];
+        uint16_t sum = buf[i + 2 + plen] | (buf[i + 3 + plen] << 8);
+        if (fletcher16(&buf[i + 1], plen + 1) != sum) {
+            /* Kein Frame - das Sync-Byte war Text */
+            dec->bad++;
+            dec->passthrough++;
+            i++;
+            continue;
+        }
+
+        payload_t pl = { &buf[i + 2], plen, 0, 0 };
+        dec->text_bytes += format_frame(dec, &pl, out);
+        dec->frames++;
+        dec->frame_bytes += plen + 4;
+        i += plen + 4;
+    }
+    return i;
+}
+
+int main(int argc, char *argv[]) {
+    const char *elf = DEFAULT_ELF;
+    const char *input = NULL;
+    int stats = 0;
+    int opt;
+    decoder_t dec;
+
+    while ((opt = getopt(argc, argv, "e:i:sh")) != -1) {
+        switch (opt) {
+            case 'e':
+                elf = optarg;
+                break;
+            case 'i':
+                input = optarg;
+                break;
+            case 's':
+                stats = 1;
+                break;
+            default:
+                printf("Usage: %s [-e firmware.elf] [-i input] [-s]\n", argv[0]);
+                printf("  -e file    Firmware ELF with the logfmt section (default %s)\n", DEFAULT_ELF);
+                printf("  -i input   Serial device or capture file (default: stdin)\n");
+                printf("  -s         Print byte statistics to stderr at the end\n");
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    memset(&dec, 0, sizeof(dec));
+    if (load_formats(&dec, elf) < 0) {
+        return 1;
+    }
+
+    int fd = STDIN_FILENO;
+    if (input && (fd = open(input, O_RDONLY | O_NOCTTY)) < 0) {
+        perror(input);
+        return 1;
+    }
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    uint8_t buf[65536];
+    size_t fill = 0;
+    for (;;) {
+        ssize_t r = read(fd, buf + fill, sizeof(buf) - fill);
+        if (r <= 0) {
+            break;
+        }
+        dec.wire_bytes += (uint64_t)r;
+        fill += (size_t)r;
+
+        size_t used = process(&dec, buf, fill, 0, stdout);
+        memmove(buf, buf + used, fill - used);
+        fill -= used;
+    }
+    process(&dec, buf, fill, 1, stdout);
+    fflush(stdout);
+
+    if (stats) {
+        fprintf(stderr, "\n%llu bytes read: %llu frames (%llu bytes) + %llu bytes text, "
+                "%llu bad syncs\n",
+                (unsigned long long)dec.wire_bytes, (unsigned long long)dec.frames,
+                (unsigned long long)dec.frame_bytes, (unsigned long long)dec.passthrough,
+                (unsigned long long)dec.bad);
+        if (dec.frame_bytes) {
+            fprintf(stderr, "Frames replace %llu bytes of text output: %.1fx fewer bytes\n",
+                    (unsigned long long)dec.text_bytes,
+                    (double)dec.text_bytes / dec.frame_bytes);
+        }
+    }
+
+    if (input) {
+        close(fd);
+    }
+    return 0;
+}
@@ -0,0 +1,422 @@
+/**
+ * @file offload_bench.c
+ * @brief Offload-Benchmark: Prüfsummen/Fill/Compare auf Core 3 gegen Linux
+ *
+ * Die Daten liegen im Job-Puffer (SHARED_JOB_ADDR). Pro Kernel und Größe
+ * wird dieselbe Arbeit zweimal gemacht:
+ *
+ *   local   : auf diesem Core - Daten aus dem Shared Memory holen
+ *             (amp_copy_from_shared, 32-bit Wörter) und rechnen
+ *   offload : Jobs über die Kommando-Queue an Core 3, bis zu -q Jobs
+ *             gleichzeitig unterwegs
+ *
+ * Gemessen werden Durchsatz (MB/s, Wanduhr) und die CPU-Zeit dieses
+ * Threads pro Job (CLOCK_THREAD_CPUTIME_ID). "saved" ist der Anteil
+ * CPU-Zeit, den Linux beim Offload spart. Mit -w poll wartet Linux aktiv
+ * auf die Completions (kürzeste Latenz, spart kaum CPU), mit -w sleep
+ * schläft es zwischen den Abfragen.
+ *
+ * Das erste Offload-Ergebnis jeder Messung wird mit dem lokalen
+ * verglichen, bei Abweichung bricht der Benchmark ab.
+ *
+ * Kompilieren (auf dem RPi3):
+ *   make offload_bench
+ *
+ * Ausführen:
+ *   sudo ./offload_bench                     # alle Kernels, 4 KB .. 128 KB
+ *   sudo ./offload_bench -k crc32c -s 65536 -n 2000
+ *   sudo ./offload_bench -w poll -q 1        # Latenz statt Durchsatz
+ *
+ * @author RPi3 AMP Project
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__aarch64__)
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+#include "amp_ipc.h"
+
+#define DEFAULT_COUNT       200
+#define DEFAULT_INFLIGHT    8
+#define TIMEOUT_SEC         10.0
+#define SLEEP_NS            20000
+
+#define JOB_OFFSET          (SHARED_JOB_ADDR - SHARED_MEM_BASE)
+#define FILL_PATTERN        0x5AA5C33C
+
+typedef enum { K_CRC32, K_CRC32C, K_ADLER32, K_FILL, K_COMPARE, K_COUNT } kernel_t;
+
+static const char *const g_names[K_COUNT] = { "crc32", "crc32c", "adler32", "fill", "compare" };
+static const uint32_t g_ops[K_COUNT] = {
+    CMD_OP_CRC32, CMD_OP_CRC32C, CMD_OP_ADLER32, CMD_OP_FILL, CMD_OP_COMPARE
+};
+static const uint32_t g_sizes[] = { 4096, 16384, 65536, 131072 };
+
+static int g_sleep = 1;
+static int g_have_crc = 0;
+
+/*============================================================================
+ * Zeit
+ *============================================================================*/
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double cpu_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double mb_per_sec(uint64_t bytes, double sec) {
+    return sec > 0.0 ? bytes / sec / (1024.0 * 1024.0) : 0.0;
+}
+
+/*============================================================================
+ * Lokale Kernels (gleiche Ergebnisse wie rpi3_amp_core3/csum.c)
+ *============================================================================*/
+
+static uint32_t g_table32[256];
+static uint32_t g_table32c[256];
+
+static void crc_tables(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t a = i, c = i;
+        for (int k = 0; k < 8; k++) {
+            a = (a >> 1) ^ (0xEDB88320 & (0U - (a & 1)));
+            c = (c >> 1) ^ (0x82F63B78 & (0U - (c & 1)));
+        }
+        g_table32[i] = a;
+        g_table32c[i] = c;
+    }
+}
+
+static uint32_t crc_table(uint32_t crc, const uint8_t *p, uint32_t len, const uint32_t *t) {
+    crc = ~crc;
+    while (len--) {
+        crc = t[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+#if defined(__aarch64__)
+/* Dieselben Befehle wie auf Core 3, falls der Linux-Kernel sie meldet */
+__attribute__((target("+crc")))
+static uint32_t crc_hw(uint32_t crc, const uint8_t *p, uint32_t len, int castagnoli) {
+    crc = ~crc;
+    while (len && ((uintptr_t)p & 7)) {
+        crc = castagnoli ? __crc32cb(crc, *p) : __crc32b(crc, *p);
+        p++;
+        len--;
+    }
+    for (; len >= 8; len -= 8, p += 8) {
+        uint64_t v;
+        memcpy(&v, p, 8);
+        crc = castagnoli ? __crc32cd(crc, v) : __crc32d(crc, v);
+    }
+    while (len--) {
+        crc = castagnoli ? __crc32cb(crc, *p) : __crc32b(crc, *p);
+        p++;
+    }
+    return ~crc;
+}
+#endif
+
+static uint32_t local_crc(uint32_t crc, const uint8_t *p, uint32_t len, int castagnoli) {
+#if defined(__aarch64__)
+    if (g_have_crc) {
+        return crc_hw(crc, p, len, castagnoli);
+    }
+#endif
+    return crc_table(crc, p, len, castagnoli ? g_table32c : g_table32);
+}
+
+static uint32_t local_adler32(uint32_t adler, const uint8_t *p, uint32_t len) {
+    uint32_t a = adler & 0xFFFF, b = adler >> 16;
+
+    while (len) {
+        uint32_t n = len < 5552 ? len : 5552;
+        len -= n;
+        while (n--) {
+            a += *p++;
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return (b << 16) | a;
+}
+
+/* Ein Durchlauf lokal, inklusive Lesen aus dem Shared Memory */
+static uint32_t run_local(amp_ipc_t *ipc, kernel_t k, uint32_t len, uint8_t *a, uint8_t *b) {
+    volatile uint8_t *shm = (volatile uint8_t *)amp_ipc_phys(ipc, SHARED_JOB_ADDR);
+
+    switch (k) {
+        case K_CRC32:
+        case K_CRC32C:
+            amp_copy_from_shared(a, shm, len);
+            return local_crc(0, a, len, k == K_CRC32C);
+        case K_ADLER32:
+            amp_copy_from_shared(a, shm, len);
+            return local_adler32(1, a, len);
+        case K_FILL: {
+            volatile uint32_t *w = (volatile uint32_t *)(shm + len);
+            for (uint32_t i = 0; i < len / 4; i++) {
+                w[i] = FILL_PATTERN;
+            }
+            return len;
+        }
+        default: {
+            uint32_t i = 0;
+            amp_copy_from_shared(a, shm, len);
+            amp_copy_from_shared(b, shm + len, len);
+            while (i < len && a[i] == b[i]) {
+                i++;
+            }
+            return i;
+        }
+    }
+}
+
+/*============================================================================
+ * Offload
+ *============================================================================*/
+
+static void make_req(cmd_req_t *req, kernel_t k, uint32_t len, uint32_t id) {
+    memset(req, 0, sizeof(*req));
+    req->id = id;
+    req->op = g_ops[k];
+    switch (k) {
+        case K_FILL:
+            req->arg[0] = JOB_OFFSET + len;
+            req->arg[1] = len;
+            req->arg[2] = FILL_PATTERN;
+            break;
+        case K_COMPARE:
+            req->arg[0] = JOB_OFFSET;
+            req->arg[1] = JOB_OFFSET + len;
+            req->arg[2] = len;
+            break;
+        default:
+            req->arg[0] = JOB_OFFSET;
+            req->arg[1] = len;
+            req->arg[2] = k == K_ADLER32 ? 1 : 0;
+            break;
+    }
+}
+
+/* count Jobs mit bis zu inflight gleichzeitig, Ergebnis des ersten in *first */
+static int run_offload(amp_cmd_t *cmd, kernel_t k, uint32_t len, uint32_t count,
+                       uint32_t inflight, uint32_t base, uint32_t *first, uint64_t *core3_us) {
+    uint32_t submitted = 0, completed = 0;
+    double start = now_sec();
+    cmd_req_t req;
+    cmd_done_t done;
+
+    while (completed < count) {
+        int queued = 0;
+        while (submitted < count && submitted - completed < inflight) {
+            make_req(&req, k, len, base + submitted);
+            if (amp_cmd_submit(cmd, &req) < 0) {
+                break;
+            }
+            submitted++;
+            queued = 1;
+        }
+        if (queued) {
+            amp_ipc_kick(cmd->ipc);
+        }
+
+        int got = 0;
+        while (amp_cmd_receive(cmd, &done) == 0) {
+            if (done.id - base >= submitted) {
+                continue;   /* Alter Lauf */
+            }
+            if (done.result != CMD_OK) {
+                fprintf(stderr, "%s: job %u failed (result %d)\n",
+                        g_names[k], done.id - base, done.result);
+                return -1;
+            }
+            if (done.id == base) {
+                *first = done.value[0];
+            }
+            *core3_us += done.elapsed_us;
+            completed++;
+            got = 1;
+        }
+
+        if (!got) {
+            if (now_sec() - start > TIMEOUT_SEC) {
+                fprintf(stderr, "%s: timeout, %u of %u jobs completed\n",
+                        g_names[k], completed, count);
+                return -1;
+            }
+            if (g_sleep) {
+                struct timespec ts = { 0, SLEEP_NS };
+                nanosleep(&ts, NULL);
+            }
+        }
+    }
+    return 0;
+}
+
+/*============================================================================
+ * Main
+ *============================================================================*/
+
+static void usage(const char *prog) {
+    printf("Usage: %s [-k kernel] [-s size] [-n count] [-q inflight] [-w poll|sleep]\n", prog);
+    printf("  -k kernel  crc32 | crc32c | adler32 | fill | compare (default all)\n");
+    printf("  -s size    Bytes per job, max %u (default 4 KB .. 128 KB)\n", SHARED_JOB_SIZE);
+    printf("  -n count   Jobs per measurement (default %u)\n", DEFAULT_COUNT);
+    printf("  -q n       Jobs in flight (default %u)\n", DEFAULT_INFLIGHT);
+    printf("  -w mode    Wait for completions: poll or sleep (default sleep)\n");
+}
+
+int main(int argc, char *argv[]) {
+    int only = -1;
+    uint32_t size = 0;
+    uint32_t count = DEFAULT_COUNT;
+    uint32_t inflight = DEFAULT_INFLIGHT;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "k:s:n:q:w:h")) != -1) {
+        switch (opt) {
+            case 'k':
+                for (only = 0; only < K_COUNT && strcmp(optarg, g_names[only]); only++) {
+                }
+                if (only == K_COUNT) {
+                    fprintf(stderr, "Unknown kernel '%s'\n", optarg);
+                    return 1;
+                }
+                break;
+            case 's': size = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'n': count = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'q': inflight = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'w': g_sleep = strcmp(optarg, "poll") != 0; break;
+            case 'h': usage(argv[0]); return 0;
+            default:  usage(argv[0]); return 1;
+        }
+    }
+    if (size > SHARED_JOB_SIZE || (size & 3) || count == 0 || inflight == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    crc_tables();
+#if defined(__aarch64__)
+    g_have_crc = (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#endif
+
+    amp_ipc_t ipc;
+    amp_cmd_t cmd;
+    if (amp_ipc_open(&ipc) < 0) {
+        return 1;
+    }
+    if (amp_cmd_open(&ipc, &cmd) < 0) {
+        amp_ipc_close(&ipc);
+        return 1;
+    }
+
+    /* src: Testdaten, a/b: Arbeitspuffer für die lokale Variante */
+    uint8_t *src = malloc(SHARED_JOB_SIZE);
+    uint8_t *a = malloc(SHARED_JOB_SIZE);
+    uint8_t *b = malloc(SHARED_JOB_SIZE);
+    if (!src || !a || !b) {
+        perror("malloc");
+        return 1;
+    }
+
+    uint32_t seed = 0x12345678;
+    for (uint32_t i = 0; i < SHARED_JOB_SIZE; i++) {
+        seed = seed * 1103515245 + 12345;
+        src[i] = (uint8_t)(seed >> 16);
+    }
+
+    printf("Offload benchmark: %u jobs per run, %u in flight, wait %s, local CRC %s\n\n",
+           count, inflight, g_sleep ? "sleep" : "poll", g_have_crc ? "crc32 insns" : "table");
+    printf("%-8s %7s | %9s %10s | %9s %10s %8s | %6s\n",
+           "kernel", "size", "local", "cpu/job", "offload", "cpu/job", "core3", "saved");
+    printf("%-8s %7s | %9s %10s | %9s %10s %8s | %6s\n",
+           "", "", "MB/s", "us", "MB/s", "us", "us/job", "");
+
+    uint32_t base = ((uint32_t)getpid() << 20) ^ (uint32_t)time(NULL);
+    int rc = 0;
+
+    for (int k = 0; k < K_COUNT && !rc; k++) {
+        if (only >= 0 && k != only) {
+            continue;
+        }
+        for (size_t s = 0; s < sizeof(g_sizes) / sizeof(g_sizes[0]) && !rc; s++) {
+            uint32_t len = size ? size : g_sizes[s];
+            uint32_t span = (k == K_FILL || k == K_COMPARE) ? 2 * len : len;
+            if (span > SHARED_JOB_SIZE) {
+                if (size) {
+                    fprintf(stderr, "%s: %u bytes do not fit twice into the job buffer\n",
+                            g_names[k], len);
+                }
+                break;
+            }
+
+            /* Daten frisch schreiben; compare bekommt zwei gleiche Hälften,
+               fill schreibt in die zweite */
+            volatile uint8_t *job = (volatile uint8_t *)amp_ipc_phys(&ipc, SHARED_JOB_ADDR);
+            amp_copy_to_shared(job, src, len);
+            if (k == K_COMPARE) {
+                amp_copy_to_shared(job + len, src, len);
+            }
+
+            uint32_t expect = 0, got = 0;
+            uint64_t core3_us = 0;
+            double t0 = now_sec(), c0 = cpu_sec();
+            for (uint32_t i = 0; i < count; i++) {
+                expect = run_local(&ipc, (kernel_t)k, len, a, b);
+            }
+            double local_wall = now_sec() - t0, local_cpu = cpu_sec() - c0;
+
+            t0 = now_sec();
+            c0 = cpu_sec();
+            if (run_offload(&cmd, (kernel_t)k, len, count, inflight, base, &got, &core3_us) < 0) {
+                rc = 1;
+                break;
+            }
+            double off_wall = now_sec() - t0, off_cpu = cpu_sec() - c0;
+            base += count;
+
+            if (got != expect) {
+                fprintf(stderr, "%s %u: Core 3 result 0x%08X, local 0x%08X\n",
+                        g_names[k], len, got, expect);
+                rc = 1;
+                break;
+            }
+
+            printf("%-8s %7u | %9.1f %10.1f | %9.1f %10.1f %8.1f | %5.0f%%\n",
+                   g_names[k], len,
+                   mb_per_sec((uint64_t)len * count, local_wall), local_cpu * 1e6 / count,
+                   mb_per_sec((uint64_t)len * count, off_wall), off_cpu * 1e6 / count,
+                   (double)core3_us / count,
+                   local_cpu > 0.0 ? 100.0 * (1.0 - off_cpu / local_cpu) : 0.0);
+
+            if (size) {
+                break;
+            }
+        }
+    }
+
+    free(src);
+    free(a);
+    free(b);
+    amp_ipc_close(&ipc);
+    return rc;
+}
@@ -0,0 +1,350 @@
+/**
+ * @file pingpong.c
+ * @brief Round-Trip Latenz Linux -> Core 3 -> Linux mit HDR-Histogramm
+ *
+ * Linux schreibt eine Sequenznummer nach ipc_ping_t.ping (SHARED_DATA_ADDR),
+ * Core 3 spiegelt sie nach pong. Gemessen wird vom Schreiben bis zum
+ * Lesen der Antwort mit CLOCK_MONOTONIC - ohne Ringe und ohne Kopien.
+ *
+ * Modi der Firmware (beide werden per Default nacheinander gemessen):
+ *   irq  : Core 3 schläft im WFI, Linux klingelt per Doorbell
+ *          (amp_ipc_kick, nur wenn core3_idle gesetzt ist)
+ *   poll : ipc_ping_t.spin = 1, Core 3 wartet aktiv statt im WFI
+ *
+ * Die Latenzen landen in einem HDR-Histogramm (log-lineare Buckets, 128
+ * Sub-Buckets pro Zweierpotenz -> < 1 % Fehler über den ganzen Bereich).
+ * -d schreibt die Percentile-Verteilung im Format von HdrHistogram
+ * (Value / Percentile / TotalCount / 1/(1-Percentile), Werte in µs).
+ *
+ * Kompilieren (auf dem RPi3):
+ *   make pingpong
+ *
+ * Ausführen:
+ *   sudo ./pingpong -c 2                     # 1000000 Runden je Modus, CPU 2
+ *   sudo ./pingpong -m poll -n 10000000 -d poll.hgrm
+ *
+ * @author RPi3 AMP Project
+ */
+
+#define _GNU_SOURCE
+#include <math.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "amp_ipc.h"
+
+#define DEFAULT_COUNT       1000000
+#define WARMUP_COUNT        1000
+#define TIMEOUT_NS          100000000ULL    /* 100 ms pro Runde */
+
+#define HIST_SUB_BITS       7
+#define HIST_SUB_COUNT      (1u << HIST_SUB_BITS)
+#define HIST_BUCKETS        34              /* bis 2^40 ns */
+
+#define MODE_IRQ            (1 << 0)
+#define MODE_POLL           (1 << 1)
+
+typedef struct {
+    uint64_t counts[HIST_BUCKETS][HIST_SUB_COUNT];
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+    double   sum;
+    double   sum_sq;
+} hist_t;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/*============================================================================
+ * HDR-Histogramm
+ *============================================================================*/
+
+/*
+ * Bucket 0 deckt [0, 128) mit Auflösung 1 ab, Bucket b >= 1 deckt
+ * [64 << b, 128 << b) mit Auflösung 1 << b (Sub-Buckets 64..127).
+ */
+static void hist_record(hist_t *h, uint64_t v) {
+    uint32_t b = 0;
+
+    if (v >= HIST_SUB_COUNT) {
+        b = 63 - __builtin_clzll(v) - (HIST_SUB_BITS - 1);
+    }
+    if (b >= HIST_BUCKETS) {
+        b = HIST_BUCKETS - 1;
+        v = ((uint64_t)HIST_SUB_COUNT << b) - 1;
+    }
+    h->counts[b][v >> b]++;
+
+    if (h->total == 0 || v < h->min) h->min = v;
+    if (v > h->max) h->max = v;
+    h->total++;
+    h->sum += v;
+    h->sum_sq += (double)v * v;
+}
+
+/* Höchster Wert, der in denselben Sub-Bucket fällt */
+static uint64_t hist_upper(uint32_t b, uint32_t sub, const hist_t *h) {
+    uint64_t v = (((uint64_t)sub + 1) << b) - 1;
+    return v < h->max ? v : h->max;
+}
+
+static uint64_t hist_percentile(const hist_t *h, double p) {
+    uint64_t target = (uint64_t)ceil(p / 100.0 * h->total);
+    uint64_t cum = 0;
+
+    if (target == 0) target = 1;
+    for (uint32_t b = 0; b < HIST_BUCKETS; b++) {
+        for (uint32_t sub = b ? HIST_SUB_COUNT / 2 : 0; sub < HIST_SUB_COUNT; sub++) {
+            cum += h->counts[b][sub];
+            if (cum >= target) {
+                return hist_upper(b, sub, h);
+            }
+        }
+    }
+    return h->max;
+}
+
+static void hist_print(const hist_t *h) {
+    static const double pct[] = { 50.0, 90.0, 99.0, 99.9, 99.99 };
+    static const char *name[] = { "p50", "p90", "p99", "p99.9", "p99.99" };
+
+    if (h->total == 0) {
+        printf("  no samples\n");
+        return;
+    }
+
+    printf("  min %.3f us, mean %.3f us, max %.3f us\n",
+           h->min / 1000.0, h->sum / h->total / 1000.0, h->max / 1000.0);
+    for (uint32_t i = 0; i < sizeof(pct) / sizeof(pct[0]); i++) {
+        printf("  %-7s %10.3f us\n", name[i], hist_percentile(h, pct[i]) / 1000.0);
+    }
+    printf("  %-7s %10.3f us\n", "max", h->max / 1000.0);
+
+    /* Grobe Verteilung pro Zweierpotenz */
+    printf("\n  range (ns)                 count\n");
+    for (uint32_t bit = 0; bit < HIST_BUCKETS + HIST_SUB_BITS - 1; bit++) {
+        uint64_t lo = bit ? 1ULL << bit : 0, hi = 2ULL << bit;
+        uint64_t n = 0;
+
+        for (uint32_t b = 0; b < HIST_BUCKETS; b++) {
+            for (uint32_t sub = 0; sub < HIST_SUB_COUNT; sub++) {
+                uint64_t v = (uint64_t)sub << b;
+                if (h->counts[b][sub] && v >= lo && v < hi) {
+                    n += h->counts[b][sub];
+                }
+            }
+        }
+        if (n) {
+            int bar = (int)(n * 40 / h->total);
+            printf("  [%9llu, %9llu) %10llu %.*s\n", (unsigned long long)lo,
+                   (unsigned long long)hi, (unsigned long long)n,
+                   bar, "########################################");
+        }
+    }
+}
+
+/* Percentile-Verteilung im HdrHistogram Textformat (Werte in µs) */
+static void hist_write(const hist_t *h, FILE *f) {
+    uint64_t cum = 0;
+    double mean = h->total ? h->sum / h->total : 0.0;
+    double var = h->total ? h->sum_sq / h->total - mean * mean : 0.0;
+
+    fprintf(f, "%12s %14s %10s %14s\n\n", "Value", "Percentile", "TotalCount",
+            "1/(1-Percentile)");
+    for (uint32_t b = 0; b < HIST_BUCKETS; b++) {
+        for (uint32_t sub = b ? HIST_SUB_COUNT / 2 : 0; sub < HIST_SUB_COUNT; sub++) {
+            if (!h->counts[b][sub]) {
+                continue;
+            }
+            cum += h->counts[b][sub];
+            double p = (double)cum / h->total;
+            if (p < 1.0) {
+                fprintf(f, "%12.3f %14.12f %10llu %14.2f\n", hist_upper(b, sub, h) / 1000.0,
+                        p, (unsigned long long)cum, 1.0 / (1.0 - p));
+            } else {
+                fprintf(f, "%12.3f %14.12f %10llu\n", hist_upper(b, sub, h) / 1000.0,
+                        p, (unsigned long long)cum);
+            }
+        }
+    }
+    fprintf(f, "#[Mean    = %12.3f, StdDeviation   = %12.3f]\n",
+            mean / 1000.0, (var > 0.0 ? sqrt(var) : 0.0) / 1000.0);
+    fprintf(f, "#[Max     = %12.3f, Total count    = %12llu]\n",
+            h->max / 1000.0, (unsigned long long)h->total);
+    fprintf(f, "#[Buckets = %12u, SubBuckets     = %12u]\n", HIST_BUCKETS, HIST_SUB_COUNT);
+}
+
+/*============================================================================
+ * Messung
+ *============================================================================*/
+
+typedef struct {
+    uint32_t kicks;         /* Runden mit Doorbell */
+    uint32_t timeouts;
+} run_stats_t;
+
+static int round_trip(amp_ipc_t *ipc, volatile ipc_ping_t *ping, uint32_t seq,
+                      uint64_t *ns, run_stats_t *st) {
+    uint64_t start = now_ns();
+    uint32_t spins = 0;
+
+    __atomic_store_n(&ping->ping, seq, __ATOMIC_RELEASE);
+    st->kicks += amp_ipc_kick(ipc);
+
+    while (__atomic_load_n(&ping->pong, __ATOMIC_ACQUIRE) != seq) {
+        if ((++spins & 0xFFF) == 0 && now_ns() - start > TIMEOUT_NS) {
+            st->timeouts++;
+            return -1;
+        }
+    }
+    *ns = now_ns() - start;
+    return 0;
+}
+
+static int run_mode(amp_ipc_t *ipc, volatile ipc_ping_t *ping, int spin,
+                    uint32_t count, const char *dump_path) {
+    hist_t *h = calloc(1, sizeof(*h));
+    run_stats_t st = { 0, 0 };
+    uint32_t seq = ping->pong;
+    uint64_t ns;
+
+    if (!h) {
+        perror("calloc");
+        return -1;
+    }
+
+    printf("Mode %s: %u round trips\n",
+           spin ? "poll (Core 3 spins)" : "irq (WFI + doorbell)", count);
+
+    /* Modus setzen; die Warmup-Runden holen Core 3 aus dem WFI */
+    ping->spin = spin;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    for (uint32_t i = 0; i < WARMUP_COUNT; i++) {
+        round_trip(ipc, ping, ++seq, &ns, &st);
+    }
+    memset(&st, 0, sizeof(st));
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (round_trip(ipc, ping, ++seq, &ns, &st) == 0) {
+            hist_record(h, ns);
+        }
+    }
+
+    hist_print(h);
+    printf("\n  doorbells %u (%.1f %%), timeouts %u\n\n",
+           st.kicks, count ? 100.0 * st.kicks / count : 0.0, st.timeouts);
+
+    if (dump_path) {
+        FILE *f = fopen(dump_path, "w");
+        if (f) {
+            hist_write(h, f);
+            fclose(f);
+            printf("  Distribution written to %s\n\n", dump_path);
+        } else {
+            perror(dump_path);
+        }
+    }
+
+    free(h);
+    return st.timeouts ? -1 : 0;
+}
+
+/*============================================================================
+ * Hauptprogramm
+ *============================================================================*/
+
+int main(int argc, char *argv[]) {
+    uint32_t count = DEFAULT_COUNT;
+    uint32_t modes = MODE_IRQ | MODE_POLL;
+    const char *dump = NULL;
+    int cpu = -1;
+    amp_ipc_t ipc;
+    int opt, rc = 0;
+
+    while ((opt = getopt(argc, argv, "n:c:m:d:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                count = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'c':
+                cpu = atoi(optarg);
+                break;
+            case 'm':
+                if (strcmp(optarg, "irq") == 0) {
+                    modes = MODE_IRQ;
+                } else if (strcmp(optarg, "poll") == 0) {
+                    modes = MODE_POLL;
+                } else if (strcmp(optarg, "both") == 0) {
+                    modes = MODE_IRQ | MODE_POLL;
+                } else {
+                    fprintf(stderr, "Unknown mode '%s'\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'd':
+                dump = optarg;
+                break;
+            default:
+                printf("Usage: %s [-n count] [-c cpu] [-m irq|poll|both] [-d file]\n", argv[0]);
+                printf("  -n count   Round trips per mode (default %u)\n", DEFAULT_COUNT);
+                printf("  -c cpu     Pin this thread to a Linux CPU (0-2)\n");
+                printf("  -m mode    Firmware wait mode to measure (default both)\n");
+                printf("  -d file    Write HdrHistogram percentile distribution\n");
+                printf("             (with both modes: file.irq / file.poll)\n");
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) < 0) {
+            perror("sched_setaffinity");
+            return 1;
+        }
+    }
+
+    if (amp_ipc_open(&ipc) < 0) {
+        return 1;
+    }
+
+    volatile ipc_shared_t *shm = (volatile ipc_shared_t *)amp_ipc_phys(&ipc, SHARED_DATA_ADDR);
+    volatile ipc_ping_t *ping = &shm->ping;
+
+    printf("RPi3 AMP - Ping-Pong Latency\n");
+    if (cpu >= 0) {
+        printf("Pinned to CPU %d, ", cpu);
+    }
+    printf("doorbell %s\n\n", ipc.local ? "mapped" : "not available");
+
+    for (int m = MODE_IRQ; m <= MODE_POLL; m <<= 1) {
+        char path[256];
+        const char *p = dump;
+
+        if (!(modes & m)) {
+            continue;
+        }
+        if (dump && modes == (MODE_IRQ | MODE_POLL)) {
+            snprintf(path, sizeof(path), "%s.%s", dump, m == MODE_POLL ? "poll" : "irq");
+            p = path;
+        }
+        if (run_mode(&ipc, ping, m == MODE_POLL, count, p) < 0) {
+            rc = 1;
+        }
+    }
+
+    /* Firmware wieder schlafen lassen */
+    ping->spin = 0;
+
+    amp_ipc_close(&ipc);
+    return rc;
+}
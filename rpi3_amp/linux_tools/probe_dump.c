@@ -0,0 +1,183 @@
+/**
+ * @file probe_dump.c
+ * @brief Gibt die Core 3 Zyklen-Messpunkte (probe.h) nach Gesamtzyklen aus
+ *
+ * Jede PROBE_BEGIN/PROBE_END Stelle hat einen Eintrag in SHARED_PROBE_ADDR
+ * mit Anzahl, Summe, min und max in PMU-Zyklen. Das Tool kopiert jeden
+ * Eintrag unter seinem Seqlock und sortiert nach Summe absteigend.
+ *
+ * Die Umrechnung in µs nimmt den ARM-Takt aus dem letzten Telemetrie-Sample
+ * (telem.h) oder -m MHz. Der Overhead eines leeren BEGIN/END Paars steht
+ * im Kopf und ist in allen Werten enthalten.
+ *
+ * Nur mit Firmware aus "make PROBE=1", sonst ist die Tabelle leer.
+ *
+ * Kompilieren (auf dem RPi3):
+ *   make probe_dump
+ *
+ * Ausführen:
+ *   sudo ./probe_dump
+ *   sudo ./probe_dump -m 1200
+ *
+ * @author RPi3 AMP Project
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "amp_ipc.h"
+
+#define SNAPSHOT_RETRIES    100
+
+typedef struct {
+    char     name[PROBE_NAME_LEN];
+    uint32_t count;
+    uint64_t total;
+    uint32_t min;
+    uint32_t max;
+} site_t;
+
+/* Konsistente Kopie eines Eintrags, -1 wenn Core 3 dauernd schreibt */
+static int entry_snapshot(volatile probe_entry_t *e, site_t *out) {
+    probe_entry_t copy;
+
+    for (int i = 0; i < SNAPSHOT_RETRIES; i++) {
+        uint32_t seq = __atomic_load_n(&e->seq, __ATOMIC_ACQUIRE);
+        if (seq & 1) {
+            continue;
+        }
+        amp_copy_from_shared(&copy, e, sizeof(copy));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (e->seq != seq) {
+            continue;
+        }
+        memcpy(out->name, copy.name, PROBE_NAME_LEN);
+        out->name[PROBE_NAME_LEN - 1] = '\0';
+        out->count = copy.count;
+        out->total = copy.total;
+        out->min = copy.min;
+        out->max = copy.max;
+        return 0;
+    }
+    return -1;
+}
+
+static int by_total(const void *a, const void *b) {
+    const site_t *x = a;
+    const site_t *y = b;
+    if (x->total != y->total) {
+        return x->total < y->total ? 1 : -1;
+    }
+    return strcmp(x->name, y->name);
+}
+
+/* ARM-Takt aus dem letzten gültigen Telemetrie-Sample, 0 = unbekannt */
+static uint32_t telem_arm_hz(amp_ipc_t *ipc) {
+    volatile telem_shared_t *t = amp_ipc_phys(ipc, SHARED_TELEM_ADDR);
+    telem_sample_t s;
+    uint32_t head;
+
+    if (t->magic != TELEM_MAGIC || t->sample_count != TELEM_SAMPLES) {
+        return 0;
+    }
+    head = __atomic_load_n(&t->head, __ATOMIC_ACQUIRE);
+    if (head == 0) {
+        return 0;
+    }
+    amp_copy_from_shared(&s, &t->samples[(head - 1) & (TELEM_SAMPLES - 1)], sizeof(s));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (s.seq != head - 1 || !(s.valid & TELEM_VALID_ARM)) {
+        return 0;
+    }
+    return s.arm_hz;
+}
+
+int main(int argc, char *argv[]) {
+    site_t sites[PROBE_MAX_SITES];
+    uint32_t used, n = 0, busy = 0;
+    uint64_t sum = 0;
+    double mhz = 0.0;
+    amp_ipc_t ipc;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "m:h")) != -1) {
+        switch (opt) {
+            case 'm':
+                mhz = strtod(optarg, NULL);
+                break;
+            default:
+                printf("Usage: %s [-m MHz]\n", argv[0]);
+                printf("  -m MHz     Core clock for the µs columns (default: telemetry)\n");
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if (amp_ipc_open(&ipc) < 0) {
+        return 1;
+    }
+
+    volatile probe_shared_t *p = amp_ipc_phys(&ipc, SHARED_PROBE_ADDR);
+    if (p->magic != PROBE_MAGIC || p->entry_size != sizeof(probe_entry_t) ||
+        p->max_entries != PROBE_MAX_SITES) {
+        fprintf(stderr, "Probe table not initialized or layout mismatch "
+                "(magic 0x%08X) - firmware built with PROBE=1?\n", p->magic);
+        amp_ipc_close(&ipc);
+        return 1;
+    }
+
+    if (mhz <= 0.0) {
+        mhz = telem_arm_hz(&ipc) / 1e6;
+    }
+
+    used = __atomic_load_n(&p->used, __ATOMIC_ACQUIRE);
+    if (used > PROBE_MAX_SITES) {
+        used = PROBE_MAX_SITES;
+    }
+    for (uint32_t i = 0; i < used; i++) {
+        if (entry_snapshot(&p->entries[i], &sites[n]) < 0) {
+            busy++;
+            continue;
+        }
+        if (sites[n].count > 0) {
+            sum += sites[n].total;
+            n++;
+        }
+    }
+    qsort(sites, n, sizeof(sites[0]), by_total);
+
+    printf("Probes: %u sites, %u dropped, pair overhead %u cycles", used, p->dropped,
+           p->overhead_cycles);
+    if (mhz > 0.0) {
+        printf(", clock %.0f MHz", mhz);
+    }
+    printf("\n\n");
+
+    printf("%-24s %10s %10s %12s %10s %16s %6s", "site", "count", "min", "avg", "max",
+           "total", "%");
+    if (mhz > 0.0) {
+        printf(" %12s %12s", "avg us", "total ms");
+    }
+    printf("\n");
+
+    for (uint32_t i = 0; i < n; i++) {
+        const site_t *s = &sites[i];
+        double avg = (double)s->total / s->count;
+
+        printf("%-24s %10u %10u %12.1f %10u %16llu %5.1f%%", s->name, s->count, s->min,
+               avg, s->max, (unsigned long long)s->total,
+               sum ? 100.0 * s->total / sum : 0.0);
+        if (mhz > 0.0) {
+            printf(" %12.3f %12.3f", avg / mhz, s->total / mhz / 1000.0);
+        }
+        printf("\n");
+    }
+
+    if (busy) {
+        fprintf(stderr, "%u entries skipped (being updated)\n", busy);
+    }
+
+    amp_ipc_close(&ipc);
+    return 0;
+}
@@ -0,0 +1,430 @@
+/**
+ * @file prof_dump.c
+ * @brief Liest den Core 3 PC-Sampling Ring und gibt ein flaches Profil aus
+ *
+ * Core 3 legt PROF_HZ mal pro Sekunde die unterbrochene Adresse (ELR) in
+ * SHARED_PROF_ADDR ab (prof.h). Dieses Tool sammelt die Samples für -t ms
+ * (wie trace_dump mit eigenem tail), ordnet sie den Funktions-Symbolen aus
+ * der Firmware-ELF zu (kernel8.elf, eigener ELF64 Parser, kein binutils
+ * nötig) und gibt die Funktionen nach Anzahl Samples sortiert aus.
+ *
+ * Mit -f kommen stattdessen Folded Stacks ("main;sched_run;foo 42"), die
+ * flamegraph.pl oder https://speedscope.app direkt lesen. Dafür muss die
+ * Firmware mit make PROF_HZ=n PROF_FP=1 gebaut sein.
+ *
+ * Auf stderr stehen Rate, Anzahl, Verluste und die Kosten des Handlers
+ * (Zyklen pro Sample, Anteil an der Laufzeit).
+ *
+ * Kompilieren (auf dem RPi3):
+ *   make prof_dump
+ *
+ * Ausführen:
+ *   sudo ./prof_dump                              # 2 s, Top 30
+ *   sudo ./prof_dump -t 10000 -n 0                # 10 s, alle Funktionen
+ *   sudo ./prof_dump -f > core3.folded
+ *   flamegraph.pl core3.folded > core3.svg
+ *
+ * @author RPi3 AMP Project
+ */
+
+#include <elf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "amp_ipc.h"
+
+#define POLL_INTERVAL_US    10000
+#define DEFAULT_ELF         "../rpi3_amp_core3/kernel8.elf"
+#define FOLD_LINE_LEN       512
+
+typedef struct {
+    uint64_t addr;
+    uint64_t size;
+    const char *name;
+    uint64_t hits;
+} sym_t;
+
+typedef struct {
+    sym_t   *syms;
+    size_t   count;
+    char    *strtab;            /* Kopie der Namen, syms zeigen hinein */
+} symtab_t;
+
+typedef struct {
+    volatile prof_shared_t *ring;
+    uint32_t tail;
+    uint64_t lost;
+    prof_sample_t *samples;     /* Gesammelte Samples */
+    size_t   count;
+    size_t   cap;
+} prof_reader_t;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*============================================================================
+ * ELF Symbole
+ *============================================================================*/
+
+static int by_addr(const void *a, const void *b) {
+    const sym_t *x = a;
+    const sym_t *y = b;
+    return x->addr < y->addr ? -1 : x->addr > y->addr;
+}
+
+/* Funktionen und Labels in ausführbaren Sections, ohne Mapping-Symbole ($x, $d) */
+static int load_symbols(const char *path, symtab_t *st) {
+    FILE *f = fopen(path, "rb");
+    Elf64_Ehdr eh;
+    Elf64_Shdr *sh = NULL;
+    Elf64_Sym *syms = NULL;
+    int ret = -1;
+
+    memset(st, 0, sizeof(*st));
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    if (fread(&eh, sizeof(eh), 1, f) != 1 || memcmp(eh.e_ident, ELFMAG, SELFMAG) ||
+        eh.e_ident[EI_CLASS] != ELFCLASS64 || eh.e_shentsize != sizeof(Elf64_Shdr)) {
+        fprintf(stderr, "%s: not an ELF64 file\n", path);
+        goto out;
+    }
+
+    sh = calloc(eh.e_shnum, sizeof(*sh));
+    if (!sh || fseek(f, (long)eh.e_shoff, SEEK_SET) ||
+        fread(sh, sizeof(*sh), eh.e_shnum, f) != eh.e_shnum) {
+        fprintf(stderr, "%s: cannot read section headers\n", path);
+        goto out;
+    }
+
+    for (unsigned i = 0; i < eh.e_shnum; i++) {
+        if (sh[i].sh_type != SHT_SYMTAB || sh[i].sh_link >= eh.e_shnum) {
+            continue;
+        }
+        const Elf64_Shdr *strsh = &sh[sh[i].sh_link];
+        size_t n = sh[i].sh_size / sizeof(Elf64_Sym);
+
+        syms = malloc(sh[i].sh_size);
+        st->strtab = malloc(strsh->sh_size + 1);
+        st->syms = calloc(n, sizeof(sym_t));
+        if (!syms || !st->strtab || !st->syms ||
+            fseek(f, (long)sh[i].sh_offset, SEEK_SET) || fread(syms, sizeof(Elf64_Sym), n, f) != n ||
+            fseek(f, (long)strsh->sh_offset, SEEK_SET) ||
+            fread(st->strtab, 1, strsh->sh_size, f) != strsh->sh_size) {
+            fprintf(stderr, "%s: cannot read symbol table\n", path);
+            goto out;
+        }
+        st->strtab[strsh->sh_size] = '\0';
+
+        for (size_t k = 0; k < n; k++) {
+            int type = ELF64_ST_TYPE(syms[k].st_info);
+            uint16_t shndx = syms[k].st_shndx;
+            const char *name = st->strtab + syms[k].st_name;
+
+            if ((type != STT_FUNC && type != STT_NOTYPE) || shndx == SHN_UNDEF ||
+                shndx >= eh.e_shnum || !(sh[shndx].sh_flags & SHF_EXECINSTR) ||
+                !name[0] || name[0] == '$') {
+                continue;
+            }
+            st->syms[st->count].addr = syms[k].st_value;
+            st->syms[st->count].size = syms[k].st_size;
+            st->syms[st->count].name = name;
+            st->count++;
+        }
+        break;
+    }
+
+    if (st->count == 0) {
+        fprintf(stderr, "%s: no function symbols (stripped?)\n", path);
+        goto out;
+    }
+    qsort(st->syms, st->count, sizeof(sym_t), by_addr);
+    ret = 0;
+
+out:
+    free(syms);
+    free(sh);
+    fclose(f);
+    return ret;
+}
+
+/* Symbol mit der größten Adresse <= pc, NULL außerhalb der Firmware */
+static sym_t *lookup(symtab_t *st, uint64_t pc) {
+    size_t lo = 0, hi = st->count;
+
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (st->syms[mid].addr <= pc) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == 0) {
+        return NULL;
+    }
+    sym_t *s = &st->syms[lo - 1];
+    if (s->size && pc >= s->addr + s->size && lo == st->count) {
+        return NULL;
+    }
+    return s;
+}
+
+static const char *sym_name(symtab_t *st, uint64_t pc, char *buf, size_t len) {
+    sym_t *s = lookup(st, pc);
+    if (s) {
+        return s->name;
+    }
+    snprintf(buf, len, "[0x%llx]", (unsigned long long)pc);
+    return buf;
+}
+
+/*============================================================================
+ * Ring lesen
+ *============================================================================*/
+
+static int keep(prof_reader_t *r, const prof_sample_t *s) {
+    if (r->count == r->cap) {
+        size_t cap = r->cap ? r->cap * 2 : 4096;
+        prof_sample_t *p = realloc(r->samples, cap * sizeof(*p));
+        if (!p) {
+            return -1;
+        }
+        r->samples = p;
+        r->cap = cap;
+    }
+    r->samples[r->count++] = *s;
+    return 0;
+}
+
+static int drain(prof_reader_t *r) {
+    volatile prof_shared_t *p = r->ring;
+    uint32_t head = __atomic_load_n(&p->head, __ATOMIC_ACQUIRE);
+    prof_sample_t s;
+
+    /* Mehr als einen Ring zurück: die ältesten sind schon überschrieben */
+    if (head - r->tail > PROF_SAMPLES) {
+        r->lost += head - r->tail - PROF_SAMPLES;
+        r->tail = head - PROF_SAMPLES;
+    }
+
+    while (r->tail != head) {
+        amp_copy_from_shared(&s, &p->samples[r->tail & (PROF_SAMPLES - 1)], sizeof(s));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        /* Slot während der Kopie überschrieben? */
+        uint32_t now = p->head;
+        if (s.seq != r->tail || now - r->tail >= PROF_SAMPLES) {
+            r->lost++;
+        } else if (keep(r, &s) < 0) {
+            return -1;
+        }
+        r->tail++;
+    }
+    return 0;
+}
+
+/*============================================================================
+ * Ausgabe
+ *============================================================================*/
+
+static int by_hits(const void *a, const void *b) {
+    const sym_t *x = *(sym_t * const *)a;
+    const sym_t *y = *(sym_t * const *)b;
+    if (x->hits != y->hits) {
+        return x->hits < y->hits ? 1 : -1;
+    }
+    return strcmp(x->name, y->name);
+}
+
+static void print_flat(prof_reader_t *r, symtab_t *st, uint32_t top) {
+    sym_t **order = calloc(st->count, sizeof(*order));
+    uint64_t outside = 0;
+    size_t n = 0;
+
+    if (!order) {
+        return;
+    }
+    for (size_t i = 0; i < r->count; i++) {
+        sym_t *s = lookup(st, r->samples[i].pc);
+        if (s) {
+            s->hits++;
+        } else {
+            outside++;
+        }
+    }
+    for (size_t i = 0; i < st->count; i++) {
+        if (st->syms[i].hits) {
+            order[n++] = &st->syms[i];
+        }
+    }
+    qsort(order, n, sizeof(*order), by_hits);
+
+    printf("%10s %7s %7s  %s\n", "samples", "%", "cum %", "function");
+    uint64_t cum = 0;
+    for (size_t i = 0; i < n && (top == 0 || i < top); i++) {
+        cum += order[i]->hits;
+        printf("%10llu %6.2f%% %6.2f%%  %s\n", (unsigned long long)order[i]->hits,
+               100.0 * order[i]->hits / r->count, 100.0 * cum / r->count, order[i]->name);
+    }
+    if (outside) {
+        printf("%10llu %6.2f%%          [outside firmware symbols]\n",
+               (unsigned long long)outside, 100.0 * outside / r->count);
+    }
+    free(order);
+}
+
+static int by_string(const void *a, const void *b) {
+    return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+/* Eine Zeile pro Sample, sortieren, gleiche Zeilen zusammenzählen */
+static void print_folded(prof_reader_t *r, symtab_t *st) {
+    char **lines = calloc(r->count, sizeof(*lines));
+    char buf[32];
+
+    if (!lines) {
+        return;
+    }
+    for (size_t i = 0; i < r->count; i++) {
+        const prof_sample_t *s = &r->samples[i];
+        char line[FOLD_LINE_LEN];
+        size_t len = 0;
+        uint32_t depth = s->depth > PROF_STACK_DEPTH ? PROF_STACK_DEPTH : s->depth;
+
+        line[0] = '\0';
+        /* Äußerster Aufrufer zuerst; Rücksprungadresse - 4 = der Call-Befehl */
+        for (uint32_t d = depth; d > 0; d--) {
+            len += snprintf(line + len, sizeof(line) - len, "%s;",
+                            sym_name(st, s->stack[d - 1] - 4, buf, sizeof(buf)));
+            if (len >= sizeof(line)) {
+                len = sizeof(line) - 1;
+            }
+        }
+        snprintf(line + len, sizeof(line) - len, "%s", sym_name(st, s->pc, buf, sizeof(buf)));
+        lines[i] = strdup(line);
+    }
+    qsort(lines, r->count, sizeof(*lines), by_string);
+
+    for (size_t i = 0; i < r->count;) {
+        size_t j = i + 1;
+        while (j < r->count && !strcmp(lines[i], lines[j])) {
+            j++;
+        }
+        printf("%s %zu\n", lines[i], j - i);
+        i = j;
+    }
+    for (size_t i = 0; i < r->count; i++) {
+        free(lines[i]);
+    }
+    free(lines);
+}
+
+/*============================================================================
+ * Hauptprogramm
+ *============================================================================*/
+
+int main(int argc, char *argv[]) {
+    uint32_t duration_ms = 2000;
+    uint32_t top = 30;
+    const char *elf = DEFAULT_ELF;
+    int folded = 0;
+    prof_reader_t r;
+    symtab_t st;
+    amp_ipc_t ipc;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "t:e:n:fh")) != -1) {
+        switch (opt) {
+            case 't':
+                duration_ms = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'e':
+                elf = optarg;
+                break;
+            case 'n':
+                top = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'f':
+                folded = 1;
+                break;
+            default:
+                printf("Usage: %s [-t ms] [-e elf] [-n top] [-f]\n", argv[0]);
+                printf("  -t ms      Collect samples for this long (default: 2000)\n");
+                printf("  -e elf     Firmware ELF for symbols (default: %s)\n", DEFAULT_ELF);
+                printf("  -n top     Show the top n functions, 0 = all (default: 30)\n");
+                printf("  -f         Folded stacks (flamegraph.pl) instead of flat profile\n");
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if (load_symbols(elf, &st) < 0) {
+        return 1;
+    }
+    if (amp_ipc_open(&ipc) < 0) {
+        return 1;
+    }
+
+    memset(&r, 0, sizeof(r));
+    r.ring = (volatile prof_shared_t *)amp_ipc_phys(&ipc, SHARED_PROF_ADDR);
+    if (r.ring->magic != PROF_MAGIC || r.ring->sample_size != sizeof(prof_sample_t) ||
+        r.ring->sample_count != PROF_SAMPLES) {
+        fprintf(stderr, "Profiler ring not initialized or layout mismatch "
+                "(magic 0x%08X) - firmware built with PROF_HZ=n?\n", r.ring->magic);
+        amp_ipc_close(&ipc);
+        return 1;
+    }
+    if (folded && r.ring->stack_depth == 0) {
+        fprintf(stderr, "Firmware without PROF_FP=1: stacks contain only the sampled function\n");
+    }
+
+    /* Nur neue Samples, der Ring davor kann vom letzten Lauf stammen */
+    r.tail = r.ring->head;
+    uint32_t head0 = r.tail;
+    uint64_t busy0 = r.ring->busy_cycles;
+    uint64_t elapsed0 = r.ring->elapsed_cycles;
+
+    double start = now_sec();
+    for (;;) {
+        if (drain(&r) < 0) {
+            fprintf(stderr, "Out of memory\n");
+            amp_ipc_close(&ipc);
+            return 1;
+        }
+        if ((now_sec() - start) * 1000.0 >= duration_ms) {
+            break;
+        }
+        usleep(POLL_INTERVAL_US);
+    }
+
+    uint32_t taken = r.ring->head - head0;
+    uint64_t busy = r.ring->busy_cycles - busy0;
+    uint64_t elapsed = r.ring->elapsed_cycles - elapsed0;
+
+    fprintf(stderr, "%u Hz: %zu samples in %.1f s, %llu lost (overrun)\n",
+            r.ring->rate_hz, r.count, (now_sec() - start), (unsigned long long)r.lost);
+    fprintf(stderr, "Handler: %.0f cycles/sample avg, %u max, %.3f%% of Core 3 time\n",
+            taken ? (double)busy / taken : 0.0, r.ring->handler_max_cycles,
+            elapsed ? 100.0 * busy / elapsed : 0.0);
+
+    if (r.count == 0) {
+        fprintf(stderr, "No samples\n");
+    } else if (folded) {
+        print_folded(&r, &st);
+    } else {
+        print_flat(&r, &st, top);
+    }
+
+    free(r.samples);
+    free(st.syms);
+    free(st.strtab);
+    amp_ipc_close(&ipc);
+    return 0;
+}
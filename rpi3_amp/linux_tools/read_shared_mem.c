@@ -6,11 +6,12 @@
  * des Core 3 bare-metal Programms aus dem Shared Memory.
  * 
  * Kompilieren (auf dem RPi3):
- *   gcc -o read_shared_mem read_shared_mem.c
+ *   make read_shared_mem
  * 
  * Ausführen:
  *   sudo ./read_shared_mem
  *   sudo ./read_shared_mem -w    # Watch mode (kontinuierlich)
+ *   sudo ./read_shared_mem -t    # Telemetrie-Verlauf (Takt, Temperatur)
  * 
  * @author RPi3 AMP Project
  * @date 2025-11-26
@@ -29,38 +30,9 @@
  * Shared Memory Definitionen (muss mit Core 3 übereinstimmen!)
  *============================================================================*/
 
-#define SHARED_MEM_BASE     0x20A00000
-#define SHARED_STATUS_ADDR  SHARED_MEM_BASE
-#define PAGE_SIZE           4096
+#include "amp_ipc.h"
 
-#define FIRMWARE_MAGIC      0x52503341  /* "RP3A" */
-
-/* Core 3 Zustände */
-#define CORE3_STATE_BOOT        0
-#define CORE3_STATE_INIT        1
-#define CORE3_STATE_RUNNING     2
-#define CORE3_STATE_MEMTEST     3
-#define CORE3_STATE_ERROR       4
-#define CORE3_STATE_HALTED      5
-
-/* Shared Status Struktur - MUSS mit Core 3 übereinstimmen! */
-typedef struct {
-    uint32_t magic;
-    uint32_t version;
-    uint32_t core3_state;
-    uint32_t boot_count;
-    uint64_t boot_time;
-    uint64_t uptime_ticks;
-    uint32_t heartbeat_counter;
-    uint32_t heartbeat_interval_ms;
-    uint32_t memtest_status;
-    uint32_t memtest_errors;
-    uint32_t memtest_bytes;
-    uint32_t messages_sent;
-    uint32_t messages_received;
-    uint32_t reserved[8];
-    char debug_message[128];
-} shared_status_t;
+#define PAGE_SIZE           4096
 
 /*============================================================================
  * Hilfsfunktionen
@@ -79,7 +51,7 @@ const char* state_to_string(uint32_t state) {
 }
 
 void format_uptime(char *buf, size_t len, uint64_t ticks) {
-    /* System Timer ist 1 MHz = 1 µs pro Tick */
+    /* uptime_ticks ist in µs (timer_get_ticks) */
     uint64_t total_sec = ticks / 1000000ULL;
     uint32_t sec = total_sec % 60;
     uint32_t min = (total_sec / 60) % 60;
@@ -93,7 +65,206 @@ void format_uptime(char *buf, size_t len, uint64_t ticks) {
     }
 }
 
-void print_status(volatile shared_status_t *status) {
+void print_mmu_perf(volatile shared_status_t *status) {
+    printf("║ MMU/Cache     : %s, D-Cache %s, I-Cache %s, Shared %s\n",
+           (status->mmu_flags & MMU_FLAG_ENABLED) ? "ON" : "OFF",
+           (status->mmu_flags & MMU_FLAG_DCACHE) ? "ON" : "OFF",
+           (status->mmu_flags & MMU_FLAG_ICACHE) ? "ON" : "OFF",
+           (status->mmu_flags & MMU_FLAG_SHARED_CACHED) ? "WB" : "NC");
+    printf("║ Instr kIPS    : %u -> %u (x%.1f)\n",
+           status->perf_kips_uncached, status->perf_kips_cached,
+           status->perf_kips_uncached ?
+               (double)status->perf_kips_cached / status->perf_kips_uncached : 0.0);
+    printf("║ Memory MB/s   : %u -> %u (x%.1f)\n",
+           status->perf_mem_mbps_uncached, status->perf_mem_mbps_cached,
+           status->perf_mem_mbps_uncached ?
+               (double)status->perf_mem_mbps_cached / status->perf_mem_mbps_uncached : 0.0);
+}
+
+void print_sched(volatile shared_status_t *status) {
+    uint32_t count = status->sched_task_count;
+
+    if (count > SCHED_MAX_TASKS) {
+        count = SCHED_MAX_TASKS;
+    }
+    printf("║ Scheduler     : %u tasks\n", count);
+    printf("║   %-16s %4s %10s %5s %7s  %s\n",
+           "name", "prio", "period_us", "runs", "misses", "exec min/avg/max ns");
+    for (uint32_t i = 0; i < count; i++) {
+        volatile sched_stats_t *t = &status->sched_tasks[i];
+        char name[SCHED_NAME_LEN];
+
+        for (uint32_t j = 0; j < SCHED_NAME_LEN; j++) {
+            name[j] = t->name[j];
+        }
+        name[SCHED_NAME_LEN - 1] = '\0';
+        printf("║   %-16s %4u %10u %5u %7u  %u/%u/%u\n",
+               name, t->priority, t->period_us, t->runs, t->misses,
+               t->exec_min_ns, t->exec_avg_ns, t->exec_max_ns);
+    }
+}
+
+void print_scrub(volatile shared_status_t *status) {
+    if (status->scrub_pass == 0) {
+        printf("║ Scrubber      : off\n");
+        return;
+    }
+    printf("║ Scrubber      : pass %u, %u/%u KB (%.0f%%), at 0x%08X\n",
+           status->scrub_pass, status->scrub_bytes_done / 1024,
+           status->scrub_pass_bytes / 1024,
+           status->scrub_pass_bytes ?
+               100.0 * status->scrub_bytes_done / status->scrub_pass_bytes : 0.0,
+           status->scrub_cur_addr);
+    printf("║ Scrub Errors  : %u words, %u bad pages\n",
+           status->scrub_errors, status->scrub_bad_pages);
+}
+
+void print_bench(volatile shared_status_t *status) {
+    if (!status->bench_done) {
+        return;
+    }
+    printf("║ Boot Bench    : mem %u/%u MB/s (scalar/wide), ring %u msgs/s, printf %u lines/s\n",
+           status->bench_mem_scalar_mbps, status->bench_mem_wide_mbps,
+           status->bench_ipc_rate, status->bench_printf_rate);
+    printf("║ printf Cycles : %u/call (legacy %u/call)\n",
+           status->bench_printf_cycles, status->bench_legacy_cycles);
+    printf("║ Timer Cycles  : systimer %u, cntpct %u, timer_get_ticks %u per call\n",
+           status->bench_timer_systimer_cycles, status->bench_timer_counter_cycles,
+           status->bench_timer_ticks_cycles);
+}
+
+/*
+ * Kopiert die letzten Telemetrie-Samples (alt -> neu) und verwirft die,
+ * die Core 3 während der Kopie überschrieben hat (wie trace_dump).
+ */
+uint32_t telem_snapshot(volatile telem_shared_t *t, telem_sample_t *out) {
+    uint32_t head, first, n = 0;
+
+    if (!t || t->magic != TELEM_MAGIC) {
+        return 0;
+    }
+    head = __atomic_load_n(&t->head, __ATOMIC_ACQUIRE);
+    first = head > TELEM_SAMPLES ? head - TELEM_SAMPLES : 0;
+
+    for (uint32_t i = first; i != head; i++) {
+        amp_copy_from_shared(&out[n], &t->samples[i & (TELEM_SAMPLES - 1)], sizeof(out[n]));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (out[n].seq == i && t->head - i < TELEM_SAMPLES) {
+            n++;
+        }
+    }
+    return n;
+}
+
+void format_throttled(char *buf, size_t len, uint32_t bits) {
+    static const char *names[] = { "under-voltage", "ARM capped", "throttled", "soft temp limit" };
+    size_t pos = 0;
+
+    buf[0] = '\0';
+    for (uint32_t i = 0; i < 4; i++) {
+        if ((bits & (1U << i)) && pos < len) {
+            pos += snprintf(buf + pos, len - pos, "%s%s", pos ? ", " : "", names[i]);
+        }
+    }
+    if (!pos) {
+        snprintf(buf, len, "none");
+    }
+}
+
+void print_telem(volatile telem_shared_t *t) {
+    static telem_sample_t samples[TELEM_SAMPLES];
+    uint32_t n = telem_snapshot(t, samples);
+    uint32_t valid = 0, temp_min = UINT32_MAX, temp_max = 0;
+    uint32_t arm_min = UINT32_MAX, arm_max = 0, throttled = 0;
+    char now_str[64], boot_str[64];
+
+    if (!t || t->magic != TELEM_MAGIC) {
+        printf("║ Telemetry     : not running\n");
+        return;
+    }
+    if (n == 0) {
+        if (t->source == TELEM_SOURCE_LINUX && t->period_ms == 0) {
+            printf("║ Telemetry     : no samples, start linux_tools/telem_feed\n");
+        } else {
+            printf("║ Telemetry     : no samples yet (every %u ms)\n", t->period_ms);
+        }
+        return;
+    }
+
+    const telem_sample_t *last = &samples[n - 1];
+    if (!last->valid) {
+        printf("║ Telemetry     : no mailbox answer, %u errors\n", t->errors);
+        return;
+    }
+    printf("║ Telemetry     : ARM %u MHz, core %u MHz, %.1f C",
+           last->arm_hz / 1000000, last->core_hz / 1000000, last->temp_mc / 1000.0);
+    if (t->max_temp_mc) {
+        printf(" (limit %.1f C)", t->max_temp_mc / 1000.0);
+    }
+    printf("%s\n", last->valid == (TELEM_VALID_ARM | TELEM_VALID_CORE |
+                                  TELEM_VALID_TEMP | TELEM_VALID_THROTTLED) ?
+           "" : ", incomplete");
+
+    format_throttled(now_str, sizeof(now_str), last->throttled & 0xF);
+    format_throttled(boot_str, sizeof(boot_str), (last->throttled >> THROTTLED_STICKY_SHIFT) & 0xF);
+    printf("║ Throttling    : now %s; since boot %s\n", now_str, boot_str);
+
+    for (uint32_t i = 0; i < n; i++) {
+        if (samples[i].valid & TELEM_VALID_TEMP) {
+            temp_min = samples[i].temp_mc < temp_min ? samples[i].temp_mc : temp_min;
+            temp_max = samples[i].temp_mc > temp_max ? samples[i].temp_mc : temp_max;
+            valid++;
+        }
+        if (samples[i].valid & TELEM_VALID_ARM) {
+            arm_min = samples[i].arm_hz < arm_min ? samples[i].arm_hz : arm_min;
+            arm_max = samples[i].arm_hz > arm_max ? samples[i].arm_hz : arm_max;
+        }
+        if (samples[i].throttled & 0xF) {
+            throttled++;
+        }
+    }
+    printf("║ History       : %u samples / %u s, ", n, n * t->period_ms / 1000);
+    if (valid) {
+        printf("%.1f..%.1f C, ARM %u..%u MHz, %u throttled",
+               temp_min / 1000.0, temp_max / 1000.0,
+               arm_min == UINT32_MAX ? 0 : arm_min / 1000000, arm_max / 1000000, throttled);
+    } else {
+        printf("no mailbox answers");
+    }
+    printf(", %u mailbox errors\n", t->errors);
+}
+
+/* Telemetrie-Verlauf als Tabelle (-t) */
+void print_telem_history(volatile telem_shared_t *t) {
+    static telem_sample_t samples[TELEM_SAMPLES];
+    uint32_t n = telem_snapshot(t, samples);
+
+    if (!t || t->magic != TELEM_MAGIC) {
+        printf("Telemetry not running (magic 0x%08X)\n", t ? t->magic : 0);
+        return;
+    }
+    printf("Telemetry: %u samples, every %u ms, %u mailbox errors\n\n",
+           n, t->period_ms, t->errors);
+    printf("%10s %8s %8s %8s %10s\n", "time_s", "arm_mhz", "core_mhz", "temp_c", "throttled");
+    for (uint32_t i = 0; i < n; i++) {
+        const telem_sample_t *s = &samples[i];
+        printf("%10.1f ", s->ts_us / 1e6);
+        if (s->valid & TELEM_VALID_ARM)  printf("%8u ", s->arm_hz / 1000000);   else printf("%8s ", "-");
+        if (s->valid & TELEM_VALID_CORE) printf("%8u ", s->core_hz / 1000000);  else printf("%8s ", "-");
+        if (s->valid & TELEM_VALID_TEMP) printf("%8.1f ", s->temp_mc / 1000.0); else printf("%8s ", "-");
+        if (s->valid & TELEM_VALID_THROTTLED) printf("0x%08X\n", s->throttled); else printf("%10s\n", "-");
+    }
+}
+
+/* Konsistente Kopie holen (Seqlock), notfalls die ungeschützte */
+void take_snapshot(volatile shared_status_t *status, shared_status_t *snap) {
+    if (amp_status_snapshot(status, snap, AMP_STATUS_SNAPSHOT_RETRIES) < 0) {
+        amp_copy_from_shared(snap, status, sizeof(*snap));
+        fprintf(stderr, "Warning: no consistent snapshot, values may be torn\n");
+    }
+}
+
+void print_status(volatile shared_status_t *status, volatile telem_shared_t *telem) {
     char uptime_str[32];
     time_t now = time(NULL);
     struct tm *tm_info = localtime(&now);
@@ -142,9 +313,39 @@ void print_status(volatile shared_status_t *status) {
         case 1: printf("PASS (%u bytes)                           ║\n", status->memtest_bytes); break;
         case 2: printf("FAIL (%u errors)                              ║\n", status->memtest_errors); break;
     }
+    if (status->memtest_status != 0) {
+        printf("║ Engine        : %s, MB/s", status->memtest_impl ? "wide" : "scalar");
+        for (int i = 0; i < MEMTEST_NUM_TESTS; i++) {
+            printf(" %u", status->memtest_mbps[i]);
+        }
+        printf("\n");
+        for (uint32_t i = 0; i < status->memtest_fail_count && i < MEMTEST_MAX_FAIL_ADDRS; i++) {
+            printf("║   Fail at     : 0x%08X\n", status->memtest_fail_addr[i]);
+        }
+    }
+    print_scrub(status);
+    print_telem(telem);
     printf("╠══════════════════════════════════════════════════════════════╣\n");
     printf("║ IPC Stats     : TX=%u, RX=%u                               ║\n", 
            status->messages_sent, status->messages_received);
+    printf("║ IPC Bench     : RX %u msgs/s, TX %u msgs/s\n",
+           status->ipc_rx_rate, status->ipc_tx_rate);
+    printf("║ Doorbell      : %u wakes, latency %u/%u/%u ns (min/avg/max)%s\n",
+           status->doorbell_count, status->wake_lat_min_ns,
+           status->wake_lat_avg_ns, status->wake_lat_max_ns,
+           status->core3_idle ? ", idle" : "");
+    printf("║ UART          : %u baud, clock %u Hz\n",
+           status->uart_baud, status->uart_clock_hz);
+    printf("║ UART TX       : %u bytes dropped, ring peak %u bytes\n",
+           status->uart_tx_dropped, status->uart_tx_peak);
+    printf("║ Buffer Pool   : RX %u bufs / %u KB (%u errors), TX %u bufs / %u KB\n",
+           status->pool_rx_bufs, status->pool_rx_kb, status->pool_rx_errors,
+           status->pool_tx_bufs, status->pool_tx_kb);
+    printf("╠══════════════════════════════════════════════════════════════╣\n");
+    print_mmu_perf(status);
+    print_bench(status);
+    printf("╠══════════════════════════════════════════════════════════════╣\n");
+    print_sched(status);
     printf("╠══════════════════════════════════════════════════════════════╣\n");
     printf("║ Debug Msg     : %-44s ║\n", status->debug_message);
     printf("╚══════════════════════════════════════════════════════════════╝\n");
@@ -158,32 +359,40 @@ void print_status(volatile shared_status_t *status) {
 
 int main(int argc, char *argv[]) {
     int watch_mode = 0;
+    int history = 0;
     int fd;
+    off_t shared_offset;
     void *map_base;
+    void *telem_map;
+    volatile telem_shared_t *telem = NULL;
     volatile shared_status_t *status;
+    shared_status_t snap;
     
     /* Argumente prüfen */
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-w") == 0 || strcmp(argv[i], "--watch") == 0) {
             watch_mode = 1;
+        } else if (strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--telemetry") == 0) {
+            history = 1;
         } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
-            printf("Usage: %s [-w|--watch]\n", argv[0]);
+            printf("Usage: %s [-w|--watch] [-t|--telemetry]\n", argv[0]);
             printf("\n");
             printf("Reads Core 3 shared memory status from 0x%08X\n", SHARED_STATUS_ADDR);
             printf("\n");
             printf("Options:\n");
             printf("  -w, --watch    Continuous monitoring mode\n");
+            printf("  -t, --telemetry  Show the clock/temperature history\n");
             printf("  -h, --help     Show this help\n");
             printf("\n");
             printf("Requires root privileges (uses /dev/mem)\n");
+            printf("Set %s to read the host build instead\n", AMP_MEM_PATH_ENV);
             return 0;
         }
     }
     
-    /* /dev/mem öffnen */
-    fd = open("/dev/mem", O_RDONLY | O_SYNC);
+    /* /dev/mem (bzw. AMP_MEM_PATH) öffnen */
+    fd = amp_mem_open(O_RDONLY, &shared_offset);
     if (fd < 0) {
-        perror("Failed to open /dev/mem");
         printf("Note: This tool requires root privileges.\n");
         printf("Try: sudo %s\n", argv[0]);
         return 1;
@@ -191,7 +400,7 @@ int main(int argc, char *argv[]) {
     
     /* Shared Memory mappen */
     map_base = mmap(NULL, PAGE_SIZE, PROT_READ, MAP_SHARED, fd, 
-                    SHARED_STATUS_ADDR & ~(PAGE_SIZE - 1));
+                    shared_offset + ((SHARED_STATUS_ADDR - SHARED_MEM_BASE) & ~(PAGE_SIZE - 1)));
     if (map_base == MAP_FAILED) {
         perror("Failed to mmap");
         close(fd);
@@ -202,17 +411,38 @@ int main(int argc, char *argv[]) {
     status = (volatile shared_status_t *)((char *)map_base + 
               (SHARED_STATUS_ADDR & (PAGE_SIZE - 1)));
     
+    /* Telemetrie-Ring (eigener Bereich, fehlt bei alter Firmware) */
+    telem_map = mmap(NULL, SHARED_TELEM_SIZE, PROT_READ, MAP_SHARED, fd,
+                     shared_offset + (SHARED_TELEM_ADDR - SHARED_MEM_BASE));
+    if (telem_map != MAP_FAILED) {
+        telem = (volatile telem_shared_t *)telem_map;
+    }
+    
+    if (history) {
+        print_telem_history(telem);
+        if (telem) {
+            munmap(telem_map, SHARED_TELEM_SIZE);
+        }
+        munmap(map_base, PAGE_SIZE);
+        close(fd);
+        return 0;
+    }
+    
     printf("RPi3 AMP - Core 3 Shared Memory Reader\n");
     printf("Mapped address: 0x%08X\n\n", SHARED_STATUS_ADDR);
     
     if (watch_mode) {
         printf("Watch mode enabled. Press Ctrl+C to stop.\n\n");
         while (1) {
-            print_status(status);
+            take_snapshot(status, &snap);
+            print_status(&snap, telem);
             usleep(500000);  /* 500ms Update-Intervall */
         }
     } else {
         /* Einmalige Ausgabe */
+        take_snapshot(status, &snap);
+        status = &snap;
+        
         printf("╔══════════════════════════════════════════════════════════════╗\n");
         printf("║           RPi3 AMP - Core 3 Status                           ║\n");
         printf("╠══════════════════════════════════════════════════════════════╣\n");
@@ -239,11 +469,19 @@ int main(int argc, char *argv[]) {
                    status->memtest_status == 1 ? "PASS" : 
                    status->memtest_status == 2 ? "FAIL" : "N/A ");
             printf("║ Debug         : %-44s ║\n", status->debug_message);
+            print_mmu_perf(status);
+            print_bench(status);
+            print_sched(status);
+            print_scrub(status);
+            print_telem(telem);
         }
         printf("╚══════════════════════════════════════════════════════════════╝\n");
     }
     
     /* Aufräumen */
+    if (telem) {
+        munmap(telem_map, SHARED_TELEM_SIZE);
+    }
     munmap(map_base, PAGE_SIZE);
     close(fd);
     
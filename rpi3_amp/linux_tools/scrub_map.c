@@ -0,0 +1,61 @@
+/**
+ * @file scrub_map.c
+ * @brief Zeigt Fortschritt und Fehler-Bitmap des Core 3 Memory Scrubbers
+ *
+ * Kompilieren (auf dem RPi3):
+ *   make scrub_map
+ *
+ * Ausführen:
+ *   sudo ./scrub_map
+ *
+ * @author RPi3 AMP Project
+ */
+
+#include <stdio.h>
+
+#include "amp_ipc.h"
+
+int main(void) {
+    amp_ipc_t ipc;
+    volatile shared_status_t *status;
+    volatile scrub_shared_t *scrub;
+    uint32_t listed = 0;
+
+    if (amp_ipc_open(&ipc) < 0) {
+        return 1;
+    }
+    status = ipc.status;
+    scrub = (volatile scrub_shared_t *)amp_ipc_phys(&ipc, SHARED_SCRUB_ADDR);
+
+    if (scrub->magic != SCRUB_MAGIC) {
+        fprintf(stderr, "Scrubber bitmap not initialized (magic 0x%08X)\n", scrub->magic);
+        amp_ipc_close(&ipc);
+        return 1;
+    }
+
+    printf("RPi3 AMP - Memory Scrubber\n");
+    if (status->scrub_pass == 0) {
+        printf("Scrubber is disabled (make SCRUB_KB=0)\n");
+    } else {
+        printf("Pass          : %u\n", status->scrub_pass);
+        printf("Progress      : %u / %u KB\n",
+               status->scrub_bytes_done / 1024, status->scrub_pass_bytes / 1024);
+        printf("Current page  : 0x%08X\n", status->scrub_cur_addr);
+    }
+    printf("Errors        : %u words\n", status->scrub_errors);
+    printf("Bad pages     : %u\n\n", status->scrub_bad_pages);
+
+    for (uint32_t bit = 0; bit < scrub->page_count && bit < SCRUB_BITMAP_WORDS * 32; bit++) {
+        if (scrub->bitmap[bit / 32] & (1u << (bit % 32))) {
+            uint32_t addr = scrub->base + bit * scrub->page_size;
+            printf("  0x%08X - 0x%08X\n", addr, addr + scrub->page_size - 1);
+            listed++;
+        }
+    }
+    if (listed == 0) {
+        printf("No bad pages.\n");
+    }
+
+    amp_ipc_close(&ipc);
+    return 0;
+}
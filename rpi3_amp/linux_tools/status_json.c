@@ -0,0 +1,185 @@
+/**
+ * @file status_json.c
+ * @brief Gibt den Core 3 Status-Block als JSON aus (für Skripte / CI)
+ *
+ * Liest entweder live aus dem Shared Memory (Seqlock Snapshot) oder aus
+ * einer Datei mit dem rohen Status-Block, z.B. dem QEMU Dump von
+ * make qemu-bench (pmemsave 0x20A00000 4096).
+ *
+ * Kompilieren:
+ *   make status_json
+ *
+ * Ausführen:
+ *   sudo ./status_json > status.json
+ *   ./status_json -f build_qemu/status.bin > bench.json
+ *
+ * Rückgabewert 1, wenn die Magic nicht stimmt (Firmware lief nicht).
+ *
+ * @author RPi3 AMP Project
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "amp_ipc.h"
+
+/*============================================================================
+ * Eingabe
+ *============================================================================*/
+
+static int load_file(const char *path, shared_status_t *snap) {
+    FILE *f = fopen(path, "rb");
+    size_t got;
+
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    memset(snap, 0, sizeof(*snap));
+    got = fread(snap, 1, sizeof(*snap), f);
+    fclose(f);
+
+    if (got != sizeof(*snap)) {
+        fprintf(stderr, "%s: %zu bytes, expected %zu\n", path, got, sizeof(*snap));
+        return -1;
+    }
+    return 0;
+}
+
+static int load_live(shared_status_t *snap) {
+    amp_ipc_t ipc;
+    int ret = 0;
+
+    if (amp_ipc_open(&ipc) < 0) {
+        return -1;
+    }
+    if (amp_status_snapshot(ipc.status, snap, AMP_STATUS_SNAPSHOT_RETRIES) < 0) {
+        fprintf(stderr, "No consistent snapshot\n");
+        ret = -1;
+    }
+    amp_ipc_close(&ipc);
+    return ret;
+}
+
+/*============================================================================
+ * Ausgabe
+ *============================================================================*/
+
+static void print_u32_array(const char *name, const uint32_t *v, uint32_t n, int last) {
+    printf("  \"%s\": [", name);
+    for (uint32_t i = 0; i < n; i++) {
+        printf("%s%u", i ? ", " : "", v[i]);
+    }
+    printf("]%s\n", last ? "" : ",");
+}
+
+/* debug_message ist ein C-String aus der Firmware: nur druckbares ASCII */
+static void print_string(const char *name, const char *s, size_t max) {
+    printf("  \"%s\": \"", name);
+    for (size_t i = 0; i < max && s[i]; i++) {
+        char c = s[i];
+        if (c == '"' || c == '\\') {
+            printf("\\%c", c);
+        } else if (c >= 0x20 && c < 0x7F) {
+            putchar(c);
+        }
+    }
+    printf("\",\n");
+}
+
+static void print_json(const shared_status_t *s) {
+    uint32_t tasks = s->sched_task_count < SCHED_MAX_TASKS ?
+                     s->sched_task_count : SCHED_MAX_TASKS;
+
+    printf("{\n");
+    printf("  \"magic_ok\": %s,\n", s->magic == FIRMWARE_MAGIC ? "true" : "false");
+    printf("  \"version\": \"%u.%u.%u\",\n",
+           (s->version >> 16) & 0xFF, (s->version >> 8) & 0xFF, s->version & 0xFF);
+    printf("  \"state\": %u,\n", s->core3_state);
+    printf("  \"boot_count\": %u,\n", s->boot_count);
+    printf("  \"uptime_ticks\": %llu,\n", (unsigned long long)s->uptime_ticks);
+    printf("  \"heartbeat\": %u,\n", s->heartbeat_counter);
+    print_string("debug", s->debug_message, sizeof(s->debug_message));
+
+    printf("  \"bench_done\": %s,\n", s->bench_done ? "true" : "false");
+    printf("  \"bench_mem_scalar_mbps\": %u,\n", s->bench_mem_scalar_mbps);
+    printf("  \"bench_mem_wide_mbps\": %u,\n", s->bench_mem_wide_mbps);
+    printf("  \"bench_ipc_msgs_per_sec\": %u,\n", s->bench_ipc_rate);
+    printf("  \"bench_printf_lines_per_sec\": %u,\n", s->bench_printf_rate);
+    printf("  \"bench_printf_cycles\": %u,\n", s->bench_printf_cycles);
+    printf("  \"bench_legacy_printf_cycles\": %u,\n", s->bench_legacy_cycles);
+    printf("  \"bench_timer_systimer_cycles\": %u,\n", s->bench_timer_systimer_cycles);
+    printf("  \"bench_timer_cntpct_cycles\": %u,\n", s->bench_timer_counter_cycles);
+    printf("  \"bench_timer_get_ticks_cycles\": %u,\n", s->bench_timer_ticks_cycles);
+
+    printf("  \"mmu_flags\": %u,\n", s->mmu_flags);
+    printf("  \"perf_kips\": [%u, %u],\n", s->perf_kips_uncached, s->perf_kips_cached);
+    printf("  \"perf_mem_mbps\": [%u, %u],\n",
+           s->perf_mem_mbps_uncached, s->perf_mem_mbps_cached);
+
+    printf("  \"memtest_status\": %u,\n", s->memtest_status);
+    printf("  \"memtest_errors\": %u,\n", s->memtest_errors);
+    printf("  \"memtest_impl\": %u,\n", s->memtest_impl);
+    print_u32_array("memtest_mbps", s->memtest_mbps, MEMTEST_NUM_TESTS, 0);
+
+    printf("  \"ipc_sent\": %u,\n", s->messages_sent);
+    printf("  \"ipc_received\": %u,\n", s->messages_received);
+    printf("  \"ipc_rx_rate\": %u,\n", s->ipc_rx_rate);
+    printf("  \"ipc_tx_rate\": %u,\n", s->ipc_tx_rate);
+    printf("  \"pool_rx\": {\"bufs\": %u, \"kb\": %u, \"errors\": %u},\n",
+           s->pool_rx_bufs, s->pool_rx_kb, s->pool_rx_errors);
+    printf("  \"pool_tx\": {\"bufs\": %u, \"kb\": %u},\n", s->pool_tx_bufs, s->pool_tx_kb);
+    printf("  \"wake_lat_ns\": [%u, %u, %u],\n",
+           s->wake_lat_min_ns, s->wake_lat_avg_ns, s->wake_lat_max_ns);
+    printf("  \"uart_baud\": %u,\n", s->uart_baud);
+    printf("  \"uart_clock_hz\": %u,\n", s->uart_clock_hz);
+    printf("  \"uart_tx_dropped\": %u,\n", s->uart_tx_dropped);
+    printf("  \"uart_tx_peak\": %u,\n", s->uart_tx_peak);
+    printf("  \"scrub_pass\": %u,\n", s->scrub_pass);
+    printf("  \"scrub_errors\": %u,\n", s->scrub_errors);
+
+    printf("  \"sched_tasks\": [");
+    for (uint32_t i = 0; i < tasks; i++) {
+        const sched_stats_t *t = &s->sched_tasks[i];
+        char name[SCHED_NAME_LEN];
+
+        memcpy(name, t->name, SCHED_NAME_LEN);
+        name[SCHED_NAME_LEN - 1] = '\0';
+        printf("%s\n    {\"name\": \"%s\", \"runs\": %u, \"misses\": %u, "
+               "\"exec_ns\": [%u, %u, %u]}",
+               i ? "," : "", name, t->runs, t->misses,
+               t->exec_min_ns, t->exec_avg_ns, t->exec_max_ns);
+    }
+    printf("%s]\n", tasks ? "\n  " : "");
+    printf("}\n");
+}
+
+/*============================================================================
+ * Hauptprogramm
+ *============================================================================*/
+
+int main(int argc, char *argv[]) {
+    const char *path = NULL;
+    shared_status_t snap;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "f:h")) != -1) {
+        switch (opt) {
+            case 'f':
+                path = optarg;
+                break;
+            default:
+                printf("Usage: %s [-f status.bin]\n", argv[0]);
+                printf("  -f file    Read a raw status block dump instead of shared memory\n");
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if ((path ? load_file(path, &snap) : load_live(&snap)) < 0) {
+        return 1;
+    }
+
+    print_json(&snap);
+    return snap.magic == FIRMWARE_MAGIC ? 0 : 1;
+}
@@ -0,0 +1,186 @@
+/**
+ * @file status_stress.c
+ * @brief Stresstest für den Seqlock um den Status-Block
+ *
+ * Core 3 schreibt während des Tests ununterbrochen einen Zähler in alle
+ * stress_words (IPC_MSG_STATUS_STRESS). Linux kopiert abwechselnd die ganze
+ * Struktur ungeschützt und per amp_status_snapshot() und zählt Kopien,
+ * in denen die Wörter nicht übereinstimmen.
+ *
+ * Erwartung: ungeschützt gibt es zerrissene Kopien, mit Seqlock keine.
+ *
+ * Kompilieren (auf dem RPi3):
+ *   make status_stress
+ *
+ * Ausführen:
+ *   sudo ./status_stress           # 1 s Stresstest
+ *   sudo ./status_stress -t 5000
+ *
+ * @author RPi3 AMP Project
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "amp_ipc.h"
+
+#define DEFAULT_DURATION_MS 1000
+#define TIMEOUT_SEC         2.0
+
+typedef struct {
+    uint64_t samples;
+    uint64_t torn;
+    uint64_t retries;
+    uint64_t failed;
+    double   elapsed;
+} stress_stats_t;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void drain(amp_ipc_t *ipc) {
+    uint8_t buf[256];
+    uint32_t type;
+    while (amp_ipc_recv(ipc, &type, buf, sizeof(buf)) >= 0) {
+        /* alte Nachrichten verwerfen */
+    }
+}
+
+/* Kopie konsistent, wenn alle Stress-Wörter denselben Wert haben */
+static int is_torn(const shared_status_t *snap) {
+    for (int i = 1; i < STATUS_STRESS_WORDS; i++) {
+        if (snap->stress_words[i] != snap->stress_words[0]) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void sample_raw(amp_ipc_t *ipc, shared_status_t *snap, stress_stats_t *st) {
+    double t0 = now_sec();
+    amp_copy_from_shared(snap, ipc->status, sizeof(*snap));
+    st->elapsed += now_sec() - t0;
+    st->samples++;
+    st->torn += is_torn(snap);
+}
+
+static void sample_seqlock(amp_ipc_t *ipc, shared_status_t *snap, stress_stats_t *st) {
+    double t0 = now_sec();
+    int retries = amp_status_snapshot(ipc->status, snap, AMP_STATUS_SNAPSHOT_RETRIES);
+    st->elapsed += now_sec() - t0;
+    st->samples++;
+    if (retries < 0) {
+        st->failed++;
+        st->retries += AMP_STATUS_SNAPSHOT_RETRIES;
+        return;
+    }
+    st->retries += (uint64_t)retries;
+    st->torn += is_torn(snap);
+}
+
+static void print_stats(const char *name, const stress_stats_t *st) {
+    printf("%-9s: %9llu copies, %9llu torn (%.3f%%), %8.0f copies/s",
+           name, (unsigned long long)st->samples, (unsigned long long)st->torn,
+           st->samples ? 100.0 * st->torn / st->samples : 0.0,
+           st->elapsed > 0 ? st->samples / st->elapsed : 0.0);
+    if (st->retries || st->failed) {
+        printf(", %.2f retries/copy, %llu failed",
+               st->samples ? (double)st->retries / st->samples : 0.0,
+               (unsigned long long)st->failed);
+    }
+    printf("\n");
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t duration_ms = DEFAULT_DURATION_MS;
+    uint32_t duration_us;
+    stress_stats_t raw, locked;
+    shared_status_t snap;
+    uint32_t done[2] = { 0, 0 };
+    uint8_t buf[256];
+    uint32_t type;
+    amp_ipc_t ipc;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "t:h")) != -1) {
+        switch (opt) {
+            case 't':
+                duration_ms = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            default:
+                printf("Usage: %s [-t duration_ms]\n", argv[0]);
+                printf("  -t ms      Stress duration (default %u, max 10000)\n",
+                       DEFAULT_DURATION_MS);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    duration_us = duration_ms * 1000;
+
+    if (amp_ipc_open(&ipc) < 0) {
+        return 1;
+    }
+
+    printf("RPi3 AMP - Status Seqlock Stress\n");
+    printf("Status block: %zu bytes, %u stress words, %u ms\n\n",
+           sizeof(shared_status_t), STATUS_STRESS_WORDS, duration_ms);
+
+    drain(&ipc);
+    memset(&raw, 0, sizeof(raw));
+    memset(&locked, 0, sizeof(locked));
+
+    /* Warten bis Core 3 schreibt */
+    uint32_t before = ipc.status->stress_words[0];
+    double start = now_sec();
+    while (amp_ipc_send(&ipc, IPC_MSG_STATUS_STRESS, &duration_us, sizeof(duration_us)) != 0) {
+        if (now_sec() - start > TIMEOUT_SEC) {
+            fprintf(stderr, "Timeout: cannot submit STATUS_STRESS\n");
+            amp_ipc_close(&ipc);
+            return 1;
+        }
+    }
+    amp_ipc_kick(&ipc);
+    while (ipc.status->stress_words[0] == before) {
+        if (now_sec() - start > TIMEOUT_SEC) {
+            fprintf(stderr, "Timeout: Core 3 does not write\n");
+            amp_ipc_close(&ipc);
+            return 1;
+        }
+    }
+
+    /* Abwechselnd ungeschützt und per Seqlock kopieren */
+    start = now_sec();
+    while (now_sec() - start < duration_ms / 1000.0) {
+        sample_raw(&ipc, &snap, &raw);
+        sample_seqlock(&ipc, &snap, &locked);
+    }
+
+    /* Ergebnis von Core 3 */
+    start = now_sec();
+    for (;;) {
+        int len = amp_ipc_recv(&ipc, &type, buf, sizeof(buf));
+        if (len >= (int)sizeof(done) && type == IPC_MSG_STATUS_STRESS_DONE) {
+            memcpy(done, buf, sizeof(done));
+            break;
+        }
+        if (len < 0 && now_sec() - start > TIMEOUT_SEC) {
+            fprintf(stderr, "Timeout waiting for STATUS_STRESS_DONE\n");
+            break;
+        }
+    }
+
+    if (done[1]) {
+        printf("Core 3   : %u writes in %u us (%.0f writes/s)\n\n",
+               done[0], done[1], done[0] * 1e6 / done[1]);
+    }
+    print_stats("raw", &raw);
+    print_stats("seqlock", &locked);
+
+    amp_ipc_close(&ipc);
+    return locked.torn ? 1 : 0;
+}
@@ -0,0 +1,230 @@
+/**
+ * @file telem_feed.c
+ * @brief Schreibt die SoC-Telemetrie aus Linux in den Ring von Core 3
+ *        (rpi3_amp_core3/telem.h)
+ *
+ * Die GPU-Mailbox gehört dem Linux Firmware-Treiber. Fragt Core 3 sie
+ * selbst ab, verfälscht das Firmware-Aufrufe von Linux (siehe mbox.h).
+ * Deshalb fragt dieses Tool die Firmware über /dev/vcio (derselbe Treiber,
+ * sauber serialisiert) und schreibt die Samples in SHARED_TELEM_ADDR -
+ * nur wenn die Firmware mit TELEM_MS=0 gebaut ist (source = LINUX), sonst
+ * gäbe es zwei Schreiber.
+ *
+ * Ein Umlauf pro Sample: ARM-Takt, Core-Takt, Temperatur, Throttling.
+ * ts_us ist CNTVCT_EL0 in µs, dieselbe Zeitbasis wie timer_get_ticks()
+ * auf Core 3 (TIMER_SRC=1, CNTVOFF = 0).
+ *
+ * Kompilieren (auf dem RPi3):
+ *   make telem_feed
+ *
+ * Ausführen:
+ *   sudo ./telem_feed &            # jede Sekunde
+ *   sudo ./telem_feed -p 250       # alle 250 ms
+ *   sudo ./telem_feed -n 1         # ein Sample und Ende
+ *
+ * @author RPi3 AMP Project
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "amp_ipc.h"
+
+#define VCIO_PATH               "/dev/vcio"
+#define IOCTL_MBOX_PROPERTY     _IOWR(100, 0, char *)
+
+/* Property-Interface (rpi3_amp_core3/mbox.h) */
+#define MBOX_REQUEST            0x00000000
+#define MBOX_RESPONSE_OK        0x80000000
+#define MBOX_TAG_RESPONSE       0x80000000
+#define MBOX_TAG_GET_CLOCK_RATE 0x00030002
+#define MBOX_TAG_GET_TEMP       0x00030006
+#define MBOX_TAG_GET_MAX_TEMP   0x0003000A
+#define MBOX_TAG_GET_THROTTLED  0x00030046
+#define MBOX_CLOCK_ARM          3
+#define MBOX_CLOCK_CORE         4
+
+#define DEFAULT_PERIOD_MS       1000
+#define TAG_WORDS               5       /* tag, Größe, Status, 2 Werte */
+
+typedef struct {
+    uint32_t tag;
+    uint32_t value[2];
+    int ok;
+} tag_t;
+
+static volatile telem_shared_t *g_telem;
+static uint32_t g_head;
+static uint32_t g_errors;
+
+/* Mehrere Tags in einer Nachricht, jeder mit 8 Byte Wertepuffer */
+static int property_batch(int fd, tag_t *tags, uint32_t count) {
+    uint32_t msg[2 + 4 * TAG_WORDS + 1] __attribute__((aligned(16)));
+    uint32_t i, p = 2;
+
+    for (i = 0; i < count; i++) {
+        msg[p++] = tags[i].tag;
+        msg[p++] = 8;
+        msg[p++] = 0;
+        msg[p++] = tags[i].value[0];
+        msg[p++] = tags[i].value[1];
+        tags[i].ok = 0;
+    }
+    msg[p++] = 0;
+    msg[0] = p * 4;
+    msg[1] = MBOX_REQUEST;
+
+    if (ioctl(fd, IOCTL_MBOX_PROPERTY, msg) < 0 || msg[1] != MBOX_RESPONSE_OK) {
+        return -1;
+    }
+    for (i = 0, p = 2; i < count; i++, p += TAG_WORDS) {
+        tags[i].ok = (msg[p + 2] & MBOX_TAG_RESPONSE) != 0;
+        tags[i].value[0] = msg[p + 3];
+        tags[i].value[1] = msg[p + 4];
+    }
+    return 0;
+}
+
+/* Zeitbasis von Core 3 in µs */
+static uint64_t now_us(void) {
+#if defined(__aarch64__)
+    uint64_t freq;
+    __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+    if (freq) {
+        uint64_t cnt = amp_counter();
+        return cnt / freq * 1000000ULL + cnt % freq * 1000000ULL / freq;
+    }
+#endif
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000;
+}
+
+/* Wie telem_sample() auf Core 3: Sample füllen, seq, dann head (Release) */
+static int feed_sample(int fd) {
+    tag_t tags[4] = {
+        { MBOX_TAG_GET_CLOCK_RATE, { MBOX_CLOCK_ARM, 0 }, 0 },
+        { MBOX_TAG_GET_CLOCK_RATE, { MBOX_CLOCK_CORE, 0 }, 0 },
+        { MBOX_TAG_GET_TEMP, { 0, 0 }, 0 },
+        { MBOX_TAG_GET_THROTTLED, { 0, 0 }, 0 },
+    };
+    telem_sample_t s;
+    uint32_t idx;
+    int rc = property_batch(fd, tags, 4);
+
+    if (rc < 0) {
+        __atomic_store_n(&g_telem->errors, ++g_errors, __ATOMIC_RELEASE);
+    }
+
+    idx = g_head++;
+    memset(&s, 0, sizeof(s));
+    s.ts_us = now_us();
+    if (tags[0].ok && tags[0].value[0] == MBOX_CLOCK_ARM) {
+        s.arm_hz = tags[0].value[1];
+        s.valid |= TELEM_VALID_ARM;
+    }
+    if (tags[1].ok && tags[1].value[0] == MBOX_CLOCK_CORE) {
+        s.core_hz = tags[1].value[1];
+        s.valid |= TELEM_VALID_CORE;
+    }
+    if (tags[2].ok) {
+        s.temp_mc = tags[2].value[1];
+        s.valid |= TELEM_VALID_TEMP;
+    }
+    if (tags[3].ok) {
+        s.throttled = tags[3].value[0];
+        s.valid |= TELEM_VALID_THROTTLED;
+    }
+
+    /* seq ist das letzte Feld und wird erst nach dem Rest geschrieben */
+    volatile telem_sample_t *dst = &g_telem->samples[idx & (TELEM_SAMPLES - 1)];
+    amp_copy_to_shared(dst, &s, offsetof(telem_sample_t, seq));
+    __atomic_store_n(&dst->seq, idx, __ATOMIC_RELEASE);
+    __atomic_store_n(&g_telem->head, idx + 1, __ATOMIC_RELEASE);
+    return rc;
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t period_ms = DEFAULT_PERIOD_MS;
+    long count = 0;
+    amp_ipc_t ipc;
+    int fd, opt;
+
+    while ((opt = getopt(argc, argv, "p:n:h")) != -1) {
+        switch (opt) {
+            case 'p':
+                period_ms = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'n':
+                count = strtol(optarg, NULL, 0);
+                break;
+            default:
+                printf("Usage: %s [-p ms] [-n count]\n", argv[0]);
+                printf("  -p ms      Sample period (default: %u)\n", DEFAULT_PERIOD_MS);
+                printf("  -n count   Stop after count samples (default: run forever)\n");
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (period_ms == 0) {
+        fprintf(stderr, "Period must be > 0\n");
+        return 1;
+    }
+
+    fd = open(VCIO_PATH, O_RDWR);
+    if (fd < 0) {
+        fprintf(stderr, "Failed to open %s: %s\n", VCIO_PATH, strerror(errno));
+        return 1;
+    }
+    if (amp_ipc_open(&ipc) < 0) {
+        close(fd);
+        return 1;
+    }
+
+    g_telem = amp_ipc_phys(&ipc, SHARED_TELEM_ADDR);
+    if (g_telem->magic != TELEM_MAGIC || g_telem->sample_count != TELEM_SAMPLES ||
+        g_telem->sample_size != sizeof(telem_sample_t)) {
+        fprintf(stderr, "Telemetry ring not initialized or layout mismatch (magic 0x%08X)\n",
+                g_telem->magic);
+        goto fail;
+    }
+    if (g_telem->source != TELEM_SOURCE_LINUX) {
+        fprintf(stderr, "Core 3 samples the mailbox itself (firmware built with TELEM_MS=%u)\n",
+                g_telem->period_ms);
+        goto fail;
+    }
+
+    /* Weiterschreiben, wo ein früherer Lauf aufgehört hat */
+    g_head = __atomic_load_n(&g_telem->head, __ATOMIC_ACQUIRE);
+    g_errors = g_telem->errors;
+
+    tag_t max_temp = { MBOX_TAG_GET_MAX_TEMP, { 0, 0 }, 0 };
+    if (property_batch(fd, &max_temp, 1) == 0 && max_temp.ok) {
+        g_telem->max_temp_mc = max_temp.value[1];
+    }
+    g_telem->period_ms = period_ms;
+
+    for (long n = 0; count == 0 || n < count; n++) {
+        if (n) {
+            usleep(period_ms * 1000);
+        }
+        if (feed_sample(fd) < 0 && n == 0) {
+            fprintf(stderr, "Warning: no answer from %s\n", VCIO_PATH);
+        }
+    }
+
+    amp_ipc_close(&ipc);
+    close(fd);
+    return 0;
+
+fail:
+    amp_ipc_close(&ipc);
+    close(fd);
+    return 1;
+}
@@ -0,0 +1,279 @@
+/**
+ * @file trace_dump.c
+ * @brief Liest den Core 3 Trace-Ring und exportiert Chrome/Perfetto JSON
+ *
+ * Der Ring (SHARED_TRACE_ADDR) ist ein Flight Recorder: Core 3 schreibt
+ * immer weiter und überschreibt die ältesten Records. Dieses Tool liest
+ * mit eigenem tail hinterher; fällt es mehr als TRACE_RECORDS zurück, sind
+ * Events verloren (Überlauf) - das steht im Trace als Instant-Event
+ * "trace overrun" und am Ende auf stderr.
+ *
+ * Zeitstempel: Core 3 schreibt CNTPCT_EL0, Linux liest denselben Counter
+ * als CNTVCT_EL0. Die Ausgabe wird auf CLOCK_MONOTONIC (µs) umgerechnet,
+ * damit sie neben einem Linux-Trace (perfetto / ftrace mit trace_clock
+ * mono) auf derselben Zeitachse liegt. -r lässt die Counter-Zeit stehen.
+ *
+ * Kompilieren (auf dem RPi3):
+ *   make trace_dump
+ *
+ * Ausführen:
+ *   sudo ./trace_dump > core3.json              # Inhalt des Rings
+ *   sudo ./trace_dump -t 5000 -o core3.json     # 5 s mitschneiden
+ *   -> https://ui.perfetto.dev oder chrome://tracing
+ *
+ * @author RPi3 AMP Project
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "amp_ipc.h"
+
+#define POLL_INTERVAL_US    1000
+
+/* Chrome Trace: pid/tid für Core 3 */
+#define TRACE_PID           3
+#define TRACE_TID_MAIN      1
+#define TRACE_TID_IRQ       2
+
+typedef struct {
+    volatile trace_shared_t *ring;
+    uint32_t tail;
+    uint64_t events;
+    uint64_t lost;
+    uint32_t pending_lost;      /* Noch nicht im JSON vermerkt */
+    double   tick_us;           /* µs pro Counter-Tick */
+    double   offset_us;         /* Counter-Zeit -> CLOCK_MONOTONIC */
+    FILE    *out;
+    int      first;             /* Kein Komma vor dem ersten Event */
+    shared_status_t status;     /* Für die Task-Namen */
+} trace_reader_t;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*============================================================================
+ * JSON Ausgabe
+ *============================================================================*/
+
+static void event_name(const trace_reader_t *r, const trace_rec_t *rec,
+                       char *buf, size_t len) {
+    static const char *bench_phase[] = { "bench memtest", "bench ipc ring", "bench printf" };
+
+    switch (rec->id) {
+        case TRACE_EV_TASK:
+            if (rec->arg0 < SCHED_MAX_TASKS && r->status.sched_tasks[rec->arg0].name[0]) {
+                snprintf(buf, len, "%.*s", SCHED_NAME_LEN - 1,
+                         r->status.sched_tasks[rec->arg0].name);
+            } else {
+                snprintf(buf, len, "task %u", rec->arg0);
+            }
+            break;
+        case TRACE_EV_IPC_POLL:
+            snprintf(buf, len, "ipc_poll");
+            break;
+        case TRACE_EV_IDLE:
+            snprintf(buf, len, "idle (wfi)");
+            break;
+        case TRACE_EV_DOORBELL:
+            snprintf(buf, len, "doorbell");
+            break;
+        case TRACE_EV_BENCH:
+            snprintf(buf, len, "%s", rec->arg0 < 3 ? bench_phase[rec->arg0] : "bench");
+            break;
+        default:
+            if (rec->id >= TRACE_EV_USER) {
+                snprintf(buf, len, "user %u", rec->id - TRACE_EV_USER);
+            } else {
+                snprintf(buf, len, "event %u", rec->id);
+            }
+            break;
+    }
+}
+
+static void emit_begin(trace_reader_t *r) {
+    fprintf(r->out, "%s\n  ", r->first ? "" : ",");
+    r->first = 0;
+}
+
+static void emit_metadata(trace_reader_t *r, int tid, const char *what, const char *name) {
+    emit_begin(r);
+    fprintf(r->out, "{\"name\": \"%s\", \"ph\": \"M\", \"pid\": %d, \"tid\": %d, "
+            "\"args\": {\"name\": \"%s\"}}", what, TRACE_PID, tid, name);
+}
+
+static void emit_record(trace_reader_t *r, const trace_rec_t *rec) {
+    static const char ph[] = { 'B', 'E', 'i', 'C' };
+    double ts = rec->ts * r->tick_us + r->offset_us;
+    int tid = rec->id == TRACE_EV_DOORBELL ? TRACE_TID_IRQ : TRACE_TID_MAIN;
+    char name[48];
+
+    if (r->pending_lost) {
+        emit_begin(r);
+        fprintf(r->out, "{\"name\": \"trace overrun\", \"ph\": \"i\", \"s\": \"p\", "
+                "\"ts\": %.3f, \"pid\": %d, \"tid\": %d, \"args\": {\"lost\": %u}}",
+                ts, TRACE_PID, TRACE_TID_MAIN, r->pending_lost);
+        r->pending_lost = 0;
+    }
+    if (rec->type > TRACE_TYPE_COUNTER) {
+        return;
+    }
+
+    event_name(r, rec, name, sizeof(name));
+    emit_begin(r);
+    fprintf(r->out, "{\"name\": \"%s\", \"ph\": \"%c\", \"ts\": %.3f, \"pid\": %d, \"tid\": %d",
+            name, ph[rec->type], ts, TRACE_PID, tid);
+    if (rec->type == TRACE_TYPE_INSTANT) {
+        fprintf(r->out, ", \"s\": \"t\"");
+    }
+    if (rec->type == TRACE_TYPE_COUNTER) {
+        fprintf(r->out, ", \"args\": {\"value\": %u}}", rec->arg0);
+    } else {
+        fprintf(r->out, ", \"args\": {\"arg0\": %u, \"arg1\": %u}}", rec->arg0, rec->arg1);
+    }
+    r->events++;
+}
+
+/*============================================================================
+ * Ring lesen
+ *============================================================================*/
+
+static void lose(trace_reader_t *r, uint32_t count) {
+    r->lost += count;
+    r->pending_lost += count;
+}
+
+static void drain(trace_reader_t *r) {
+    volatile trace_shared_t *t = r->ring;
+    uint32_t head = __atomic_load_n(&t->head, __ATOMIC_ACQUIRE);
+    trace_rec_t rec;
+
+    /* Mehr als einen Ring zurück: die ältesten sind schon überschrieben */
+    if (head - r->tail > TRACE_RECORDS) {
+        lose(r, head - r->tail - TRACE_RECORDS);
+        r->tail = head - TRACE_RECORDS;
+    }
+
+    while (r->tail != head) {
+        amp_copy_from_shared(&rec, &t->rec[r->tail & (TRACE_RECORDS - 1)], sizeof(rec));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        /* Slot während der Kopie überschrieben? */
+        uint32_t now = t->head;
+        if (rec.seq != r->tail || now - r->tail >= TRACE_RECORDS) {
+            lose(r, 1);
+        } else {
+            emit_record(r, &rec);
+        }
+        r->tail++;
+    }
+}
+
+/*============================================================================
+ * Hauptprogramm
+ *============================================================================*/
+
+int main(int argc, char *argv[]) {
+    uint32_t duration_ms = 0;
+    const char *path = NULL;
+    int only_new = 0;
+    int raw_time = 0;
+    trace_reader_t r;
+    amp_ipc_t ipc;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "t:o:nrh")) != -1) {
+        switch (opt) {
+            case 't':
+                duration_ms = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'o':
+                path = optarg;
+                break;
+            case 'n':
+                only_new = 1;
+                break;
+            case 'r':
+                raw_time = 1;
+                break;
+            default:
+                printf("Usage: %s [-t ms] [-o file] [-n] [-r]\n", argv[0]);
+                printf("  -t ms      Keep draining for this long (default: dump ring and exit)\n");
+                printf("  -o file    Write JSON to file (default: stdout)\n");
+                printf("  -n         Only events after start, not the ring contents\n");
+                printf("  -r         Raw counter time instead of CLOCK_MONOTONIC\n");
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if (amp_ipc_open(&ipc) < 0) {
+        return 1;
+    }
+
+    memset(&r, 0, sizeof(r));
+    r.ring = (volatile trace_shared_t *)amp_ipc_phys(&ipc, SHARED_TRACE_ADDR);
+    if (r.ring->magic != TRACE_MAGIC || r.ring->rec_size != sizeof(trace_rec_t) ||
+        r.ring->rec_count != TRACE_RECORDS || r.ring->counter_freq == 0) {
+        fprintf(stderr, "Trace ring not initialized or layout mismatch "
+                "(magic 0x%08X, %u x %u bytes)\n",
+                r.ring->magic, r.ring->rec_count, r.ring->rec_size);
+        amp_ipc_close(&ipc);
+        return 1;
+    }
+    if (amp_status_snapshot(ipc.status, &r.status, AMP_STATUS_SNAPSHOT_RETRIES) < 0) {
+        memset(&r.status, 0, sizeof(r.status));
+    }
+
+    /* Zeitbasis: Counter-Ticks in µs, Offset zu CLOCK_MONOTONIC */
+    r.tick_us = 1e6 / r.ring->counter_freq;
+    uint64_t cnt = amp_counter();
+    if (!raw_time && cnt != 0) {
+        r.offset_us = now_sec() * 1e6 - cnt * r.tick_us;
+    }
+
+    uint32_t head = r.ring->head;
+    if (only_new) {
+        r.tail = head;
+    } else {
+        r.tail = head > TRACE_RECORDS ? head - TRACE_RECORDS : 0;
+    }
+
+    r.out = path ? fopen(path, "w") : stdout;
+    if (!r.out) {
+        perror(path);
+        amp_ipc_close(&ipc);
+        return 1;
+    }
+    r.first = 1;
+
+    fprintf(r.out, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [");
+    emit_metadata(&r, TRACE_TID_MAIN, "process_name", "Core 3 (bare metal)");
+    emit_metadata(&r, TRACE_TID_MAIN, "thread_name", "main loop");
+    emit_metadata(&r, TRACE_TID_IRQ, "thread_name", "irq");
+
+    double start = now_sec();
+    for (;;) {
+        drain(&r);
+        if ((now_sec() - start) * 1000.0 >= duration_ms) {
+            break;
+        }
+        usleep(POLL_INTERVAL_US);
+    }
+
+    fprintf(r.out, "\n]}\n");
+    if (path) {
+        fclose(r.out);
+    }
+
+    fprintf(stderr, "%llu events, %llu lost (overrun), head %u\n",
+            (unsigned long long)r.events, (unsigned long long)r.lost, r.ring->head);
+
+    amp_ipc_close(&ipc);
+    return 0;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file uart_baud.c
+ * @brief Zeigt bzw. ändert die Baudrate von UART0 (Core 3)
+ *
+ * Ohne Argument werden Takt und Baudrate aus dem Status-Block gelesen.
+ * Mit Argument schickt das Tool IPC_MSG_SET_BAUD und wartet auf die
+ * Antwort. Core 3 leert vorher den TX-Ring, die Ausgabe bis dahin kommt
+ * also noch mit der alten Rate. Danach das Terminal umstellen, z.B.
+ *   picocom -b 3000000 /dev/ttyUSB0
+ *
+ * Kompilieren (auf dem RPi3):
+ *   make uart_baud
+ *
+ * Ausführen:
+ *   sudo ./uart_baud               # aktuelle Rate
+ *   sudo ./uart_baud 921600
+ *   sudo ./uart_baud 3000000
+ *
+ * @author RPi3 AMP Project
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "amp_ipc.h"
+
+#define TIMEOUT_SEC     2.0
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void drain(amp_ipc_t *ipc) {
+    uint8_t buf[256];
+    uint32_t type;
+    while (amp_ipc_recv(ipc, &type, buf, sizeof(buf)) >= 0) {
+        /* alte Nachrichten verwerfen */
+    }
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t baud;
+    uint32_t done[2] = { 0, 0 };
+    uint8_t buf[256];
+    uint32_t type;
+    amp_ipc_t ipc;
+
+    if (argc > 2 || (argc == 2 && (!strcmp(argv[1], "-h") || !strcmp(argv[1], "--help")))) {
+        printf("Usage: %s [baud]\n", argv[0]);
+        printf("  baud       New UART0 rate, e.g. 115200, 921600, 2000000, 3000000\n");
+        printf("             (without argument: show current rate)\n");
+        return argc == 2 ? 0 : 1;
+    }
+
+    if (amp_ipc_open(&ipc) < 0) {
+        return 1;
+    }
+
+    printf("UART0: %u baud, clock %u Hz\n", ipc.status->uart_baud, ipc.status->uart_clock_hz);
+    if (argc < 2) {
+        amp_ipc_close(&ipc);
+        return 0;
+    }
+
+    baud = (uint32_t)strtoul(argv[1], NULL, 0);
+    drain(&ipc);
+
+    double start = now_sec();
+    while (amp_ipc_send(&ipc, IPC_MSG_SET_BAUD, &baud, sizeof(baud)) != 0) {
+        if (now_sec() - start > TIMEOUT_SEC) {
+            fprintf(stderr, "Timeout: cannot submit SET_BAUD\n");
+            amp_ipc_close(&ipc);
+            return 1;
+        }
+    }
+    amp_ipc_kick(&ipc);
+
+    for (;;) {
+        int len = amp_ipc_recv(&ipc, &type, buf, sizeof(buf));
+        if (len >= (int)sizeof(done) && type == IPC_MSG_SET_BAUD_DONE) {
+            memcpy(done, buf, sizeof(done));
+            break;
+        }
+        if (len < 0 && now_sec() - start > TIMEOUT_SEC) {
+            fprintf(stderr, "Timeout waiting for SET_BAUD_DONE\n");
+            amp_ipc_close(&ipc);
+            return 1;
+        }
+    }
+
+    if (!done[0]) {
+        fprintf(stderr, "Core 3 rejected %u baud (clock %u Hz)\n", baud, done[1]);
+        amp_ipc_close(&ipc);
+        return 1;
+    }
+    printf("UART0: %u baud (requested %u, %+.2f%%)\n",
+           done[0], baud, 100.0 * ((double)done[0] - baud) / baud);
+
+    amp_ipc_close(&ipc);
+    return 0;
+}
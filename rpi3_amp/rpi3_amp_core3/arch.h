@@ -0,0 +1,115 @@
+/**
+ * @file arch.h
+ * @brief ARMv8-A System-Register Zugriff für Core 3
+ *
+ * Core 3 wird vom armstub in EL2 gestartet (siehe README "Bekannte Issues").
+ * Alle Register, die es pro Exception Level gibt (SCTLR, TCR, MAIR, ...),
+ * werden deshalb über arch_current_el() ausgewählt, damit der Code auch
+ * funktioniert, falls die Firmware einmal in EL1 gestartet wird.
+ */
+
+#ifndef ARCH_H
+#define ARCH_H
+
+#include "common.h"
+
+/*============================================================================
+ * System-Register Makros
+ *============================================================================*/
+
+#define READ_SYSREG(reg) ({                                 \
+    uint64_t __val;                                         \
+    asm volatile("mrs %0, " #reg : "=r"(__val));            \
+    __val;                                                  \
+})
+
+#define WRITE_SYSREG(reg, val) \
+    asm volatile("msr " #reg ", %0" :: "r"((uint64_t)(val)) : "memory")
+
+/*============================================================================
+ * Inline Hilfsfunktionen
+ *============================================================================*/
+
+#ifdef AMP_HOST
+
+/* Host-Build: CLOCK_MONOTONIC in ns statt CNTPCT_EL0 (host/host.h) */
+#include "host.h"
+
+static inline uint64_t arch_counter(void) {
+    return host_counter();
+}
+
+static inline uint32_t arch_counter_freq(void) {
+    return HOST_COUNTER_FREQ;
+}
+
+/* Zyklenzähler: TSC auf x86-64, sonst der ns-Counter */
+static inline void arch_cycles_init(void) {
+}
+
+static inline uint64_t arch_cycles(void) {
+#if defined(__x86_64__)
+    return __builtin_ia32_rdtsc();
+#else
+    return host_counter();
+#endif
+}
+
+#else
+
+/**
+ * @brief Gibt das aktuelle Exception Level zurück (1, 2 oder 3)
+ */
+static inline uint32_t arch_current_el(void) {
+    return (uint32_t)((READ_SYSREG(CurrentEL) >> 2) & 0x3);
+}
+
+/**
+ * @brief Cache-Line Größe der kleinsten D-Cache Line in Bytes (CTR_EL0.DminLine)
+ */
+static inline uint32_t arch_dcache_line_size(void) {
+    return 4U << ((READ_SYSREG(ctr_el0) >> 16) & 0xF);
+}
+
+/**
+ * @brief Liest den physikalischen Counter (CNTPCT_EL0)
+ *
+ * Das ISB verhindert, dass der Read vor vorherige Instruktionen
+ * gezogen wird (wichtig für Zeitmessungen).
+ */
+static inline uint64_t arch_counter(void) {
+    ISB();
+    return READ_SYSREG(cntpct_el0);
+}
+
+/**
+ * @brief Frequenz des Counters in Hz (CNTFRQ_EL0, RPi3: 19.2 MHz)
+ */
+static inline uint32_t arch_counter_freq(void) {
+    return (uint32_t)READ_SYSREG(cntfrq_el0);
+}
+
+/**
+ * @brief Startet den PMU Zyklenzähler (PMCCNTR_EL0, 64-bit)
+ *
+ * PMCR_EL0.E + LC, PMCNTENSET_EL0.C. PMCCFILTR_EL0.NSH muss gesetzt sein,
+ * sonst zählt der Zähler in (Non-secure) EL2 nicht - dort läuft Core 3.
+ */
+static inline void arch_cycles_init(void) {
+    WRITE_SYSREG(pmccfiltr_el0, 1UL << 27);
+    WRITE_SYSREG(pmcr_el0, READ_SYSREG(pmcr_el0) | (1 << 0) | (1 << 6));
+    WRITE_SYSREG(pmcntenset_el0, 1UL << 31);
+    ISB();
+}
+
+/**
+ * @brief CPU-Zyklen seit arch_cycles_init() (PMCCNTR_EL0)
+ */
+static inline uint64_t arch_cycles(void) {
+    ISB();
+    return READ_SYSREG(pmccntr_el0);
+}
+
+#endif /* AMP_HOST */
+
+#endif /* ARCH_H */
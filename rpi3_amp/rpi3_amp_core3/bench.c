@@ -0,0 +1,344 @@
+/**
+ * @file bench.c
+ * @brief Boot-Benchmark Implementierung
+ */
+
+#include "bench.h"
+#include "arch.h"
+#include "dma.h"
+#include "ipc.h"
+#include "memlib.h"
+#include "memory.h"
+#include "memtest.h"
+#include "timer.h"
+#include "uart.h"
+#include "trace.h"
+
+_Static_assert((BENCH_IPC_SLOTS & (BENCH_IPC_SLOTS - 1)) == 0,
+               "BENCH_IPC_SLOTS muss eine Zweierpotenz sein");
+_Static_assert(BENCH_PRINTF_BATCH * 64 <= UART_TX_BUF_SIZE,
+               "BENCH_PRINTF_BATCH Zeilen passen nicht in den TX-Ring");
+_Static_assert(sizeof(ipc_ring_ctrl_t) + BENCH_IPC_SLOTS * IPC_SLOT_SIZE <= SHARED_MEMTEST_SIZE,
+               "Loopback-Ring passt nicht ins Memtest-Fenster");
+
+/*============================================================================
+ * Hilfsfunktionen
+ *============================================================================*/
+
+static uint32_t rate_per_sec(uint32_t count, uint64_t elapsed_us) {
+    if (elapsed_us == 0) elapsed_us = 1;
+    return (uint32_t)((uint64_t)count * 1000000ULL / elapsed_us);
+}
+
+/*============================================================================
+ * Einzelne Benchmarks
+ *============================================================================*/
+
+/* Mittlere MB/s eines Pattern-Tests über das Memtest-Fenster */
+static uint32_t bench_memtest(memtest_impl_t impl) {
+    memtest_impl_t prev = memtest_get_impl();
+    memtest_result_t res;
+    uint64_t sum = 0;
+
+    memtest_set_impl(impl);
+    for (uint32_t i = 0; i < BENCH_MEM_ROUNDS; i++) {
+        memtest_pattern(SHARED_MEMTEST_ADDR, SHARED_MEMTEST_SIZE, MEMTEST_PATTERN_AA, &res);
+        sum += res.mbps;
+    }
+    memtest_set_impl(prev);
+
+    return (uint32_t)(sum / BENCH_MEM_ROUNDS);
+}
+
+/*
+ * Loopback über einen eigenen Ring: abwechselnd einen halben Ring füllen
+ * und wieder leeren, damit auch peer_cache nachgeladen werden muss.
+ * Gibt 0 zurück, wenn eine Nachricht verfälscht ankommt.
+ */
+static uint32_t bench_ipc_loopback(uint32_t count) {
+    ipc_ring_ctrl_t *ctrl = (ipc_ring_ctrl_t *)SHARED_MEMTEST_ADDR;
+    uint8_t *slots = (uint8_t *)(SHARED_MEMTEST_ADDR + sizeof(ipc_ring_ctrl_t));
+    ipc_ring_t tx, rx;
+    uint32_t sent = 0, received = 0;
+    uint64_t start;
+
+    ipc_ring_init(&tx, ctrl, slots, IPC_SLOT_SIZE, BENCH_IPC_SLOTS);
+    rx = tx;
+
+    start = timer_get_ticks();
+    while (received < count) {
+        for (uint32_t i = 0; i < BENCH_IPC_SLOTS / 2 && sent < count; i++) {
+            ipc_msg_t *msg = (ipc_msg_t *)ipc_ring_reserve(&tx);
+            if (!msg) {
+                break;
+            }
+            msg->type = IPC_MSG_BENCH_DATA;
+            msg->length = sizeof(uint32_t);
+            *(uint32_t *)msg->data = sent++;
+            ipc_ring_commit(&tx);
+        }
+
+        ipc_msg_t *msg;
+        while ((msg = (ipc_msg_t *)ipc_ring_peek(&rx)) != NULL) {
+            if (msg->type != IPC_MSG_BENCH_DATA || *(const uint32_t *)msg->data != received) {
+                return 0;
+            }
+            ipc_ring_release(&rx);
+            received++;
+        }
+    }
+
+    return rate_per_sec(count, timer_get_ticks() - start);
+}
+
+/* Zeilen mit gemischten Formaten, jede ca. 40 Zeichen */
+static uint32_t bench_printf(uint32_t lines) {
+    uint64_t start = timer_get_ticks();
+
+    for (uint32_t i = 0; i < lines; i++) {
+        uart_printf("[BENCH] %u 0x%x %d %s\n", i, i * 0x9E3779B9u, -(int)i, "printf");
+    }
+    uart_flush();
+
+    return rate_per_sec(lines, timer_get_ticks() - start);
+}
+
+typedef void (*bench_printf_fn)(const char *fmt, ...);
+
+/*
+ * Zyklen pro Aufruf: Minimum über BENCH_PRINTF_ROUNDS Blöcke. Vor jedem
+ * Block wird der TX-Ring geleert, damit nur Formatierung und Kopie in den
+ * Ring gemessen werden und nicht das Warten auf die UART.
+ */
+static uint32_t bench_printf_cycles(bench_printf_fn fn) {
+    uint64_t best = ~0ULL;
+
+    for (uint32_t r = 0; r < BENCH_PRINTF_ROUNDS; r++) {
+        uart_flush();
+        uint64_t start = arch_cycles();
+        for (uint32_t i = 0; i < BENCH_PRINTF_BATCH; i++) {
+            fn("[BENCH] %u %x %d %s\n", i, i * 0x9E3779B9u, -(int)i, "cycles");
+        }
+        uint64_t elapsed = arch_cycles() - start;
+        if (elapsed < best) {
+            best = elapsed;
+        }
+    }
+    uart_flush();
+
+    return (uint32_t)(best / BENCH_PRINTF_BATCH);
+}
+
+typedef uint64_t (*bench_timer_fn)(void);
+
+/*
+ * Zyklen pro Read: Minimum über BENCH_TIMER_ROUNDS Blöcke. Die Summe geht
+ * in ein leeres asm, damit der Compiler keinen Aufruf streicht.
+ */
+static uint32_t bench_timer_cycles(bench_timer_fn fn) {
+    uint64_t best = ~0ULL;
+
+    for (uint32_t r = 0; r < BENCH_TIMER_ROUNDS; r++) {
+        uint64_t sum = 0;
+        uint64_t start = arch_cycles();
+        for (uint32_t i = 0; i < BENCH_TIMER_CALLS; i++) {
+            sum += fn();
+        }
+        uint64_t elapsed = arch_cycles() - start;
+        asm volatile("" :: "r"(sum));
+        if (elapsed < best) {
+            best = elapsed;
+        }
+    }
+
+    return (uint32_t)(best / BENCH_TIMER_CALLS);
+}
+
+/* Core 3 RAM: Ziel für Kopien aus dem ganzen Shared Memory, memlib-Puffer */
+static uint8_t g_dma_ram[SHARED_MEM_SIZE] __attribute__((aligned(64)));
+
+/* MB/s (Byte/µs) für BENCH_DMA_BYTES in Stücken zu len, src == NULL füllt */
+static uint32_t bench_copy(void *dst, const void *src, uint32_t len, bool dma) {
+    uint32_t rounds = len < BENCH_DMA_BYTES ? BENCH_DMA_BYTES / len : 1;
+    uint64_t start = timer_get_ticks();
+
+    for (uint32_t r = 0; r < rounds; r++) {
+        if (dma) {
+            int32_t rc = src ? dma_memcpy_start(dst, src, len) : dma_memset_start(dst, 0xA5A5A5A5, len);
+            if (rc != DMA_OK || dma_wait(DMA_TIMEOUT_US) != DMA_OK) {
+                return 0;
+            }
+        } else if (src) {
+            dma_cpu_copy(dst, src, len);
+        } else {
+            dma_cpu_fill(dst, 0xA5A5A5A5, len);
+        }
+    }
+
+    uint64_t elapsed = timer_get_ticks() - start;
+    return (uint32_t)((uint64_t)len * rounds / (elapsed ? elapsed : 1));
+}
+
+static void bench_dma(bench_result_t *result) {
+    void *shm = (void *)SHARED_MEM_BASE;
+    void *window = (void *)SHARED_MEMTEST_ADDR;
+
+    for (uint32_t i = 0; i < BENCH_DMA_SIZES; i++) {
+        /* 4 KB .. 1 MB in Viererschritten, zuletzt das ganze Shared Memory */
+        uint32_t len = i + 1 < BENCH_DMA_SIZES ? 4096U << (2 * i) : SHARED_MEM_SIZE;
+        bool fits = len <= SHARED_MEMTEST_SIZE;
+
+        result->dma_sizes[i] = len;
+        result->dma_in_mbps[i] = bench_copy(g_dma_ram, shm, len, true);
+        result->cpu_in_mbps[i] = bench_copy(g_dma_ram, shm, len, false);
+        result->dma_out_mbps[i] = fits ? bench_copy(window, g_dma_ram, len, true) : 0;
+        result->cpu_out_mbps[i] = fits ? bench_copy(window, g_dma_ram, len, false) : 0;
+        result->dma_fill_mbps[i] = fits ? bench_copy(window, NULL, len, true) : 0;
+        result->cpu_fill_mbps[i] = fits ? bench_copy(window, NULL, len, false) : 0;
+    }
+}
+
+/* Byte-Schleife wie str_copy() vor memlib, volatile: sonst wird sie zu memcpy() */
+static void *byte_copy(void *dst, const void *src, size_t n) {
+    volatile uint8_t *d = (volatile uint8_t *)dst;
+    const volatile uint8_t *s = (const volatile uint8_t *)src;
+
+    while (n--) {
+        *d++ = *s++;
+    }
+    return dst;
+}
+
+typedef void *(*bench_copy_fn)(void *dst, const void *src, size_t n);
+
+/* MB/s für BENCH_MEMLIB_BYTES in Aufrufen zu len, copy == NULL: memset(fill) */
+static uint32_t bench_memlib_one(bench_copy_fn copy, int fill, uint32_t len) {
+    uint8_t *src = g_dma_ram;
+    uint8_t *dst = g_dma_ram + SHARED_MEM_SIZE / 2;
+    uint32_t rounds = BENCH_MEMLIB_BYTES / len;
+    uint64_t start = timer_get_ticks();
+
+    for (uint32_t r = 0; r < rounds; r++) {
+        if (copy) {
+            copy(dst, src, len);
+        } else {
+            memset(dst, fill, len);
+        }
+        /* Jeder Durchlauf zählt: GCC darf gleiche Stores nicht zusammenlegen */
+        asm volatile("" ::: "memory");
+    }
+
+    uint64_t elapsed = timer_get_ticks() - start;
+    return (uint32_t)((uint64_t)len * rounds / (elapsed ? elapsed : 1));
+}
+
+static void bench_memlib(bench_result_t *result) {
+    for (uint32_t i = 0; i < BENCH_MEMLIB_SIZES; i++) {
+        uint32_t len = 16U << (2 * i);
+
+        result->memlib_sizes[i] = len;
+        result->memcpy_mbps[i] = bench_memlib_one(memcpy, 0, len);
+        result->bytecopy_mbps[i] = bench_memlib_one(byte_copy, 0, len);
+        result->memset_mbps[i] = bench_memlib_one(NULL, 0xA5, len);
+        result->memzero_mbps[i] = bench_memlib_one(NULL, 0, len);
+    }
+}
+
+/*============================================================================
+ * Öffentliche Funktionen
+ *============================================================================*/
+
+bool bench_run_phase(uint32_t phase, bench_result_t *result) {
+    if (phase >= BENCH_PHASES) {
+        return false;
+    }
+
+    TRACE_BEGIN(TRACE_EV_BENCH, phase);
+    switch (phase) {
+        case BENCH_PHASE_MEMORY:
+            result->mem_scalar_mbps = bench_memtest(MEMTEST_IMPL_SCALAR);
+            result->mem_wide_mbps = bench_memtest(MEMTEST_IMPL_WIDE);
+            break;
+        case BENCH_PHASE_IPC:
+            result->ipc_rate = bench_ipc_loopback(BENCH_IPC_MESSAGES);
+            break;
+        case BENCH_PHASE_PRINTF:
+            result->printf_rate = bench_printf(BENCH_PRINTF_LINES);
+            arch_cycles_init();
+            result->legacy_cycles = bench_printf_cycles(uart_printf_legacy);
+            result->printf_cycles = bench_printf_cycles(uart_printf);
+            break;
+        case BENCH_PHASE_DMA:
+            bench_dma(result);
+            break;
+        case BENCH_PHASE_MEMLIB:
+            bench_memlib(result);
+            break;
+        default:
+            arch_cycles_init();
+            result->timer_systimer_cycles = bench_timer_cycles(timer_read_systimer);
+            result->timer_counter_cycles = bench_timer_cycles(timer_read_counter);
+            result->timer_ticks_cycles = bench_timer_cycles(timer_get_ticks);
+            break;
+    }
+    TRACE_END(TRACE_EV_BENCH, phase);
+    return true;
+}
+
+void bench_run(bench_result_t *result) {
+    bench_result_t res;
+
+    uart_puts("\nRunning boot benchmark...\n");
+
+    for (uint32_t phase = 0; phase < BENCH_PHASES; phase++) {
+        bench_run_phase(phase, &res);
+    }
+
+    uart_printf("  Memory  : %u MB/s scalar, %u MB/s wide\n",
+                res.mem_scalar_mbps, res.mem_wide_mbps);
+    uart_printf("  IPC ring: %u msgs/s (loopback, %u slots x %u bytes)\n",
+                res.ipc_rate, BENCH_IPC_SLOTS, IPC_SLOT_SIZE);
+    uart_printf("  printf  : %u lines/s\n", res.printf_rate);
+    uart_printf("  printf  : %u cycles/call, legacy %u cycles/call\n",
+                res.printf_cycles, res.legacy_cycles);
+    uart_printf("  timer   : systimer %u, cntpct %u, timer_get_ticks (%s) %u cycles/call\n",
+                res.timer_systimer_cycles, res.timer_counter_cycles,
+                timer_source_name(), res.timer_ticks_cycles);
+    uart_printf("  DMA     : channel %d%s, MB/s dma / cpu (- = not measured)\n",
+                dma_channel(), dma_is_lite() ? " lite" : "");
+    uart_puts("      size   shm -> ram     ram -> shm     fill shm\n");
+    for (uint32_t i = 0; i < BENCH_DMA_SIZES; i++) {
+        const uint32_t *col[6] = { res.dma_in_mbps, res.cpu_in_mbps, res.dma_out_mbps,
+                                   res.cpu_out_mbps, res.dma_fill_mbps, res.cpu_fill_mbps };
+        uart_printf("   %5u KB", res.dma_sizes[i] / 1024);
+        for (uint32_t c = 0; c < 6; c += 2) {
+            if (col[c + 1][i] == 0) {
+                uart_puts("         -    ");
+            } else if (col[c][i] == 0) {
+                uart_printf("     - / %-5u", col[c + 1][i]);
+            } else {
+                uart_printf("  %4u / %-5u", col[c][i], col[c + 1][i]);
+            }
+        }
+        uart_puts("\n");
+    }
+    uart_puts("  memlib  : MB/s in Core 3 RAM\n");
+    uart_puts("      size   memcpy / bytes   memset / zero\n");
+    for (uint32_t i = 0; i < BENCH_MEMLIB_SIZES; i++) {
+        uart_printf("   %6u B  %6u / %-6u  %6u / %-6u\n", res.memlib_sizes[i],
+                    res.memcpy_mbps[i], res.bytecopy_mbps[i],
+                    res.memset_mbps[i], res.memzero_mbps[i]);
+    }
+
+    shared_mem_set_bench_printf(res.printf_cycles, res.legacy_cycles);
+    shared_mem_set_bench_timer(res.timer_systimer_cycles, res.timer_counter_cycles,
+                               res.timer_ticks_cycles);
+    shared_mem_set_bench(res.mem_scalar_mbps, res.mem_wide_mbps,
+                         res.ipc_rate, res.printf_rate);
+    uart_puts(BENCH_DONE_MARKER "\n");
+    uart_flush();
+
+    if (result) {
+        *result = res;
+    }
+}
@@ -0,0 +1,120 @@
+/**
+ * @file bench.h
+ * @brief Boot-Benchmark: Memory Test, IPC Ring und Formatierung
+ *
+ * Mit AMP_BENCH_BOOT=1 (make qemu-bench) läuft bench_run() einmal beim
+ * Boot, ohne dass Linux mitspielen muss:
+ *
+ *   Memory   : Pattern Fill+Verify über das Memtest-Fenster, Scalar- und
+ *              Wide-Pfad, Mittel über BENCH_MEM_ROUNDS Durchläufe
+ *   IPC Ring : Loopback auf einem eigenen Ring im Memtest-Fenster,
+ *              Core 3 ist Producer und Consumer (reine Ring-Kosten)
+ *   printf   : BENCH_PRINTF_LINES formatierte Zeilen über uart_printf,
+ *              inklusive Ausgabe - unter QEMU praktisch nur Formatierung
+ *   Zyklen   : CPU-Zyklen pro Aufruf von uart_printf und uart_printf_legacy,
+ *              in Blöcken von BENCH_PRINTF_BATCH Zeilen, die in den TX-Ring
+ *              passen (Warten auf die UART wird nicht mitgezählt)
+ *   Timer    : CPU-Zyklen pro Read von System Timer, CNTPCT_EL0 und
+ *              timer_get_ticks() (gewählte Quelle + Umrechnung in µs)
+ *   DMA      : DMA gegen CPU-Kopie (dma.h) von 4 KB bis 2 MB: Shared Memory
+ *              -> Core 3 RAM, zurück ins Memtest-Fenster und Füllen dort
+ *              (die beiden letzten nur bis SHARED_MEMTEST_SIZE)
+ *   memlib   : memcpy / memset aus memlib.S von 16 Byte bis 256 KB im
+ *              Core 3 RAM, gegen eine Byte-Schleife; memset(0) mit DC ZVA
+ *
+ * Die Ergebnisse landen im Status-Block (bench_*), danach wird
+ * BENCH_DONE_MARKER ausgegeben. Das Memtest-Fenster wird überschrieben.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "common.h"
+
+/*============================================================================
+ * Konfiguration
+ *============================================================================*/
+
+#define BENCH_MEM_ROUNDS        8
+#define BENCH_IPC_MESSAGES      100000
+#define BENCH_IPC_SLOTS         32      /* Loopback-Ring (Zweierpotenz) */
+#define BENCH_PRINTF_LINES      1000
+#define BENCH_PRINTF_BATCH      32      /* Zeilen pro Messung (< TX-Ring) */
+#define BENCH_PRINTF_ROUNDS     8       /* Minimum über so viele Messungen */
+#define BENCH_TIMER_CALLS       256     /* Reads pro Messung */
+#define BENCH_TIMER_ROUNDS      8
+#define BENCH_DMA_SIZES         6       /* 4 KB, 16 KB, 64 KB, 256 KB, 1 MB, 2 MB */
+#define BENCH_DMA_BYTES         0x400000 /* Bytes pro Messung (Wiederholungen) */
+#define BENCH_MEMLIB_SIZES      8       /* 16 Byte .. 256 KB in Viererschritten */
+#define BENCH_MEMLIB_BYTES      0x100000 /* Bytes pro Messung (Wiederholungen) */
+
+/* Teile des Benchmarks (bench_run_phase, TRACE_EV_BENCH arg0) */
+#define BENCH_PHASE_MEMORY      0
+#define BENCH_PHASE_IPC         1
+#define BENCH_PHASE_PRINTF      2
+#define BENCH_PHASE_TIMER       3
+#define BENCH_PHASE_DMA         4
+#define BENCH_PHASE_MEMLIB      5
+#define BENCH_PHASES            6
+
+/* Zeile auf UART0, nach der qemu/qemu_bench.sh den Status ausliest */
+#define BENCH_DONE_MARKER       "BENCH DONE"
+
+/*============================================================================
+ * Typen
+ *============================================================================*/
+
+typedef struct {
+    uint32_t mem_scalar_mbps;   /* Memory Test Scalar-Pfad */
+    uint32_t mem_wide_mbps;     /* Memory Test Wide-Pfad (= scalar ohne NEON) */
+    uint32_t ipc_rate;          /* Nachrichten/s durch den Loopback-Ring */
+    uint32_t printf_rate;       /* uart_printf Zeilen/s */
+    uint32_t printf_cycles;     /* Zyklen pro uart_printf Aufruf */
+    uint32_t legacy_cycles;     /* Zyklen pro uart_printf_legacy Aufruf */
+    uint32_t timer_systimer_cycles; /* Zyklen pro timer_read_systimer() */
+    uint32_t timer_counter_cycles;  /* Zyklen pro timer_read_counter() */
+    uint32_t timer_ticks_cycles;    /* Zyklen pro timer_get_ticks() */
+    /* MB/s pro Größe, 0 = nicht gemessen (kein DMA-Kanal / größer als das Fenster) */
+    uint32_t dma_sizes[BENCH_DMA_SIZES];
+    uint32_t dma_in_mbps[BENCH_DMA_SIZES];  /* Shared Memory -> Core 3 RAM */
+    uint32_t cpu_in_mbps[BENCH_DMA_SIZES];
+    uint32_t dma_out_mbps[BENCH_DMA_SIZES]; /* Core 3 RAM -> Memtest-Fenster */
+    uint32_t cpu_out_mbps[BENCH_DMA_SIZES];
+    uint32_t dma_fill_mbps[BENCH_DMA_SIZES]; /* Memtest-Fenster füllen */
+    uint32_t cpu_fill_mbps[BENCH_DMA_SIZES];
+    /* MB/s pro Größe, Core 3 RAM (cachebar) */
+    uint32_t memlib_sizes[BENCH_MEMLIB_SIZES];
+    uint32_t memcpy_mbps[BENCH_MEMLIB_SIZES];
+    uint32_t bytecopy_mbps[BENCH_MEMLIB_SIZES]; /* Byte-Schleife zum Vergleich */
+    uint32_t memset_mbps[BENCH_MEMLIB_SIZES];   /* Muster 0xA5: stp */
+    uint32_t memzero_mbps[BENCH_MEMLIB_SIZES];  /* 0: ab 256 Byte DC ZVA */
+} bench_result_t;
+
+/*============================================================================
+ * Funktionen
+ *============================================================================*/
+
+/**
+ * @brief Führt alle Benchmarks aus, gibt sie aus und trägt sie in den
+ *        Status-Block ein
+ *
+ * Blockiert einige Sekunden (auf dem Pi vor allem die UART-Ausgabe).
+ * Nach shared_mem_init() und vor sched_start() aufrufen.
+ *
+ * @param result Wird gefüllt (darf NULL sein)
+ */
+void bench_run(bench_result_t *result);
+
+/**
+ * @brief Führt einen Teil des Benchmarks aus (ohne Ausgabe, ohne Status-Block)
+ *
+ * Füllt nur die Felder der Phase in result. Memory, IPC und DMA überschreiben
+ * das Memtest-Fenster, printf schreibt BENCH_PRINTF_LINES Zeilen auf UART0.
+ *
+ * @param phase BENCH_PHASE_*
+ * @param result Wird teilweise gefüllt
+ * @return false bei ungültiger Phase
+ */
+bool bench_run_phase(uint32_t phase, bench_result_t *result);
+
+#endif /* BENCH_H */
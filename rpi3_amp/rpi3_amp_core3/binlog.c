@@ -0,0 +1,206 @@
+/**
+ * @file binlog.c
+ * @brief Binäres Log Implementierung
+ */
+
+#include "binlog.h"
+
+#if AMP_LOG_BINARY
+
+/* Anfang der Section "logfmt" (link.ld, im Host-Build vom Linker) */
+extern const char __start_logfmt[];
+
+/* Sync + len + payload + Prüfsumme */
+#define FRAME_SIZE      (2 + LOG_PAYLOAD_MAX + 2)
+
+typedef struct {
+    uint8_t  buf[FRAME_SIZE];
+    uint32_t len;           /* Belegte Bytes in buf */
+    bool     full;          /* Argument passte nicht mehr, Rest entfällt */
+} frame_t;
+
+/*============================================================================
+ * Kodierung
+ *============================================================================*/
+
+static uint32_t frame_room(const frame_t *f) {
+    return 2 + LOG_PAYLOAD_MAX - f->len;
+}
+
+static void put_varint(frame_t *f, uint64_t v) {
+    uint8_t tmp[10];
+    uint32_t n = 0;
+
+    do {
+        tmp[n] = (uint8_t)(v & 0x7F);
+        v >>= 7;
+        if (v) {
+            tmp[n] |= 0x80;
+        }
+        n++;
+    } while (v);
+
+    if (f->full || n > frame_room(f)) {
+        f->full = true;
+        return;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        f->buf[f->len++] = tmp[i];
+    }
+}
+
+/* Kleine negative Zahlen bleiben kurz: 0,-1,1,-2 -> 0,1,2,3 */
+static void put_signed(frame_t *f, int64_t v) {
+    put_varint(f, ((uint64_t)v << 1) ^ (uint64_t)(v >> 63));
+}
+
+static void put_string(frame_t *f, const char *s) {
+    uint32_t len = 0;
+
+    if (!s) {
+        s = "(null)";
+    }
+    while (s[len]) {
+        len++;
+    }
+
+    /* Kürzen, damit Längenfeld (max. 2 Bytes) und Text noch passen */
+    if (f->full || frame_room(f) < 2) {
+        f->full = true;
+        return;
+    }
+    uint32_t max = frame_room(f) - (len < 0x80 ? 1 : 2);
+    if (len > max) {
+        len = max;
+    }
+    put_varint(f, len);
+    for (uint32_t i = 0; i < len; i++) {
+        f->buf[f->len++] = (uint8_t)s[i];
+    }
+}
+
+/* Fletcher-16 (mod 255) */
+static uint16_t fletcher16(const uint8_t *p, uint32_t len) {
+    uint32_t a = 0, b = 0;
+
+    for (uint32_t i = 0; i < len; i++) {
+        a = (a + p[i]) % 255;
+        b = (b + a) % 255;
+    }
+    return (uint16_t)((b << 8) | a);
+}
+
+/*============================================================================
+ * Öffentliche Funktionen
+ *============================================================================*/
+
+void binlog_frame(const char *fmt, ...) {
+    frame_t f;
+    __builtin_va_list args;
+
+    f.len = 2;
+    f.full = false;
+    put_varint(&f, (uint64_t)(fmt - __start_logfmt));
+
+    /*
+     * Nur die Konversionen auswerten, um die Argumente in der richtigen
+     * Breite zu holen - Text und Flags bleiben dem Decoder überlassen.
+     */
+    __builtin_va_start(args, fmt);
+    while (*fmt) {
+        if (*fmt++ != '%') {
+            continue;
+        }
+        while (*fmt == '-' || *fmt == '0' || *fmt == '#' || *fmt == '+' || *fmt == ' ') {
+            fmt++;
+        }
+        if (*fmt == '*') {
+            put_signed(&f, __builtin_va_arg(args, int));
+            fmt++;
+        }
+        while (*fmt >= '0' && *fmt <= '9') {
+            fmt++;
+        }
+        if (*fmt == '.') {
+            fmt++;
+            if (*fmt == '*') {
+                put_signed(&f, __builtin_va_arg(args, int));
+                fmt++;
+            }
+            while (*fmt >= '0' && *fmt <= '9') {
+                fmt++;
+            }
+        }
+
+        uint32_t shorts = 0;
+        uint32_t longs = 0;
+        bool size = false;
+        while (*fmt == 'h') {
+            shorts++;
+            fmt++;
+        }
+        while (*fmt == 'l') {
+            longs++;
+            fmt++;
+        }
+        if (*fmt == 'z') {
+            size = true;
+            fmt++;
+        }
+
+        char conv = *fmt;
+        if (conv) {
+            fmt++;
+        }
+        switch (conv) {
+            case 'd':
+            case 'i':
+                if (longs >= 2)     put_signed(&f, __builtin_va_arg(args, long long));
+                else if (longs)     put_signed(&f, __builtin_va_arg(args, long));
+                else if (size)      put_signed(&f, (int64_t)__builtin_va_arg(args, size_t));
+                else if (shorts >= 2) put_signed(&f, (signed char)__builtin_va_arg(args, int));
+                else if (shorts)    put_signed(&f, (short)__builtin_va_arg(args, int));
+                else                put_signed(&f, __builtin_va_arg(args, int));
+                break;
+            case 'u':
+            case 'x':
+            case 'X':
+                if (longs >= 2)     put_varint(&f, __builtin_va_arg(args, unsigned long long));
+                else if (longs)     put_varint(&f, __builtin_va_arg(args, unsigned long));
+                else if (size)      put_varint(&f, __builtin_va_arg(args, size_t));
+                else if (shorts >= 2) put_varint(&f, (unsigned char)__builtin_va_arg(args, unsigned int));
+                else if (shorts)    put_varint(&f, (unsigned short)__builtin_va_arg(args, unsigned int));
+                else                put_varint(&f, __builtin_va_arg(args, unsigned int));
+                break;
+            case 'p':
+                put_varint(&f, (uintptr_t)__builtin_va_arg(args, void *));
+                break;
+            case 'c': {
+                uint8_t c = (uint8_t)__builtin_va_arg(args, int);
+                if (!f.full && frame_room(&f) >= 1) {
+                    f.buf[f.len++] = c;
+                } else {
+                    f.full = true;
+                }
+                break;
+            }
+            case 's':
+                put_string(&f, __builtin_va_arg(args, const char *));
+                break;
+            default:
+                /* %% und Unbekanntes: kein Argument */
+                break;
+        }
+    }
+    __builtin_va_end(args);
+
+    f.buf[0] = LOG_FRAME_SYNC;
+    f.buf[1] = (uint8_t)(f.len - 2);
+    uint16_t sum = fletcher16(&f.buf[1], f.len - 1);
+    f.buf[f.len++] = (uint8_t)(sum & 0xFF);
+    f.buf[f.len++] = (uint8_t)(sum >> 8);
+
+    uart_write(f.buf, f.len);
+}
+
+#endif /* AMP_LOG_BINARY */
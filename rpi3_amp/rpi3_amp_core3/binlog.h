@@ -0,0 +1,85 @@
+/**
+ * @file binlog.h
+ * @brief Binäres Log über UART0: Format-ID + rohe Argumente statt Text
+ *
+ * Mit LOG_BINARY=1 (make LOG_BINARY=1) schickt LOG_PRINTF keinen Text,
+ * sondern einen Frame mit der ID des Format-Strings und den Argumenten.
+ * Die Format-Strings liegen in der Section "logfmt" (link.ld), die ID ist
+ * der Offset darin. linux_tools/log_decode liest die Section aus dem ELF
+ * (kernel8.elf bzw. core3_host) und formatiert den Text auf dem Host.
+ *
+ * Frame (alle Felder Bytes, Mehrbyte-Werte little-endian):
+ *
+ *   0x1E | len | payload[len] | fletcher16 (2)
+ *
+ *   payload = varint(ID), danach pro Argument in Format-Reihenfolge:
+ *     %d %i        : zigzag varint
+ *     %u %x %X %p  : varint
+ *     * (Breite/Präz.) : zigzag varint
+ *     %c           : 1 Byte
+ *     %s           : varint(Länge) + Bytes (gekürzt, falls der Frame voll ist)
+ *   Prüfsumme: Fletcher-16 über len und payload
+ *
+ * 0x1E (ASCII Record Separator) kommt in der Textausgabe nicht vor; der
+ * Decoder reicht alles außerhalb gültiger Frames als Text durch, normale
+ * uart_puts/uart_printf Ausgabe darf also weiter gemischt werden.
+ *
+ * Ein Frame geht am Stück in den TX-Ring oder (UART_TX_DROP) gar nicht.
+ * Mit LOG_BINARY=0 ist LOG_PRINTF einfach uart_printf.
+ */
+
+#ifndef BINLOG_H
+#define BINLOG_H
+
+#include "common.h"
+#include "uart.h"
+
+/*============================================================================
+ * Konfiguration
+ *============================================================================*/
+
+#ifndef AMP_LOG_BINARY
+#define AMP_LOG_BINARY      0
+#endif
+
+#define LOG_FRAME_SYNC      0x1E
+#define LOG_PAYLOAD_MAX     255     /* len ist ein Byte */
+
+/*============================================================================
+ * Makros
+ *============================================================================*/
+
+#if AMP_LOG_BINARY
+
+/*
+ * Der Format-String landet nur in "logfmt". Der nie ausgeführte
+ * uart_printf Aufruf sorgt dafür, dass GCC die Argumente trotzdem prüft.
+ */
+#define LOG_PRINTF(fmt, ...)                                                \
+    do {                                                                    \
+        static const char _log_fmt[] __attribute__((section("logfmt"))) = fmt; \
+        if (0) {                                                            \
+            uart_printf(fmt, ##__VA_ARGS__);                                \
+        }                                                                   \
+        binlog_frame(_log_fmt, ##__VA_ARGS__);                              \
+    } while (0)
+
+#else
+
+#define LOG_PRINTF(fmt, ...)    uart_printf(fmt, ##__VA_ARGS__)
+
+#endif
+
+/*============================================================================
+ * Funktionen
+ *============================================================================*/
+
+/**
+ * @brief Schickt einen Log-Frame (nur über LOG_PRINTF aufrufen)
+ *
+ * @param fmt Format-String in der Section "logfmt"
+ * @param ... Argumente wie bei uart_printf
+ */
+void binlog_frame(const char *fmt, ...);
+
+#endif /* BINLOG_H */
@@ -0,0 +1,348 @@
+/**
+ * @file cmd.c
+ * @brief Kommando-Queue Implementierung
+ */
+
+#include "cmd.h"
+#include "bench.h"
+#include "csum.h"
+#include "memory.h"
+#include "mmu.h"
+#include "sched.h"
+#include "timer.h"
+
+_Static_assert(sizeof(cmd_req_t) == 32 && sizeof(cmd_done_t) == 32, "cmd_*_t Layout");
+_Static_assert(sizeof(cmd_shared_t) <= SHARED_CMD_SIZE,
+               "cmd_shared_t passt nicht in SHARED_CMD");
+_Static_assert((CMD_SLOTS & (CMD_SLOTS - 1)) == 0, "CMD_SLOTS muss eine Zweierpotenz sein");
+
+/* Memtest-Bereiche: Ausrichtung für den Wide-Pfad (64 Byte pro Durchlauf) */
+#define CMD_MEMTEST_ALIGN   64
+
+typedef int32_t (*cmd_fn_t)(const cmd_req_t *req, uint32_t *value);
+
+/*============================================================================
+ * Private Variablen
+ *============================================================================*/
+
+static cmd_shared_t *g_cmd = NULL;
+static ipc_ring_t g_submit;         /* Core 3 ist Consumer */
+static ipc_ring_t g_done;           /* Core 3 ist Producer */
+static uint32_t g_executed = 0;
+static uint32_t g_failed = 0;
+static uint32_t g_batches = 0;
+static uint32_t g_max_batch = 0;
+
+/*============================================================================
+ * Handler
+ *============================================================================*/
+
+static int32_t cmd_nop(const cmd_req_t *req, uint32_t *value) {
+    (void)req;
+    (void)value;
+    return CMD_OK;
+}
+
+/* Bereich vollständig in [start, end) */
+static bool inside(uint64_t addr, uint64_t size, uint64_t start, uint64_t end) {
+    return addr >= start && addr + size <= end;
+}
+
+/*
+ * Was ein Job überschreiben darf: nur der Job-Puffer. Memtest-Fenster und
+ * freien Bereich überschreibt der Scrubber (scrub.h) im Hintergrund, dort
+ * geschriebene Daten wären nicht stabil.
+ */
+static bool writable(uint64_t offset, uint64_t size) {
+    uint64_t job = SHARED_JOB_ADDR - SHARED_MEM_BASE;
+
+    return inside(offset, size, job, job + SHARED_JOB_SIZE);
+}
+
+/* Daten von Linux: bei cacheable Shared Memory erst aus dem Cache werfen */
+static uintptr_t job_data(uint64_t offset, uint32_t size) {
+    uintptr_t addr = (uintptr_t)(SHARED_MEM_BASE + offset);
+
+    if (size && mmu_is_cacheable(addr)) {
+        dcache_clean_invalidate_range(addr, size);
+    }
+    return addr;
+}
+
+/* Nur was der Memtest überschreiben darf: Memtest-Fenster und freies Shared Memory */
+static int32_t cmd_memtest(const cmd_req_t *req, uint32_t *value) {
+    uint64_t offset = req->arg[0];
+    uint64_t size = req->arg[1];
+    uint64_t memtest = SHARED_MEMTEST_ADDR - SHARED_MEM_BASE;
+    uint64_t unused = SHARED_FREE_ADDR - SHARED_MEM_BASE;
+    uint32_t errors;
+
+    if (size == 0 || (offset | size) & (CMD_MEMTEST_ALIGN - 1)) {
+        return CMD_E_INVAL;
+    }
+    if (!inside(offset, size, memtest, memtest + SHARED_MEMTEST_SIZE) &&
+        !inside(offset, size, unused, SHARED_MEM_SIZE)) {
+        return CMD_E_INVAL;
+    }
+
+    errors = memory_test_full((uintptr_t)(SHARED_MEM_BASE + offset), (uint32_t)size, false);
+    value[0] = errors;
+    value[1] = (uint32_t)size;
+    return errors ? CMD_E_FAILED : CMD_OK;
+}
+
+static int32_t cmd_set_heartbeat(const cmd_req_t *req, uint32_t *value) {
+    uint32_t ms = req->arg[0];
+    int id = sched_find("heartbeat");
+    shared_status_t *status = shared_mem_get_status();
+
+    if (id < 0 || ms < CMD_HEARTBEAT_MIN_MS || ms > CMD_HEARTBEAT_MAX_MS) {
+        return CMD_E_INVAL;
+    }
+
+    value[0] = status ? status->heartbeat_interval_ms : 0;
+    if (!sched_set_period(id, ms * 1000)) {
+        return CMD_E_INVAL;
+    }
+    shared_mem_set_heartbeat_interval(ms);
+    return CMD_OK;
+}
+
+static int32_t cmd_run_bench(const cmd_req_t *req, uint32_t *value) {
+    uint32_t phase = req->arg[0];
+    bench_result_t res;
+
+    if (phase == BENCH_PHASES) {
+        bench_run(&res);
+        value[0] = res.mem_scalar_mbps;
+        value[1] = res.mem_wide_mbps;
+        value[2] = res.ipc_rate;
+        value[3] = res.printf_rate;
+        return CMD_OK;
+    }
+    if (!bench_run_phase(phase, &res)) {
+        return CMD_E_INVAL;
+    }
+
+    switch (phase) {
+        case BENCH_PHASE_MEMORY:
+            value[0] = res.mem_scalar_mbps;
+            value[1] = res.mem_wide_mbps;
+            break;
+        case BENCH_PHASE_IPC:
+            /* 0 = Nachricht verfälscht angekommen */
+            value[0] = res.ipc_rate;
+            if (res.ipc_rate == 0) {
+                return CMD_E_FAILED;
+            }
+            break;
+        case BENCH_PHASE_PRINTF:
+            value[0] = res.printf_rate;
+            value[1] = res.printf_cycles;
+            value[2] = res.legacy_cycles;
+            break;
+        case BENCH_PHASE_DMA:
+            /* Ganzes Shared Memory -> RAM und volles Memtest-Fenster zurück */
+            value[0] = res.dma_in_mbps[BENCH_DMA_SIZES - 1];
+            value[1] = res.cpu_in_mbps[BENCH_DMA_SIZES - 1];
+            value[2] = res.dma_out_mbps[2];
+            value[3] = res.cpu_out_mbps[2];
+            break;
+        case BENCH_PHASE_MEMLIB:
+            /* 4 KB: memcpy, Byte-Schleife, memset, memset(0) */
+            value[0] = res.memcpy_mbps[4];
+            value[1] = res.bytecopy_mbps[4];
+            value[2] = res.memset_mbps[4];
+            value[3] = res.memzero_mbps[4];
+            break;
+        default:
+            value[0] = res.timer_systimer_cycles;
+            value[1] = res.timer_counter_cycles;
+            value[2] = res.timer_ticks_cycles;
+            break;
+    }
+    return CMD_OK;
+}
+
+/* CRC32 / CRC32C / Adler-32 über einen beliebigen Bereich im Shared Memory */
+static int32_t cmd_checksum(const cmd_req_t *req, uint32_t *value) {
+    uint32_t offset = req->arg[0];
+    uint32_t len = req->arg[1];
+    const void *data;
+
+    if (!inside(offset, len, 0, SHARED_MEM_SIZE)) {
+        return CMD_E_INVAL;
+    }
+
+    data = (const void *)job_data(offset, len);
+    switch (req->op) {
+        case CMD_OP_CRC32:
+            value[0] = csum_crc32(req->arg[2], data, len);
+            break;
+        case CMD_OP_CRC32C:
+            value[0] = csum_crc32c(req->arg[2], data, len);
+            break;
+        default:
+            value[0] = csum_adler32(req->arg[2], data, len);
+            break;
+    }
+    value[1] = len;
+    return CMD_OK;
+}
+
+static int32_t cmd_fill(const cmd_req_t *req, uint32_t *value) {
+    uint32_t offset = req->arg[0];
+    uint32_t len = req->arg[1];
+    uint32_t pattern = req->arg[2];
+    uintptr_t addr;
+
+    if ((offset | len) & 3 || !writable(offset, len)) {
+        return CMD_E_INVAL;
+    }
+
+    addr = (uintptr_t)(SHARED_MEM_BASE + offset);
+    uint32_t *w = (uint32_t *)addr;
+    for (uint32_t i = 0; i < len / 4; i++) {
+        w[i] = pattern;
+    }
+    /* Linux liest am Cache vorbei */
+    if (len && mmu_is_cacheable(addr)) {
+        dcache_clean_range(addr, len);
+    }
+    DSB();
+
+    value[0] = len;
+    return CMD_OK;
+}
+
+static int32_t cmd_compare(const cmd_req_t *req, uint32_t *value) {
+    uint32_t len = req->arg[2];
+    const uint8_t *a;
+    const uint8_t *b;
+    uint32_t i = 0;
+
+    if (!inside(req->arg[0], len, 0, SHARED_MEM_SIZE) ||
+        !inside(req->arg[1], len, 0, SHARED_MEM_SIZE)) {
+        return CMD_E_INVAL;
+    }
+
+    a = (const uint8_t *)job_data(req->arg[0], len);
+    b = (const uint8_t *)job_data(req->arg[1], len);
+
+    /* Gleich ausgerichtet: 8 Byte pro Vergleich bis zum ersten Unterschied */
+    if (((uintptr_t)a & 7) == 0 && ((uintptr_t)b & 7) == 0) {
+        const uint64_t *wa = (const uint64_t *)a;
+        const uint64_t *wb = (const uint64_t *)b;
+        while (i + 8 <= len && wa[i / 8] == wb[i / 8]) {
+            i += 8;
+        }
+    }
+    while (i < len && a[i] == b[i]) {
+        i++;
+    }
+
+    value[0] = i;
+    value[1] = len;
+    return CMD_OK;
+}
+
+/* Dispatch-Tabelle, Index = op */
+static const cmd_fn_t g_table[CMD_OP_COUNT] = {
+    [CMD_OP_NOP]           = cmd_nop,
+    [CMD_OP_MEMTEST]       = cmd_memtest,
+    [CMD_OP_SET_HEARTBEAT] = cmd_set_heartbeat,
+    [CMD_OP_RUN_BENCH]     = cmd_run_bench,
+    [CMD_OP_CRC32]         = cmd_checksum,
+    [CMD_OP_CRC32C]        = cmd_checksum,
+    [CMD_OP_ADLER32]       = cmd_checksum,
+    [CMD_OP_FILL]          = cmd_fill,
+    [CMD_OP_COMPARE]       = cmd_compare,
+};
+
+/*============================================================================
+ * Implementierung
+ *============================================================================*/
+
+void cmd_init(void) {
+    cmd_shared_t *c = (cmd_shared_t *)SHARED_CMD_ADDR;
+
+    g_cmd = NULL;
+    c->magic = 0;
+    c->req_size = sizeof(cmd_req_t);
+    c->done_size = sizeof(cmd_done_t);
+    c->slot_count = CMD_SLOTS;
+    c->executed = 0;
+    c->failed = 0;
+    c->batches = 0;
+    c->max_batch = 0;
+    g_executed = 0;
+    g_failed = 0;
+    g_batches = 0;
+    g_max_batch = 0;
+
+    ipc_ring_init(&g_submit, &c->submit, c->submit_slots, sizeof(cmd_req_t), CMD_SLOTS);
+    ipc_ring_init(&g_done, &c->done, c->done_slots, sizeof(cmd_done_t), CMD_SLOTS);
+
+    /* Magic zuletzt: Linux reiht erst ein, wenn beide Ringe stehen */
+    STORE_RELEASE(&c->magic, CMD_MAGIC);
+    g_cmd = c;
+}
+
+bool cmd_pending(void) {
+    return g_cmd && ipc_ring_peek(&g_submit) != NULL;
+}
+
+uint32_t cmd_poll(void) {
+    uint32_t count = 0;
+    cmd_req_t *req;
+    cmd_done_t *done;
+
+    if (!g_cmd) {
+        return 0;
+    }
+
+    while (count < CMD_BATCH && (req = (cmd_req_t *)ipc_ring_peek(&g_submit)) != NULL) {
+        /* Ohne freien Completion-Slot liegen lassen, Linux holt erst ab */
+        done = (cmd_done_t *)ipc_ring_reserve(&g_done);
+        if (!done) {
+            break;
+        }
+
+        /* Kopie, damit Linux den Slot schon wieder füllen kann */
+        cmd_req_t r = *req;
+        ipc_ring_release(&g_submit);
+
+        uint32_t value[CMD_VALUES] = { 0, 0, 0, 0 };
+        uint64_t start = timer_get_ticks();
+        int32_t result = (r.op < CMD_OP_COUNT && g_table[r.op]) ?
+                         g_table[r.op](&r, value) : CMD_E_UNKNOWN;
+        uint64_t elapsed = timer_get_ticks() - start;
+
+        done->id = r.id;
+        done->op = r.op;
+        done->result = result;
+        done->elapsed_us = elapsed > 0xFFFFFFFFULL ? 0xFFFFFFFF : (uint32_t)elapsed;
+        for (uint32_t i = 0; i < CMD_VALUES; i++) {
+            done->value[i] = value[i];
+        }
+        ipc_ring_commit(&g_done);
+
+        g_executed++;
+        if (result != CMD_OK) {
+            g_failed++;
+        }
+        count++;
+    }
+
+    if (count) {
+        g_batches++;
+        if (count > g_max_batch) {
+            g_max_batch = count;
+        }
+        g_cmd->executed = g_executed;
+        g_cmd->failed = g_failed;
+        g_cmd->batches = g_batches;
+        g_cmd->max_batch = g_max_batch;
+    }
+    return count;
+}
@@ -0,0 +1,128 @@
+/**
+ * @file cmd.h
+ * @brief Kommando-Queue: Linux steuert Core 3 zur Laufzeit (SHARED_CMD_ADDR)
+ *
+ * Zwei SPSC Ringe (ipc_ring_*, wie beim Pool) mit Slots fester Größe:
+ *
+ *   submit : Linux  -> Core 3, cmd_req_t  {id, op, arg[6]}
+ *   done   : Core 3 -> Linux,  cmd_done_t {id, op, result, elapsed_us, value[4]}
+ *
+ * cmd_poll() läuft in jeder Runde der Hauptschleife, nimmt bis zu
+ * CMD_BATCH Kommandos, schlägt den Handler in einer Tabelle nach op nach
+ * und schreibt für jedes Kommando genau einen Completion-Record mit
+ * Ergebnis (CMD_OK / CMD_E_*), Laufzeit und bis zu vier Werten. Ist der
+ * done-Ring voll, bleiben die Kommandos liegen bis Linux abholt.
+ *
+ * Offload-Jobs (CRC32, CRC32C, ADLER32, FILL, COMPARE) rechnen auf Daten
+ * im Shared Memory, adressiert als Offset ab SHARED_MEM_BASE. Lesen darf
+ * ein Job überall im Shared Memory, schreiben (FILL) nur im Job-Puffer
+ * (SHARED_JOB_ADDR) - Memtest-Fenster und freien Bereich überschreibt der
+ * Scrubber. Die Queue
+ * arbeitet die Jobs in Reihenfolge ab, Linux darf die Daten eines Jobs
+ * erst nach seiner Completion wieder ändern.
+ *
+ * Die Kommandos laufen im Kontext der Hauptschleife: ein langer MEMTEST
+ * oder RUN_BENCH verschiebt die Scheduler-Tasks (zählt dort als Miss).
+ *
+ * Linux: linux_tools/amp_cmd.
+ */
+
+#ifndef CMD_H
+#define CMD_H
+
+#include "common.h"
+#include "ipc.h"
+
+/*============================================================================
+ * Konfiguration
+ *============================================================================*/
+
+#define CMD_MAGIC           0x51444D43  /* "CMDQ" */
+#define CMD_SLOTS           64          /* Pro Ring, Zweierpotenz */
+#define CMD_BATCH           8           /* Kommandos pro cmd_poll() */
+#define CMD_ARGS            6
+#define CMD_VALUES          4
+
+/* Kommandos (op) */
+#define CMD_OP_NOP              0   /* Sofort fertig (Latenz der Queue) */
+#define CMD_OP_MEMTEST          1   /* arg = {offset, size} im Shared Memory: value = {errors, bytes} */
+#define CMD_OP_SET_HEARTBEAT    2   /* arg = {ms}: value = {alt_ms} */
+#define CMD_OP_RUN_BENCH        3   /* arg = {BENCH_PHASE_* oder BENCH_PHASES = alle} */
+#define CMD_OP_CRC32            4   /* arg = {offset, len, crc}: value = {crc, len} */
+#define CMD_OP_CRC32C           5   /* arg = {offset, len, crc}: value = {crc, len} */
+#define CMD_OP_ADLER32          6   /* arg = {offset, len, adler}: value = {adler, len} */
+#define CMD_OP_FILL             7   /* arg = {offset, len, pattern}, 4 Byte aligned: value = {len} */
+#define CMD_OP_COMPARE          8   /* arg = {offset_a, offset_b, len}: value = {erste Abweichung oder len, len} */
+#define CMD_OP_COUNT            9
+
+/* Ergebnis (result) */
+#define CMD_OK              0
+#define CMD_E_UNKNOWN       (-1)    /* op nicht in der Tabelle */
+#define CMD_E_INVAL         (-2)    /* Argument ungültig */
+#define CMD_E_FAILED        (-3)    /* Ausgeführt, aber fehlgeschlagen (z.B. Memtest-Fehler) */
+
+/* Grenzen für CMD_OP_SET_HEARTBEAT */
+#define CMD_HEARTBEAT_MIN_MS    10
+#define CMD_HEARTBEAT_MAX_MS    3600000
+
+/*============================================================================
+ * Shared Memory Strukturen (MÜSSEN mit linux_tools/amp_shared.h übereinstimmen!)
+ *============================================================================*/
+
+typedef struct {
+    uint32_t id;                /* Von Linux vergeben, kommt in cmd_done_t zurück */
+    uint32_t op;                /* CMD_OP_* */
+    uint32_t arg[CMD_ARGS];
+} cmd_req_t;
+
+typedef struct {
+    uint32_t id;
+    uint32_t op;
+    int32_t  result;            /* CMD_OK / CMD_E_* */
+    uint32_t elapsed_us;        /* Laufzeit des Handlers */
+    uint32_t value[CMD_VALUES]; /* Ergebnis, je nach op */
+} cmd_done_t;
+
+/* Layout von SHARED_CMD_ADDR */
+typedef struct {
+    /* Cache-Line 0: Geometrie read-only, Zähler nur von Core 3 geschrieben */
+    uint32_t magic;             /* CMD_MAGIC, wird zuletzt gesetzt */
+    uint32_t req_size;          /* sizeof(cmd_req_t) */
+    uint32_t done_size;         /* sizeof(cmd_done_t) */
+    uint32_t slot_count;        /* CMD_SLOTS */
+    volatile uint32_t executed; /* Bearbeitete Kommandos */
+    volatile uint32_t failed;   /* Davon mit result != CMD_OK */
+    volatile uint32_t batches;  /* cmd_poll() Aufrufe mit mindestens einem Kommando */
+    volatile uint32_t max_batch;
+    uint8_t  _pad0[IPC_CACHE_LINE - 32];
+
+    ipc_ring_ctrl_t submit;
+    ipc_ring_ctrl_t done;
+
+    cmd_req_t  submit_slots[CMD_SLOTS];
+    cmd_done_t done_slots[CMD_SLOTS];
+} cmd_shared_t;
+
+/*============================================================================
+ * Funktionen
+ *============================================================================*/
+
+/**
+ * @brief Legt beide Ringe in SHARED_CMD_ADDR an
+ *
+ * Nach ipc_init() aufrufen. Noch nicht abgeholte Kommandos gehen verloren.
+ */
+void cmd_init(void);
+
+/**
+ * @brief Prüft ob Linux Kommandos eingereiht hat
+ */
+bool cmd_pending(void);
+
+/**
+ * @brief Bearbeitet bis zu CMD_BATCH Kommandos (aus der Hauptschleife)
+ * @return Anzahl bearbeiteter Kommandos
+ */
+uint32_t cmd_poll(void);
+
+#endif /* CMD_H */
@@ -6,6 +6,9 @@
  * Typdefinitionen für die modulare Firmware.
  * 
  * HINWEIS: Da wir -nostdinc verwenden, definieren wir alle Typen selbst!
+ *
+ * Host-Build (AMP_HOST, make host): Typen kommen aus der libc, Peripherie
+ * und Shared Memory liegen in einem memfd (host/host.c).
  */
 
 #ifndef COMMON_H
@@ -15,6 +18,18 @@
  * Standard-Typdefinitionen (kein stdint.h in bare-metal!)
  *============================================================================*/
 
+#ifdef AMP_HOST
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef unsigned int        uint;
+typedef int                 bool;
+#define true                1
+#define false               0
+
+#else
+
 typedef unsigned char       uint8_t;
 typedef unsigned short      uint16_t;
 typedef unsigned int        uint32_t;
@@ -28,7 +43,7 @@ typedef signed long long    int64_t;
 typedef unsigned long       uintptr_t;
 typedef long                intptr_t;
 
-typedef unsigned int        size_t;
+typedef unsigned long       size_t;
 
 typedef unsigned int        uint;
 typedef int                 bool;
@@ -40,12 +55,24 @@ typedef int                 bool;
 #define NULL ((void *)0)
 #endif
 
+#endif /* AMP_HOST */
+
 /*============================================================================
  * RPi3 BCM2837 Hardware-Adressen
  *============================================================================*/
 
+#ifdef AMP_HOST
+/* Host-Build: Basisadressen der memfd-Mappings, gesetzt von host_init() */
+extern uintptr_t host_periph_base;
+extern uintptr_t host_shared_base;
+#endif
+
 /* Peripheral Base - KRITISCH: RPi3 = 0x3F000000, RPi4 = 0xFE000000! */
+#ifdef AMP_HOST
+#define PERIPHERAL_BASE     host_periph_base
+#else
 #define PERIPHERAL_BASE     0x3F000000
+#endif
 
 /* ARM Local Peripherals - Für Mailboxes und lokale Interrupts */
 #define ARM_LOCAL_BASE      0x40000000
@@ -59,6 +86,9 @@ typedef int                 bool;
 /* System Timer - 1 MHz Zähler */
 #define SYSTIMER_BASE       (PERIPHERAL_BASE + 0x003000)
 
+/* DMA-Controller, Kanäle 0..14 im Abstand von 0x100 */
+#define DMA_BASE            (PERIPHERAL_BASE + 0x007000)
+
 /*============================================================================
  * AMP Memory Map
  *============================================================================*/
@@ -68,7 +98,11 @@ typedef int                 bool;
 #define AMP_CODE_SIZE       0x00A00000  /* 10 MB */
 
 /* Shared Memory für IPC (Linux ↔ Core 3) */
+#ifdef AMP_HOST
+#define SHARED_MEM_BASE     host_shared_base
+#else
 #define SHARED_MEM_BASE     0x20A00000
+#endif
 #define SHARED_MEM_SIZE     0x00200000  /* 2 MB */
 
 /*============================================================================
@@ -87,6 +121,49 @@ typedef int                 bool;
 #define SHARED_MEMTEST_ADDR     (SHARED_MEM_BASE + 0x2000)
 #define SHARED_MEMTEST_SIZE     0x10000 /* 64 KB */
 
+/* IPC Slot-Speicher für die SPSC Ringe (Steuerblöcke liegen in SHARED_DATA) */
+#define SHARED_IPC_SLOTS_ADDR   (SHARED_MEM_BASE + 0x12000)
+#define SHARED_IPC_SLOTS_SIZE   0x40000 /* 256 KB */
+
+/* Scrubber: Fehler-Bitmap pro 4 KB Seite */
+#define SHARED_SCRUB_ADDR       (SHARED_MEM_BASE + 0x52000)
+#define SHARED_SCRUB_SIZE       0x1000  /* 4 KB */
+
+/* Trace-Ring: binäre Events von Core 3 (trace.h) */
+#define SHARED_TRACE_ADDR       (SHARED_MEM_BASE + 0x53000)
+#define SHARED_TRACE_SIZE       0x10000 /* 64 KB */
+
+/* Zero-Copy Buffer-Pool: Steuerblock + 2 KB / 64 KB Puffer (pool.h) */
+#define SHARED_POOL_ADDR        (SHARED_MEM_BASE + 0x63000)
+#define SHARED_POOL_SIZE        0x142000 /* 8 KB + 256 KB + 1 MB */
+
+/* SoC-Telemetrie: Takt/Temperatur/Throttling Samples (telem.h) */
+#define SHARED_TELEM_ADDR       (SHARED_MEM_BASE + 0x1A5000)
+#define SHARED_TELEM_SIZE       0x3000  /* 12 KB */
+
+/* Zyklen-Messpunkte: Statistik pro PROBE_BEGIN/END Stelle (probe.h) */
+#define SHARED_PROBE_ADDR       (SHARED_MEM_BASE + 0x1A8000)
+#define SHARED_PROBE_SIZE       0x1000  /* 4 KB */
+
+/* PC-Sampling Profiler: Ring mit ELR + Aufrufkette (prof.h) */
+#define SHARED_PROF_ADDR        (SHARED_MEM_BASE + 0x1A9000)
+#define SHARED_PROF_SIZE        0x11000 /* 68 KB */
+
+/* Kommando-Queue: Linux -> Core 3 Kommandos + Completions (cmd.h) */
+#define SHARED_CMD_ADDR         (SHARED_MEM_BASE + 0x1BA000)
+#define SHARED_CMD_SIZE         0x2000  /* 8 KB */
+
+/* Job-Puffer: Daten für Offload-Kommandos, gehören Linux (cmd.h) */
+#define SHARED_JOB_ADDR         (SHARED_MEM_BASE + 0x1BC000)
+#define SHARED_JOB_SIZE         0x30000 /* 192 KB */
+
+/* DSP-Pipeline: Konfiguration + in/out Blockringe (dsp.h) */
+#define SHARED_DSP_ADDR         (SHARED_MEM_BASE + 0x1EC000)
+#define SHARED_DSP_SIZE         0x10000 /* 64 KB */
+
+/* Ab hier unbenutzt - neue Bereiche davor einfügen und FREE verschieben */
+#define SHARED_FREE_ADDR        (SHARED_MEM_BASE + 0x1FC000)
+
 /*============================================================================
  * Magic Numbers und Versionen
  *============================================================================*/
@@ -103,8 +180,22 @@ typedef int                 bool;
 #define REG64(addr)         (*(volatile uint64_t *)(addr))
 
 /* Memory Barriers */
+#ifdef AMP_HOST
+#define DMB()               __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define DSB()               __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define ISB()               asm volatile("" ::: "memory")
+#else
 #define DMB()               asm volatile("dmb sy" ::: "memory")
 #define DSB()               asm volatile("dsb sy" ::: "memory")
 #define ISB()               asm volatile("isb" ::: "memory")
+#endif
+
+/*
+ * Acquire/Release Zugriffe für Shared-Memory Indizes.
+ * Erzeugt ldar/stlr statt eines vollen DSB - ordnet nur die Zugriffe,
+ * die für das Producer/Consumer Protokoll nötig sind.
+ */
+#define LOAD_ACQUIRE(p)     __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
 
 #endif /* COMMON_H */
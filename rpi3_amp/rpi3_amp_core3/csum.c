@@ -0,0 +1,138 @@
+/**
+ * @file csum.c
+ * @brief Prüfsummen-Kernels Implementierung
+ */
+
+#include "csum.h"
+
+/* Reflektierte Polynome (LSB zuerst) */
+#define CRC32_POLY          0xEDB88320
+#define CRC32C_POLY         0x82F63B78
+
+#define ADLER_MOD           65521
+#define ADLER_NMAX          5552    /* Größter Block ohne Überlauf von b (zlib) */
+
+/*============================================================================
+ * CRC
+ *============================================================================*/
+
+#if CSUM_HAVE_CRC
+
+/* Ein Befehl pro Byte bzw. 8 Byte, crc32* und crc32c* gleich aufgebaut */
+#define CRC_INSNS(name, insn_b, insn_x)                                     \
+static inline uint32_t name##_b(uint32_t crc, uint8_t v) {                  \
+    asm(insn_b " %w0, %w0, %w1" : "+r"(crc) : "r"((uint32_t)v));            \
+    return crc;                                                             \
+}                                                                           \
+static inline uint32_t name##_x(uint32_t crc, uint64_t v) {                 \
+    asm(insn_x " %w0, %w0, %x1" : "+r"(crc) : "r"(v));                      \
+    return crc;                                                             \
+}
+
+CRC_INSNS(crc32, "crc32b", "crc32x")
+CRC_INSNS(crc32c, "crc32cb", "crc32cx")
+
+/* Kopf bis zur 8-Byte Grenze, Rumpf mit 64-bit Loads (4x abgerollt), Rest */
+#define CRC_BODY(name)                                                      \
+    const uint8_t *p = (const uint8_t *)buf;                                \
+    const uint64_t *w;                                                      \
+                                                                            \
+    crc = ~crc;                                                             \
+    while (len && ((uintptr_t)p & 7)) {                                     \
+        crc = name##_b(crc, *p++);                                          \
+        len--;                                                              \
+    }                                                                       \
+    w = (const uint64_t *)p;                                                \
+    for (; len >= 32; len -= 32, w += 4) {                                  \
+        crc = name##_x(crc, w[0]);                                          \
+        crc = name##_x(crc, w[1]);                                          \
+        crc = name##_x(crc, w[2]);                                          \
+        crc = name##_x(crc, w[3]);                                          \
+    }                                                                       \
+    for (; len >= 8; len -= 8) {                                            \
+        crc = name##_x(crc, *w++);                                          \
+    }                                                                       \
+    p = (const uint8_t *)w;                                                 \
+    while (len--) {                                                         \
+        crc = name##_b(crc, *p++);                                          \
+    }                                                                       \
+    return ~crc
+
+uint32_t csum_crc32(uint32_t crc, const void *buf, uint32_t len) {
+    CRC_BODY(crc32);
+}
+
+uint32_t csum_crc32c(uint32_t crc, const void *buf, uint32_t len) {
+    CRC_BODY(crc32c);
+}
+
+#else /* !CSUM_HAVE_CRC */
+
+/* Bitweise, nur für den Host-Build */
+static uint32_t crc_bitwise(uint32_t crc, const uint8_t *p, uint32_t len, uint32_t poly) {
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (poly & (0U - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+uint32_t csum_crc32(uint32_t crc, const void *buf, uint32_t len) {
+    return crc_bitwise(crc, (const uint8_t *)buf, len, CRC32_POLY);
+}
+
+uint32_t csum_crc32c(uint32_t crc, const void *buf, uint32_t len) {
+    return crc_bitwise(crc, (const uint8_t *)buf, len, CRC32C_POLY);
+}
+
+#endif /* CSUM_HAVE_CRC */
+
+/*============================================================================
+ * Adler-32
+ *============================================================================*/
+
+#define ADLER_BYTE(v, shift)    do { a += (uint8_t)((v) >> (shift)); b += a; } while (0)
+
+uint32_t csum_adler32(uint32_t adler, const void *buf, uint32_t len) {
+    const uint8_t *p = (const uint8_t *)buf;
+    uint32_t a = adler & 0xFFFF;
+    uint32_t b = adler >> 16;
+
+    while (len) {
+        uint32_t n = len < ADLER_NMAX ? len : ADLER_NMAX;
+        const uint64_t *w;
+
+        len -= n;
+        while (n && ((uintptr_t)p & 7)) {
+            a += *p++;
+            b += a;
+            n--;
+        }
+
+        /* Ein 64-bit Load pro 8 Byte, Little Endian = Speicherreihenfolge */
+        w = (const uint64_t *)p;
+        for (; n >= 8; n -= 8) {
+            uint64_t v = *w++;
+            ADLER_BYTE(v, 0);
+            ADLER_BYTE(v, 8);
+            ADLER_BYTE(v, 16);
+            ADLER_BYTE(v, 24);
+            ADLER_BYTE(v, 32);
+            ADLER_BYTE(v, 40);
+            ADLER_BYTE(v, 48);
+            ADLER_BYTE(v, 56);
+        }
+        p = (const uint8_t *)w;
+        while (n--) {
+            a += *p++;
+            b += a;
+        }
+
+        a %= ADLER_MOD;
+        b %= ADLER_MOD;
+    }
+    return (b << 16) | a;
+}
@@ -0,0 +1,49 @@
+/**
+ * @file csum.h
+ * @brief Prüfsummen-Kernels für Offload-Jobs: CRC32, CRC32C, Adler-32
+ *
+ * CRC32 (IEEE 802.3, zlib) und CRC32C (Castagnoli, iSCSI) laufen über die
+ * CRC-Befehle des A53 (crc32x / crc32cx, 8 Byte pro Befehl), Adler-32 in C.
+ * Gelesen wird nach einem kurzen Kopf nur mit ausgerichteten 64-bit
+ * Loads - auf dem nicht-cachebaren Shared Memory zählt jeder Bus-Zugriff.
+ *
+ * Die Schnittstelle ist die von zlib: der Wert des vorigen Blocks geht
+ * hinein, Start mit 0 (CRC) bzw. 1 (Adler-32). Inversion vor/nach der CRC
+ * passiert intern, Ergebnisse sind also direkt mit crc32() / crc32c()
+ * unter Linux vergleichbar.
+ *
+ * Im Host-Build gibt es die Befehle nicht, dort rechnet eine bitweise
+ * C-Variante dieselben Werte.
+ */
+
+#ifndef CSUM_H
+#define CSUM_H
+
+#include "common.h"
+
+/* CRC-Befehle nur auf aarch64 (Inline-Assembler), im Host-Build bitweise */
+#ifdef AMP_HOST
+#define CSUM_HAVE_CRC       0
+#else
+#define CSUM_HAVE_CRC       1
+#endif
+
+/**
+ * @brief CRC32 (Polynom 0x04C11DB7, reflektiert)
+ * @param crc Ergebnis des vorigen Blocks, 0 am Anfang
+ */
+uint32_t csum_crc32(uint32_t crc, const void *buf, uint32_t len);
+
+/**
+ * @brief CRC32C (Polynom 0x1EDC6F41, reflektiert)
+ * @param crc Ergebnis des vorigen Blocks, 0 am Anfang
+ */
+uint32_t csum_crc32c(uint32_t crc, const void *buf, uint32_t len);
+
+/**
+ * @brief Adler-32 (RFC 1950)
+ * @param adler Ergebnis des vorigen Blocks, 1 am Anfang
+ */
+uint32_t csum_adler32(uint32_t adler, const void *buf, uint32_t len);
+
+#endif /* CSUM_H */
@@ -0,0 +1,357 @@
+/**
+ * @file dma.c
+ * @brief DMA-Controller Implementierung
+ */
+
+#include "dma.h"
+#include "memlib.h"
+#include "mmu.h"
+#include "timer.h"
+
+/* Register pro Kanal */
+#define DMA_CH(ch)          (DMA_BASE + (uintptr_t)(ch) * 0x100)
+#define DMA_CS(ch)          REG32(DMA_CH(ch) + 0x00)
+#define DMA_CONBLK_AD(ch)   REG32(DMA_CH(ch) + 0x04)
+#define DMA_DEBUG(ch)       REG32(DMA_CH(ch) + 0x20)
+#define DMA_ENABLE          REG32(DMA_BASE + 0xFF0)
+
+#define DMA_CS_ACTIVE       (1U << 0)
+#define DMA_CS_END          (1U << 1)   /* W1C */
+#define DMA_CS_INT          (1U << 2)   /* W1C */
+#define DMA_CS_ERROR        (1U << 8)
+#define DMA_CS_PRIORITY(n)  ((uint32_t)(n) << 16)
+#define DMA_CS_PANIC(n)     ((uint32_t)(n) << 20)
+#define DMA_CS_WAIT_WRITES  (1U << 28)  /* END erst nach den letzten Write-Responses */
+#define DMA_CS_RESET        (1U << 31)
+
+#define DMA_TI_WAIT_RESP    (1U << 3)
+#define DMA_TI_DEST_INC     (1U << 4)
+#define DMA_TI_DEST_WIDTH   (1U << 5)   /* 128 bit */
+#define DMA_TI_SRC_INC      (1U << 8)
+#define DMA_TI_SRC_WIDTH    (1U << 9)   /* 128 bit */
+#define DMA_TI_BURST(n)     ((uint32_t)(n) << 12)
+
+#define DMA_DEBUG_ERRORS    0x7         /* READ_LAST_NOT_SET, FIFO, READ (W1C) */
+#define DMA_DEBUG_LITE      (1U << 28)
+
+/* ARM physikalisch -> Bus, RAM ohne VideoCore L2 */
+#define DMA_BUS(addr)       ((uint32_t)(uintptr_t)(addr) | 0xC0000000)
+
+/* Kontrollblock, vom Controller aus dem RAM gelesen */
+typedef struct {
+    uint32_t ti;
+    uint32_t source_ad;
+    uint32_t dest_ad;
+    uint32_t txfr_len;
+    uint32_t stride;
+    uint32_t nextconbk;
+    uint32_t _reserved[2];
+} __attribute__((aligned(32))) dma_cb_t;
+
+_Static_assert(sizeof(dma_cb_t) == 32, "dma_cb_t muss 32 Byte groß sein");
+
+/*============================================================================
+ * Private Variablen
+ *============================================================================*/
+
+static uint32_t g_pattern[4] __attribute__((aligned(DMA_ALIGN)));
+
+static int32_t g_channel = -1;
+static bool g_lite = false;
+static uint32_t g_chunk = DMA_CHUNK;
+
+/* Laufender Transfer */
+static bool g_active = false;
+static int32_t g_result = DMA_OK;
+
+#if DMA_HAVE_ENGINE
+static dma_cb_t g_cbs[DMA_MAX_CBS];
+static uintptr_t g_dst = 0;
+static uint32_t g_len = 0;
+#endif
+
+static dma_stats_t g_stats;
+
+/*============================================================================
+ * CPU-Pfad
+ *============================================================================*/
+
+void dma_cpu_copy(void *dst, const void *src, uint32_t len) {
+    memcpy(dst, src, len);
+}
+
+void dma_cpu_fill(void *dst, uint32_t pattern, uint32_t len) {
+    uint8_t *d8 = (uint8_t *)dst;
+    uint32_t i = 0;
+
+    /* Gleiche Bytes (0, 0xFF, ...): memset, bei 0 mit DC ZVA */
+    if (pattern == (pattern & 0xFF) * 0x01010101U) {
+        memset(dst, (int)(pattern & 0xFF), len);
+        return;
+    }
+
+    if (((uintptr_t)dst & 7) == 0) {
+        uint64_t *d = (uint64_t *)dst;
+        uint64_t v = pattern | (uint64_t)pattern << 32;
+        for (; len >= 32; len -= 32, d += 4) {
+            d[0] = v;
+            d[1] = v;
+            d[2] = v;
+            d[3] = v;
+        }
+        for (; len >= 8; len -= 8) {
+            *d++ = v;
+        }
+        d8 = (uint8_t *)d;
+    }
+
+    /* Rest bzw. unausgerichtet: bytewise, Muster in Speicher-Reihenfolge */
+    for (; i < len; i++) {
+        d8[i] = (uint8_t)(pattern >> ((i & 3) * 8));
+    }
+}
+
+/*============================================================================
+ * DMA-Pfad
+ *============================================================================*/
+
+#if DMA_HAVE_ENGINE
+
+/* Kette aus CBs bauen und starten; src_inc = 0 liest immer denselben Block */
+static int32_t start(uintptr_t dst, uintptr_t src, uint32_t len, bool src_inc) {
+    uint32_t ti, count;
+
+    if (g_channel < 0 || len == 0 || ((dst | src | len) & (DMA_ALIGN - 1))) {
+        return DMA_E_UNAVAIL;
+    }
+    if (g_active) {
+        return DMA_E_BUSY;
+    }
+    count = (len + g_chunk - 1) / g_chunk;
+    if (count > DMA_MAX_CBS) {
+        return DMA_E_UNAVAIL;
+    }
+
+    /* Lite-Kanäle: 32-bit Zugriffe, keine Bursts */
+    ti = DMA_TI_DEST_INC | DMA_TI_WAIT_RESP;
+    if (!g_lite) {
+        ti |= DMA_TI_DEST_WIDTH | DMA_TI_SRC_WIDTH | DMA_TI_BURST(4);
+    }
+    if (src_inc) {
+        ti |= DMA_TI_SRC_INC;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t off = i * g_chunk;
+        uint32_t n = len - off < g_chunk ? len - off : g_chunk;
+        dma_cb_t *cb = &g_cbs[i];
+
+        cb->ti = ti;
+        cb->source_ad = DMA_BUS(src_inc ? src + off : src);
+        cb->dest_ad = DMA_BUS(dst + off);
+        cb->txfr_len = n;
+        cb->stride = 0;
+        cb->nextconbk = i + 1 < count ? DMA_BUS(&g_cbs[i + 1]) : 0;
+    }
+
+    /* Der Controller liest CBs und Quelle am Cache vorbei */
+    dcache_clean_range((uintptr_t)g_cbs, count * sizeof(dma_cb_t));
+    if (mmu_is_cacheable(src)) {
+        dcache_clean_range(src, src_inc ? len : sizeof(g_pattern));
+    }
+    if (mmu_is_cacheable(dst)) {
+        dcache_clean_invalidate_range(dst, len);
+    }
+
+    g_dst = dst;
+    g_len = len;
+    g_active = true;
+    g_result = DMA_E_BUSY;
+
+    DMA_CS(g_channel) = DMA_CS_END | DMA_CS_INT;
+    DMA_DEBUG(g_channel) = DMA_DEBUG_ERRORS;
+    DMA_CONBLK_AD(g_channel) = DMA_BUS(&g_cbs[0]);
+    DSB();
+    DMA_CS(g_channel) = DMA_CS_ACTIVE | DMA_CS_WAIT_WRITES |
+                        DMA_CS_PRIORITY(8) | DMA_CS_PANIC(15);
+    return DMA_OK;
+}
+
+static void finish(int32_t result) {
+    /* Zeilen, die die CPU währenddessen spekulativ geladen hat, verwerfen */
+    if (mmu_is_cacheable(g_dst)) {
+        dcache_clean_invalidate_range(g_dst, g_len);
+    }
+    if (result == DMA_OK) {
+        g_stats.transfers++;
+        g_stats.bytes += g_len;
+    } else {
+        g_stats.errors++;
+    }
+    g_result = result;
+    g_active = false;
+}
+
+void dma_init(void) {
+    int32_t ch = DMA_CHANNEL;
+
+    g_channel = -1;
+    g_active = false;
+    g_result = DMA_OK;
+    g_stats = (dma_stats_t){ 0 };
+
+    if (ch < 0 || ch > 14) {
+        return;
+    }
+
+    /*
+     * Nur lesen: ENABLE teilen sich alle Kanäle (Read-Modify-Write würde
+     * mit Linux kollidieren), und ein Reset träfe einen Kanal, den Linux
+     * vergeben hat und der gerade nur ruht. Die Firmware schaltet alle
+     * Kanäle beim Boot frei.
+     */
+    if (!(DMA_ENABLE & (1U << ch))) {
+        return;
+    }
+    if ((DMA_CS(ch) & (DMA_CS_ACTIVE | DMA_CS_ERROR)) || DMA_CONBLK_AD(ch) != 0 ||
+        (DMA_DEBUG(ch) & DMA_DEBUG_ERRORS)) {
+        /* Läuft, hängt an einer Kette oder hat Fehler - gehört jemand anderem */
+        return;
+    }
+
+    g_lite = (DMA_DEBUG(ch) & DMA_DEBUG_LITE) != 0;
+    g_chunk = g_lite ? DMA_LITE_CHUNK : DMA_CHUNK;
+    g_channel = ch;
+}
+
+int32_t dma_poll(void) {
+    uint32_t cs;
+
+    if (!g_active) {
+        return g_result;
+    }
+
+    cs = DMA_CS(g_channel);
+    if (cs & DMA_CS_ERROR) {
+        DMA_CS(g_channel) = DMA_CS_RESET;
+        finish(DMA_E_ERROR);
+    } else if (!(cs & DMA_CS_ACTIVE) && (cs & DMA_CS_END)) {
+        DMA_CS(g_channel) = DMA_CS_END | DMA_CS_INT;
+        finish((DMA_DEBUG(g_channel) & DMA_DEBUG_ERRORS) ? DMA_E_ERROR : DMA_OK);
+    }
+    return g_result;
+}
+
+int32_t dma_wait(uint32_t timeout_us) {
+    uint64_t start = timer_get_ticks();
+    int32_t result;
+
+    while ((result = dma_poll()) == DMA_E_BUSY) {
+        if (timer_get_ticks() - start > timeout_us) {
+            DMA_CS(g_channel) = DMA_CS_RESET;
+            finish(DMA_E_TIMEOUT);
+            return DMA_E_TIMEOUT;
+        }
+        asm volatile("yield");
+    }
+    return result;
+}
+
+#else /* !DMA_HAVE_ENGINE */
+
+static int32_t start(uintptr_t dst, uintptr_t src, uint32_t len, bool src_inc) {
+    (void)dst;
+    (void)src;
+    (void)len;
+    (void)src_inc;
+    return DMA_E_UNAVAIL;
+}
+
+void dma_init(void) {
+    g_channel = -1;
+    g_active = false;
+    g_result = DMA_OK;
+    g_stats = (dma_stats_t){ 0 };
+}
+
+int32_t dma_poll(void) {
+    return g_result;
+}
+
+int32_t dma_wait(uint32_t timeout_us) {
+    (void)timeout_us;
+    return g_result;
+}
+
+#endif /* DMA_HAVE_ENGINE */
+
+/*============================================================================
+ * Öffentliche Funktionen
+ *============================================================================*/
+
+int32_t dma_channel(void) {
+    return g_channel;
+}
+
+bool dma_is_lite(void) {
+    return g_lite;
+}
+
+int32_t dma_memcpy_start(void *dst, const void *src, uint32_t len) {
+    return start((uintptr_t)dst, (uintptr_t)src, len, true);
+}
+
+int32_t dma_memset_start(void *dst, uint32_t pattern, uint32_t len) {
+    if (g_active) {
+        return DMA_E_BUSY;
+    }
+    for (uint32_t i = 0; i < 4; i++) {
+        g_pattern[i] = pattern;
+    }
+    return start((uintptr_t)dst, (uintptr_t)g_pattern, len, false);
+}
+
+void dma_memcpy(void *dst, const void *src, uint32_t len) {
+    uint32_t max = DMA_MAX_CBS * g_chunk;
+
+    /* Ein asynchron gestarteter Transfer muss erst fertig sein */
+    dma_wait(DMA_TIMEOUT_US);
+
+    /* Ausgerichteter Teil in Stücken zu höchstens einer Kette, Rest per CPU */
+    while (len >= DMA_MIN_BYTES) {
+        uint32_t n = (len < max ? len : max) & ~(uint32_t)(DMA_ALIGN - 1);
+        if (dma_memcpy_start(dst, src, n) != DMA_OK || dma_wait(DMA_TIMEOUT_US) != DMA_OK) {
+            break;
+        }
+        dst = (uint8_t *)dst + n;
+        src = (const uint8_t *)src + n;
+        len -= n;
+    }
+    if (len) {
+        dma_cpu_copy(dst, src, len);
+        g_stats.fallbacks++;
+    }
+}
+
+void dma_memset(void *dst, uint32_t pattern, uint32_t len) {
+    uint32_t max = DMA_MAX_CBS * g_chunk;
+
+    dma_wait(DMA_TIMEOUT_US);
+
+    while (len >= DMA_MIN_BYTES) {
+        uint32_t n = (len < max ? len : max) & ~(uint32_t)(DMA_ALIGN - 1);
+        if (dma_memset_start(dst, pattern, n) != DMA_OK || dma_wait(DMA_TIMEOUT_US) != DMA_OK) {
+            break;
+        }
+        dst = (uint8_t *)dst + n;
+        len -= n;
+    }
+    if (len) {
+        dma_cpu_fill(dst, pattern, len);
+        g_stats.fallbacks++;
+    }
+}
+
+void dma_get_stats(dma_stats_t *stats) {
+    *stats = g_stats;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file dma.h
+ * @brief BCM2837 DMA-Controller: memcpy/memset großer Puffer, CPU als Fallback
+ *
+ * Core 3 benutzt genau einen Kanal (DMA_CHANNEL, make DMA_CH=n). Ein
+ * Transfer ist eine Kette von Kontrollblöcken (CB, 32 Byte, über
+ * NEXTCONBK verkettet), jeder CB bewegt höchstens DMA_CHUNK Bytes - auf
+ * den Lite-Kanälen (7..14, 16-bit Länge) DMA_LITE_CHUNK.
+ *
+ *   dma_memcpy_start() / dma_memset_start()  Kette bauen und starten
+ *   dma_poll()                               DMA_E_BUSY bis CS.END
+ *   dma_wait()                               pollen mit Timeout
+ *   dma_memcpy() / dma_memset()              synchron, fällt auf die CPU zurück
+ *
+ * Fertigmeldung nur per Polling: die IRQs des Controllers laufen über den
+ * GPU-Interrupt-Controller, dessen Routing Linux auf Core 0 gehört. Die
+ * asynchrone Variante lässt Core 3 in der Zwischenzeit weiterarbeiten.
+ *
+ * Der Controller sieht Busadressen: RAM über den 0xC0000000 Alias (am
+ * VideoCore L2 vorbei). Cachebare Quellen werden vorher geschrieben
+ * (clean), cachebare Ziele vorher und nachher invalidiert.
+ *
+ * CPU statt DMA: per Default (DMA_CH=-1), im Host-Build, wenn der Kanal
+ * beim Init benutzt aussieht, unter DMA_MIN_BYTES, bei Adressen oder
+ * Längen, die nicht DMA_ALIGN-ausgerichtet sind, und nach Fehler oder
+ * Timeout des Kanals.
+ *
+ * Einen Kanal bekommt Core 3 nur, wenn Linux ihn nicht vergeben kann: er
+ * muss vorher aus der brcm,dma-channel-mask des Device Trees genommen
+ * werden (Default 0x7F35 enthält 0, 2, 4, 5 und 8..14). Ein zurückgesetzter
+ * fremder Kanal würde sonst von beiden Seiten programmiert. dma_init()
+ * schreibt deshalb weder CS noch das globale ENABLE-Register, es prüft nur.
+ */
+
+#ifndef DMA_H
+#define DMA_H
+
+#include "common.h"
+
+/*============================================================================
+ * Konfiguration
+ *============================================================================*/
+
+/* Kanal 0..14, -1 = kein DMA (alles über die CPU) */
+#ifndef DMA_CHANNEL
+#define DMA_CHANNEL         (-1)
+#endif
+
+#ifdef AMP_HOST
+#define DMA_HAVE_ENGINE     0
+#else
+#define DMA_HAVE_ENGINE     (DMA_CHANNEL >= 0)
+#endif
+
+#define DMA_MAX_CBS         64          /* Kontrollblöcke pro Transfer */
+#define DMA_CHUNK           0x40000     /* Bytes pro CB, volle Kanäle (256 KB) */
+#define DMA_LITE_CHUNK      0x8000      /* Bytes pro CB, Lite-Kanäle (32 KB) */
+#define DMA_MIN_BYTES       4096        /* Darunter ist die CPU schneller */
+#define DMA_ALIGN           16          /* 128-bit Zugriffe */
+#define DMA_TIMEOUT_US      100000      /* dma_memcpy / dma_memset */
+
+/* Ergebnisse */
+#define DMA_OK              0
+#define DMA_E_BUSY          (-1)        /* Transfer läuft noch */
+#define DMA_E_UNAVAIL       (-2)        /* Kein Kanal oder nicht per DMA machbar */
+#define DMA_E_ERROR         (-3)        /* Kanal meldet Fehler (CS.ERROR / DEBUG) */
+#define DMA_E_TIMEOUT       (-4)
+
+/*============================================================================
+ * Typen
+ *============================================================================*/
+
+typedef struct {
+    uint32_t transfers;         /* Per DMA erledigt */
+    uint32_t fallbacks;         /* Über die CPU erledigt */
+    uint32_t errors;            /* Fehler + Timeouts (danach CPU) */
+    uint64_t bytes;             /* Per DMA bewegt */
+} dma_stats_t;
+
+/*============================================================================
+ * Funktionen
+ *============================================================================*/
+
+/**
+ * @brief Prüft den Kanal, ohne ihn anzufassen (vor dem ersten Transfer aufrufen)
+ */
+void dma_init(void);
+
+/**
+ * @brief Kanal in Benutzung, -1 wenn alles über die CPU läuft
+ */
+int32_t dma_channel(void);
+
+/**
+ * @brief true für einen Lite-Kanal (kleinere CBs, 32-bit Zugriffe)
+ */
+bool dma_is_lite(void);
+
+/**
+ * @brief Startet eine Kopie, kehrt sofort zurück
+ * @return DMA_OK, DMA_E_BUSY (voriger Transfer läuft) oder DMA_E_UNAVAIL
+ *         (kein Kanal, zu groß für DMA_MAX_CBS, nicht ausgerichtet)
+ */
+int32_t dma_memcpy_start(void *dst, const void *src, uint32_t len);
+
+/**
+ * @brief Startet ein Füllen mit einem 32-bit Muster, kehrt sofort zurück
+ * @return wie dma_memcpy_start()
+ */
+int32_t dma_memset_start(void *dst, uint32_t pattern, uint32_t len);
+
+/**
+ * @brief Stand des laufenden Transfers
+ * @return DMA_E_BUSY solange er läuft, danach sein Ergebnis
+ */
+int32_t dma_poll(void);
+
+/**
+ * @brief Wartet auf das Ende des Transfers, bricht nach timeout_us ab
+ * @return DMA_OK, DMA_E_ERROR oder DMA_E_TIMEOUT
+ */
+int32_t dma_wait(uint32_t timeout_us);
+
+/**
+ * @brief Kopiert synchron, per DMA wenn möglich, sonst mit der CPU
+ */
+void dma_memcpy(void *dst, const void *src, uint32_t len);
+
+/**
+ * @brief Füllt synchron mit einem 32-bit Muster (Byte-Reihenfolge wie im Speicher)
+ */
+void dma_memset(void *dst, uint32_t pattern, uint32_t len);
+
+/**
+ * @brief CPU-Kopie per memcpy() (memlib.h), der Fallback-Pfad
+ */
+void dma_cpu_copy(void *dst, const void *src, uint32_t len);
+
+/**
+ * @brief CPU-Füllen (memset() bei gleichen Bytes, sonst 64-bit Wörter), der Fallback-Pfad
+ */
+void dma_cpu_fill(void *dst, uint32_t pattern, uint32_t len);
+
+/**
+ * @brief Zähler seit dma_init()
+ */
+void dma_get_stats(dma_stats_t *stats);
+
+#endif /* DMA_H */
@@ -0,0 +1,91 @@
+/**
+ * @file doorbell.c
+ * @brief Doorbell (ARM Local Mailbox) Implementierung
+ */
+
+#include "doorbell.h"
+#include "gtimer.h"
+#include "irq.h"
+#include "memory.h"
+#include "trace.h"
+
+/*============================================================================
+ * Private Variablen
+ *============================================================================*/
+
+static volatile uint32_t g_pending = 0;
+
+/* Wake-Latenz Statistik (Nanosekunden) */
+static uint32_t g_count = 0;
+static uint32_t g_lat_min = 0xFFFFFFFF;
+static uint32_t g_lat_max = 0;
+static uint64_t g_lat_sum = 0;
+static uint32_t g_lat_samples = 0;
+
+/*============================================================================
+ * IRQ Handler
+ *============================================================================*/
+
+static void doorbell_irq(exception_frame_t *frame) {
+    uint64_t now = gtimer_count();
+    uint32_t bits;
+    uint32_t lat = 0;
+
+    (void)frame;
+
+    /* Mailbox lesen und durch Zurückschreiben der Bits löschen */
+    bits = REG32(ARM_LOCAL_MBOX_RDCLR(CORE3_ID, DOORBELL_MBOX));
+    REG32(ARM_LOCAL_MBOX_RDCLR(CORE3_ID, DOORBELL_MBOX)) = bits;
+    g_pending |= bits;
+    g_count++;
+
+    shared_status_t *status = shared_mem_get_status();
+    if (!status) {
+        TRACE_INSTANT(TRACE_EV_DOORBELL, bits, 0);
+        return;
+    }
+
+    uint64_t stamp = status->doorbell_stamp;
+    if (stamp != 0 && now > stamp) {
+        uint64_t ns = gtimer_ticks_to_ns(now - stamp);
+        lat = (ns > 0xFFFFFFFFULL) ? 0xFFFFFFFF : (uint32_t)ns;
+
+        if (lat < g_lat_min) g_lat_min = lat;
+        if (lat > g_lat_max) g_lat_max = lat;
+        g_lat_sum += lat;
+        g_lat_samples++;
+
+        /* Stempel verbraucht - der nächste Klingler setzt einen neuen */
+        status->doorbell_stamp = 0;
+    }
+
+    shared_mem_set_wake_latency(g_count, g_lat_samples ? g_lat_min : 0,
+                                g_lat_samples ? (uint32_t)(g_lat_sum / g_lat_samples) : 0,
+                                g_lat_max);
+    TRACE_INSTANT(TRACE_EV_DOORBELL, bits, lat);
+}
+
+/*============================================================================
+ * Implementierung
+ *============================================================================*/
+
+void doorbell_init(void) {
+    /* Alte Bits verwerfen */
+    REG32(ARM_LOCAL_MBOX_RDCLR(CORE3_ID, DOORBELL_MBOX)) = 0xFFFFFFFF;
+
+    irq_register(IRQ_SRC_MBOX0 + DOORBELL_MBOX, doorbell_irq);
+    REG32(ARM_LOCAL_MBOX_INT_CTRL(CORE3_ID)) |= (1U << DOORBELL_MBOX);
+    DSB();
+}
+
+bool doorbell_pending(void) {
+    return g_pending != 0;
+}
+
+uint32_t doorbell_take(void) {
+    uint64_t flags = irq_save();
+    uint32_t bits = g_pending;
+    g_pending = 0;
+    irq_restore(flags);
+    return bits;
+}
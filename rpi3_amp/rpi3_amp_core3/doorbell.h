@@ -0,0 +1,49 @@
+/**
+ * @file doorbell.h
+ * @brief Doorbell: Linux weckt Core 3 über die ARM Local Mailbox
+ *
+ * Linux schreibt (über /dev/mem) in das Mailbox-0 Set-Register von Core 3
+ * (0x400000B0). Das löst auf Core 3 sofort einen IRQ aus und holt die
+ * Firmware aus dem WFI.
+ *
+ * Latenz-Messung: Linux legt vor dem Klingeln CNTVCT_EL0 in
+ * shared_status_t.doorbell_stamp ab, der IRQ Handler vergleicht mit
+ * CNTPCT_EL0 (gleiche Zeitbasis) und führt min/avg/max.
+ */
+
+#ifndef DOORBELL_H
+#define DOORBELL_H
+
+#include "common.h"
+
+/*============================================================================
+ * Konfiguration
+ *============================================================================*/
+
+/* Mailbox von Core 3, die als Doorbell dient (0..3) */
+#define DOORBELL_MBOX       0
+
+/* Bedeutung der Bits, die Linux in die Mailbox schreibt */
+#define DOORBELL_BIT_IPC    (1U << 0)   /* Neue Nachrichten in den Ringen */
+
+/*============================================================================
+ * Funktionen
+ *============================================================================*/
+
+/**
+ * @brief Gibt den Mailbox-IRQ für Core 3 frei und registriert den Handler
+ */
+void doorbell_init(void);
+
+/**
+ * @brief Prüft ob seit dem letzten doorbell_take() geklingelt wurde
+ */
+bool doorbell_pending(void);
+
+/**
+ * @brief Holt und löscht die gesammelten Doorbell-Bits
+ * @return Alle seit dem letzten Aufruf geschriebenen Bits
+ */
+uint32_t doorbell_take(void);
+
+#endif /* DOORBELL_H */
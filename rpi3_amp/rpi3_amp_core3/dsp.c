@@ -0,0 +1,462 @@
+/**
+ * @file dsp.c
+ * @brief Streaming-Filter Implementierung
+ */
+
+#include "dsp.h"
+#include "gtimer.h"
+#include "mmu.h"
+
+#define DSP_F32_MAX         (DSP_BLOCK_BYTES / 4)   /* Samples pro Block */
+#define DSP_Q15_MAX         (DSP_BLOCK_BYTES / 2)
+#define DSP_HIST            (DSP_MAX_TAPS - 1)      /* FIR-Historie vor den Daten */
+
+_Static_assert(sizeof(dsp_block_t) == 64 + DSP_BLOCK_BYTES, "dsp_block_t Layout");
+_Static_assert(__builtin_offsetof(dsp_shared_t, in) % IPC_CACHE_LINE == 0,
+               "dsp_shared_t: Ringe nicht auf Cache-Line");
+_Static_assert(sizeof(dsp_shared_t) <= SHARED_DSP_SIZE, "dsp_shared_t passt nicht in SHARED_DSP");
+_Static_assert((DSP_SLOTS & (DSP_SLOTS - 1)) == 0, "DSP_SLOTS muss eine Zweierpotenz sein");
+
+/* 4 Lanes; die u-Varianten erlauben ungerade ausgerichtete Loads/Stores */
+typedef float   v4f  __attribute__((vector_size(16)));
+typedef float   v4fu __attribute__((vector_size(16), aligned(4)));
+typedef int32_t v4i  __attribute__((vector_size(16)));
+typedef int16_t v4hu __attribute__((vector_size(8), aligned(2)));
+
+/* Stufe mit lokalen Koeffizienten und Zustand */
+typedef struct {
+    uint32_t type;
+    uint32_t taps;
+    float    hf[DSP_MAX_TAPS];      /* FIR float, umgedreht: hf[k] = h[taps-1-k] */
+    int16_t  hq[DSP_MAX_TAPS];      /* FIR Q15, umgedreht */
+    float    bf[5];                 /* Biquad b0 b1 b2 a1 a2 */
+    int32_t  bq[5];                 /* Biquad Q14 */
+    float    hist_f[DSP_HIST];      /* Letzte taps-1 Eingänge */
+    int16_t  hist_q[DSP_HIST];
+    float    s1, s2;                /* DF2T Zustand */
+    int32_t  x1, x2, y1, y2;        /* DF1 Zustand (Q15) */
+} stage_t;
+
+/*============================================================================
+ * Private Variablen
+ *============================================================================*/
+
+static dsp_shared_t *g_dsp = NULL;
+static ipc_ring_t g_in;             /* Core 3 ist Consumer */
+static ipc_ring_t g_out;            /* Core 3 ist Producer */
+
+static stage_t g_stages[DSP_MAX_STAGES];
+static uint32_t g_stage_count = 0;
+static uint32_t g_format = DSP_FMT_F32;
+static uint32_t g_config_seq = 0;
+
+/* Zwei Arbeitspuffer, Daten ab Index DSP_HIST (davor Platz für die FIR-Historie) */
+static float g_f[2][DSP_HIST + DSP_F32_MAX] __attribute__((aligned(16)));
+static int16_t g_q[2][DSP_HIST + DSP_Q15_MAX] __attribute__((aligned(16)));
+
+static uint32_t g_blocks = 0;
+static uint32_t g_errors = 0;
+static uint32_t g_stalls = 0;
+static uint32_t g_proc_max = 0;
+static uint64_t g_samples = 0;
+static uint64_t g_busy_ns = 0;
+
+/*============================================================================
+ * Kernels
+ *============================================================================*/
+
+/* x[0 .. n+taps-2] inkl. Historie, y[i] = sum hf[k] * x[i+k] */
+static void fir_f32(const float *x, float *y, uint32_t n, const float *hf, uint32_t taps) {
+    uint32_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        v4f a0 = { 0, 0, 0, 0 };
+        v4f a1 = { 0, 0, 0, 0 };
+        for (uint32_t k = 0; k < taps; k++) {
+            a0 += hf[k] * *(const v4fu *)&x[i + k];
+            a1 += hf[k] * *(const v4fu *)&x[i + k + 4];
+        }
+        *(v4fu *)&y[i] = a0;
+        *(v4fu *)&y[i + 4] = a1;
+    }
+    for (; i < n; i++) {
+        float acc = 0;
+        for (uint32_t k = 0; k < taps; k++) {
+            acc += hf[k] * x[i + k];
+        }
+        y[i] = acc;
+    }
+}
+
+/* Q30 Akkumulator -> Q15, rund und gesättigt */
+static inline int16_t sat_q15(int64_t acc, uint32_t shift) {
+    acc = (acc + (1LL << (shift - 1))) >> shift;
+    if (acc > 32767) {
+        return 32767;
+    }
+    if (acc < -32768) {
+        return -32768;
+    }
+    return (int16_t)acc;
+}
+
+static void fir_q15(const int16_t *x, int16_t *y, uint32_t n, const int16_t *hq, uint32_t taps) {
+    uint32_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        v4i a0 = { 0, 0, 0, 0 };
+        v4i a1 = { 0, 0, 0, 0 };
+        for (uint32_t k = 0; k < taps; k++) {
+            int32_t h = hq[k];
+            a0 += __builtin_convertvector(*(const v4hu *)&x[i + k], v4i) * h;
+            a1 += __builtin_convertvector(*(const v4hu *)&x[i + k + 4], v4i) * h;
+        }
+        for (uint32_t j = 0; j < 4; j++) {
+            y[i + j] = sat_q15(a0[j], 15);
+            y[i + 4 + j] = sat_q15(a1[j], 15);
+        }
+    }
+    for (; i < n; i++) {
+        int32_t acc = 0;
+        for (uint32_t k = 0; k < taps; k++) {
+            acc += (int32_t)hq[k] * x[i + k];
+        }
+        y[i] = sat_q15(acc, 15);
+    }
+}
+
+/* Direct Form II transponiert, in place */
+static void biquad_f32(stage_t *s, float *x, uint32_t n) {
+    float b0 = s->bf[0], b1 = s->bf[1], b2 = s->bf[2], a1 = s->bf[3], a2 = s->bf[4];
+    float s1 = s->s1, s2 = s->s2;
+
+    for (uint32_t i = 0; i < n; i++) {
+        float in = x[i];
+        float out = b0 * in + s1;
+        s1 = b1 * in - a1 * out + s2;
+        s2 = b2 * in - a2 * out;
+        x[i] = out;
+    }
+    s->s1 = s1;
+    s->s2 = s2;
+}
+
+/* Direct Form I, Q14 Koeffizienten, 64-bit Akkumulator, in place */
+static void biquad_q15(stage_t *s, int16_t *x, uint32_t n) {
+    const int32_t *b = s->bq;
+    int32_t x1 = s->x1, x2 = s->x2, y1 = s->y1, y2 = s->y2;
+
+    for (uint32_t i = 0; i < n; i++) {
+        int32_t in = x[i];
+        int64_t acc = (int64_t)b[0] * in + (int64_t)b[1] * x1 + (int64_t)b[2] * x2 -
+                      (int64_t)b[3] * y1 - (int64_t)b[4] * y2;
+        int32_t out = sat_q15(acc, 14);
+        x2 = x1;
+        x1 = in;
+        y2 = y1;
+        y1 = out;
+        x[i] = (int16_t)out;
+    }
+    s->x1 = x1;
+    s->x2 = x2;
+    s->y1 = y1;
+    s->y2 = y2;
+}
+
+/*============================================================================
+ * Kette
+ *============================================================================*/
+
+/* Läuft die Kette ab, Ergebnis im zurückgegebenen Puffer (ab Index DSP_HIST) */
+static float *run_f32(uint32_t n) {
+    uint32_t cur = 0;
+
+    for (uint32_t s = 0; s < g_stage_count; s++) {
+        stage_t *st = &g_stages[s];
+        float *x = &g_f[cur][DSP_HIST];
+
+        if (st->type == DSP_STAGE_BIQUAD) {
+            biquad_f32(st, x, n);
+            continue;
+        }
+
+        /* Historie direkt vor die Daten, danach die letzten taps-1 merken */
+        uint32_t h = st->taps - 1;
+        float *ext = x - h;
+        for (uint32_t k = 0; k < h; k++) {
+            ext[k] = st->hist_f[k];
+        }
+        fir_f32(ext, &g_f[cur ^ 1][DSP_HIST], n, st->hf, st->taps);
+        for (uint32_t k = 0; k < h; k++) {
+            st->hist_f[k] = ext[n + k];
+        }
+        cur ^= 1;
+    }
+    return &g_f[cur][DSP_HIST];
+}
+
+static int16_t *run_q15(uint32_t n) {
+    uint32_t cur = 0;
+
+    for (uint32_t s = 0; s < g_stage_count; s++) {
+        stage_t *st = &g_stages[s];
+        int16_t *x = &g_q[cur][DSP_HIST];
+
+        if (st->type == DSP_STAGE_BIQUAD) {
+            biquad_q15(st, x, n);
+            continue;
+        }
+
+        uint32_t h = st->taps - 1;
+        int16_t *ext = x - h;
+        for (uint32_t k = 0; k < h; k++) {
+            ext[k] = st->hist_q[k];
+        }
+        fir_q15(ext, &g_q[cur ^ 1][DSP_HIST], n, st->hq, st->taps);
+        for (uint32_t k = 0; k < h; k++) {
+            st->hist_q[k] = ext[n + k];
+        }
+        cur ^= 1;
+    }
+    return &g_q[cur][DSP_HIST];
+}
+
+/* Shared Memory nur wortweise (ungecacht), len auf 4 Byte aufgerundet */
+static void copy_words(void *dst, const void *src, uint32_t len) {
+    uint32_t *d = (uint32_t *)dst;
+    const volatile uint32_t *s = (const volatile uint32_t *)src;
+
+    for (uint32_t i = 0; i < (len + 3) / 4; i++) {
+        d[i] = s[i];
+    }
+}
+
+/*============================================================================
+ * Konfiguration
+ *============================================================================*/
+
+/* round + sättigen auf int16; false wenn |c| > limit */
+static bool to_fixed(float c, float limit, float one, int32_t *out) {
+    float v;
+
+    /* So herum fällt auch NaN durch */
+    if (!(c <= limit && c >= -limit)) {
+        return false;
+    }
+    v = c * one;
+    v += v >= 0 ? 0.5f : -0.5f;
+    if (v > 32767.0f) {
+        v = 32767.0f;
+    } else if (v < -32768.0f) {
+        v = -32768.0f;
+    }
+    *out = (int32_t)v;
+    return true;
+}
+
+static int32_t load_config(const dsp_config_t *cfg) {
+    static stage_t next[DSP_MAX_STAGES];
+    uint32_t count = cfg->stage_count;
+
+    if (cfg->format != DSP_FMT_F32 && cfg->format != DSP_FMT_Q15) {
+        return DSP_E_FORMAT;
+    }
+    if (count > DSP_MAX_STAGES) {
+        return DSP_E_STAGE;
+    }
+
+    for (uint32_t s = 0; s < count; s++) {
+        const dsp_stage_t *src = &cfg->stages[s];
+        stage_t *st = &next[s];
+        uint32_t taps = src->taps;
+        int32_t q;
+
+        /* Zustand zurücksetzen */
+        for (uint32_t k = 0; k < DSP_HIST; k++) {
+            st->hist_f[k] = 0;
+            st->hist_q[k] = 0;
+        }
+        st->s1 = st->s2 = 0;
+        st->x1 = st->x2 = st->y1 = st->y2 = 0;
+        st->type = src->type;
+        st->taps = taps;
+
+        if (src->type == DSP_STAGE_FIR) {
+            int32_t sum = 0;
+            if (taps == 0 || taps > DSP_MAX_TAPS) {
+                return DSP_E_STAGE;
+            }
+            for (uint32_t k = 0; k < taps; k++) {
+                float c = src->coeff[taps - 1 - k];
+                st->hf[k] = c;
+                if (!to_fixed(c, 1.0f, 32768.0f, &q)) {
+                    return DSP_E_RANGE;
+                }
+                st->hq[k] = (int16_t)q;
+                sum += q < 0 ? -q : q;
+            }
+            /* Q15: 32-bit Akkumulator verlangt Summe |h| < 2 */
+            if (cfg->format == DSP_FMT_Q15 && sum >= 65536) {
+                return DSP_E_RANGE;
+            }
+        } else if (src->type == DSP_STAGE_BIQUAD) {
+            if (taps != 5) {
+                return DSP_E_STAGE;
+            }
+            for (uint32_t k = 0; k < 5; k++) {
+                st->bf[k] = src->coeff[k];
+                if (!to_fixed(src->coeff[k], 2.0f, 16384.0f, &q)) {
+                    return DSP_E_RANGE;
+                }
+                st->bq[k] = q;
+            }
+        } else {
+            return DSP_E_STAGE;
+        }
+    }
+
+    /* Erst jetzt übernehmen - bei Fehler bleibt die alte Kette */
+    for (uint32_t s = 0; s < count; s++) {
+        g_stages[s] = next[s];
+    }
+    g_stage_count = count;
+    g_format = cfg->format;
+    return DSP_OK;
+}
+
+static void check_config(void) {
+    static dsp_config_t cfg;
+    uint32_t seq = LOAD_ACQUIRE(&g_dsp->config_seq);
+
+    if (seq == g_config_seq) {
+        return;
+    }
+
+    if (mmu_is_cacheable((uintptr_t)&g_dsp->config)) {
+        dcache_clean_invalidate_range((uintptr_t)&g_dsp->config, sizeof(cfg));
+    }
+    copy_words(&cfg, &g_dsp->config, sizeof(cfg));
+
+    g_config_seq = seq;
+    g_dsp->config_result = load_config(&cfg);
+    STORE_RELEASE(&g_dsp->config_ack, seq);
+}
+
+/*============================================================================
+ * Implementierung
+ *============================================================================*/
+
+void dsp_init(void) {
+    dsp_shared_t *d = (dsp_shared_t *)SHARED_DSP_ADDR;
+
+    g_dsp = NULL;
+    d->magic = 0;
+    d->slot_size = sizeof(dsp_block_t);
+    d->slot_count = DSP_SLOTS;
+    d->block_bytes = DSP_BLOCK_BYTES;
+    d->max_stages = DSP_MAX_STAGES;
+    d->max_taps = DSP_MAX_TAPS;
+    d->config_seq = 0;
+    d->config_ack = 0;
+    d->config_result = DSP_OK;
+    d->blocks = 0;
+    d->errors = 0;
+    d->stalls = 0;
+    d->proc_max_ns = 0;
+    d->samples = 0;
+    d->busy_ns = 0;
+
+    g_stage_count = 0;
+    g_format = DSP_FMT_F32;
+    g_config_seq = 0;
+    g_blocks = 0;
+    g_errors = 0;
+    g_stalls = 0;
+    g_proc_max = 0;
+    g_samples = 0;
+    g_busy_ns = 0;
+
+    ipc_ring_init(&g_in, &d->in, d->in_slots, sizeof(dsp_block_t), DSP_SLOTS);
+    ipc_ring_init(&g_out, &d->out, d->out_slots, sizeof(dsp_block_t), DSP_SLOTS);
+
+    /* Magic zuletzt: Linux streamt erst, wenn beide Ringe stehen */
+    STORE_RELEASE(&d->magic, DSP_MAGIC);
+    g_dsp = d;
+}
+
+bool dsp_pending(void) {
+    return g_dsp && (ipc_ring_peek(&g_in) != NULL || g_dsp->config_seq != g_config_seq);
+}
+
+uint32_t dsp_poll(void) {
+    uint32_t count = 0;
+    dsp_block_t *in;
+    dsp_block_t *out;
+
+    if (!g_dsp) {
+        return 0;
+    }
+    check_config();
+
+    while (count < DSP_BATCH && (in = (dsp_block_t *)ipc_ring_peek(&g_in)) != NULL) {
+        out = (dsp_block_t *)ipc_ring_reserve(&g_out);
+        if (!out) {
+            g_stalls++;
+            break;
+        }
+
+        uint64_t t0 = gtimer_count();
+        uint32_t n = in->count;
+        uint32_t size = g_format == DSP_FMT_F32 ? 4 : 2;
+        bool cached = mmu_is_cacheable((uintptr_t)in);
+
+        out->seq = in->seq;
+        out->format = in->format;
+        out->config = g_config_seq;
+
+        if (in->format != g_format || n == 0 || n * size > DSP_BLOCK_BYTES) {
+            /* Leerer Ausgangsblock, damit Linux nicht auf die seq wartet */
+            out->count = 0;
+            out->proc_ns = 0;
+            g_errors++;
+        } else {
+            if (cached) {
+                dcache_clean_invalidate_range((uintptr_t)in->data, n * size);
+            }
+            if (g_format == DSP_FMT_F32) {
+                copy_words(&g_f[0][DSP_HIST], in->data, n * size);
+                copy_words(out->data, run_f32(n), n * size);
+            } else {
+                copy_words(&g_q[0][DSP_HIST], in->data, n * size);
+                copy_words(out->data, run_q15(n), n * size);
+            }
+            if (cached) {
+                dcache_clean_range((uintptr_t)out->data, n * size);
+            }
+
+            uint32_t ns = (uint32_t)gtimer_ticks_to_ns(gtimer_count() - t0);
+            out->count = n;
+            out->proc_ns = ns;
+            g_blocks++;
+            g_samples += n;
+            g_busy_ns += ns;
+            if (ns > g_proc_max) {
+                g_proc_max = ns;
+            }
+        }
+
+        ipc_ring_commit(&g_out);
+        ipc_ring_release(&g_in);
+        count++;
+    }
+
+    if (count || g_stalls != g_dsp->stalls) {
+        g_dsp->blocks = g_blocks;
+        g_dsp->errors = g_errors;
+        g_dsp->stalls = g_stalls;
+        g_dsp->proc_max_ns = g_proc_max;
+        g_dsp->samples = g_samples;
+        g_dsp->busy_ns = g_busy_ns;
+    }
+    return count;
+}
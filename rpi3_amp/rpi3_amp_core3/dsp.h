@@ -0,0 +1,146 @@
+/**
+ * @file dsp.h
+ * @brief Streaming-Filter auf Core 3: FIR und Biquad-Ketten (SHARED_DSP_ADDR)
+ *
+ * Linux schreibt Sample-Blöcke in den in-Ring, Core 3 filtert sie durch
+ * eine Kette aus bis zu DSP_MAX_STAGES Stufen und schreibt das Ergebnis
+ * in den out-Ring (ipc_ring_*, wie beim Pool):
+ *
+ *   in  : Linux  -> Core 3, dsp_block_t {seq, count, format} + Samples
+ *   out : Core 3 -> Linux,  dsp_block_t {seq, count, format, config, proc_ns}
+ *
+ * Doppelpuffer: Core 3 liest Block n aus dem in-Ring und schreibt direkt
+ * in einen reservierten out-Slot, während Linux schon Block n+1 füllt
+ * bzw. das Ergebnis von n-1 liest. Intern wechseln die Stufen zwischen
+ * zwei lokalen (cachebaren) Puffern. Ist der out-Ring voll, bleibt der
+ * Eingangsblock liegen (stalls).
+ *
+ * Formate: float32 oder int16 Q15. Die Koeffizienten kommen immer als
+ * float; für Q15 rechnet Core 3 sie beim Übernehmen um (FIR Q15, Biquad
+ * Q14). Q15-FIR akkumuliert in 32 Bit, deshalb muss Summe |h| < 2 sein.
+ *
+ * Kernels: FIR über GCC Vektortypen (4 Lanes, auf dem A53 NEON fmla bzw.
+ * sxtl/mla), 8 Ausgänge pro Durchlauf. Biquads sind rekursiv und laufen
+ * skalar - float als Direct Form II transponiert, Q15 als Direct Form I
+ * mit 64-bit Akkumulator. Ergebnisse runden und sättigen wie die
+ * Referenz in linux_tools/dsp_stream (Q15 bitgenau).
+ *
+ * Konfiguration: Linux schreibt config, dann config_seq (Release). Core 3
+ * übernimmt sie zwischen zwei Blöcken, setzt die Filterzustände zurück und
+ * quittiert mit config_ack / config_result.
+ */
+
+#ifndef DSP_H
+#define DSP_H
+
+#include "common.h"
+#include "ipc.h"
+
+/*============================================================================
+ * Konfiguration
+ *============================================================================*/
+
+#define DSP_MAGIC           0x20505344  /* "DSP " */
+#define DSP_SLOTS           16          /* Pro Ring, Zweierpotenz */
+#define DSP_BLOCK_BYTES     1024        /* Nutzdaten pro Block: 256 float / 512 Q15 */
+#define DSP_BATCH           4           /* Blöcke pro dsp_poll() */
+#define DSP_MAX_STAGES      4
+#define DSP_MAX_TAPS        64
+
+/* Sample-Formate */
+#define DSP_FMT_F32         0
+#define DSP_FMT_Q15         1
+
+/* Stufen */
+#define DSP_STAGE_FIR       1           /* coeff = h[0..taps-1] */
+#define DSP_STAGE_BIQUAD    2           /* coeff = b0 b1 b2 a1 a2 (a0 = 1), taps = 5 */
+
+/* config_result */
+#define DSP_OK              0
+#define DSP_E_FORMAT        (-1)        /* Unbekanntes Format */
+#define DSP_E_STAGE         (-2)        /* Stufentyp / Anzahl Taps ungültig */
+#define DSP_E_RANGE         (-3)        /* Koeffizient passt nicht in Q15/Q14 */
+
+/*============================================================================
+ * Shared Memory Strukturen (MÜSSEN mit linux_tools/amp_shared.h übereinstimmen!)
+ *============================================================================*/
+
+typedef struct {
+    uint32_t seq;               /* Von Linux, kommt im Ausgangsblock zurück */
+    uint32_t count;             /* Samples im Block */
+    uint32_t format;            /* DSP_FMT_*, muss zur Konfiguration passen */
+    uint32_t config;            /* out: config_seq, mit der gerechnet wurde */
+    uint32_t proc_ns;           /* out: Rechenzeit auf Core 3 */
+    uint8_t  _pad[44];
+    uint8_t  data[DSP_BLOCK_BYTES];
+} dsp_block_t;
+
+typedef struct {
+    uint32_t type;              /* DSP_STAGE_* */
+    uint32_t taps;
+    float    coeff[DSP_MAX_TAPS];
+} dsp_stage_t;
+
+typedef struct {
+    uint32_t format;            /* DSP_FMT_* */
+    uint32_t stage_count;       /* 0 = durchreichen */
+    dsp_stage_t stages[DSP_MAX_STAGES];
+} dsp_config_t;
+
+/* Layout von SHARED_DSP_ADDR */
+typedef struct {
+    /* Cache-Line 0: Geometrie, nach dem Init read-only */
+    uint32_t magic;             /* DSP_MAGIC, wird zuletzt gesetzt */
+    uint32_t slot_size;         /* sizeof(dsp_block_t) */
+    uint32_t slot_count;        /* DSP_SLOTS */
+    uint32_t block_bytes;       /* DSP_BLOCK_BYTES */
+    uint32_t max_stages;
+    uint32_t max_taps;
+    uint8_t  _pad0[IPC_CACHE_LINE - 24];
+
+    /* Cache-Line 1: nur von Linux geschrieben */
+    volatile uint32_t config_seq;       /* Neue config gültig (Release) */
+    uint8_t  _pad1[IPC_CACHE_LINE - 4];
+
+    /* Cache-Line 2: nur von Core 3 geschrieben */
+    volatile uint32_t config_ack;       /* Zuletzt übernommene config_seq */
+    volatile int32_t  config_result;    /* DSP_OK / DSP_E_* */
+    volatile uint32_t blocks;           /* Gefilterte Blöcke */
+    volatile uint32_t errors;           /* Verworfene Blöcke (count/format falsch) */
+    volatile uint32_t stalls;           /* out-Ring voll angetroffen */
+    volatile uint32_t proc_max_ns;      /* Längste Rechenzeit eines Blocks */
+    volatile uint64_t samples;
+    volatile uint64_t busy_ns;          /* Summe der Rechenzeiten */
+    uint8_t  _pad2[IPC_CACHE_LINE - 40];
+
+    dsp_config_t config;                /* Von Linux vor config_seq geschrieben */
+    uint8_t  _pad3[IPC_CACHE_LINE - sizeof(dsp_config_t) % IPC_CACHE_LINE];
+
+    ipc_ring_ctrl_t in;
+    ipc_ring_ctrl_t out;
+
+    dsp_block_t in_slots[DSP_SLOTS];
+    dsp_block_t out_slots[DSP_SLOTS];
+} dsp_shared_t;
+
+/*============================================================================
+ * Funktionen
+ *============================================================================*/
+
+/**
+ * @brief Legt beide Ringe in SHARED_DSP_ADDR an, Kette leer (durchreichen)
+ */
+void dsp_init(void);
+
+/**
+ * @brief Prüft ob Blöcke oder eine neue Konfiguration anstehen
+ */
+bool dsp_pending(void);
+
+/**
+ * @brief Übernimmt eine neue Konfiguration und filtert bis zu DSP_BATCH Blöcke
+ * @return Anzahl gefilterter Blöcke
+ */
+uint32_t dsp_poll(void);
+
+#endif /* DSP_H */
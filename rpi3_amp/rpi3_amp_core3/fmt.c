@@ -0,0 +1,332 @@
+/**
+ * @file fmt.c
+ * @brief printf-Formatierer Implementierung
+ */
+
+#include "fmt.h"
+
+/*============================================================================
+ * Flags und Längen
+ *============================================================================*/
+
+#define FMT_LEFT        (1 << 0)    /* - */
+#define FMT_ZERO        (1 << 1)    /* 0 */
+#define FMT_ALT         (1 << 2)    /* # */
+#define FMT_PLUS        (1 << 3)    /* + */
+#define FMT_SPACE       (1 << 4)    /* Leerzeichen */
+#define FMT_UPPER       (1 << 5)    /* %X */
+#define FMT_PTR         (1 << 6)    /* %p: Prefix auch bei 0 */
+
+typedef enum {
+    LEN_INT = 0,
+    LEN_CHAR,
+    LEN_SHORT,
+    LEN_LONG,
+    LEN_LLONG,
+    LEN_SIZE
+} fmt_len_t;
+
+/*============================================================================
+ * Ausgabe
+ *============================================================================*/
+
+static inline void put(fmt_out_t *out, char c) {
+    if (out->len >= out->size) {
+        if (out->flush) {
+            out->flush(out);
+        }
+        if (out->len >= out->size) {
+            out->total++;   /* Abgeschnitten, zählt aber für snprintf */
+            return;
+        }
+    }
+    out->buf[out->len++] = c;
+    out->total++;
+}
+
+static void pad(fmt_out_t *out, char c, uint32_t count) {
+    while (count--) {
+        put(out, c);
+    }
+}
+
+/* Literaler Text bis zum nächsten '%': blockweise statt Zeichen für Zeichen */
+static const char *put_literal(fmt_out_t *out, const char *s) {
+    const char *end = s;
+
+    while (*end && *end != '%') {
+        end++;
+    }
+    uint32_t len = (uint32_t)(end - s);
+    out->total += len;
+
+    while (len) {
+        if (out->len >= out->size && out->flush) {
+            out->flush(out);
+        }
+        uint32_t room = out->size - out->len;
+        if (room == 0) {
+            break;  /* Abgeschnitten (total schon gezählt) */
+        }
+        uint32_t n = len < room ? len : room;
+        for (uint32_t i = 0; i < n; i++) {
+            out->buf[out->len + i] = s[i];
+        }
+        out->len += n;
+        s += n;
+        len -= n;
+    }
+    return end;
+}
+
+static void put_number(fmt_out_t *out, uint64_t val, bool neg, uint32_t base,
+                       uint32_t flags, uint32_t width) {
+    const char *digits = (flags & FMT_UPPER) ? "0123456789ABCDEF" : "0123456789abcdef";
+    char tmp[24];
+    char prefix[2];
+    uint32_t n = 0, plen = 0;
+
+    if (neg) {
+        prefix[plen++] = '-';
+    } else if (flags & FMT_PLUS) {
+        prefix[plen++] = '+';
+    } else if (flags & FMT_SPACE) {
+        prefix[plen++] = ' ';
+    }
+    if (base == 16 && (flags & FMT_ALT) && (val || (flags & FMT_PTR))) {
+        prefix[plen++] = '0';
+        prefix[plen++] = (flags & FMT_UPPER) ? 'X' : 'x';
+    }
+
+    /* Ziffern rückwärts; Basis 16 per Shift, Basis 10 in 32-bit sobald möglich */
+    if (base == 16) {
+        do {
+            tmp[n++] = digits[val & 0xF];
+            val >>= 4;
+        } while (val);
+    } else {
+        while (val > 0xFFFFFFFFULL) {
+            tmp[n++] = (char)('0' + val % 10);
+            val /= 10;
+        }
+        uint32_t v32 = (uint32_t)val;
+        do {
+            tmp[n++] = (char)('0' + v32 % 10);
+            v32 /= 10;
+        } while (v32);
+    }
+
+    uint32_t len = plen + n;
+    uint32_t fill = width > len ? width - len : 0;
+
+    if (!(flags & (FMT_LEFT | FMT_ZERO))) {
+        pad(out, ' ', fill);
+    }
+    for (uint32_t i = 0; i < plen; i++) {
+        put(out, prefix[i]);
+    }
+    if ((flags & FMT_ZERO) && !(flags & FMT_LEFT)) {
+        pad(out, '0', fill);
+    }
+    while (n) {
+        put(out, tmp[--n]);
+    }
+    if (flags & FMT_LEFT) {
+        pad(out, ' ', fill);
+    }
+}
+
+static void put_string(fmt_out_t *out, const char *s, uint32_t flags, uint32_t width,
+                       int32_t prec) {
+    uint32_t len = 0;
+
+    if (!s) {
+        s = "(null)";
+    }
+    while (s[len] && (prec < 0 || len < (uint32_t)prec)) {
+        len++;
+    }
+
+    uint32_t fill = width > len ? width - len : 0;
+    if (!(flags & FMT_LEFT)) {
+        pad(out, ' ', fill);
+    }
+    for (uint32_t i = 0; i < len; i++) {
+        put(out, s[i]);
+    }
+    if (flags & FMT_LEFT) {
+        pad(out, ' ', fill);
+    }
+}
+
+/*============================================================================
+ * Öffentliche Funktionen
+ *============================================================================*/
+
+uint32_t fmt_vformat(fmt_out_t *out, const char *fmt, __builtin_va_list args) {
+    uint32_t start = out->total;
+
+    while (*fmt) {
+        if (*fmt != '%') {
+            fmt = put_literal(out, fmt);
+            continue;
+        }
+        fmt++;
+
+        /* Flags */
+        uint32_t flags = 0;
+        for (;; fmt++) {
+            if (*fmt == '-') flags |= FMT_LEFT;
+            else if (*fmt == '0') flags |= FMT_ZERO;
+            else if (*fmt == '#') flags |= FMT_ALT;
+            else if (*fmt == '+') flags |= FMT_PLUS;
+            else if (*fmt == ' ') flags |= FMT_SPACE;
+            else break;
+        }
+
+        /* Breite */
+        uint32_t width = 0;
+        if (*fmt == '*') {
+            int32_t w = __builtin_va_arg(args, int);
+            if (w < 0) {
+                flags |= FMT_LEFT;
+                /* -INT_MIN gibt es nicht: dann ohne Breite */
+                w = w == -0x7FFFFFFF - 1 ? 0 : -w;
+            }
+            width = (uint32_t)w;
+            fmt++;
+        } else {
+            while (*fmt >= '0' && *fmt <= '9') {
+                width = width * 10 + (uint32_t)(*fmt++ - '0');
+            }
+        }
+
+        /* Präzision (nur für %s ausgewertet) */
+        int32_t prec = -1;
+        if (*fmt == '.') {
+            fmt++;
+            prec = 0;
+            if (*fmt == '*') {
+                prec = __builtin_va_arg(args, int);
+                fmt++;
+            } else {
+                while (*fmt >= '0' && *fmt <= '9') {
+                    prec = prec * 10 + (*fmt++ - '0');
+                }
+            }
+        }
+
+        /* Länge */
+        fmt_len_t lenmod = LEN_INT;
+        if (*fmt == 'h') {
+            fmt++;
+            lenmod = LEN_SHORT;
+            if (*fmt == 'h') {
+                fmt++;
+                lenmod = LEN_CHAR;
+            }
+        } else if (*fmt == 'l') {
+            fmt++;
+            lenmod = LEN_LONG;
+            if (*fmt == 'l') {
+                fmt++;
+                lenmod = LEN_LLONG;
+            }
+        } else if (*fmt == 'z') {
+            fmt++;
+            lenmod = LEN_SIZE;
+        }
+
+        char conv = *fmt;
+        if (conv) {
+            fmt++;
+        }
+
+        switch (conv) {
+            case 'd':
+            case 'i': {
+                int64_t v;
+                switch (lenmod) {
+                    case LEN_LONG:  v = __builtin_va_arg(args, long); break;
+                    case LEN_LLONG: v = __builtin_va_arg(args, long long); break;
+                    case LEN_SIZE:  v = (int64_t)__builtin_va_arg(args, size_t); break;
+                    case LEN_SHORT: v = (short)__builtin_va_arg(args, int); break;
+                    case LEN_CHAR:  v = (signed char)__builtin_va_arg(args, int); break;
+                    default:        v = __builtin_va_arg(args, int); break;
+                }
+                /* Betrag ohne Überlauf bei INT64_MIN */
+                uint64_t mag = v < 0 ? 0 - (uint64_t)v : (uint64_t)v;
+                put_number(out, mag, v < 0, 10, flags, width);
+                break;
+            }
+            case 'u':
+            case 'x':
+            case 'X': {
+                uint64_t v;
+                switch (lenmod) {
+                    case LEN_LONG:  v = __builtin_va_arg(args, unsigned long); break;
+                    case LEN_LLONG: v = __builtin_va_arg(args, unsigned long long); break;
+                    case LEN_SIZE:  v = __builtin_va_arg(args, size_t); break;
+                    case LEN_SHORT: v = (unsigned short)__builtin_va_arg(args, unsigned int); break;
+                    case LEN_CHAR:  v = (unsigned char)__builtin_va_arg(args, unsigned int); break;
+                    default:        v = __builtin_va_arg(args, unsigned int); break;
+                }
+                if (conv == 'X') {
+                    flags |= FMT_UPPER;
+                }
+                put_number(out, v, false, conv == 'u' ? 10 : 16,
+                           flags & ~(FMT_PLUS | FMT_SPACE), width);
+                break;
+            }
+            case 'p': {
+                uintptr_t v = (uintptr_t)__builtin_va_arg(args, void *);
+                if (width < 2 + 2 * sizeof(void *)) {
+                    width = 2 + 2 * sizeof(void *);
+                }
+                put_number(out, v, false, 16, FMT_ALT | FMT_ZERO | FMT_PTR, width);
+                break;
+            }
+            case 'c': {
+                char c = (char)__builtin_va_arg(args, int);
+                uint32_t fill = width > 1 ? width - 1 : 0;
+                if (!(flags & FMT_LEFT)) pad(out, ' ', fill);
+                put(out, c);
+                if (flags & FMT_LEFT) pad(out, ' ', fill);
+                break;
+            }
+            case 's':
+                put_string(out, __builtin_va_arg(args, const char *), flags, width, prec);
+                break;
+            case '%':
+                put(out, '%');
+                break;
+            default:
+                /* Unbekannt: unverändert ausgeben */
+                put(out, '%');
+                if (conv) put(out, conv);
+                break;
+        }
+    }
+
+    return out->total - start;
+}
+
+uint32_t fmt_vsnprintf(char *buf, uint32_t size, const char *fmt, __builtin_va_list args) {
+    fmt_out_t out = { buf, size ? size - 1 : 0, 0, 0, NULL };
+    uint32_t total = fmt_vformat(&out, fmt, args);
+
+    if (size) {
+        buf[out.len] = '\0';
+    }
+    return total;
+}
+
+uint32_t fmt_snprintf(char *buf, uint32_t size, const char *fmt, ...) {
+    __builtin_va_list args;
+    uint32_t total;
+
+    __builtin_va_start(args, fmt);
+    total = fmt_vsnprintf(buf, size, fmt, args);
+    __builtin_va_end(args);
+    return total;
+}
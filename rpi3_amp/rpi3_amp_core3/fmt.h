@@ -0,0 +1,56 @@
+/**
+ * @file fmt.h
+ * @brief printf-Formatierer für Bare-Metal (kein libc, kein stdarg.h)
+ *
+ * Formatiert in einen Puffer. Läuft der Puffer voll, wird er über
+ * fmt_out_t.flush geleert (uart_printf: in den TX-Ring) oder die Ausgabe
+ * abgeschnitten (fmt_snprintf).
+ *
+ * Unterstützt:
+ *   %d %i %u %x %X %c %s %p %%
+ *   Längen  : hh h (char/short, wie C gekürzt), l ll (64-bit), z (size_t)
+ *   Flags   : - (links) 0 (Nullen) # (0x Prefix bei x/X) + und Leerzeichen
+ *   Breite  : Zahl oder *
+ *   Präzision bei %s: .N oder .* (maximale Zeichen)
+ *
+ * %x/%X geben wie in C keinen Prefix aus - "0x%08x" oder "%#x" verwenden.
+ * %p gibt 0x und die Adresse in voller Breite (16 Stellen) aus.
+ */
+
+#ifndef FMT_H
+#define FMT_H
+
+#include "common.h"
+
+/*============================================================================
+ * Typen
+ *============================================================================*/
+
+typedef struct fmt_out {
+    char    *buf;
+    uint32_t size;          /* Kapazität von buf */
+    uint32_t len;           /* Belegte Bytes in buf */
+    uint32_t total;         /* Insgesamt erzeugte Zeichen (auch abgeschnittene) */
+    void   (*flush)(struct fmt_out *out);  /* Leert buf (len = 0), NULL = abschneiden */
+} fmt_out_t;
+
+/*============================================================================
+ * Funktionen
+ *============================================================================*/
+
+/**
+ * @brief Formatiert nach out (ohne abschließende Null)
+ * @return Anzahl erzeugter Zeichen
+ */
+uint32_t fmt_vformat(fmt_out_t *out, const char *fmt, __builtin_va_list args);
+
+/**
+ * @brief snprintf: schreibt höchstens size-1 Zeichen plus Null
+ * @return Länge der vollständigen Ausgabe (wie C snprintf)
+ */
+uint32_t fmt_vsnprintf(char *buf, uint32_t size, const char *fmt, __builtin_va_list args);
+
+uint32_t fmt_snprintf(char *buf, uint32_t size, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#endif /* FMT_H */
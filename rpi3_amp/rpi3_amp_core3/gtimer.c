@@ -0,0 +1,88 @@
+/**
+ * @file gtimer.c
+ * @brief ARM Generic Timer Implementierung
+ */
+
+#include "gtimer.h"
+#include "arch.h"
+#include "irq.h"
+#include "timer.h"
+
+/* CNTP_CTL_EL0 Bits */
+#define CNTP_CTL_ENABLE     (1UL << 0)
+#define CNTP_CTL_IMASK      (1UL << 1)
+
+/* Bit im Core Timer Interrupt Control Register: nCNTPNSIRQ -> IRQ */
+#define TIMER_INT_CNTPNS_IRQ    (1U << 1)
+
+/*============================================================================
+ * Private Variablen
+ *============================================================================*/
+
+static uint32_t g_freq = 0;
+static timer_conv_t g_us_to_ticks;
+static timer_conv_t g_ticks_to_ns;
+static void (*g_callback)(void) = NULL;
+
+/*============================================================================
+ * IRQ Handler
+ *============================================================================*/
+
+static void gtimer_irq(exception_frame_t *frame) {
+    (void)frame;
+
+    /* One-Shot: Timer aus, sonst feuert er sofort wieder */
+    WRITE_SYSREG(cntp_ctl_el0, CNTP_CTL_IMASK);
+
+    if (g_callback) {
+        g_callback();
+    }
+}
+
+/*============================================================================
+ * Implementierung
+ *============================================================================*/
+
+void gtimer_init(void) {
+    g_freq = arch_counter_freq();
+    timer_conv_init(&g_us_to_ticks, 1000000, g_freq);
+    timer_conv_init(&g_ticks_to_ns, g_freq, 1000000000);
+
+    WRITE_SYSREG(cntp_ctl_el0, CNTP_CTL_IMASK);
+    irq_register(IRQ_SRC_CNTPNS, gtimer_irq);
+
+    REG32(ARM_LOCAL_TIMER_INT_CTRL(CORE3_ID)) |= TIMER_INT_CNTPNS_IRQ;
+    DSB();
+}
+
+uint64_t gtimer_count(void) {
+    return arch_counter();
+}
+
+uint32_t gtimer_freq(void) {
+    return g_freq;
+}
+
+uint64_t gtimer_us_to_ticks(uint64_t us) {
+    return timer_conv(&g_us_to_ticks, us);
+}
+
+uint64_t gtimer_ticks_to_ns(uint64_t ticks) {
+    /* g_freq == 0: mult = 0, wie vorher 0 */
+    return timer_conv(&g_ticks_to_ns, ticks);
+}
+
+void gtimer_set_deadline(uint64_t deadline) {
+    WRITE_SYSREG(cntp_cval_el0, deadline);
+    WRITE_SYSREG(cntp_ctl_el0, CNTP_CTL_ENABLE);
+    ISB();
+}
+
+void gtimer_cancel(void) {
+    WRITE_SYSREG(cntp_ctl_el0, CNTP_CTL_IMASK);
+    ISB();
+}
+
+void gtimer_set_callback(void (*callback)(void)) {
+    g_callback = callback;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file gtimer.h
+ * @brief ARM Generic Timer (CNTP) für Core 3
+ *
+ * Der Non-Secure Physical Timer (CNTP_*_EL0) wird als One-Shot Weckquelle
+ * benutzt: gtimer_set_deadline() programmiert CNTP_CVAL_EL0, beim Erreichen
+ * kommt IRQ_SRC_CNTPNS über den ARM Local Interrupt Controller.
+ *
+ * Zeitbasis ist CNTPCT_EL0 (RPi3: 19.2 MHz) - dieselbe Zeitbasis, die
+ * Linux über CNTVCT_EL0 sieht (CNTVOFF = 0).
+ */
+
+#ifndef GTIMER_H
+#define GTIMER_H
+
+#include "common.h"
+
+/*============================================================================
+ * Funktionen
+ *============================================================================*/
+
+/**
+ * @brief Registriert den IRQ Handler und routet CNTPNS auf Core 3
+ */
+void gtimer_init(void);
+
+/**
+ * @brief Aktueller Counter-Wert (CNTPCT_EL0)
+ */
+uint64_t gtimer_count(void);
+
+/**
+ * @brief Counter-Frequenz in Hz
+ */
+uint32_t gtimer_freq(void);
+
+/**
+ * @brief Rechnet Mikrosekunden in Counter-Ticks um
+ */
+uint64_t gtimer_us_to_ticks(uint64_t us);
+
+/**
+ * @brief Rechnet Counter-Ticks in Nanosekunden um
+ */
+uint64_t gtimer_ticks_to_ns(uint64_t ticks);
+
+/**
+ * @brief Programmiert einen One-Shot IRQ auf einen absoluten Counter-Wert
+ * @param deadline Counter-Wert (CNTPCT_EL0)
+ */
+void gtimer_set_deadline(uint64_t deadline);
+
+/**
+ * @brief Deaktiviert den Timer
+ */
+void gtimer_cancel(void);
+
+/**
+ * @brief Registriert eine Funktion, die im Timer-IRQ aufgerufen wird
+ * @param callback Funktion oder NULL
+ */
+void gtimer_set_callback(void (*callback)(void));
+
+#endif /* GTIMER_H */
@@ -0,0 +1,188 @@
+/**
+ * @file host.c
+ * @brief Host-Build: memfd-Mappings, Timer und UART Ersatz
+ *
+ * Ersetzt außerdem die Module, die es im Host-Build nicht gibt:
+ * gtimer (Counter ohne Compare-IRQ), mmu (keine Cache-Wartung nötig,
+ * MAP_SHARED ist zwischen Prozessen kohärent) und mbox (keine GPU).
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "host.h"
+#include "gtimer.h"
+#include "mbox.h"
+#include "mmu.h"
+
+/* System Timer Register (wie in timer.c) */
+#define SYSTIMER_CLO    REG32(SYSTIMER_BASE + 0x04)
+#define SYSTIMER_CHI    REG32(SYSTIMER_BASE + 0x08)
+
+/*============================================================================
+ * Variablen
+ *============================================================================*/
+
+uintptr_t host_periph_base = 0;
+uintptr_t host_shared_base = 0;
+
+static int g_memfd = -1;
+static char g_path[64];
+static uint64_t g_start_ns = 0;
+
+/*============================================================================
+ * memfd
+ *============================================================================*/
+
+int host_init(void) {
+    size_t total = SHARED_MEM_SIZE + HOST_PERIPH_SIZE;
+    void *shared, *periph;
+
+    g_memfd = memfd_create("rpi3_amp", 0);
+    if (g_memfd < 0) {
+        perror("memfd_create");
+        return -1;
+    }
+    if (ftruncate(g_memfd, (off_t)total) < 0) {
+        perror("ftruncate");
+        return -1;
+    }
+
+    shared = mmap(NULL, SHARED_MEM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, g_memfd, 0);
+    periph = mmap(NULL, HOST_PERIPH_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, g_memfd,
+                  SHARED_MEM_SIZE);
+    if (shared == MAP_FAILED || periph == MAP_FAILED) {
+        perror("mmap memfd");
+        return -1;
+    }
+
+    host_shared_base = (uintptr_t)shared;
+    host_periph_base = (uintptr_t)periph;
+    snprintf(g_path, sizeof(g_path), "/proc/%d/fd/%d", (int)getpid(), g_memfd);
+
+    g_start_ns = host_counter();
+    host_systimer_update();
+    return 0;
+}
+
+const char *host_mem_path(void) {
+    return g_path;
+}
+
+/*============================================================================
+ * Timer und UART
+ *============================================================================*/
+
+uint64_t host_counter(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void host_systimer_update(void) {
+    uint64_t us = (host_counter() - g_start_ns) / 1000;
+
+    SYSTIMER_CHI = (uint32_t)(us >> 32);
+    SYSTIMER_CLO = (uint32_t)us;
+}
+
+void host_uart_tx(char c) {
+#if !AMP_LOG_BINARY
+    /* Firmware sendet \r\n, im Terminal reicht \n (Binär-Frames unverändert) */
+    if (c == '\r') {
+        return;
+    }
+#endif
+    putchar(c);
+    if (c == '\n') {
+        fflush(stdout);
+    }
+}
+
+/*============================================================================
+ * gtimer Ersatz (kein Compare-IRQ, Core 3 pollt)
+ *============================================================================*/
+
+void gtimer_init(void) {
+}
+
+uint64_t gtimer_count(void) {
+    return host_counter();
+}
+
+uint32_t gtimer_freq(void) {
+    return HOST_COUNTER_FREQ;
+}
+
+uint64_t gtimer_us_to_ticks(uint64_t us) {
+    return us * 1000ULL;
+}
+
+uint64_t gtimer_ticks_to_ns(uint64_t ticks) {
+    return ticks;
+}
+
+void gtimer_set_deadline(uint64_t deadline) {
+    (void)deadline;
+}
+
+void gtimer_cancel(void) {
+}
+
+void gtimer_set_callback(void (*callback)(void)) {
+    (void)callback;
+}
+
+/*============================================================================
+ * mmu Ersatz
+ *============================================================================*/
+
+uint32_t mmu_get_flags(void) {
+    return 0;
+}
+
+bool mmu_is_cacheable(uintptr_t addr) {
+    (void)addr;
+    return false;
+}
+
+void dcache_clean_range(uintptr_t addr, uint32_t size) {
+    (void)addr;
+    (void)size;
+}
+
+void dcache_invalidate_range(uintptr_t addr, uint32_t size) {
+    (void)addr;
+    (void)size;
+}
+
+void dcache_clean_invalidate_range(uintptr_t addr, uint32_t size) {
+    (void)addr;
+    (void)size;
+}
+
+/*============================================================================
+ * mbox Ersatz (keine GPU-Firmware, Aufrufer nehmen ihre Defaults)
+ *============================================================================*/
+
+bool mbox_property(uint32_t tag, uint32_t *values, uint32_t words) {
+    (void)tag;
+    (void)values;
+    (void)words;
+    return false;
+}
+
+bool mbox_property_batch(mbox_tag_t *tags, uint32_t count) {
+    (void)tags;
+    (void)count;
+    return false;
+}
+
+uint32_t mbox_get_clock_rate(uint32_t clock_id) {
+    (void)clock_id;
+    return 0;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file host.h
+ * @brief Host-Build: simulierte Hardware für x86-64 Linux (make host)
+ *
+ * uart, timer, memory, ipc, sched und memtest laufen unverändert als
+ * "Core 3" Thread in einem normalen Linux-Prozess. Ein memfd enthält:
+ *
+ *   Offset 0                : Shared Memory (SHARED_MEM_SIZE)
+ *   Offset SHARED_MEM_SIZE  : Peripherie-Fenster ab PERIPHERAL_BASE (sparse)
+ *
+ * Im Host-Build zeigen PERIPHERAL_BASE und SHARED_MEM_BASE auf diese
+ * Mappings (common.h). Die Register-Zugriffe über REG32 landen damit im
+ * memfd; zwei Register bekommen Verhalten:
+ *
+ *   System Timer CLO/CHI : werden bei jedem timer_get_ticks() aus
+ *                          CLOCK_MONOTONIC nachgeführt
+ *   UART0 DR             : jedes gesendete Byte geht nach stdout
+ *
+ * Die Linux-Tools öffnen den memfd über /proc/<pid>/fd/<n>
+ * (Umgebungsvariable AMP_MEM_PATH) statt /dev/mem.
+ *
+ * Nicht simuliert: MMU/Caches, IRQs, Doorbell und WFI - der Core 3 Thread
+ * pollt die Ringe wie mit IDLE_SPIN=1.
+ */
+
+#ifndef HOST_H
+#define HOST_H
+
+#include "common.h"
+
+/*============================================================================
+ * Konfiguration
+ *============================================================================*/
+
+/* Peripherie-Fenster (0x3F000000 - 0x3FFFFFFF) */
+#define HOST_PERIPH_SIZE    0x01000000
+
+/* Ersatz für den Generic Timer: Counter in ns */
+#define HOST_COUNTER_FREQ   1000000000U
+
+/*============================================================================
+ * Funktionen
+ *============================================================================*/
+
+/**
+ * @brief Legt den memfd an und mappt Shared Memory und Peripherie
+ *
+ * Muss vor allen anderen Firmware-Funktionen laufen.
+ *
+ * @return 0 bei Erfolg, -1 bei Fehler (Meldung auf stderr)
+ */
+int host_init(void);
+
+/**
+ * @brief Pfad, unter dem andere Prozesse den memfd öffnen können
+ */
+const char *host_mem_path(void);
+
+/**
+ * @brief Counter für arch_counter()/gtimer_count() (CLOCK_MONOTONIC, ns)
+ */
+uint64_t host_counter(void);
+
+/**
+ * @brief Schreibt die µs seit host_init() in SYSTIMER CLO/CHI
+ */
+void host_systimer_update(void);
+
+/**
+ * @brief Ein in UART0 DR geschriebenes Byte ausgeben
+ */
+void host_uart_tx(char c);
+
+#endif /* HOST_H */
@@ -0,0 +1,226 @@
+/**
+ * @file main_host.c
+ * @brief Host-Build Hauptprogramm: Core 3 Firmware als Thread auf Linux
+ *
+ * Bauen und starten:
+ *   make host
+ *   ./core3_host              # läuft bis Ctrl+C
+ *   ./core3_host -m -t 10     # Memory Test beim Start, nach 10 s beenden
+ *   ./core3_host -b -t 1      # Boot-Benchmark wie make qemu-bench
+ *
+ * Die Tools aus linux_tools laufen in einem zweiten Terminal gegen den
+ * memfd (Pfad wird beim Start ausgegeben):
+ *   AMP_MEM_PATH=/proc/<pid>/fd/<n> ./ipc_bench
+ */
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "host.h"
+#include "uart.h"
+#include "binlog.h"
+#include "timer.h"
+#include "memory.h"
+#include "ipc.h"
+#include "pool.h"
+#include "cmd.h"
+#include "dsp.h"
+#include "dma.h"
+#include "gtimer.h"
+#include "sched.h"
+#include "bench.h"
+#include "trace.h"
+#include "telem.h"
+#include "probe.h"
+
+/*============================================================================
+ * Konfiguration
+ *============================================================================*/
+
+#define HEARTBEAT_INTERVAL_MS   5000
+#define HEARTBEAT_PRIORITY      4
+#define HEARTBEAT_DEADLINE_US   10000
+#define TELEM_PRIORITY          6
+
+typedef struct {
+    bool memtest;               /* -m: memory_test_full() beim Start */
+    bool bench;                 /* -b: bench_run() beim Start */
+    uint32_t duration_sec;      /* -t: 0 = bis Ctrl+C */
+} host_options_t;
+
+static volatile sig_atomic_t g_stop = 0;
+
+/*============================================================================
+ * Core 3 Thread
+ *============================================================================*/
+
+static void on_signal(int sig) {
+    (void)sig;
+    g_stop = 1;
+}
+
+static void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    asm volatile("pause");
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+/* Ersatz für idle_wait(): pollen bis Nachrichten/Puffer/Kommandos/DSP-Blöcke da sind oder wake_at erreicht */
+static void idle_poll(uint64_t wake_at) {
+    while (!g_stop && !ipc_rx_pending() && !ipc_ping_pending() && !pool_rx_pending() &&
+           !cmd_pending() && !dsp_pending() && gtimer_count() < wake_at) {
+        cpu_relax();
+    }
+}
+
+static void heartbeat_task(void *arg) {
+    uint32_t *count = (uint32_t *)arg;
+    char uptime[24];
+
+    (*count)++;
+    shared_mem_heartbeat();
+
+    timer_format_uptime(uptime, timer_get_seconds());
+    LOG_PRINTF("[HEARTBEAT #%u] uptime %s\n", *count, uptime);
+    shared_mem_set_uart_stats(uart_get_tx_dropped(), uart_get_tx_peak());
+}
+
+static void *core3_main(void *arg) {
+    const host_options_t *opt = (const host_options_t *)arg;
+    uint32_t heartbeat_count = 0;
+
+    timer_init();
+    uart_init();
+    uart_puts("RPi3 AMP - Core 3 firmware (host build)\n");
+    uart_printf("Time source: %s, %u Hz\n", timer_source_name(), timer_freq());
+
+    dma_init();
+    shared_mem_init();
+    shared_mem_set_uart_baud(uart_get_clock(), uart_get_baud());
+    ipc_init();
+    uart_printf("IPC rings: %u slots x %u bytes per direction\n",
+                IPC_SLOT_COUNT, IPC_SLOT_SIZE);
+    trace_init();
+    probe_init();
+    pool_init();
+    cmd_init();
+    dsp_init();
+    telem_init();
+
+    gtimer_init();
+    sched_init();
+    sched_add("heartbeat", heartbeat_task, &heartbeat_count,
+              HEARTBEAT_INTERVAL_MS * 1000, HEARTBEAT_PRIORITY, HEARTBEAT_DEADLINE_US);
+    shared_mem_set_heartbeat_interval(HEARTBEAT_INTERVAL_MS);
+#if TELEM_PERIOD_MS > 0
+    sched_add("telem", telem_task, NULL, TELEM_PERIOD_MS * 1000, TELEM_PRIORITY, 0);
+#endif
+
+    if (opt->memtest) {
+        memory_test_full(SHARED_MEMTEST_ADDR, SHARED_MEMTEST_SIZE, true);
+    }
+    if (opt->bench) {
+        bench_run(NULL);
+    }
+
+    shared_mem_set_state(CORE3_STATE_RUNNING);
+    shared_mem_set_debug("Core 3 running (host)");
+    uart_set_tx_policy(UART_TX_POLICY);
+
+    sched_start();
+    while (!g_stop) {
+        sched_run();
+        ipc_poll();
+        pool_poll();
+        cmd_poll();
+        dsp_poll();
+        uart_tx_pump();
+        idle_poll(sched_next_release());
+    }
+
+    shared_mem_set_state(CORE3_STATE_HALTED);
+    uart_flush();
+    return NULL;
+}
+
+/*============================================================================
+ * Hauptprogramm
+ *============================================================================*/
+
+/* Core 3 Thread auf die letzte CPU legen (wie auf dem Pi: eigener Kern) */
+static void pin_last_cpu(pthread_t thread) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    cpu_set_t set;
+
+    if (cpus < 2) {
+        return;
+    }
+    CPU_ZERO(&set);
+    CPU_SET((int)(cpus - 1), &set);
+    if (pthread_setaffinity_np(thread, sizeof(set), &set) != 0) {
+        fprintf(stderr, "Warning: cannot pin Core 3 thread to CPU %ld\n", cpus - 1);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    host_options_t opt = { false, false, 0 };
+    pthread_t core3;
+    uint64_t start;
+    int c;
+
+    while ((c = getopt(argc, argv, "mbt:h")) != -1) {
+        switch (c) {
+            case 'm':
+                opt.memtest = true;
+                break;
+            case 'b':
+                opt.bench = true;
+                break;
+            case 't':
+                opt.duration_sec = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            default:
+                printf("Usage: %s [-m] [-b] [-t seconds]\n", argv[0]);
+                printf("  -m           Run memory_test_full() at startup\n");
+                printf("  -b           Run the boot benchmark at startup\n");
+                printf("  -t seconds   Stop after this time (default: run until Ctrl+C)\n");
+                return c == 'h' ? 0 : 1;
+        }
+    }
+
+    if (host_init() < 0) {
+        return 1;
+    }
+    printf("Shared memory: %s (%u KB)\n", host_mem_path(), SHARED_MEM_SIZE / 1024);
+    printf("  export AMP_MEM_PATH=%s\n\n", host_mem_path());
+    fflush(stdout);
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    if (pthread_create(&core3, NULL, core3_main, &opt) != 0) {
+        perror("pthread_create");
+        return 1;
+    }
+    pin_last_cpu(core3);
+
+    start = host_counter();
+    while (!g_stop) {
+        usleep(100000);
+        if (opt.duration_sec &&
+            host_counter() - start >= (uint64_t)opt.duration_sec * HOST_COUNTER_FREQ) {
+            g_stop = 1;
+        }
+    }
+
+    pthread_join(core3, NULL);
+    return 0;
+}
@@ -0,0 +1,361 @@
+/**
+ * @file ipc.c
+ * @brief SPSC Message Ringe Implementierung
+ */
+
+#include "ipc.h"
+#include "memlib.h"
+#include "memory.h"
+#include "pool.h"
+#include "timer.h"
+#include "uart.h"
+#include "trace.h"
+
+_Static_assert((IPC_SLOT_COUNT & (IPC_SLOT_COUNT - 1)) == 0,
+               "IPC_SLOT_COUNT muss eine Zweierpotenz sein");
+_Static_assert((IPC_SLOT_SIZE % 8) == 0 && IPC_SLOT_SIZE > IPC_MSG_HDR_SIZE,
+               "IPC_SLOT_SIZE muss ein Vielfaches von 8 sein");
+_Static_assert(2 * IPC_SLOT_SIZE * IPC_SLOT_COUNT <= SHARED_IPC_SLOTS_SIZE,
+               "IPC Slots passen nicht in SHARED_IPC_SLOTS");
+_Static_assert(sizeof(ipc_ring_ctrl_t) == 3 * IPC_CACHE_LINE,
+               "ipc_ring_ctrl_t Layout");
+_Static_assert(sizeof(ipc_shared_t) <= SHARED_DATA_SIZE,
+               "ipc_shared_t passt nicht in SHARED_DATA");
+
+/* Timeout wenn Linux den to_linux Ring während eines Benchmarks nicht leert */
+#define IPC_BENCH_TX_TIMEOUT_US     1000000
+
+/*============================================================================
+ * Private Variablen
+ *============================================================================*/
+
+static ipc_ring_t g_rx;     /* to_core3: Core 3 ist Consumer */
+static ipc_ring_t g_tx;     /* to_linux: Core 3 ist Producer */
+static ipc_ping_t *g_ping = NULL;
+
+static uint32_t g_sent = 0;
+static uint32_t g_received = 0;
+
+/* Benchmark-Zustand */
+static uint64_t g_bench_rx_start = 0;
+static uint32_t g_bench_rx_count = 0;
+static uint32_t g_rx_rate = 0;
+static uint32_t g_tx_rate = 0;
+
+/*============================================================================
+ * Generische Ring-Funktionen
+ *============================================================================*/
+
+void ipc_ring_init(ipc_ring_t *ring, ipc_ring_ctrl_t *ctrl, void *slots,
+                   uint32_t slot_size, uint32_t slot_count) {
+    ring->ctrl = ctrl;
+    ring->slots = (uint8_t *)slots;
+    ring->slot_size = slot_size;
+    ring->mask = slot_count - 1;
+    ring->local = 0;
+    ring->peer_cache = 0;
+
+    ctrl->magic = 0;
+    ctrl->head = 0;
+    ctrl->tail = 0;
+    ctrl->slot_size = slot_size;
+    ctrl->slot_count = slot_count;
+    ctrl->slots_offset = (uint32_t)((uintptr_t)slots - SHARED_MEM_BASE);
+
+    /* Magic zuletzt: Linux benutzt den Ring erst wenn die Geometrie steht */
+    STORE_RELEASE(&ctrl->magic, IPC_RING_MAGIC);
+}
+
+void* ipc_ring_reserve(ipc_ring_t *ring) {
+    /* Nur wenn der Cache "voll" meldet, den echten tail nachladen */
+    if (ring->local - ring->peer_cache > ring->mask) {
+        ring->peer_cache = LOAD_ACQUIRE(&ring->ctrl->tail);
+        if (ring->local - ring->peer_cache > ring->mask) {
+            return NULL;
+        }
+    }
+    return ring->slots + (ring->local & ring->mask) * ring->slot_size;
+}
+
+void ipc_ring_commit(ipc_ring_t *ring) {
+    ring->local++;
+    STORE_RELEASE(&ring->ctrl->head, ring->local);
+}
+
+void* ipc_ring_peek(ipc_ring_t *ring) {
+    if (ring->local == ring->peer_cache) {
+        ring->peer_cache = LOAD_ACQUIRE(&ring->ctrl->head);
+        if (ring->local == ring->peer_cache) {
+            return NULL;
+        }
+    }
+    return ring->slots + (ring->local & ring->mask) * ring->slot_size;
+}
+
+void ipc_ring_release(ipc_ring_t *ring) {
+    ring->local++;
+    STORE_RELEASE(&ring->ctrl->tail, ring->local);
+}
+
+/*============================================================================
+ * Hilfsfunktionen
+ *============================================================================*/
+
+static void publish_stats(void) {
+    shared_mem_set_ipc_stats(g_sent, g_received, g_rx_rate, g_tx_rate);
+}
+
+static uint32_t rate_per_sec(uint32_t count, uint64_t elapsed_us) {
+    if (elapsed_us == 0) elapsed_us = 1;
+    return (uint32_t)((uint64_t)count * 1000000ULL / elapsed_us);
+}
+
+/*============================================================================
+ * Message API
+ *============================================================================*/
+
+void ipc_init(void) {
+    ipc_shared_t *shm = (ipc_shared_t *)SHARED_DATA_ADDR;
+    uint8_t *slots = (uint8_t *)SHARED_IPC_SLOTS_ADDR;
+    uint32_t ring_bytes = IPC_SLOT_SIZE * IPC_SLOT_COUNT;
+
+    ipc_ring_init(&g_rx, &shm->to_core3, slots, IPC_SLOT_SIZE, IPC_SLOT_COUNT);
+    ipc_ring_init(&g_tx, &shm->to_linux, slots + ring_bytes, IPC_SLOT_SIZE, IPC_SLOT_COUNT);
+
+    g_ping = &shm->ping;
+    g_ping->spin = 0;
+    g_ping->pong = g_ping->ping;
+
+    g_sent = 0;
+    g_received = 0;
+    publish_stats();
+}
+
+bool ipc_send(uint32_t type, const void *data, uint32_t len) {
+    if (len > IPC_MSG_MAX_PAYLOAD) {
+        return false;
+    }
+
+    ipc_msg_t *msg = (ipc_msg_t *)ipc_ring_reserve(&g_tx);
+    if (!msg) {
+        return false;
+    }
+
+    msg->type = type;
+    msg->length = len;
+    if (len) {
+        memcpy(msg->data, data, len);
+    }
+    ipc_ring_commit(&g_tx);
+    g_sent++;
+
+    return true;
+}
+
+bool ipc_rx_pending(void) {
+    return ipc_ring_peek(&g_rx) != NULL;
+}
+
+bool ipc_ping_pending(void) {
+    return g_ping && g_ping->ping != g_ping->pong;
+}
+
+bool ipc_spin_requested(void) {
+    return g_ping && g_ping->spin != 0;
+}
+
+/* Antwort an Linux; bei vollem Ring bis IPC_BENCH_TX_TIMEOUT_US wiederholen */
+static void send_reply(uint32_t type, const void *data, uint32_t len) {
+    uint64_t sent_at = timer_get_ticks();
+
+    while (!ipc_send(type, data, len)) {
+        if (timer_get_ticks() - sent_at > IPC_BENCH_TX_TIMEOUT_US) {
+            break;
+        }
+    }
+}
+
+static void bench_rx(const ipc_msg_t *msg) {
+    const uint32_t *args = (const uint32_t *)msg->data;
+    uint32_t seq = args[0];
+    uint32_t total = args[1];
+
+    if (seq == 0) {
+        g_bench_rx_start = timer_get_ticks();
+        g_bench_rx_count = 0;
+    }
+    g_bench_rx_count++;
+
+    if (seq + 1 == total) {
+        g_rx_rate = rate_per_sec(g_bench_rx_count, timer_get_ticks() - g_bench_rx_start);
+    }
+}
+
+static void bench_tx(uint32_t count) {
+    uint64_t start = timer_get_ticks();
+    uint64_t last_progress = start;
+    uint32_t sent = 0;
+
+    while (sent < count) {
+        if (ipc_send(IPC_MSG_BENCH_DATA, &sent, sizeof(sent))) {
+            sent++;
+            last_progress = timer_get_ticks();
+        } else if (timer_get_ticks() - last_progress > IPC_BENCH_TX_TIMEOUT_US) {
+            break;  /* Linux liest nicht mehr */
+        }
+    }
+
+    uint64_t elapsed = timer_get_ticks() - start;
+    uint32_t done[2] = { sent, (uint32_t)elapsed };
+    g_tx_rate = rate_per_sec(sent, elapsed);
+
+    while (!ipc_send(IPC_MSG_BENCH_DONE, done, sizeof(done))) {
+        if (timer_get_ticks() - last_progress > IPC_BENCH_TX_TIMEOUT_US) {
+            break;
+        }
+    }
+}
+
+/*
+ * Schreibt so schnell wie möglich in den Stresstest-Block des Status,
+ * während Linux liest und zerrissene Kopien zählt.
+ */
+static void status_stress(uint32_t duration_us) {
+    uint64_t start = timer_get_ticks();
+    uint64_t elapsed;
+    uint32_t writes = 0;
+
+    if (duration_us > IPC_STATUS_STRESS_MAX_US) {
+        duration_us = IPC_STATUS_STRESS_MAX_US;
+    }
+
+    do {
+        shared_mem_stress(++writes);
+        elapsed = timer_get_ticks() - start;
+    } while (elapsed < duration_us);
+
+    uint32_t done[2] = { writes, (uint32_t)elapsed };
+    send_reply(IPC_MSG_STATUS_STRESS_DONE, done, sizeof(done));
+}
+
+/* Pool-Puffer an Linux schicken, danach BULK_TX_DONE über den Ring */
+static void bulk_tx(uint32_t cls, uint32_t count) {
+    uint32_t done[2];
+
+    done[0] = pool_bulk_tx(cls, count, &done[1]);
+
+    send_reply(IPC_MSG_BULK_TX_DONE, done, sizeof(done));
+}
+
+/* Baudrate umstellen, blockiert bis der TX-Ring mit der alten Rate leer ist */
+static void set_baud(uint32_t baud) {
+    uint32_t reply[2];
+
+    uart_printf("[IPC] UART0 -> %u baud\n", baud);
+    reply[0] = uart_set_baud(baud);
+    reply[1] = uart_get_clock();
+    if (reply[0]) {
+        uart_printf("[IPC] UART0 now %u baud (clock %u Hz)\n", reply[0], reply[1]);
+    } else {
+        uart_printf("[IPC] %u baud not reachable with %u Hz UART clock\n", baud, reply[1]);
+    }
+    shared_mem_set_uart_baud(reply[1], uart_get_baud());
+
+    send_reply(IPC_MSG_SET_BAUD_DONE, reply, sizeof(reply));
+}
+
+uint32_t ipc_poll(void) {
+    uint32_t processed = 0;
+    ipc_msg_t *msg;
+
+    /* Ping zuerst: kürzester Weg für den Latenztest */
+    if (ipc_ping_pending()) {
+        STORE_RELEASE(&g_ping->pong, LOAD_ACQUIRE(&g_ping->ping));
+    }
+
+    /* Leere Polls nicht tracen, die Hauptschleife pollt ständig */
+    if (!ipc_rx_pending()) {
+        return 0;
+    }
+    TRACE_BEGIN(TRACE_EV_IPC_POLL, 0);
+
+    while ((msg = (ipc_msg_t *)ipc_ring_peek(&g_rx)) != NULL) {
+        uint32_t len = msg->length;
+        if (len > IPC_MSG_MAX_PAYLOAD) {
+            len = IPC_MSG_MAX_PAYLOAD;
+        }
+
+        switch (msg->type) {
+            case IPC_MSG_ECHO:
+                /* Gegenseite voll: Nachricht liegen lassen, nächster Poll */
+                if (!ipc_send(IPC_MSG_ECHO, msg->data, len)) {
+                    goto out;
+                }
+                break;
+            case IPC_MSG_TEXT:
+                uart_puts("[IPC] ");
+                for (uint32_t i = 0; i < len && msg->data[i]; i++) {
+                    uart_putc(msg->data[i]);
+                }
+                uart_puts("\n");
+                break;
+            case IPC_MSG_BENCH_RX:
+                if (len >= 8) bench_rx(msg);
+                break;
+            case IPC_MSG_BENCH_TX:
+                if (len >= 4) {
+                    uint32_t count = *(const uint32_t *)msg->data;
+                    ipc_ring_release(&g_rx);
+                    g_received++;
+                    processed++;
+                    bench_tx(count);
+                    continue;
+                }
+                break;
+            case IPC_MSG_STATUS_STRESS:
+                if (len >= 4) {
+                    uint32_t duration_us = *(const uint32_t *)msg->data;
+                    ipc_ring_release(&g_rx);
+                    g_received++;
+                    processed++;
+                    status_stress(duration_us);
+                    continue;
+                }
+                break;
+            case IPC_MSG_BULK_TX:
+                if (len >= 8) {
+                    uint32_t cls = ((const uint32_t *)msg->data)[0];
+                    uint32_t count = ((const uint32_t *)msg->data)[1];
+                    ipc_ring_release(&g_rx);
+                    g_received++;
+                    processed++;
+                    bulk_tx(cls, count);
+                    continue;
+                }
+                break;
+            case IPC_MSG_SET_BAUD:
+                if (len >= 4) {
+                    uint32_t baud = *(const uint32_t *)msg->data;
+                    ipc_ring_release(&g_rx);
+                    g_received++;
+                    processed++;
+                    set_baud(baud);
+                    continue;
+                }
+                break;
+            default:
+                break;
+        }
+
+        ipc_ring_release(&g_rx);
+        g_received++;
+        processed++;
+    }
+
+out:
+    if (processed) {
+        publish_stats();
+    }
+    TRACE_END(TRACE_EV_IPC_POLL, processed);
+    return processed;
+}
@@ -0,0 +1,212 @@
+/**
+ * @file ipc.h
+ * @brief Lock-freie SPSC Message Ringe zwischen Linux und Core 3
+ *
+ * Zwei Single-Producer/Single-Consumer Ringe, einer pro Richtung:
+ *
+ *   to_core3 : Linux  -> Core 3  (Linux = Producer, Core 3 = Consumer)
+ *   to_linux : Core 3 -> Linux   (Core 3 = Producer, Linux = Consumer)
+ *
+ * Die Steuerblöcke liegen in SHARED_DATA_ADDR, die Slots in
+ * SHARED_IPC_SLOTS_ADDR. head und tail liegen jeweils auf einer eigenen
+ * Cache-Line, damit Producer und Consumer sich nicht gegenseitig die
+ * Line wegnehmen. Veröffentlicht wird mit Store-Release (stlr),
+ * gelesen mit Load-Acquire (ldar) - kein DSB pro Nachricht.
+ *
+ * Die Indizes laufen frei (uint32_t) und werden erst beim Zugriff
+ * mit (slot_count - 1) maskiert -> slot_count muss Zweierpotenz sein.
+ */
+
+#ifndef IPC_H
+#define IPC_H
+
+#include "common.h"
+
+/*============================================================================
+ * Konfiguration
+ *============================================================================*/
+
+#define IPC_CACHE_LINE      64
+#define IPC_RING_MAGIC      0x474E4952  /* "RING" */
+
+/* Slot-Größe in Bytes (inkl. 8 Byte Header, Vielfaches von 8) */
+#ifndef IPC_SLOT_SIZE
+#define IPC_SLOT_SIZE       128
+#endif
+
+/* Slots pro Richtung (Zweierpotenz) */
+#ifndef IPC_SLOT_COUNT
+#define IPC_SLOT_COUNT      512
+#endif
+
+/*============================================================================
+ * Shared Memory Strukturen (MÜSSEN mit linux_tools/amp_shared.h übereinstimmen!)
+ *============================================================================*/
+
+/* Steuerblock eines Rings - 3 Cache-Lines */
+typedef struct {
+    /* Cache-Line 0: nur vom Producer geschrieben */
+    volatile uint32_t head;
+    uint8_t  _pad0[IPC_CACHE_LINE - 4];
+
+    /* Cache-Line 1: nur vom Consumer geschrieben */
+    volatile uint32_t tail;
+    uint8_t  _pad1[IPC_CACHE_LINE - 4];
+
+    /* Cache-Line 2: Geometrie, nach dem Init read-only */
+    uint32_t magic;         /* IPC_RING_MAGIC, wird zuletzt gesetzt */
+    uint32_t slot_size;     /* Bytes pro Slot */
+    uint32_t slot_count;    /* Anzahl Slots (Zweierpotenz) */
+    uint32_t slots_offset;  /* Offset der Slots ab SHARED_MEM_BASE */
+    uint8_t  _pad2[IPC_CACHE_LINE - 16];
+} ipc_ring_ctrl_t;
+
+/*
+ * Ping-Pong Latenztest (linux_tools/pingpong): Linux schreibt eine
+ * Sequenznummer nach ping, Core 3 spiegelt sie nach pong - ohne Ring,
+ * je eine Cache-Line pro Schreiber.
+ */
+typedef struct {
+    /* Cache-Line 0: nur von Linux geschrieben */
+    volatile uint32_t ping;     /* Sequenznummer */
+    volatile uint32_t spin;     /* 1 = Core 3 pollt statt WFI (Polling-Modus) */
+    uint8_t  _pad0[IPC_CACHE_LINE - 8];
+
+    /* Cache-Line 1: nur von Core 3 geschrieben */
+    volatile uint32_t pong;     /* Zuletzt beantwortetes ping */
+    uint8_t  _pad1[IPC_CACHE_LINE - 4];
+} ipc_ping_t;
+
+/* Layout von SHARED_DATA_ADDR */
+typedef struct {
+    ipc_ring_ctrl_t to_core3;
+    ipc_ring_ctrl_t to_linux;
+    ipc_ping_t ping;
+} ipc_shared_t;
+
+/* Nachricht in einem Slot */
+typedef struct {
+    uint32_t type;          /* IPC_MSG_* */
+    uint32_t length;        /* Länge der Nutzdaten in Bytes */
+    uint8_t  data[];
+} ipc_msg_t;
+
+#define IPC_MSG_HDR_SIZE    8
+#define IPC_MSG_MAX_PAYLOAD (IPC_SLOT_SIZE - IPC_MSG_HDR_SIZE)
+
+/* Nachrichten-Typen */
+#define IPC_MSG_NOP         0   /* Wird ignoriert */
+#define IPC_MSG_ECHO        1   /* Core 3 schickt die Nachricht unverändert zurück */
+#define IPC_MSG_TEXT        2   /* Text, wird auf UART ausgegeben */
+#define IPC_MSG_BENCH_RX    3   /* Benchmark Linux->Core 3: data = {seq, total} */
+#define IPC_MSG_BENCH_TX    4   /* Benchmark Core 3->Linux anfordern: data = {count} */
+#define IPC_MSG_BENCH_DATA  5   /* Benchmark-Nachricht von Core 3: data = {seq} */
+#define IPC_MSG_BENCH_DONE  6   /* Ende Benchmark: data = {count, elapsed_us} */
+#define IPC_MSG_STATUS_STRESS       7   /* Seqlock Stresstest: data = {duration_us} */
+#define IPC_MSG_STATUS_STRESS_DONE  8   /* Ende Stresstest: data = {writes, elapsed_us} */
+#define IPC_MSG_BULK_TX     9   /* Pool-Puffer Core 3->Linux anfordern: data = {class, count} */
+#define IPC_MSG_BULK_TX_DONE 10 /* Ende Bulk-Transfer: data = {count, elapsed_us} */
+#define IPC_MSG_SET_BAUD    11  /* UART0 Baudrate: data = {baud} */
+#define IPC_MSG_SET_BAUD_DONE 12 /* Antwort: data = {baud (0 = abgelehnt), clock_hz} */
+
+/* Obergrenze für IPC_MSG_STATUS_STRESS (blockiert die Hauptschleife) */
+#define IPC_STATUS_STRESS_MAX_US    10000000
+
+/*============================================================================
+ * Lokaler Ring-Handle (nicht im Shared Memory)
+ *============================================================================*/
+
+typedef struct {
+    ipc_ring_ctrl_t *ctrl;
+    uint8_t  *slots;
+    uint32_t slot_size;
+    uint32_t mask;
+    uint32_t local;         /* Eigener Index (head beim Producer, tail beim Consumer) */
+    uint32_t peer_cache;    /* Zuletzt gelesener Index der Gegenseite */
+} ipc_ring_t;
+
+/*============================================================================
+ * Generische Ring-Funktionen
+ *============================================================================*/
+
+/**
+ * @brief Initialisiert Steuerblock und Handle eines Rings (Core 3 ist Owner)
+ * @param ring Lokaler Handle
+ * @param ctrl Steuerblock im Shared Memory
+ * @param slots Slot-Speicher im Shared Memory
+ * @param slot_size Bytes pro Slot (Vielfaches von 8)
+ * @param slot_count Anzahl Slots (Zweierpotenz)
+ */
+void ipc_ring_init(ipc_ring_t *ring, ipc_ring_ctrl_t *ctrl, void *slots,
+                   uint32_t slot_size, uint32_t slot_count);
+
+/**
+ * @brief Producer: Gibt den nächsten freien Slot zurück
+ * @return Slot-Pointer oder NULL wenn der Ring voll ist
+ */
+void* ipc_ring_reserve(ipc_ring_t *ring);
+
+/**
+ * @brief Producer: Veröffentlicht den mit ipc_ring_reserve() geholten Slot
+ */
+void ipc_ring_commit(ipc_ring_t *ring);
+
+/**
+ * @brief Consumer: Gibt den ältesten belegten Slot zurück
+ * @return Slot-Pointer oder NULL wenn der Ring leer ist
+ */
+void* ipc_ring_peek(ipc_ring_t *ring);
+
+/**
+ * @brief Consumer: Gibt den mit ipc_ring_peek() gelesenen Slot frei
+ */
+void ipc_ring_release(ipc_ring_t *ring);
+
+/*============================================================================
+ * Message API
+ *============================================================================*/
+
+/**
+ * @brief Initialisiert beide Ringe in SHARED_DATA_ADDR
+ */
+void ipc_init(void);
+
+/**
+ * @brief Sendet eine Nachricht an Linux
+ * @param type IPC_MSG_*
+ * @param data Nutzdaten (darf NULL sein wenn len = 0)
+ * @param len Länge in Bytes (max. IPC_MSG_MAX_PAYLOAD)
+ * @return true wenn gesendet, false wenn Ring voll oder zu lang
+ */
+bool ipc_send(uint32_t type, const void *data, uint32_t len);
+
+/**
+ * @brief Prüft ob Nachrichten von Linux anstehen (ohne sie zu verarbeiten)
+ */
+bool ipc_rx_pending(void);
+
+/**
+ * @brief Prüft ob Linux ein neues ping geschrieben hat
+ */
+bool ipc_ping_pending(void);
+
+/**
+ * @brief Prüft ob Linux den Polling-Modus angefordert hat (ipc_ping_t.spin)
+ *
+ * Dann wartet die Hauptschleife aktiv statt im WFI - für Latenzmessungen
+ * ohne Doorbell und Wake-up.
+ */
+bool ipc_spin_requested(void);
+
+/**
+ * @brief Verarbeitet alle anstehenden Nachrichten von Linux
+ *
+ * Beantwortet zuerst ein anstehendes ping. ECHO, TEXT, die Benchmark-
+ * Nachrichten und BULK_TX (pool.h) werden direkt behandelt.
+ * Aus der Hauptschleife aufrufen.
+ *
+ * @return Anzahl verarbeiteter Nachrichten
+ */
+uint32_t ipc_poll(void);
+
+#endif /* IPC_H */
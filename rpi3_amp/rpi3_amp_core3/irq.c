@@ -0,0 +1,100 @@
+/**
+ * @file irq.c
+ * @brief Exception- und Interrupt-Handling Implementierung
+ */
+
+#include "irq.h"
+#include "arch.h"
+#include "memory.h"
+#include "uart.h"
+
+/* HCR_EL2 Bits */
+#define HCR_FMO     (1UL << 3)
+#define HCR_IMO     (1UL << 4)
+
+/* Aus vectors.S */
+extern char vector_table[];
+
+/* Von vectors.S aufgerufen */
+void irq_handler(exception_frame_t *frame);
+void exception_handler(exception_frame_t *frame, uint32_t type);
+
+/*============================================================================
+ * Private Variablen
+ *============================================================================*/
+
+static irq_handler_t g_handlers[IRQ_SRC_COUNT];
+static volatile uint32_t g_irq_count = 0;
+
+/*============================================================================
+ * Implementierung
+ *============================================================================*/
+
+void irq_init(void) {
+    irq_disable();
+
+    if (arch_current_el() == 2) {
+        WRITE_SYSREG(vbar_el2, (uintptr_t)vector_table);
+        WRITE_SYSREG(hcr_el2, READ_SYSREG(hcr_el2) | HCR_IMO | HCR_FMO);
+    } else {
+        WRITE_SYSREG(vbar_el1, (uintptr_t)vector_table);
+    }
+    ISB();
+}
+
+void irq_register(uint32_t source, irq_handler_t handler) {
+    if (source < IRQ_SRC_COUNT) {
+        g_handlers[source] = handler;
+    }
+}
+
+uint32_t irq_get_count(void) {
+    return g_irq_count;
+}
+
+void irq_handler(exception_frame_t *frame) {
+    uint32_t pending = REG32(ARM_LOCAL_IRQ_SOURCE(CORE3_ID));
+
+    g_irq_count++;
+
+    for (uint32_t src = 0; src < IRQ_SRC_COUNT; src++) {
+        if ((pending & (1U << src)) && g_handlers[src]) {
+            g_handlers[src](frame);
+        }
+    }
+}
+
+void exception_handler(exception_frame_t *frame, uint32_t type) {
+    uint64_t esr, far;
+
+    if (arch_current_el() == 2) {
+        esr = READ_SYSREG(esr_el2);
+        far = READ_SYSREG(far_el2);
+    } else {
+        esr = READ_SYSREG(esr_el1);
+        far = READ_SYSREG(far_el1);
+    }
+
+    shared_mem_set_state(CORE3_STATE_ERROR);
+    shared_mem_set_debug("Unhandled exception - Core 3 halted");
+
+    /* Danach läuft keine Hauptschleife mehr, die den TX-Ring leert */
+    uart_set_tx_policy(UART_TX_BLOCK);
+
+    uart_puts("\n");
+    uart_puts("╔════════════════════════════════════════╗\n");
+    uart_puts("║           EXCEPTION                    ║\n");
+    uart_puts("╠════════════════════════════════════════╣\n");
+    uart_puts("║ Type : ");
+    switch (type) {
+        case EXC_TYPE_SYNC:   uart_puts("Synchronous\n"); break;
+        case EXC_TYPE_SERROR: uart_puts("SError\n"); break;
+        default:              uart_puts("Unhandled vector\n"); break;
+    }
+    uart_puts("║ ESR  : "); uart_put_hex64(esr);        uart_puts("\n");
+    uart_puts("║ FAR  : "); uart_put_hex64(far);        uart_puts("\n");
+    uart_puts("║ ELR  : "); uart_put_hex64(frame->elr); uart_puts("\n");
+    uart_puts("║ SPSR : "); uart_put_hex64(frame->spsr); uart_puts("\n");
+    uart_puts("╚════════════════════════════════════════╝\n");
+    uart_flush();
+}
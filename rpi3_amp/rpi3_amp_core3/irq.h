@@ -0,0 +1,127 @@
+/**
+ * @file irq.h
+ * @brief Exception-Vektoren und Interrupt-Dispatch für Core 3
+ *
+ * Interrupts kommen auf dem BCM2837 über den ARM Local Interrupt
+ * Controller (0x40000000) - pro Core gibt es ein eigenes IRQ Source
+ * Register. Die GPU Interrupts (UART, DMA, ...) werden NICHT auf Core 3
+ * geroutet: das GPU Routing gilt für alle GPU IRQs gleichzeitig und
+ * gehört Linux.
+ *
+ * Läuft Core 3 in EL2, wird HCR_EL2.IMO/FMO gesetzt, damit physikalische
+ * IRQs/FIQs in EL2 genommen werden.
+ */
+
+#ifndef IRQ_H
+#define IRQ_H
+
+#include "common.h"
+
+/*============================================================================
+ * ARM Local Register (BCM2836 QA7)
+ *============================================================================*/
+
+#define CORE3_ID                    3
+
+#define ARM_LOCAL_TIMER_INT_CTRL(c) (ARM_LOCAL_BASE + 0x40 + 4 * (c))
+#define ARM_LOCAL_MBOX_INT_CTRL(c)  (ARM_LOCAL_BASE + 0x50 + 4 * (c))
+#define ARM_LOCAL_IRQ_SOURCE(c)     (ARM_LOCAL_BASE + 0x60 + 4 * (c))
+#define ARM_LOCAL_MBOX_SET(c, m)    (ARM_LOCAL_BASE + 0x80 + 16 * (c) + 4 * (m))
+#define ARM_LOCAL_MBOX_RDCLR(c, m)  (ARM_LOCAL_BASE + 0xC0 + 16 * (c) + 4 * (m))
+
+/* Bits im IRQ Source Register */
+#define IRQ_SRC_CNTPS               0   /* Secure Physical Timer */
+#define IRQ_SRC_CNTPNS              1   /* Non-Secure Physical Timer */
+#define IRQ_SRC_CNTHP               2   /* Hypervisor Timer */
+#define IRQ_SRC_CNTV                3   /* Virtual Timer */
+#define IRQ_SRC_MBOX0               4   /* Mailbox 0..3 = Bits 4..7 */
+#define IRQ_SRC_GPU                 8
+#define IRQ_SRC_PMU                 9
+#define IRQ_SRC_LOCAL_TIMER         11
+#define IRQ_SRC_COUNT               12
+
+/*============================================================================
+ * Exception Frame (muss zu vectors.S passen!)
+ *============================================================================*/
+
+typedef struct {
+    uint64_t x[31];     /* x0 - x30 */
+    uint64_t elr;       /* Rücksprungadresse */
+    uint64_t spsr;      /* Gesicherter PSTATE */
+    uint64_t _pad;      /* 16-Byte Alignment */
+} exception_frame_t;
+
+/* Exception-Typen (Argument an exception_handler) */
+#define EXC_TYPE_SYNC               0
+#define EXC_TYPE_SERROR             1
+#define EXC_TYPE_UNHANDLED          2
+
+typedef void (*irq_handler_t)(exception_frame_t *frame);
+
+/*============================================================================
+ * Funktionen
+ *============================================================================*/
+
+/**
+ * @brief Installiert die Vektor-Tabelle und routet IRQs in das aktuelle EL
+ *
+ * IRQs bleiben maskiert bis irq_enable() aufgerufen wird.
+ */
+void irq_init(void);
+
+/**
+ * @brief Registriert einen Handler für ein Bit im Core 3 IRQ Source Register
+ * @param source IRQ_SRC_*
+ * @param handler Handler (läuft mit maskierten IRQs)
+ */
+void irq_register(uint32_t source, irq_handler_t handler);
+
+/**
+ * @brief Anzahl bisher behandelter IRQs
+ */
+uint32_t irq_get_count(void);
+
+#ifdef AMP_HOST
+
+/* Host-Build: Core 3 ist ein Thread ohne IRQs, nichts zu maskieren */
+static inline void irq_enable(void) {}
+static inline void irq_disable(void) {}
+static inline uint64_t irq_save(void) { return 0; }
+static inline void irq_restore(uint64_t flags) { (void)flags; }
+
+#else
+
+/**
+ * @brief Gibt IRQs frei (PSTATE.I = 0)
+ */
+static inline void irq_enable(void) {
+    asm volatile("msr daifclr, #2" ::: "memory");
+}
+
+/**
+ * @brief Maskiert IRQs (PSTATE.I = 1)
+ */
+static inline void irq_disable(void) {
+    asm volatile("msr daifset, #2" ::: "memory");
+}
+
+/**
+ * @brief Maskiert IRQs und gibt den vorherigen Zustand zurück
+ */
+static inline uint64_t irq_save(void) {
+    uint64_t flags;
+    asm volatile("mrs %0, daif" : "=r"(flags));
+    asm volatile("msr daifset, #2" ::: "memory");
+    return flags;
+}
+
+/**
+ * @brief Stellt den mit irq_save() gesicherten Zustand wieder her
+ */
+static inline void irq_restore(uint64_t flags) {
+    asm volatile("msr daif, %0" :: "r"(flags) : "memory");
+}
+
+#endif /* AMP_HOST */
+
+#endif /* IRQ_H */
@@ -7,8 +7,25 @@
 
 #include "common.h"
 #include "uart.h"
+#include "binlog.h"
 #include "timer.h"
 #include "memory.h"
+#include "mmu.h"
+#include "ipc.h"
+#include "pool.h"
+#include "cmd.h"
+#include "dsp.h"
+#include "dma.h"
+#include "irq.h"
+#include "gtimer.h"
+#include "doorbell.h"
+#include "sched.h"
+#include "scrub.h"
+#include "bench.h"
+#include "trace.h"
+#include "telem.h"
+#include "probe.h"
+#include "prof.h"
 
 /* CPU Info vorerst deaktiviert - verursacht Crash */
 /* #include "cpu_info.h" */
@@ -18,6 +35,25 @@
  *============================================================================*/
 
 #define HEARTBEAT_INTERVAL_MS   5000    /* 5 Sekunden */
+#define HEARTBEAT_PRIORITY      4       /* Scheduler: 0 = höchste */
+#define HEARTBEAT_DEADLINE_US   10000   /* Ausgabe landet nur im TX-Ring */
+#define TELEM_PRIORITY          6       /* Mailbox-Umlauf, nicht zeitkritisch */
+#define SCRUB_PRIORITY          7       /* Hintergrund: nach allen anderen */
+
+/* 1 = Memory Test beim Boot, scalar und wide zum Vergleich */
+#ifndef AMP_MEMTEST_BOOT
+#define AMP_MEMTEST_BOOT        0
+#endif
+
+/* 1 = Boot-Benchmark (Memory, IPC Ring, printf), für make qemu-bench */
+#ifndef AMP_BENCH_BOOT
+#define AMP_BENCH_BOOT          0
+#endif
+
+/* 1 = alte nop-Warteschleife statt WFI (Fallback zum Debuggen) */
+#ifndef AMP_IDLE_SPIN
+#define AMP_IDLE_SPIN           0
+#endif
 
 /*============================================================================
  * Einfache CPU-ID Funktion (sicher)
@@ -34,20 +70,75 @@ static uint32_t get_core_id(void) {
  *============================================================================*/
 
 static void print_banner(void) {
-    uart_puts("\n");
-    uart_puts("╔════════════════════════════════════════════════════════════╗\n");
-    uart_puts("║                                                            ║\n");
-    uart_puts("║   ██████╗ ██████╗ ██╗██████╗      █████╗ ███╗   ███╗██████╗║\n");
-    uart_puts("║   ██╔══██╗██╔══██╗██║╚════██╗    ██╔══██╗████╗ ████║██╔══██║\n");
-    uart_puts("║   ██████╔╝██████╔╝██║ █████╔╝    ███████║██╔████╔██║██████╔║\n");
-    uart_puts("║   ██╔══██╗██╔═══╝ ██║ ╚═══██╗    ██╔══██║██║╚██╔╝██║██╔═══╝║\n");
-    uart_puts("║   ██║  ██║██║     ██║██████╔╝    ██║  ██║██║ ╚═╝ ██║██║    ║\n");
-    uart_puts("║   ╚═╝  ╚═╝╚═╝     ╚═╝╚═════╝     ╚═╝  ╚═╝╚═╝     ╚═╝╚═╝    ║\n");
-    uart_puts("║                                                            ║\n");
-    uart_puts("║        Asymmetric Multiprocessing - Core 3 Firmware        ║\n");
-    uart_puts("║                                                            ║\n");
-    uart_puts("╚════════════════════════════════════════════════════════════╝\n");
-    uart_puts("\n");
+    /* Ein Aufruf = ein Frame im Binär-Log */
+    LOG_PRINTF("\n"
+               "╔════════════════════════════════════════════════════════════╗\n"
+               "║                                                            ║\n"
+               "║   ██████╗ ██████╗ ██╗██████╗      █████╗ ███╗   ███╗██████╗║\n"
+               "║   ██╔══██╗██╔══██╗██║╚════██╗    ██╔══██╗████╗ ████║██╔══██║\n"
+               "║   ██████╔╝██████╔╝██║ █████╔╝    ███████║██╔████╔██║██████╔║\n"
+               "║   ██╔══██╗██╔═══╝ ██║ ╚═══██╗    ██╔══██║██║╚██╔╝██║██╔═══╝║\n"
+               "║   ██║  ██║██║     ██║██████╔╝    ██║  ██║██║ ╚═╝ ██║██║    ║\n"
+               "║   ╚═╝  ╚═╝╚═╝     ╚═╝╚═════╝     ╚═╝  ╚═╝╚═╝     ╚═╝╚═╝    ║\n"
+               "║                                                            ║\n"
+               "║        Asymmetric Multiprocessing - Core 3 Firmware        ║\n"
+               "║                                                            ║\n"
+               "╚════════════════════════════════════════════════════════════╝\n"
+               "\n");
+}
+
+/*============================================================================
+ * Idle
+ *============================================================================*/
+
+/**
+ * Schläft bis zum Doorbell-IRQ oder bis wake_at (Generic Timer Ticks).
+ * Solange der UART TX-Ring nicht leer ist, spätestens nach
+ * uart_tx_refill_us(), damit der FIFO nicht leerläuft.
+ *
+ * Ablauf mit maskierten IRQs, damit kein Klingeln verloren geht:
+ * erst core3_idle setzen, dann Ringe/Doorbell erneut prüfen, dann WFI.
+ * Linux prüft core3_idle nach dem Commit - einer von beiden sieht den
+ * anderen immer. Ein anstehender IRQ weckt WFI auch bei maskiertem DAIF.I.
+ */
+static void idle_wait(uint64_t wake_at) {
+#if AMP_IDLE_SPIN
+    (void)wake_at;
+    for (volatile int i = 0; i < 10000; i++) {
+        asm volatile("nop");
+    }
+#else
+    uint64_t refill = gtimer_count() + gtimer_us_to_ticks(uart_tx_refill_us());
+
+    if (uart_tx_pending() && wake_at > refill) {
+        wake_at = refill;
+    }
+
+    if (ipc_spin_requested()) {
+        /* Polling-Modus (pingpong -m poll): kein WFI, core3_idle bleibt 0 */
+        while (!ipc_ping_pending() && !doorbell_pending() && !ipc_rx_pending() &&
+               !pool_rx_pending() && !cmd_pending() && !dsp_pending() && wake_at > gtimer_count()) {
+        }
+        doorbell_take();
+        return;
+    }
+    
+    irq_disable();
+    shared_mem_set_idle(true);
+
+    if (!doorbell_pending() && !ipc_rx_pending() && !ipc_ping_pending() &&
+        !pool_rx_pending() && !cmd_pending() && !dsp_pending() && wake_at > gtimer_count()) {
+        gtimer_set_deadline(wake_at);
+        TRACE_BEGIN(TRACE_EV_IDLE, 0);
+        asm volatile("wfi");
+        TRACE_END(TRACE_EV_IDLE, 0);
+        gtimer_cancel();
+    }
+
+    shared_mem_set_idle(false);
+    irq_enable();
+    doorbell_take();
+#endif
 }
 
 /*============================================================================
@@ -60,22 +151,35 @@ static void print_heartbeat(uint32_t count) {
     timer_format_timestamp(timestamp, 0);
     timer_format_uptime(uptime, timer_get_seconds());
     
-    uart_puts("\n");
-    uart_puts("┌──────────────────────────────────────────┐\n");
-    uart_printf("│ HEARTBEAT #%u\n", count);
-    uart_puts("├──────────────────────────────────────────┤\n");
-    uart_printf("│ Time     : %s\n", timestamp);
-    uart_printf("│ Uptime   : %s\n", uptime);
-    
     shared_status_t *status = shared_mem_get_status();
-    if (status) {
-        uart_printf("│ HB Count : %u\n", status->heartbeat_counter);
-        uart_puts("│ Magic    : ");
-        uart_put_hex32(status->magic);
-        uart_puts("\n");
-    }
     
-    uart_puts("└──────────────────────────────────────────┘\n");
+    /* Ein Frame pro Heartbeat im Binär-Log */
+    LOG_PRINTF("\n"
+               "┌──────────────────────────────────────────┐\n"
+               "│ HEARTBEAT #%u\n"
+               "├──────────────────────────────────────────┤\n"
+               "│ Time     : %s\n"
+               "│ Uptime   : %s\n"
+               "│ HB Count : %u\n"
+               "│ Magic    : 0x%08X\n"
+               "└──────────────────────────────────────────┘\n",
+               count, timestamp, uptime,
+               status ? status->heartbeat_counter : 0,
+               status ? status->magic : 0);
+}
+
+/* Scheduler-Task: arg zeigt auf den Heartbeat-Zähler */
+static void heartbeat_task(void *arg) {
+    uint32_t *count = (uint32_t *)arg;
+
+    (*count)++;
+    
+    /* Shared Memory aktualisieren */
+    shared_mem_heartbeat();
+    
+    /* Ausgabe */
+    print_heartbeat(*count);
+    shared_mem_set_uart_stats(uart_get_tx_dropped(), uart_get_tx_peak());
 }
 
 /*============================================================================
@@ -84,12 +188,19 @@ static void print_heartbeat(uint32_t count) {
 
 void main(void) {
     uint32_t heartbeat_count = 0;
-    uint64_t last_heartbeat = 0;
+    uint32_t uart_dropped = 0;
     uint32_t core_id;
+    mmu_perf_t perf_before, perf_after;
+    
+    /* Zeitbasis zuerst: uart_init() braucht schon Timeouts */
+    timer_init();
     
     /* UART initialisieren */
     uart_init();
     
+    /* Exception Vektoren installieren (IRQs bleiben noch maskiert) */
+    irq_init();
+    
     /* Banner */
     print_banner();
     
@@ -98,25 +209,44 @@ void main(void) {
     /* Core ID prüfen */
     core_id = get_core_id();
     uart_printf("Core ID: %u\n", core_id);
+    uart_printf("UART0: %u baud, clock %u Hz\n", uart_get_baud(), uart_get_clock());
+    uart_printf("Time source: %s, %u Hz\n", timer_source_name(), timer_freq());
     
     if (core_id != 3) {
         uart_puts("WARNING: Not running on Core 3!\n");
     }
     
     /* Boot Info */
-    uart_puts("\n");
-    uart_puts("╔════════════════════════════════════════╗\n");
-    uart_puts("║           BOOT INFORMATION             ║\n");
-    uart_puts("╠════════════════════════════════════════╣\n");
-    uart_puts("║ Load Address  : ");
-    uart_put_hex32(AMP_CODE_BASE);
-    uart_puts("\n");
-    uart_printf("║ FW Version    : %u.%u.%u\n", 
-                (FIRMWARE_VERSION >> 16) & 0xFF,
-                (FIRMWARE_VERSION >> 8) & 0xFF,
-                FIRMWARE_VERSION & 0xFF);
-    uart_puts("║ Build Date    : " __DATE__ " " __TIME__ "\n");
-    uart_puts("╚════════════════════════════════════════╝\n");
+    LOG_PRINTF("\n"
+               "╔════════════════════════════════════════╗\n"
+               "║           BOOT INFORMATION             ║\n"
+               "╠════════════════════════════════════════╣\n"
+               "║ Load Address  : 0x%08X\n"
+               "║ FW Version    : %u.%u.%u\n"
+               "║ Build Date    : " __DATE__ " " __TIME__ "\n"
+               "╚════════════════════════════════════════╝\n",
+               AMP_CODE_BASE,
+               (FIRMWARE_VERSION >> 16) & 0xFF,
+               (FIRMWARE_VERSION >> 8) & 0xFF,
+               FIRMWARE_VERSION & 0xFF);
+    
+    /* MMU und Caches aktivieren - Durchsatz vorher/nachher messen */
+    uart_puts("\nEnabling MMU and caches...\n");
+    mmu_measure_perf(&perf_before);
+    mmu_init();
+    mmu_measure_perf(&perf_after);
+    uart_printf("  Instructions : %u -> %u kIPS\n", perf_before.kips, perf_after.kips);
+    uart_printf("  Memory       : %u -> %u MB/s\n", perf_before.mem_mbps, perf_after.mem_mbps);
+    
+    /* DMA-Kanal prüfen (vor den ersten dma_memcpy / dma_memset Aufrufen) */
+    dma_init();
+    if (dma_channel() >= 0) {
+        uart_printf("DMA: channel %d%s, %u KB per control block\n", dma_channel(),
+                    dma_is_lite() ? " (lite)" : "",
+                    (dma_is_lite() ? DMA_LITE_CHUNK : DMA_CHUNK) / 1024);
+    } else {
+        uart_puts("DMA: no channel, copies run on the CPU\n");
+    }
     
     /* Shared Memory initialisieren */
     uart_puts("\nInitializing shared memory...\n");
@@ -130,43 +260,143 @@ void main(void) {
         uart_put_hex32(status->magic);
         uart_puts(" (valid)\n");
         uart_printf("Boot count: %u\n", status->boot_count);
+        shared_mem_set_mmu_perf(mmu_get_flags(), &perf_before, &perf_after);
+        shared_mem_set_uart_baud(uart_get_clock(), uart_get_baud());
     } else {
         uart_puts("ERROR: Failed to initialize shared memory!\n");
     }
     
-    /* Memory Test überspringen für jetzt */
-    uart_puts("\nSkipping memory test for now.\n");
+    /* IPC Ringe im Data-Bereich anlegen */
+    ipc_init();
+    uart_printf("IPC rings: %u slots x %u bytes per direction\n",
+                IPC_SLOT_COUNT, IPC_SLOT_SIZE);
+    
+    /* Trace-Ring für linux_tools/trace_dump */
+    trace_init();
+    uart_printf("Trace ring: %u records x %u bytes\n",
+                TRACE_RECORDS, (uint32_t)sizeof(trace_rec_t));
+    
+    /* Zyklen-Messpunkte für linux_tools/probe_dump (make PROBE=1) */
+    probe_init();
+#if PROBE_ENABLE
+    uart_printf("Probes: %u sites, pair overhead %u cycles\n",
+                PROBE_MAX_SITES, ((probe_shared_t *)SHARED_PROBE_ADDR)->overhead_cycles);
+#endif
+    
+    /* Zero-Copy Buffer-Pool für Bulk-Transfers */
+    pool_init();
+    uart_printf("Buffer pool: %u x %u KB, %u x %u KB\n",
+                POOL_SMALL_COUNT, POOL_SMALL_SIZE / 1024,
+                POOL_LARGE_COUNT, POOL_LARGE_SIZE / 1024);
+    
+    /* Kommando-Queue (linux_tools/amp_cmd) */
+    cmd_init();
+    uart_printf("Command queue: %u slots, %u per loop\n", CMD_SLOTS, CMD_BATCH);
+    
+    /* DSP-Pipeline (linux_tools/dsp_stream) */
+    dsp_init();
+    uart_printf("DSP pipeline: %u x %u byte blocks, %u stages x %u taps\n",
+                DSP_SLOTS, DSP_BLOCK_BYTES, DSP_MAX_STAGES, DSP_MAX_TAPS);
+    
+    /* SoC-Telemetrie (Takte, Temperatur, Throttling), per Default von Linux */
+    telem_init();
+#if TELEM_PERIOD_MS > 0
+    if (telem_sample()) {
+        const telem_sample_t *s = telem_last();
+        uart_printf("Telemetry: ARM %u MHz, core %u MHz, %u.%u C, throttled 0x%X, every %u ms\n",
+                    s->arm_hz / 1000000, s->core_hz / 1000000,
+                    s->temp_mc / 1000, (s->temp_mc % 1000) / 100,
+                    s->throttled, TELEM_PERIOD_MS);
+    } else {
+        uart_printf("Telemetry: no mailbox answer, sampling every %u ms anyway\n",
+                    TELEM_PERIOD_MS);
+    }
+#else
+    uart_puts("Telemetry: written by linux_tools/telem_feed (GPU mailbox belongs to Linux)\n");
+#endif
+    
+    /* Doorbell und Wake-Timer, danach IRQs freigeben */
+    gtimer_init();
+    doorbell_init();
+    prof_init();
+    irq_enable();
+#if PROF_HZ > 0
+    uart_printf("Profiler: %u Hz, %u samples ring, stack depth %u\n",
+                PROF_HZ, PROF_SAMPLES, PROF_STACKS ? PROF_STACK_DEPTH : 0);
+#endif
+    uart_printf("Doorbell: mailbox %u, timer %u Hz\n", DOORBELL_MBOX, gtimer_freq());
+    
+    /* Periodische Tasks */
+    sched_init();
+    sched_add("heartbeat", heartbeat_task, &heartbeat_count,
+              HEARTBEAT_INTERVAL_MS * 1000, HEARTBEAT_PRIORITY, HEARTBEAT_DEADLINE_US);
+    shared_mem_set_heartbeat_interval(HEARTBEAT_INTERVAL_MS);
+#if SCRUB_KB_PER_STEP > 0
+    sched_add("scrub", scrub_task, NULL, SCRUB_PERIOD_MS * 1000, SCRUB_PRIORITY, 0);
+#endif
+#if TELEM_PERIOD_MS > 0
+    sched_add("telem", telem_task, NULL, TELEM_PERIOD_MS * 1000, TELEM_PRIORITY, 0);
+#endif
+    
+#if AMP_MEMTEST_BOOT
+    /* Memory Test: beide Engines nacheinander, MB/s stehen in der Ausgabe */
+    memtest_set_impl(MEMTEST_IMPL_SCALAR);
+    memory_test_full(SHARED_MEMTEST_ADDR, SHARED_MEMTEST_SIZE, true);
+    memtest_set_impl(MEMTEST_IMPL_WIDE);
+    memory_test_full(SHARED_MEMTEST_ADDR, SHARED_MEMTEST_SIZE, true);
+#endif
+    
+#if AMP_BENCH_BOOT
+    /* Ergebnisse im Status-Block (bench_*), danach BENCH_DONE_MARKER */
+    bench_run(NULL);
+#endif
+    
+    /* Memory Scrubber: läuft als Scheduler-Task im Hintergrund */
+    scrub_init();
+#if SCRUB_KB_PER_STEP > 0
+    scrub_add_default_ranges();
+    uart_printf("\nScrubber: %u KB per pass, %u KB every %u ms\n",
+                shared_mem_get_status() ? shared_mem_get_status()->scrub_pass_bytes / 1024 : 0,
+                SCRUB_KB_PER_STEP, SCRUB_PERIOD_MS);
+#else
+    uart_puts("\nScrubber disabled.\n");
+#endif
     
     /* Status setzen */
     shared_mem_set_state(CORE3_STATE_RUNNING);
     shared_mem_set_debug("Core 3 running OK");
     
-    uart_puts("\n");
-    uart_puts("════════════════════════════════════════════════════════════════\n");
-    uart_puts("  STARTUP COMPLETE - Entering main loop\n");
-    uart_printf("  Heartbeat interval: %u ms\n", HEARTBEAT_INTERVAL_MS);
-    uart_puts("  Linux can read status from: 0x20A00000\n");
-    uart_puts("════════════════════════════════════════════════════════════════\n");
+    LOG_PRINTF("\n"
+               "════════════════════════════════════════════════════════════════\n"
+               "  STARTUP COMPLETE - Entering main loop\n"
+               "  Heartbeat interval: %u ms\n"
+               "  Linux can read status from: 0x20A00000\n"
+               "════════════════════════════════════════════════════════════════\n",
+               HEARTBEAT_INTERVAL_MS);
+    
+    /* Ab hier darf die UART Ausgabe die Hauptschleife nicht mehr aufhalten */
+    uart_set_tx_policy(UART_TX_POLICY);
     
     /* Hauptschleife */
+    sched_start();
     while (1) {
-        uint64_t now = timer_get_ticks();
+        /* Fällige periodische Tasks (Heartbeat, ...) */
+        sched_run();
         
-        /* Heartbeat */
-        if ((now - last_heartbeat) >= (HEARTBEAT_INTERVAL_MS * 1000ULL)) {
-            last_heartbeat = now;
-            heartbeat_count++;
-            
-            /* Shared Memory aktualisieren */
-            shared_mem_heartbeat();
-            
-            /* Ausgabe */
-            print_heartbeat(heartbeat_count);
-        }
+        /* Nachrichten, Bulk-Puffer, Kommandos und DSP-Blöcke von Linux */
+        ipc_poll();
+        pool_poll();
+        cmd_poll();
+        dsp_poll();
         
-        /* Kurze Pause - KEIN wfe, das verursacht Crash! */
-        for (volatile int i = 0; i < 10000; i++) {
-            asm volatile("nop");
+        /* UART FIFO aus dem TX-Ring nachfüllen */
+        uart_tx_pump();
+        if (uart_get_tx_dropped() != uart_dropped) {
+            uart_dropped = uart_get_tx_dropped();
+            shared_mem_set_uart_stats(uart_dropped, uart_get_tx_peak());
         }
+        
+        /* Warten bis Linux klingelt oder die nächste Task fällig ist */
+        idle_wait(sched_next_release());
     }
 }
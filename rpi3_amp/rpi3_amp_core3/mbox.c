@@ -0,0 +1,150 @@
+/**
+ * @file mbox.c
+ * @brief VideoCore Mailbox Property-Interface Implementierung
+ */
+
+#include "mbox.h"
+#include "mmu.h"
+#include "timer.h"
+
+/*============================================================================
+ * Register (Mailbox 0 = GPU -> ARM lesen, Mailbox 1 = ARM -> GPU schreiben)
+ *============================================================================*/
+
+#define MBOX_BASE       (PERIPHERAL_BASE + 0x00B880)
+#define MBOX_READ       REG32(MBOX_BASE + 0x00)
+#define MBOX_PEEK       REG32(MBOX_BASE + 0x10)     /* Wie READ, ohne abzuholen */
+#define MBOX_STATUS     REG32(MBOX_BASE + 0x18)
+#define MBOX_WRITE      REG32(MBOX_BASE + 0x20)
+
+#define MBOX_FULL       0x80000000
+#define MBOX_EMPTY      0x40000000
+
+#define MBOX_CH_PROP    8               /* Property Tags ARM -> VC */
+#define MBOX_REQUEST    0x00000000
+#define MBOX_RESPONSE   0x80000000      /* Code im Header bei Erfolg */
+#define MBOX_TAG_RESP   0x80000000      /* Bit 31 in der Tag-Länge */
+
+/* GPU-Sicht auf den ARM Speicher: L2-ungecachter Alias */
+#define MBOX_BUS_ALIAS  0xC0000000
+
+/*============================================================================
+ * Variablen
+ *============================================================================*/
+
+/* Header (2) + Tags (3 + Werte) + End-Tag, 16 Byte ausgerichtet */
+#define MSG_WORDS_SINGLE    (2 + 3 + MBOX_MAX_VALUE_WORDS + 1)
+#define MSG_WORDS_BATCH     (2 + (3 + 2) * MBOX_BATCH_MAX + 1)
+#define MSG_WORDS           (MSG_WORDS_SINGLE > MSG_WORDS_BATCH ? MSG_WORDS_SINGLE : MSG_WORDS_BATCH)
+
+static volatile uint32_t g_msg[MSG_WORDS] __attribute__((aligned(16)));
+
+/*============================================================================
+ * Hilfsfunktionen
+ *============================================================================*/
+
+/*
+ * Schickt g_msg (words Wörter inkl. End-Tag) und wartet auf die Antwort.
+ * Fremde Antworten (Linux) bleiben in der Mailbox liegen.
+ */
+static bool transfer(uint32_t words) {
+    uintptr_t addr = (uintptr_t)g_msg;
+    uint32_t mail = ((uint32_t)addr | MBOX_BUS_ALIAS) | MBOX_CH_PROP;
+
+    g_msg[0] = words * 4;
+    g_msg[1] = MBOX_REQUEST;
+    dcache_clean_invalidate_range(addr, sizeof(g_msg));
+    DSB();
+
+    uint64_t start = timer_get_ticks();
+    while (MBOX_STATUS & MBOX_FULL) {
+        if (timer_get_ticks() - start > MBOX_TIMEOUT_US) {
+            return false;
+        }
+    }
+    MBOX_WRITE = mail;
+
+    for (;;) {
+        if (timer_get_ticks() - start > MBOX_TIMEOUT_US) {
+            return false;
+        }
+        if (!(MBOX_STATUS & MBOX_EMPTY) && MBOX_PEEK == mail) {
+            (void)MBOX_READ;
+            break;
+        }
+    }
+
+    DSB();
+    dcache_invalidate_range(addr, sizeof(g_msg));
+    return g_msg[1] == MBOX_RESPONSE;
+}
+
+/*============================================================================
+ * Öffentliche Funktionen
+ *============================================================================*/
+
+bool mbox_property(uint32_t tag, uint32_t *values, uint32_t words) {
+    uint32_t i;
+
+    if (words > MBOX_MAX_VALUE_WORDS) {
+        return false;
+    }
+
+    g_msg[2] = tag;
+    g_msg[3] = words * 4;
+    g_msg[4] = 0;
+    for (i = 0; i < words; i++) {
+        g_msg[5 + i] = values[i];
+    }
+    g_msg[5 + words] = 0;
+
+    if (!transfer(2 + 3 + words + 1) || !(g_msg[4] & MBOX_TAG_RESP)) {
+        return false;
+    }
+
+    for (i = 0; i < words; i++) {
+        values[i] = g_msg[5 + i];
+    }
+    return true;
+}
+
+bool mbox_property_batch(mbox_tag_t *tags, uint32_t count) {
+    uint32_t i, w = 2;
+
+    if (count > MBOX_BATCH_MAX) {
+        return false;
+    }
+
+    for (i = 0; i < count; i++) {
+        g_msg[w + 0] = tags[i].tag;
+        g_msg[w + 1] = 8;
+        g_msg[w + 2] = 0;
+        g_msg[w + 3] = tags[i].value[0];
+        g_msg[w + 4] = tags[i].value[1];
+        tags[i].ok = false;
+        w += 5;
+    }
+    g_msg[w] = 0;
+
+    if (!transfer(w + 1)) {
+        return false;
+    }
+
+    for (i = 0, w = 2; i < count; i++, w += 5) {
+        if (g_msg[w + 2] & MBOX_TAG_RESP) {
+            tags[i].value[0] = g_msg[w + 3];
+            tags[i].value[1] = g_msg[w + 4];
+            tags[i].ok = true;
+        }
+    }
+    return true;
+}
+
+uint32_t mbox_get_clock_rate(uint32_t clock_id) {
+    uint32_t values[2] = { clock_id, 0 };
+
+    if (!mbox_property(MBOX_TAG_GET_CLOCK_RATE, values, 2) || values[0] != clock_id) {
+        return 0;
+    }
+    return values[1];
+}
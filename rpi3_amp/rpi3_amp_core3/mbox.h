@@ -0,0 +1,103 @@
+/**
+ * @file mbox.h
+ * @brief VideoCore Mailbox Property-Interface (Mailbox 0, Kanal 8)
+ *
+ * Nicht zu verwechseln mit den ARM Local Mailboxes der Doorbell: hier
+ * fragt Core 3 die GPU-Firmware nach Takten, Spannungen usw. Der Puffer
+ * liegt im Core 3 Speicher und wird vor/nach dem Aufruf per Cache-Wartung
+ * mit der GPU abgeglichen (die GPU sieht ihn über den 0xC0000000 Alias).
+ *
+ * ACHTUNG: Linux benutzt dieselbe Mailbox (raspberrypi firmware driver)
+ * mit IRQ. Core 3 schaut per PEEK nach und holt nur die eigene Antwort ab,
+ * fremde bleiben für Linux liegen. Der Linux IRQ Handler auf Core 0 holt
+ * die Antwort von Core 3 aber fast immer zuerst ab: er schließt damit
+ * seine gerade laufende Transaktion mit einem nicht gefüllten Puffer ab,
+ * die echte Antwort landet dann bei seiner nächsten. Hier läuft derweil
+ * MBOX_TIMEOUT_US lang der Timeout ab (busy-wait), der Aufrufer nimmt
+ * Defaults.
+ *
+ * Jeder Aufruf kann also einen Firmware-Aufruf von Linux verfälschen: nur
+ * beim Boot oder auf ausdrückliche Benutzeraktion, nie periodisch. Die
+ * Telemetrie holt Linux selbst (/dev/vcio, linux_tools/telem_feed), die
+ * Mailbox-Task von Core 3 (make TELEM_MS=n) ist nur für Tests ohne Linux.
+ * Mehrere Tags per mbox_property_batch() in einer Nachricht schicken.
+ * Im Host-Build gibt es keine GPU, dort liefern alle Aufrufe false bzw. 0.
+ */
+
+#ifndef MBOX_H
+#define MBOX_H
+
+#include "common.h"
+
+/*============================================================================
+ * Konfiguration
+ *============================================================================*/
+
+#define MBOX_TIMEOUT_US         10000   /* Antwort der GPU-Firmware */
+#define MBOX_MAX_VALUE_WORDS    8       /* Größter Tag-Wertepuffer */
+#define MBOX_BATCH_MAX          4       /* Tags pro mbox_property_batch() */
+
+/* Property Tags */
+#define MBOX_TAG_GET_CLOCK_RATE 0x00030002  /* {clock_id} -> {clock_id, Hz} */
+#define MBOX_TAG_GET_TEMP       0x00030006  /* {0} -> {0, milli-°C} */
+#define MBOX_TAG_GET_MAX_TEMP   0x0003000A  /* {0} -> {0, milli-°C} */
+#define MBOX_TAG_GET_THROTTLED  0x00030046  /* {0} -> {MBOX_THROTTLED_*} */
+
+/* Clock IDs */
+#define MBOX_CLOCK_UART         2
+#define MBOX_CLOCK_ARM          3
+#define MBOX_CLOCK_CORE         4
+
+/* GET_THROTTLED Bits (aktuell, ab Bit 16 seit dem Boot aufgetreten) */
+#define MBOX_THROTTLED_UNDERVOLT    (1U << 0)
+#define MBOX_THROTTLED_ARM_CAPPED   (1U << 1)
+#define MBOX_THROTTLED_THROTTLED    (1U << 2)
+#define MBOX_THROTTLED_SOFT_TEMP    (1U << 3)
+#define MBOX_THROTTLED_STICKY(b)    ((b) << 16)
+
+/*============================================================================
+ * Typen
+ *============================================================================*/
+
+/* Ein Tag mit (höchstens) zwei Wertewörtern für mbox_property_batch() */
+typedef struct {
+    uint32_t tag;           /* MBOX_TAG_* */
+    uint32_t value[2];      /* Ein: Request, Aus: Antwort */
+    bool     ok;            /* Aus: GPU hat den Tag beantwortet */
+} mbox_tag_t;
+
+/*============================================================================
+ * Funktionen
+ *============================================================================*/
+
+/**
+ * @brief Schickt eine Property-Nachricht mit genau einem Tag
+ *
+ * @param tag MBOX_TAG_*
+ * @param values Ein: Request-Werte, Aus: Antwort-Werte
+ * @param words Größe des Wertepuffers in Wörtern (max. MBOX_MAX_VALUE_WORDS)
+ * @return true wenn die GPU den Tag beantwortet hat
+ */
+bool mbox_property(uint32_t tag, uint32_t *values, uint32_t words);
+
+/**
+ * @brief Schickt bis zu MBOX_BATCH_MAX Tags in einer Nachricht
+ *
+ * Ein Umlauf zur GPU statt einem pro Tag. Jeder Tag hat einen
+ * Wertepuffer von zwei Wörtern, ok sagt, ob er beantwortet wurde.
+ *
+ * @param tags Tags, value[] vorbelegt
+ * @param count Anzahl (max. MBOX_BATCH_MAX)
+ * @return true wenn die Nachricht beantwortet wurde (einzelne Tags
+ *         können trotzdem ok = false haben)
+ */
+bool mbox_property_batch(mbox_tag_t *tags, uint32_t count);
+
+/**
+ * @brief Fragt einen Takt ab
+ * @param clock_id MBOX_CLOCK_*
+ * @return Takt in Hz, 0 bei Fehler
+ */
+uint32_t mbox_get_clock_rate(uint32_t clock_id);
+
+#endif /* MBOX_H */
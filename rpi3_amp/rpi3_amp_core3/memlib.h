@@ -0,0 +1,43 @@
+/**
+ * @file memlib.h
+ * @brief memcpy / memmove / memset / memcmp ohne libc (memlib.S)
+ *
+ * Die Firmware hat keine libc, GCC erzeugt aber auch mit -ffreestanding
+ * Aufrufe dieser Funktionen (Struct-Kopien, große Initialisierungen,
+ * erkannte Schleifen). memlib.S liefert sie mit den C-Signaturen:
+ * ldp/stp mit 64 Byte pro Durchlauf, memset(0) ab 256 Byte per DC ZVA.
+ *
+ * -ffreestanding schaltet die Builtins ab, jeder memcpy() wäre ein Aufruf.
+ * Die Makros unten geben GCC die Builtins zurück: kleine konstante Längen
+ * werden inline zu ein paar ldr/str, alles andere ruft memlib.S auf.
+ *
+ * Erst nach mmu_init() benutzen: unausgerichtete Zugriffe und DC ZVA
+ * brauchen Normal Memory (vorher Alignment Fault).
+ *
+ * Host-Build: die libc Funktionen aus <string.h>.
+ */
+
+#ifndef MEMLIB_H
+#define MEMLIB_H
+
+#include "common.h"
+
+#ifdef AMP_HOST
+
+#include <string.h>
+
+#else
+
+void *memcpy(void *dst, const void *src, size_t n);
+void *memmove(void *dst, const void *src, size_t n);
+void *memset(void *dst, int c, size_t n);
+int memcmp(const void *a, const void *b, size_t n);
+
+#define memcpy(dst, src, n)     __builtin_memcpy((dst), (src), (n))
+#define memmove(dst, src, n)    __builtin_memmove((dst), (src), (n))
+#define memset(dst, c, n)       __builtin_memset((dst), (c), (n))
+#define memcmp(a, b, n)         __builtin_memcmp((a), (b), (n))
+
+#endif /* AMP_HOST */
+
+#endif /* MEMLIB_H */
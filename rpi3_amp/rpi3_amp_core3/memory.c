@@ -4,8 +4,12 @@
  */
 
 #include "memory.h"
+#include "irq.h"
+#include "memlib.h"
 #include "uart.h"
+#include "binlog.h"
 #include "timer.h"
+#include "probe.h"
 
 /*============================================================================
  * Private Variablen
@@ -13,16 +17,42 @@
 
 static shared_status_t *g_status = NULL;
 
+_Static_assert(sizeof(shared_status_t) <= SHARED_STATUS_SIZE,
+               "shared_status_t passt nicht in die Status-Page");
+
 /*============================================================================
  * String Hilfsfunktionen
  *============================================================================*/
 
 static void str_copy(char *dest, const char *src, uint32_t max_len) {
-    uint32_t i;
-    for (i = 0; i < max_len - 1 && src[i] != '\0'; i++) {
-        dest[i] = src[i];
+    uint32_t len = 0;
+    while (len < max_len - 1 && src[len] != '\0') {
+        len++;
     }
-    dest[i] = '\0';
+    /* Ziel ist Shared Memory: ein memcpy statt einzelner Byte-Stores */
+    memcpy(dest, src, len);
+    dest[len] = '\0';
+}
+
+/*============================================================================
+ * Seqlock
+ *
+ * IRQs bleiben während des Updates maskiert: sonst könnte der Doorbell-
+ * Handler (shared_mem_set_wake_latency) mitten in ein anderes Update
+ * schreiben und seq zweimal hochzählen.
+ *============================================================================*/
+
+static uint64_t status_write_begin(void) {
+    uint64_t flags = irq_save();
+    g_status->seq++;
+    DMB();  /* seq ungerade, bevor die Daten geschrieben werden */
+    return flags;
+}
+
+static void status_write_end(uint64_t flags) {
+    DMB();  /* Daten vollständig, bevor seq wieder gerade wird */
+    g_status->seq++;
+    irq_restore(flags);
 }
 
 /*============================================================================
@@ -32,13 +62,11 @@ static void str_copy(char *dest, const char *src, uint32_t max_len) {
 shared_status_t* shared_mem_init(void) {
     g_status = (shared_status_t *)SHARED_STATUS_ADDR;
     
-    /* Erst den gesamten Bereich auf 0 setzen */
-    uint8_t *ptr = (uint8_t *)g_status;
-    for (uint32_t i = 0; i < sizeof(shared_status_t); i++) {
-        ptr[i] = 0;
-    }
+    /* Erst den gesamten Bereich auf 0 setzen (unter DMA_MIN_BYTES, DC ZVA) */
+    memset(g_status, 0, sizeof(shared_status_t));
     
     /* Dann Struktur initialisieren */
+    uint64_t flags = status_write_begin();
     g_status->magic = FIRMWARE_MAGIC;
     g_status->version = FIRMWARE_VERSION;
     g_status->core3_state = CORE3_STATE_INIT;
@@ -54,6 +82,7 @@ shared_status_t* shared_mem_init(void) {
     g_status->messages_received = 0;
     
     str_copy(g_status->debug_message, "Core 3 initialized", sizeof(g_status->debug_message));
+    status_write_end(flags);
     
     /* Memory Barrier sicherstellen */
     DSB();
@@ -63,29 +92,188 @@ shared_status_t* shared_mem_init(void) {
 
 void shared_mem_update_uptime(void) {
     if (g_status) {
+        uint64_t flags = status_write_begin();
         g_status->uptime_ticks = timer_get_ticks() - g_status->boot_time;
-        DSB();
+        status_write_end(flags);
     }
 }
 
 void shared_mem_heartbeat(void) {
+    PROBE_BEGIN(shared_mem_heartbeat);
     if (g_status) {
+        /* Zähler und Uptime im selben Update */
+        uint64_t flags = status_write_begin();
         g_status->heartbeat_counter++;
-        shared_mem_update_uptime();
+        g_status->uptime_ticks = timer_get_ticks() - g_status->boot_time;
+        status_write_end(flags);
     }
+    PROBE_END(shared_mem_heartbeat);
 }
 
 void shared_mem_set_state(uint32_t state) {
     if (g_status) {
+        uint64_t flags = status_write_begin();
         g_status->core3_state = state;
-        DSB();
+        status_write_end(flags);
     }
 }
 
 void shared_mem_set_debug(const char *msg) {
     if (g_status) {
+        uint64_t flags = status_write_begin();
         str_copy(g_status->debug_message, msg, sizeof(g_status->debug_message));
-        DSB();
+        status_write_end(flags);
+    }
+}
+
+void shared_mem_set_mmu_perf(uint32_t flags, const mmu_perf_t *before,
+                             const mmu_perf_t *after) {
+    if (g_status) {
+        uint64_t irq = status_write_begin();
+        g_status->mmu_flags = flags;
+        g_status->perf_kips_uncached = before->kips;
+        g_status->perf_kips_cached = after->kips;
+        g_status->perf_mem_mbps_uncached = before->mem_mbps;
+        g_status->perf_mem_mbps_cached = after->mem_mbps;
+        status_write_end(irq);
+    }
+}
+
+void shared_mem_set_ipc_stats(uint32_t sent, uint32_t received,
+                              uint32_t rx_rate, uint32_t tx_rate) {
+    if (g_status) {
+        uint64_t flags = status_write_begin();
+        g_status->messages_sent = sent;
+        g_status->messages_received = received;
+        g_status->ipc_rx_rate = rx_rate;
+        g_status->ipc_tx_rate = tx_rate;
+        status_write_end(flags);
+    }
+}
+
+void shared_mem_set_wake_latency(uint32_t count, uint32_t min_ns,
+                                 uint32_t avg_ns, uint32_t max_ns) {
+    if (g_status) {
+        uint64_t flags = status_write_begin();
+        g_status->doorbell_count = count;
+        g_status->wake_lat_min_ns = min_ns;
+        g_status->wake_lat_avg_ns = avg_ns;
+        g_status->wake_lat_max_ns = max_ns;
+        status_write_end(flags);
+    }
+}
+
+void shared_mem_set_idle(bool idle) {
+    if (g_status) {
+        g_status->core3_idle = idle ? 1 : 0;
+        DMB();
+    }
+}
+
+void shared_mem_set_heartbeat_interval(uint32_t ms) {
+    if (g_status) {
+        uint64_t flags = status_write_begin();
+        g_status->heartbeat_interval_ms = ms;
+        status_write_end(flags);
+    }
+}
+
+void shared_mem_set_uart_stats(uint32_t dropped, uint32_t peak) {
+    if (g_status) {
+        uint64_t flags = status_write_begin();
+        g_status->uart_tx_dropped = dropped;
+        g_status->uart_tx_peak = peak;
+        status_write_end(flags);
+    }
+}
+
+void shared_mem_set_uart_baud(uint32_t clock_hz, uint32_t baud) {
+    if (g_status) {
+        uint64_t flags = status_write_begin();
+        g_status->uart_clock_hz = clock_hz;
+        g_status->uart_baud = baud;
+        status_write_end(flags);
+    }
+}
+
+void shared_mem_set_sched_task(uint32_t index, const sched_stats_t *stats) {
+    if (g_status && index < SCHED_MAX_TASKS) {
+        uint64_t flags = status_write_begin();
+        g_status->sched_tasks[index] = *stats;
+        if (index >= g_status->sched_task_count) {
+            g_status->sched_task_count = index + 1;
+        }
+        status_write_end(flags);
+    }
+}
+
+void shared_mem_set_scrub(uint32_t pass, uint32_t done, uint32_t pass_bytes,
+                          uint32_t errors, uint32_t bad_pages, uint32_t cur_addr) {
+    if (g_status) {
+        uint64_t flags = status_write_begin();
+        g_status->scrub_pass = pass;
+        g_status->scrub_bytes_done = done;
+        g_status->scrub_pass_bytes = pass_bytes;
+        g_status->scrub_errors = errors;
+        g_status->scrub_bad_pages = bad_pages;
+        g_status->scrub_cur_addr = cur_addr;
+        status_write_end(flags);
+    }
+}
+
+void shared_mem_set_bench(uint32_t mem_scalar_mbps, uint32_t mem_wide_mbps,
+                          uint32_t ipc_rate, uint32_t printf_rate) {
+    if (g_status) {
+        uint64_t flags = status_write_begin();
+        g_status->bench_mem_scalar_mbps = mem_scalar_mbps;
+        g_status->bench_mem_wide_mbps = mem_wide_mbps;
+        g_status->bench_ipc_rate = ipc_rate;
+        g_status->bench_printf_rate = printf_rate;
+        g_status->bench_done = 1;
+        status_write_end(flags);
+    }
+}
+
+void shared_mem_set_bench_printf(uint32_t printf_cycles, uint32_t legacy_cycles) {
+    if (g_status) {
+        uint64_t flags = status_write_begin();
+        g_status->bench_printf_cycles = printf_cycles;
+        g_status->bench_legacy_cycles = legacy_cycles;
+        status_write_end(flags);
+    }
+}
+
+void shared_mem_set_bench_timer(uint32_t systimer_cycles, uint32_t counter_cycles,
+                                uint32_t ticks_cycles) {
+    if (g_status) {
+        uint64_t flags = status_write_begin();
+        g_status->bench_timer_systimer_cycles = systimer_cycles;
+        g_status->bench_timer_counter_cycles = counter_cycles;
+        g_status->bench_timer_ticks_cycles = ticks_cycles;
+        status_write_end(flags);
+    }
+}
+
+void shared_mem_set_pool(uint32_t rx_bufs, uint32_t rx_kb, uint32_t rx_errors,
+                         uint32_t tx_bufs, uint32_t tx_kb) {
+    if (g_status) {
+        uint64_t flags = status_write_begin();
+        g_status->pool_rx_bufs = rx_bufs;
+        g_status->pool_rx_kb = rx_kb;
+        g_status->pool_rx_errors = rx_errors;
+        g_status->pool_tx_bufs = tx_bufs;
+        g_status->pool_tx_kb = tx_kb;
+        status_write_end(flags);
+    }
+}
+
+void shared_mem_stress(uint32_t value) {
+    if (g_status) {
+        uint64_t flags = status_write_begin();
+        for (uint32_t i = 0; i < STATUS_STRESS_WORDS; i++) {
+            g_status->stress_words[i] = value;
+        }
+        status_write_end(flags);
     }
 }
 
@@ -98,52 +286,14 @@ shared_status_t* shared_mem_get_status(void) {
  *============================================================================*/
 
 uint32_t memory_test_pattern(uintptr_t start_addr, uint32_t size, uint32_t pattern) {
-    volatile uint32_t *ptr = (volatile uint32_t *)start_addr;
-    uint32_t words = size / 4;
-    uint32_t errors = 0;
-    
-    /* Schreibe Pattern */
-    for (uint32_t i = 0; i < words; i++) {
-        ptr[i] = pattern;
-    }
-    
-    DSB();
-    
-    /* Lese und verifiziere */
-    for (uint32_t i = 0; i < words; i++) {
-        if (ptr[i] != pattern) {
-            errors++;
-        }
-    }
-    
+    PROBE_BEGIN(memory_test_pattern);
+    uint32_t errors = memtest_pattern(start_addr, size, pattern, NULL);
+    PROBE_END(memory_test_pattern);
     return errors;
 }
 
 uint32_t memory_test_walking_ones(uintptr_t start_addr, uint32_t size) {
-    volatile uint32_t *ptr = (volatile uint32_t *)start_addr;
-    uint32_t words = size / 4;
-    uint32_t errors = 0;
-    
-    /* Teste jede Bit-Position */
-    for (int bit = 0; bit < 32; bit++) {
-        uint32_t pattern = 1U << bit;
-        
-        /* Schreibe */
-        for (uint32_t i = 0; i < words; i++) {
-            ptr[i] = pattern;
-        }
-        
-        DSB();
-        
-        /* Verifiziere */
-        for (uint32_t i = 0; i < words; i++) {
-            if (ptr[i] != pattern) {
-                errors++;
-            }
-        }
-    }
-    
-    return errors;
+    return memtest_walking_ones(start_addr, size, NULL);
 }
 
 uint32_t memory_test_quick(uintptr_t start_addr, uint32_t size) {
@@ -157,12 +307,55 @@ uint32_t memory_test_quick(uintptr_t start_addr, uint32_t size) {
     return errors;
 }
 
+/* Ergebnis eines Einzeltests ausgeben und für den Status merken */
+static void report_test(uint32_t index, const memtest_result_t *res, bool verbose,
+                        uint32_t *fail_count, uint32_t *fail_addr) {
+    if (g_status && index < MEMTEST_NUM_TESTS) {
+        uint64_t flags = status_write_begin();
+        g_status->memtest_mbps[index] = res->mbps;
+        status_write_end(flags);
+    }
+    
+    for (uint32_t i = 0; i < res->fail_count && *fail_count < MEMTEST_MAX_FAIL_ADDRS; i++) {
+        fail_addr[(*fail_count)++] = res->fail_addr[i];
+    }
+    
+    if (!verbose) {
+        return;
+    }
+    if (res->errors == 0) {
+        uart_printf("PASS  %u MB/s\n", res->mbps);
+    } else {
+        uart_printf("FAIL (%u) %u MB/s\n", res->errors, res->mbps);
+        for (uint32_t i = 0; i < res->fail_count; i++) {
+            uart_printf("║   at 0x%08X\n", res->fail_addr[i]);
+        }
+    }
+}
+
 uint32_t memory_test_full(uintptr_t start_addr, uint32_t size, bool verbose) {
+    static const uint32_t patterns[4] = {
+        MEMTEST_PATTERN_ZEROS, MEMTEST_PATTERN_ONES,
+        MEMTEST_PATTERN_AA, MEMTEST_PATTERN_55
+    };
+    static const char * const names[4] = {
+        "All Zeros...    ", "All Ones...     ",
+        "0xAAAAAAAA...   ", "0x55555555...   "
+    };
+    memtest_result_t res;
     uint32_t total_errors = 0;
-    uint32_t test_errors;
+    uint32_t fail_count = 0;
+    uint32_t fail_addr[MEMTEST_MAX_FAIL_ADDRS];
+    memtest_impl_t impl = memtest_get_impl();
     
     if (g_status) {
         shared_mem_set_state(CORE3_STATE_MEMTEST);
+        uint64_t flags = status_write_begin();
+        g_status->memtest_impl = impl;
+        for (uint32_t i = 0; i < MEMTEST_NUM_TESTS; i++) {
+            g_status->memtest_mbps[i] = 0;
+        }
+        status_write_end(flags);
     }
     
     if (verbose) {
@@ -170,85 +363,31 @@ uint32_t memory_test_full(uintptr_t start_addr, uint32_t size, bool verbose) {
         uart_puts("╔════════════════════════════════════════╗\n");
         uart_puts("║           MEMORY TEST                  ║\n");
         uart_puts("╠════════════════════════════════════════╣\n");
-        uart_printf("║ Start Addr  : %x\n", start_addr);
+        uart_printf("║ Start Addr  : 0x%08lX\n", start_addr);
         uart_printf("║ Size        : %u bytes\n", size);
+        uart_printf("║ Engine      : %s\n",
+                    impl == MEMTEST_IMPL_WIDE ? "wide (128-bit NEON)" : "scalar (32-bit)");
         uart_puts("╠════════════════════════════════════════╣\n");
     }
     
-    /* Test 1: All Zeros */
-    if (verbose) uart_puts("║ Test 1: All Zeros...    ");
-    test_errors = memory_test_pattern(start_addr, size, MEMTEST_PATTERN_ZEROS);
-    total_errors += test_errors;
-    if (verbose) {
-        if (test_errors == 0) uart_puts("PASS\n");
-        else uart_printf("FAIL (%u)\n", test_errors);
-    }
-    
-    /* Test 2: All Ones */
-    if (verbose) uart_puts("║ Test 2: All Ones...     ");
-    test_errors = memory_test_pattern(start_addr, size, MEMTEST_PATTERN_ONES);
-    total_errors += test_errors;
-    if (verbose) {
-        if (test_errors == 0) uart_puts("PASS\n");
-        else uart_printf("FAIL (%u)\n", test_errors);
-    }
-    
-    /* Test 3: 0xAA */
-    if (verbose) uart_puts("║ Test 3: 0xAAAAAAAA...   ");
-    test_errors = memory_test_pattern(start_addr, size, MEMTEST_PATTERN_AA);
-    total_errors += test_errors;
-    if (verbose) {
-        if (test_errors == 0) uart_puts("PASS\n");
-        else uart_printf("FAIL (%u)\n", test_errors);
-    }
-    
-    /* Test 4: 0x55 */
-    if (verbose) uart_puts("║ Test 4: 0x55555555...   ");
-    test_errors = memory_test_pattern(start_addr, size, MEMTEST_PATTERN_55);
-    total_errors += test_errors;
-    if (verbose) {
-        if (test_errors == 0) uart_puts("PASS\n");
-        else uart_printf("FAIL (%u)\n", test_errors);
+    /* Test 1-4: Feste Pattern */
+    for (uint32_t t = 0; t < 4; t++) {
+        if (verbose) uart_printf("║ Test %u: %s", t + 1, names[t]);
+        total_errors += memtest_pattern(start_addr, size, patterns[t], &res);
+        report_test(t, &res, verbose, &fail_count, fail_addr);
     }
     
-    /* Test 5: Walking Ones (nur für kleine Bereiche) */
-    if (size <= 0x10000) {  /* Max 64 KB für walking ones */
+    /* Test 5: Walking Ones (scalar nur für kleine Bereiche) */
+    if (impl == MEMTEST_IMPL_WIDE || size <= MEMTEST_WALKING_MAX_SCALAR) {
         if (verbose) uart_puts("║ Test 5: Walking Ones... ");
-        test_errors = memory_test_walking_ones(start_addr, size);
-        total_errors += test_errors;
-        if (verbose) {
-            if (test_errors == 0) uart_puts("PASS\n");
-            else uart_printf("FAIL (%u)\n", test_errors);
-        }
+        total_errors += memtest_walking_ones(start_addr, size, &res);
+        report_test(4, &res, verbose, &fail_count, fail_addr);
     }
     
     /* Test 6: Address as Data */
     if (verbose) uart_puts("║ Test 6: Addr as Data... ");
-    {
-        volatile uint32_t *ptr = (volatile uint32_t *)start_addr;
-        uint32_t words = size / 4;
-        test_errors = 0;
-        
-        /* Schreibe Adresse als Daten */
-        for (uint32_t i = 0; i < words; i++) {
-            ptr[i] = start_addr + (i * 4);
-        }
-        
-        DSB();
-        
-        /* Verifiziere */
-        for (uint32_t i = 0; i < words; i++) {
-            if (ptr[i] != start_addr + (i * 4)) {
-                test_errors++;
-            }
-        }
-        
-        total_errors += test_errors;
-        if (verbose) {
-            if (test_errors == 0) uart_puts("PASS\n");
-            else uart_printf("FAIL (%u)\n", test_errors);
-        }
-    }
+    total_errors += memtest_addr_as_data(start_addr, size, &res);
+    report_test(5, &res, verbose, &fail_count, fail_addr);
     
     /* Ergebnis */
     if (verbose) {
@@ -264,9 +403,15 @@ uint32_t memory_test_full(uintptr_t start_addr, uint32_t size, bool verbose) {
     
     /* Status aktualisieren */
     if (g_status) {
+        uint64_t flags = status_write_begin();
         g_status->memtest_status = (total_errors == 0) ? 1 : 2;
         g_status->memtest_errors = total_errors;
         g_status->memtest_bytes = size;
+        g_status->memtest_fail_count = fail_count;
+        for (uint32_t i = 0; i < MEMTEST_MAX_FAIL_ADDRS; i++) {
+            g_status->memtest_fail_addr[i] = (i < fail_count) ? fail_addr[i] : 0;
+        }
+        status_write_end(flags);
         shared_mem_set_state(CORE3_STATE_RUNNING);
     }
     
@@ -278,28 +423,41 @@ uint32_t memory_test_full(uintptr_t start_addr, uint32_t size, bool verbose) {
  *============================================================================*/
 
 void memory_print_map(void) {
-    uart_puts("\n");
-    uart_puts("╔════════════════════════════════════════╗\n");
-    uart_puts("║           MEMORY MAP                   ║\n");
-    uart_puts("╠════════════════════════════════════════╣\n");
-    uart_puts("║ Linux RAM       : 0x00000000-0x1FFFFFFF\n");
-    uart_puts("║                   (512 MB)             ║\n");
-    uart_puts("╠────────────────────────────────────────╣\n");
-    uart_puts("║ AMP Code/Data   : 0x20000000-0x209FFFFF\n");
-    uart_puts("║                   (10 MB)              ║\n");
-    uart_puts("╠────────────────────────────────────────╣\n");
-    uart_puts("║ Shared Memory   : 0x20A00000-0x20BFFFFF\n");
-    uart_puts("║                   (2 MB)               ║\n");
-    uart_puts("║   - Status      : 0x20A00000 (4 KB)    ║\n");
-    uart_puts("║   - Data        : 0x20A01000 (4 KB)    ║\n");
-    uart_puts("║   - Memtest     : 0x20A02000 (64 KB)   ║\n");
-    uart_puts("╠────────────────────────────────────────╣\n");
-    uart_puts("║ Peripherals     : 0x3F000000-0x3FFFFFFF\n");
-    uart_puts("║                   (16 MB)              ║\n");
-    uart_puts("╠────────────────────────────────────────╣\n");
-    uart_puts("║ ARM Local       : 0x40000000-0x40000FFF\n");
-    uart_puts("║                   (4 KB)               ║\n");
-    uart_puts("╚════════════════════════════════════════╝\n");
+    LOG_PRINTF("\n"
+               "╔════════════════════════════════════════╗\n"
+               "║           MEMORY MAP                   ║\n"
+               "╠════════════════════════════════════════╣\n"
+               "║ Linux RAM       : 0x00000000-0x1FFFFFFF\n"
+               "║                   (512 MB)             ║\n"
+               "╠────────────────────────────────────────╣\n"
+               "║ AMP Code/Data   : 0x20000000-0x209FFFFF\n"
+               "║                   (10 MB)              ║\n"
+               "╠────────────────────────────────────────╣\n"
+               "║ Shared Memory   : 0x20A00000-0x20BFFFFF\n"
+               "║                   (2 MB)               ║\n"
+               "║   - Status      : 0x20A00000 (4 KB)    ║\n"
+               "║   - Data        : 0x20A01000 (4 KB)    ║\n"
+               "║   - Memtest     : 0x20A02000 (64 KB)   ║\n"
+               "╠────────────────────────────────────────╣\n"
+               "║ Peripherals     : 0x3F000000-0x3FFFFFFF\n"
+               "║                   (16 MB)              ║\n"
+               "╠────────────────────────────────────────╣\n"
+               "║ ARM Local       : 0x40000000-0x40000FFF\n"
+               "║                   (4 KB)               ║\n"
+               "╚════════════════════════════════════════╝\n");
+}
+
+/* Zustandsname für memory_print_status */
+static const char *state_name(uint32_t state) {
+    switch (state) {
+        case CORE3_STATE_BOOT:    return "BOOT";
+        case CORE3_STATE_INIT:    return "INIT";
+        case CORE3_STATE_RUNNING: return "RUNNING";
+        case CORE3_STATE_MEMTEST: return "MEMTEST";
+        case CORE3_STATE_ERROR:   return "ERROR";
+        case CORE3_STATE_HALTED:  return "HALTED";
+        default:                  return "UNKNOWN";
+    }
 }
 
 void memory_print_status(void) {
@@ -311,42 +469,33 @@ void memory_print_status(void) {
     char timestamp[16];
     timer_format_timestamp(timestamp, g_status->uptime_ticks);
     
-    uart_puts("\n");
-    uart_puts("╔════════════════════════════════════════╗\n");
-    uart_puts("║         SHARED MEMORY STATUS           ║\n");
-    uart_puts("╠════════════════════════════════════════╣\n");
-    uart_printf("║ Magic         : %x", g_status->magic);
-    if (g_status->magic == FIRMWARE_MAGIC) {
-        uart_puts(" (valid)\n");
-    } else {
-        uart_puts(" (INVALID!)\n");
-    }
-    uart_printf("║ Version       : %u.%u.%u\n", 
-                (g_status->version >> 16) & 0xFF,
-                (g_status->version >> 8) & 0xFF,
-                g_status->version & 0xFF);
-    uart_printf("║ State         : %u", g_status->core3_state);
-    switch (g_status->core3_state) {
-        case CORE3_STATE_BOOT:    uart_puts(" (BOOT)\n"); break;
-        case CORE3_STATE_INIT:    uart_puts(" (INIT)\n"); break;
-        case CORE3_STATE_RUNNING: uart_puts(" (RUNNING)\n"); break;
-        case CORE3_STATE_MEMTEST: uart_puts(" (MEMTEST)\n"); break;
-        case CORE3_STATE_ERROR:   uart_puts(" (ERROR)\n"); break;
-        case CORE3_STATE_HALTED:  uart_puts(" (HALTED)\n"); break;
-        default:                  uart_puts(" (UNKNOWN)\n"); break;
-    }
-    uart_printf("║ Boot Count    : %u\n", g_status->boot_count);
-    uart_printf("║ Uptime        : %s\n", timestamp);
-    uart_printf("║ Heartbeat     : %u\n", g_status->heartbeat_counter);
-    uart_puts("╠────────────────────────────────────────╣\n");
-    uart_puts("║ Memtest       : ");
+    /* Wenige große Aufrufe: im Binär-Log je ein Frame */
+    LOG_PRINTF("\n"
+               "╔════════════════════════════════════════╗\n"
+               "║         SHARED MEMORY STATUS           ║\n"
+               "╠════════════════════════════════════════╣\n"
+               "║ Magic         : 0x%08X (%s)\n"
+               "║ Version       : %u.%u.%u\n"
+               "║ State         : %u (%s)\n"
+               "║ Boot Count    : %u\n"
+               "║ Uptime        : %s\n"
+               "║ Heartbeat     : %u\n"
+               "╠────────────────────────────────────────╣\n",
+               g_status->magic,
+               g_status->magic == FIRMWARE_MAGIC ? "valid" : "INVALID!",
+               (g_status->version >> 16) & 0xFF,
+               (g_status->version >> 8) & 0xFF,
+               g_status->version & 0xFF,
+               g_status->core3_state, state_name(g_status->core3_state),
+               g_status->boot_count, timestamp, g_status->heartbeat_counter);
     switch (g_status->memtest_status) {
-        case 0: uart_puts("Not run\n"); break;
-        case 1: uart_printf("PASS (%u bytes)\n", g_status->memtest_bytes); break;
-        case 2: uart_printf("FAIL (%u errors)\n", g_status->memtest_errors); break;
+        case 0: LOG_PRINTF("║ Memtest       : Not run\n"); break;
+        case 1: LOG_PRINTF("║ Memtest       : PASS (%u bytes)\n", g_status->memtest_bytes); break;
+        case 2: LOG_PRINTF("║ Memtest       : FAIL (%u errors)\n", g_status->memtest_errors); break;
     }
-    uart_puts("╠────────────────────────────────────────╣\n");
-    uart_printf("║ Debug         : %s\n", g_status->debug_message);
-    uart_puts("╚════════════════════════════════════════╝\n");
+    LOG_PRINTF("╠────────────────────────────────────────╣\n"
+               "║ Debug         : %s\n"
+               "╚════════════════════════════════════════╝\n",
+               g_status->debug_message);
 }
 
@@ -10,14 +10,27 @@
 #define MEMORY_H
 
 #include "common.h"
+#include "mmu.h"
+#include "sched.h"
+#include "memtest.h"
 
 /*============================================================================
  * Shared Memory Status Struktur
  * 
  * Diese Struktur liegt am Anfang des Shared Memory (0x20A00000)
  * und kann von Linux und Core 3 gelesen/geschrieben werden.
+ *
+ * Alle shared_mem_set_*() Schreiber laufen als Seqlock: seq wird vor dem
+ * Update ungerade und danach wieder gerade. Ein Leser kopiert die ganze
+ * Struktur und wiederholt, wenn seq ungerade war oder sich geändert hat
+ * (linux_tools: amp_status_snapshot). Ausgenommen sind die Doorbell-Felder
+ * doorbell_stamp und core3_idle - die gehören zum Wake-Protokoll und
+ * werden einzeln gelesen.
  *============================================================================*/
 
+/* Wörter im Stresstest-Block (jedes Wort = Schreibzähler) */
+#define STATUS_STRESS_WORDS     8
+
 typedef struct {
     /* Header - Magic und Version zur Validierung */
     uint32_t magic;             /* FIRMWARE_MAGIC = "RP3A" */
@@ -42,12 +55,85 @@ typedef struct {
     uint32_t messages_sent;     /* Von Core 3 gesendet */
     uint32_t messages_received; /* Von Core 3 empfangen */
     
+    /* Seqlock Zähler, ungerade = Update läuft */
+    volatile uint32_t seq;
+    
     /* Reserviert für zukünftige Erweiterungen */
-    uint32_t reserved[8];
+    uint32_t reserved[7];
     
     /* Debug String (null-terminiert) */
     char debug_message[128];
     
+    /* MMU / Cache (gemessen beim Boot: vor und nach mmu_init) */
+    uint32_t mmu_flags;             /* MMU_FLAG_* Bits */
+    uint32_t perf_kips_uncached;    /* Instruktionen/s / 1000, MMU aus */
+    uint32_t perf_kips_cached;      /* Instruktionen/s / 1000, MMU an */
+    uint32_t perf_mem_mbps_uncached;/* Speicher-Durchsatz MB/s, MMU aus */
+    uint32_t perf_mem_mbps_cached;  /* Speicher-Durchsatz MB/s, MMU an */
+    
+    /* IPC Benchmark (Nachrichten/s, gemessen auf Core 3) */
+    uint32_t ipc_rx_rate;           /* Linux -> Core 3 */
+    uint32_t ipc_tx_rate;           /* Core 3 -> Linux */
+    
+    /* Doorbell / Idle (siehe doorbell.h) */
+    uint64_t doorbell_stamp;        /* Von Linux: CNTVCT_EL0 beim Klingeln */
+    uint32_t core3_idle;            /* 1 = Core 3 schläft in WFI -> Linux muss klingeln */
+    uint32_t doorbell_count;        /* Anzahl Doorbell-IRQs */
+    uint32_t wake_lat_min_ns;       /* Wake-Latenz Klingeln -> IRQ Handler */
+    uint32_t wake_lat_avg_ns;
+    uint32_t wake_lat_max_ns;
+    uint32_t uart_tx_dropped;       /* Wegen vollem TX-Ring verworfene Bytes */
+    uint32_t uart_tx_peak;          /* Höchster Füllstand des TX-Rings */
+    
+    /* Scheduler (siehe sched.h) */
+    uint32_t sched_task_count;
+    uint32_t _pad0;
+    sched_stats_t sched_tasks[SCHED_MAX_TASKS];
+    
+    /* Memory Test Details (memory_test_full) */
+    uint32_t memtest_impl;          /* memtest_impl_t: 0 = scalar, 1 = wide */
+    uint32_t memtest_mbps[MEMTEST_NUM_TESTS];   /* MB/s pro Test, 0 = nicht gelaufen */
+    uint32_t memtest_fail_count;    /* Gültige Einträge in memtest_fail_addr */
+    uint32_t memtest_fail_addr[MEMTEST_MAX_FAIL_ADDRS];  /* Erste Fehleradressen */
+    
+    /* Scrubber (siehe scrub.h, Bitmap in SHARED_SCRUB_ADDR) */
+    uint32_t scrub_pass;            /* Laufender Pass (1 = erster), 0 = aus */
+    uint32_t scrub_bytes_done;      /* Im laufenden Pass getestet */
+    uint32_t scrub_pass_bytes;      /* Bytes pro Pass */
+    uint32_t scrub_errors;          /* Fehlerhafte 64-bit Wörter, alle Passes */
+    uint32_t scrub_bad_pages;       /* Gesetzte Bits in der Bitmap */
+    uint32_t scrub_cur_addr;        /* Nächste zu testende Seite */
+    
+    /* Seqlock Stresstest (IPC_MSG_STATUS_STRESS): alle Wörter = Schreibzähler */
+    uint32_t stress_words[STATUS_STRESS_WORDS];
+    
+    /* Boot-Benchmark (AMP_BENCH_BOOT, siehe bench.h) */
+    uint32_t bench_done;            /* 1 = Ergebnisse gültig */
+    uint32_t bench_mem_scalar_mbps; /* Pattern Fill+Verify, Scalar-Pfad */
+    uint32_t bench_mem_wide_mbps;   /* Pattern Fill+Verify, Wide-Pfad */
+    uint32_t bench_ipc_rate;        /* Ring Loopback, Nachrichten/s */
+    uint32_t bench_printf_rate;     /* uart_printf Zeilen/s inkl. UART */
+    
+    /* Zero-Copy Buffer-Pool (siehe pool.h) */
+    uint32_t pool_rx_bufs;          /* Von Linux empfangene Puffer */
+    uint32_t pool_rx_kb;            /* Davon Nutzdaten in KB (läuft über) */
+    uint32_t pool_rx_errors;        /* Prüfsummen- oder Deskriptorfehler */
+    uint32_t pool_tx_bufs;          /* An Linux gesendete Puffer */
+    uint32_t pool_tx_kb;            /* Davon Nutzdaten in KB (läuft über) */
+    
+    /* Boot-Benchmark: CPU-Zyklen pro printf Aufruf (gültig mit bench_done) */
+    uint32_t bench_printf_cycles;   /* uart_printf (gepuffert, fmt.c) */
+    uint32_t bench_legacy_cycles;   /* uart_printf_legacy (zeichenweise) */
+    
+    /* UART0 (uart_set_baud, IPC_MSG_SET_BAUD) */
+    uint32_t uart_clock_hz;         /* UART-Takt laut GPU-Mailbox (sonst Default) */
+    uint32_t uart_baud;             /* Tatsächliche Baudrate */
+    
+    /* Boot-Benchmark: CPU-Zyklen pro Zeitquellen-Read (timer.h) */
+    uint32_t bench_timer_systimer_cycles;   /* System Timer CHI/CLO (MMIO) */
+    uint32_t bench_timer_counter_cycles;    /* CNTPCT_EL0 */
+    uint32_t bench_timer_ticks_cycles;      /* timer_get_ticks() inkl. Umrechnung */
+    
 } shared_status_t;
 
 /* Core 3 Zustände */
@@ -101,6 +187,138 @@ void shared_mem_set_state(uint32_t state);
  */
 void shared_mem_set_debug(const char *msg);
 
+/**
+ * @brief Trägt MMU-Status und die Durchsatz-Messung vorher/nachher ein
+ * @param flags MMU_FLAG_* Bits
+ * @param before Messung mit MMU/Caches aus
+ * @param after Messung mit MMU/Caches an
+ */
+void shared_mem_set_mmu_perf(uint32_t flags, const mmu_perf_t *before,
+                             const mmu_perf_t *after);
+
+/**
+ * @brief Aktualisiert die IPC Statistiken
+ * @param sent Gesendete Nachrichten
+ * @param received Empfangene Nachrichten
+ * @param rx_rate Benchmark Linux -> Core 3 (Nachrichten/s)
+ * @param tx_rate Benchmark Core 3 -> Linux (Nachrichten/s)
+ */
+void shared_mem_set_ipc_stats(uint32_t sent, uint32_t received,
+                              uint32_t rx_rate, uint32_t tx_rate);
+
+/**
+ * @brief Trägt die Doorbell Wake-Latenz Statistik ein
+ * @param count Anzahl Doorbell-IRQs
+ * @param min_ns Minimum in ns
+ * @param avg_ns Durchschnitt in ns
+ * @param max_ns Maximum in ns
+ */
+void shared_mem_set_wake_latency(uint32_t count, uint32_t min_ns,
+                                 uint32_t avg_ns, uint32_t max_ns);
+
+/**
+ * @brief Setzt das Idle-Flag, das Linux vor dem Klingeln prüft
+ *
+ * Läuft ohne Seqlock (Wake-Protokoll, wird bei jedem WFI geschrieben).
+ * Enthält eine volle Barriere: der Store muss sichtbar sein, bevor
+ * Core 3 ein letztes Mal die Ringe prüft und in WFI geht.
+ *
+ * @param idle true = Core 3 geht schlafen
+ */
+void shared_mem_set_idle(bool idle);
+
+/**
+ * @brief Trägt das aktuelle Heartbeat-Intervall ein
+ * @param ms Intervall in ms
+ */
+void shared_mem_set_heartbeat_interval(uint32_t ms);
+
+/**
+ * @brief Trägt die UART TX-Ring Statistik ein
+ * @param dropped Verworfene Bytes
+ * @param peak Höchster Füllstand in Bytes
+ */
+void shared_mem_set_uart_stats(uint32_t dropped, uint32_t peak);
+
+/**
+ * @brief Trägt UART-Takt und aktuelle Baudrate ein
+ * @param clock_hz UART-Takt in Hz
+ * @param baud Tatsächliche Baudrate
+ */
+void shared_mem_set_uart_baud(uint32_t clock_hz, uint32_t baud);
+
+/**
+ * @brief Trägt die Statistik einer Scheduler-Task ein
+ * @param index Task-ID (< SCHED_MAX_TASKS)
+ * @param stats Aktuelle Statistik
+ */
+void shared_mem_set_sched_task(uint32_t index, const sched_stats_t *stats);
+
+/**
+ * @brief Trägt den Fortschritt des Scrubbers ein
+ * @param pass Laufender Pass
+ * @param done Im laufenden Pass getestete Bytes
+ * @param pass_bytes Bytes pro Pass
+ * @param errors Fehlerhafte Wörter über alle Passes
+ * @param bad_pages Seiten mit Fehlern
+ * @param cur_addr Nächste zu testende Seite
+ */
+void shared_mem_set_scrub(uint32_t pass, uint32_t done, uint32_t pass_bytes,
+                          uint32_t errors, uint32_t bad_pages, uint32_t cur_addr);
+
+/**
+ * @brief Schreibt einen Stresstest-Wert in alle stress_words
+ *
+ * Für IPC_MSG_STATUS_STRESS: Linux zählt Kopien, in denen die Wörter
+ * nicht übereinstimmen (zerrissene Reads).
+ *
+ * @param value Schreibzähler
+ */
+void shared_mem_stress(uint32_t value);
+
+/**
+ * @brief Trägt die Ergebnisse des Boot-Benchmarks ein und setzt bench_done
+ * @param mem_scalar_mbps Memory Test Scalar-Pfad (MB/s)
+ * @param mem_wide_mbps Memory Test Wide-Pfad (MB/s)
+ * @param ipc_rate Ring Loopback (Nachrichten/s)
+ * @param printf_rate uart_printf (Zeilen/s)
+ */
+void shared_mem_set_bench(uint32_t mem_scalar_mbps, uint32_t mem_wide_mbps,
+                          uint32_t ipc_rate, uint32_t printf_rate);
+
+/**
+ * @brief Trägt die printf Zyklen des Boot-Benchmarks ein
+ *
+ * Vor shared_mem_set_bench() aufrufen, das bench_done setzt.
+ *
+ * @param printf_cycles Zyklen pro uart_printf
+ * @param legacy_cycles Zyklen pro uart_printf_legacy
+ */
+void shared_mem_set_bench_printf(uint32_t printf_cycles, uint32_t legacy_cycles);
+
+/**
+ * @brief Trägt die Zyklen pro Zeitquellen-Read des Boot-Benchmarks ein
+ *
+ * Vor shared_mem_set_bench() aufrufen, das bench_done setzt.
+ *
+ * @param systimer_cycles timer_read_systimer()
+ * @param counter_cycles timer_read_counter()
+ * @param ticks_cycles timer_get_ticks() mit der gewählten Quelle
+ */
+void shared_mem_set_bench_timer(uint32_t systimer_cycles, uint32_t counter_cycles,
+                                uint32_t ticks_cycles);
+
+/**
+ * @brief Aktualisiert die Statistik des Buffer-Pools
+ * @param rx_bufs Von Linux empfangene Puffer
+ * @param rx_kb Empfangene Nutzdaten in KB
+ * @param rx_errors Fehlerhafte Puffer
+ * @param tx_bufs An Linux gesendete Puffer
+ * @param tx_kb Gesendete Nutzdaten in KB
+ */
+void shared_mem_set_pool(uint32_t rx_bufs, uint32_t rx_kb, uint32_t rx_errors,
+                         uint32_t tx_bufs, uint32_t tx_kb);
+
 /**
  * @brief Gibt den Pointer zur Status-Struktur zurück
  * @return Pointer zur shared_status_t
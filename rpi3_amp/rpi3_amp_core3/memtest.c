@@ -0,0 +1,273 @@
+/**
+ * @file memtest.c
+ * @brief Memory-Test Engine Implementierung
+ *
+ * Alle Tests sind "Wort k enthält first + k * step":
+ *   Pattern       : step = 0
+ *   Addr as Data  : first = Startadresse, step = 4
+ *
+ * Der Wide-Pfad bearbeitet nur den 64 Byte ausgerichteten Kern des
+ * Bereichs, Anfang und Ende laufen über den Scalar-Pfad.
+ */
+
+#include "memtest.h"
+#include "arch.h"
+#include "mmu.h"
+
+/* 4 x 32-bit in einem Q-Register */
+typedef uint32_t v4u32 __attribute__((vector_size(16)));
+
+#define WIDE_BLOCK  64
+
+/*============================================================================
+ * Private Variablen
+ *============================================================================*/
+
+static memtest_impl_t g_impl = MEMTEST_IMPL_DEFAULT;
+
+/*============================================================================
+ * Ergebnis-Hilfsfunktionen
+ *============================================================================*/
+
+static void result_reset(memtest_result_t *res) {
+    res->errors = 0;
+    res->mbps = 0;
+    res->bytes = 0;
+    res->fail_count = 0;
+    for (uint32_t i = 0; i < MEMTEST_MAX_FAIL_ADDRS; i++) {
+        res->fail_addr[i] = 0;
+    }
+}
+
+static void result_fail(memtest_result_t *res, uintptr_t addr) {
+    res->errors++;
+    if (res->fail_count < MEMTEST_MAX_FAIL_ADDRS) {
+        res->fail_addr[res->fail_count++] = (uint32_t)addr;
+    }
+}
+
+static void result_finish(memtest_result_t *res, uint64_t ticks) {
+    if (ticks == 0) {
+        ticks = 1;
+    }
+    res->mbps = (uint32_t)(res->bytes * arch_counter_freq() / ticks / 1000000ULL);
+}
+
+/*============================================================================
+ * Scalar-Pfad (ein volatile 32-bit Zugriff pro Wort)
+ *============================================================================*/
+
+static void scalar_fill(uintptr_t p, uintptr_t end, uint32_t val, uint32_t step) {
+    volatile uint32_t *ptr = (volatile uint32_t *)p;
+
+    for (; (uintptr_t)ptr < end; ptr++) {
+        *ptr = val;
+        val += step;
+    }
+}
+
+static void scalar_verify(uintptr_t p, uintptr_t end, uint32_t val, uint32_t step,
+                          memtest_result_t *res) {
+    volatile uint32_t *ptr = (volatile uint32_t *)p;
+
+    for (; (uintptr_t)ptr < end; ptr++) {
+        if (*ptr != val) {
+            result_fail(res, (uintptr_t)ptr);
+        }
+        val += step;
+    }
+}
+
+/*============================================================================
+ * Wide-Pfad (128-bit NEON, 64 Byte pro Durchlauf)
+ *============================================================================*/
+
+#if MEMTEST_HAVE_WIDE
+
+/* Erwartete Werte der ersten 4 Wörter ab val */
+static v4u32 wide_first(uint32_t val, uint32_t step) {
+    v4u32 v = { val, val + step, val + 2 * step, val + 3 * step };
+    return v;
+}
+
+static v4u32 wide_splat(uint32_t val) {
+    v4u32 v = { val, val, val, val };
+    return v;
+}
+
+static void wide_fill(uintptr_t p, uintptr_t end, uint32_t val, uint32_t step) {
+    v4u32 e = wide_first(val, step);
+    v4u32 inc = wide_splat(4 * step);
+
+    asm volatile(
+        "1:  cmp     %[p], %[end]\n"
+        "    b.hs    2f\n"
+        "    add     v20.4s, %[e].4s, %[inc].4s\n"
+        "    add     v21.4s, v20.4s, %[inc].4s\n"
+        "    add     v22.4s, v21.4s, %[inc].4s\n"
+        "    stp     %q[e], q20, [%[p]]\n"
+        "    stp     q21, q22, [%[p], #32]\n"
+        "    add     %[e].4s, v22.4s, %[inc].4s\n"
+        "    add     %[p], %[p], #64\n"
+        "    b       1b\n"
+        "2:\n"
+        : [p] "+r"(p), [e] "+w"(e)
+        : [end] "r"(end), [inc] "w"(inc)
+        : "v20", "v21", "v22", "cc", "memory");
+}
+
+/*
+ * Vergleicht 64 Byte Blöcke ab p mit den erwarteten Werten in *e.
+ * Gibt den ersten fehlerhaften Block zurück (oder end); *e enthält
+ * dann die erwarteten Werte für dessen erste 4 Wörter.
+ */
+static uintptr_t wide_scan(uintptr_t p, uintptr_t end, v4u32 *e, v4u32 inc) {
+    v4u32 exp = *e;
+
+    asm volatile(
+        "1:  cmp     %[p], %[end]\n"
+        "    b.hs    2f\n"
+        "    ldp     q16, q17, [%[p]]\n"
+        "    ldp     q18, q19, [%[p], #32]\n"
+        "    add     v20.4s, %[e].4s, %[inc].4s\n"
+        "    add     v21.4s, v20.4s, %[inc].4s\n"
+        "    add     v22.4s, v21.4s, %[inc].4s\n"
+        "    eor     v16.16b, v16.16b, %[e].16b\n"
+        "    eor     v17.16b, v17.16b, v20.16b\n"
+        "    eor     v18.16b, v18.16b, v21.16b\n"
+        "    eor     v19.16b, v19.16b, v22.16b\n"
+        "    orr     v16.16b, v16.16b, v17.16b\n"
+        "    orr     v18.16b, v18.16b, v19.16b\n"
+        "    orr     v16.16b, v16.16b, v18.16b\n"
+        "    umaxv   s16, v16.4s\n"
+        "    fmov    w9, s16\n"
+        "    cbnz    w9, 2f\n"
+        "    add     %[e].4s, v22.4s, %[inc].4s\n"
+        "    add     %[p], %[p], #64\n"
+        "    b       1b\n"
+        "2:\n"
+        : [p] "+r"(p), [e] "+w"(exp)
+        : [end] "r"(end), [inc] "w"(inc)
+        : "v16", "v17", "v18", "v19", "v20", "v21", "v22", "x9", "cc", "memory");
+
+    *e = exp;
+    return p;
+}
+
+static void wide_verify(uintptr_t p, uintptr_t end, uint32_t val, uint32_t step,
+                        memtest_result_t *res) {
+    v4u32 e = wide_first(val, step);
+    v4u32 inc = wide_splat(4 * step);
+    v4u32 block = wide_splat(16 * step);
+
+    while ((p = wide_scan(p, end, &e, inc)) < end) {
+        /* Fehlerhafter Block: wortweise zählen und Adressen merken */
+        scalar_verify(p, p + WIDE_BLOCK, e[0], step, res);
+        e += block;
+        p += WIDE_BLOCK;
+    }
+}
+
+#else
+
+/* Kein NEON (Host-Build): memtest_set_impl() lässt WIDE nie zu */
+#define wide_fill       scalar_fill
+#define wide_verify     scalar_verify
+
+#endif /* MEMTEST_HAVE_WIDE */
+
+/*============================================================================
+ * Fill + Verify über einen Bereich
+ *============================================================================*/
+
+static void fill_verify(uintptr_t start, uint32_t size, uint32_t first, uint32_t step,
+                        memtest_result_t *res) {
+    uintptr_t end = start + (size & ~3U);
+    uintptr_t head = (start + WIDE_BLOCK - 1) & ~(uintptr_t)(WIDE_BLOCK - 1);
+    uintptr_t tail = end & ~(uintptr_t)(WIDE_BLOCK - 1);
+    bool wide = (g_impl == MEMTEST_IMPL_WIDE) && head < tail && (start & 3) == 0;
+
+#define VAL_AT(a)   (first + (uint32_t)(((a) - start) / 4) * step)
+
+    /* Fill */
+    if (wide) {
+        scalar_fill(start, head, first, step);
+        wide_fill(head, tail, VAL_AT(head), step);
+        scalar_fill(tail, end, VAL_AT(tail), step);
+    } else {
+        scalar_fill(start, end, first, step);
+    }
+
+    DSB();
+
+    /* Aus dem Cache verdrängen, damit Verify aus dem DRAM liest */
+    if (mmu_is_cacheable(start)) {
+        dcache_clean_invalidate_range(start, (uint32_t)(end - start));
+    }
+
+    /* Verify */
+    if (wide) {
+        scalar_verify(start, head, first, step, res);
+        wide_verify(head, tail, VAL_AT(head), step, res);
+        scalar_verify(tail, end, VAL_AT(tail), step, res);
+    } else {
+        scalar_verify(start, end, first, step, res);
+    }
+
+#undef VAL_AT
+
+    res->bytes += 2ULL * (end - start);
+}
+
+/*============================================================================
+ * Öffentliche Funktionen
+ *============================================================================*/
+
+void memtest_set_impl(memtest_impl_t impl) {
+    g_impl = MEMTEST_HAVE_WIDE ? impl : MEMTEST_IMPL_SCALAR;
+}
+
+memtest_impl_t memtest_get_impl(void) {
+    return g_impl;
+}
+
+uint32_t memtest_pattern(uintptr_t start, uint32_t size, uint32_t pattern,
+                         memtest_result_t *result) {
+    memtest_result_t local;
+    memtest_result_t *res = result ? result : &local;
+
+    result_reset(res);
+    uint64_t t0 = arch_counter();
+    fill_verify(start, size, pattern, 0, res);
+    result_finish(res, arch_counter() - t0);
+
+    return res->errors;
+}
+
+uint32_t memtest_walking_ones(uintptr_t start, uint32_t size,
+                              memtest_result_t *result) {
+    memtest_result_t local;
+    memtest_result_t *res = result ? result : &local;
+
+    result_reset(res);
+    uint64_t t0 = arch_counter();
+    for (int bit = 0; bit < 32; bit++) {
+        fill_verify(start, size, 1U << bit, 0, res);
+    }
+    result_finish(res, arch_counter() - t0);
+
+    return res->errors;
+}
+
+uint32_t memtest_addr_as_data(uintptr_t start, uint32_t size,
+                              memtest_result_t *result) {
+    memtest_result_t local;
+    memtest_result_t *res = result ? result : &local;
+
+    result_reset(res);
+    uint64_t t0 = arch_counter();
+    fill_verify(start, size, (uint32_t)start, 4, res);
+    result_finish(res, arch_counter() - t0);
+
+    return res->errors;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file memtest.h
+ * @brief Memory-Test Engine: Scalar (32-bit volatile) und Wide (128-bit NEON)
+ *
+ * Jeder Test besteht aus Fill + Verify über einen Bereich:
+ *
+ *   SCALAR : ein volatile 32-bit Zugriff pro Wort (ursprünglicher Pfad)
+ *   WIDE   : stp/ldp mit Q-Registern, 64 Byte pro Schleifendurchlauf;
+ *            Vergleich per eor/orr/umaxv, erst bei einem fehlerhaften
+ *            64 Byte Block wird wortweise nachgezählt
+ *
+ * Beide Pfade zählen Fehler pro 32-bit Wort und liefern dieselben
+ * Ergebnisse. Liegt der Bereich cacheable, wird zwischen Fill und Verify
+ * clean+invalidate gemacht - sonst würde nur der Cache getestet.
+ *
+ * Die FPU/SIMD Einheit wird in boot.S freigeschaltet.
+ */
+
+#ifndef MEMTEST_H
+#define MEMTEST_H
+
+#include "common.h"
+
+/*============================================================================
+ * Konfiguration
+ *============================================================================*/
+
+/* Tests in memory_test_full(): 4 Pattern, Walking Ones, Addr as Data */
+#define MEMTEST_NUM_TESTS       6
+
+/* Anzahl gemerkter Fehleradressen pro Test */
+#define MEMTEST_MAX_FAIL_ADDRS  4
+
+/* Walking Ones über mehr als 64 KB nur mit dem Wide-Pfad */
+#define MEMTEST_WALKING_MAX_SCALAR  0x10000
+
+typedef enum {
+    MEMTEST_IMPL_SCALAR = 0,
+    MEMTEST_IMPL_WIDE   = 1
+} memtest_impl_t;
+
+/* Wide-Pfad nur auf aarch64 (Inline-Assembler), im Host-Build immer scalar */
+#ifdef AMP_HOST
+#define MEMTEST_HAVE_WIDE       0
+#else
+#define MEMTEST_HAVE_WIDE       1
+#endif
+
+/* Default-Implementierung (zur Laufzeit mit memtest_set_impl() umschaltbar) */
+#ifndef MEMTEST_IMPL_DEFAULT
+#if MEMTEST_HAVE_WIDE
+#define MEMTEST_IMPL_DEFAULT    MEMTEST_IMPL_WIDE
+#else
+#define MEMTEST_IMPL_DEFAULT    MEMTEST_IMPL_SCALAR
+#endif
+#endif
+
+/*============================================================================
+ * Typen
+ *============================================================================*/
+
+typedef struct {
+    uint32_t errors;            /* Fehlerhafte 32-bit Wörter */
+    uint32_t mbps;              /* (geschriebene + gelesene Bytes) / Zeit */
+    uint64_t bytes;             /* Geschriebene + gelesene Bytes */
+    uint32_t fail_count;        /* Gültige Einträge in fail_addr */
+    uint32_t fail_addr[MEMTEST_MAX_FAIL_ADDRS];  /* Erste Fehleradressen */
+} memtest_result_t;
+
+/*============================================================================
+ * Funktionen
+ *============================================================================*/
+
+/**
+ * @brief Wählt den Scalar- oder Wide-Pfad für alle folgenden Tests
+ *
+ * Ohne MEMTEST_HAVE_WIDE bleibt es beim Scalar-Pfad.
+ */
+void memtest_set_impl(memtest_impl_t impl);
+
+/**
+ * @brief Aktuell gewählter Pfad
+ */
+memtest_impl_t memtest_get_impl(void);
+
+/**
+ * @brief Fill + Verify mit einem festen 32-bit Muster
+ * @param result Wird gefüllt (darf NULL sein)
+ * @return Anzahl Fehler
+ */
+uint32_t memtest_pattern(uintptr_t start, uint32_t size, uint32_t pattern,
+                         memtest_result_t *result);
+
+/**
+ * @brief Walking Ones: 32 Durchläufe mit je einem gesetzten Bit
+ * @param result Wird gefüllt (darf NULL sein)
+ * @return Anzahl Fehler
+ */
+uint32_t memtest_walking_ones(uintptr_t start, uint32_t size,
+                              memtest_result_t *result);
+
+/**
+ * @brief Adresse als Daten: jedes Wort enthält seine eigene Adresse
+ * @param result Wird gefüllt (darf NULL sein)
+ * @return Anzahl Fehler
+ */
+uint32_t memtest_addr_as_data(uintptr_t start, uint32_t size,
+                              memtest_result_t *result);
+
+#endif /* MEMTEST_H */
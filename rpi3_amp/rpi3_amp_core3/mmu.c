@@ -0,0 +1,282 @@
+/**
+ * @file mmu.c
+ * @brief MMU und Cache Setup Implementierung
+ *
+ * Translation Regime: 4 KB Granule, T0SZ = 32 (4 GB VA), Start bei Level 1.
+ *
+ *   Level 1 [0] 0x00000000-0x3FFFFFFF  -> Level 2 Table (2 MB Blöcke)
+ *   Level 1 [1] 0x40000000-0x7FFFFFFF  -> 1 GB Device Block (ARM Local)
+ *   Level 1 [2..3]                     -> ungemappt
+ */
+
+#include "mmu.h"
+#include "arch.h"
+#include "timer.h"
+
+/*============================================================================
+ * Page Table Descriptor Bits (VMSAv8-64, Stage 1)
+ *============================================================================*/
+
+#define PT_INVALID          0x0UL
+#define PT_BLOCK            0x1UL           /* Block Descriptor (L1/L2) */
+#define PT_TABLE            0x3UL           /* Table Descriptor */
+
+#define PT_ATTR(idx)        ((uint64_t)(idx) << 2)
+#define PT_AP_RES1_EL2      (1UL << 6)      /* AP[1] ist RES1 im EL2 Regime */
+#define PT_SH_INNER         (3UL << 8)
+#define PT_AF               (1UL << 10)     /* Access Flag */
+#define PT_PXN_EL1          (1UL << 53)     /* nur EL1: Privileged Execute Never */
+#define PT_XN               (1UL << 54)     /* EL2: XN, EL1: UXN */
+
+/* MAIR Attribut-Indizes */
+#define MAIR_IDX_DEVICE     0
+#define MAIR_IDX_NORMAL_NC  1
+#define MAIR_IDX_NORMAL_WB  2
+
+#define MAIR_VALUE  ((0x04UL << (8 * MAIR_IDX_DEVICE))    |  /* Device-nGnRE */ \
+                     (0x44UL << (8 * MAIR_IDX_NORMAL_NC)) |  /* Normal NC */    \
+                     (0xFFUL << (8 * MAIR_IDX_NORMAL_WB)))   /* Normal WB RWA */
+
+/* TCR: T0SZ=32, IRGN0/ORGN0 = WB-WA, SH0 = Inner Shareable, TG0 = 4 KB */
+#define TCR_T0SZ            (32UL << 0)
+#define TCR_IRGN0_WBWA      (1UL << 8)
+#define TCR_ORGN0_WBWA      (1UL << 10)
+#define TCR_SH0_INNER       (3UL << 12)
+#define TCR_COMMON          (TCR_T0SZ | TCR_IRGN0_WBWA | TCR_ORGN0_WBWA | TCR_SH0_INNER)
+#define TCR_EL2_RES1        ((1UL << 31) | (1UL << 23))  /* PS = 0 (32-bit PA) */
+#define TCR_EL1_EPD1        (1UL << 23)                  /* TTBR1 Walks aus */
+
+/* SCTLR Bits */
+#define SCTLR_M             (1UL << 0)
+#define SCTLR_A             (1UL << 1)
+#define SCTLR_C             (1UL << 2)
+#define SCTLR_I             (1UL << 12)
+#define SCTLR_WXN           (1UL << 19)
+
+#define L2_BLOCK_SHIFT      21              /* 2 MB */
+#define L2_BLOCK_SIZE       (1UL << L2_BLOCK_SHIFT)
+#define L1_BLOCK_SHIFT      30              /* 1 GB */
+
+/*============================================================================
+ * Page Tables (in .bss, von boot.S gelöscht)
+ *============================================================================*/
+
+static uint64_t g_l1_table[512] __attribute__((aligned(4096)));
+static uint64_t g_l2_table[512] __attribute__((aligned(4096)));
+
+static uint32_t g_mmu_flags = 0;
+
+/* Puffer für den Speicher-Durchsatz Test (liegt im AMP Bereich) */
+#define PERF_BUF_SIZE       0x10000         /* 64 KB */
+#define PERF_MEM_ROUNDS     16
+#define PERF_ALU_ITERS      20000           /* x 10 Instruktionen */
+
+static uint64_t g_perf_buf[PERF_BUF_SIZE / 8] __attribute__((aligned(64)));
+
+/*============================================================================
+ * Page Table Aufbau
+ *============================================================================*/
+
+static void map_l2_range(uintptr_t start, uint32_t size, uint64_t attrs) {
+    for (uintptr_t addr = start; addr < start + size; addr += L2_BLOCK_SIZE) {
+        g_l2_table[(addr >> L2_BLOCK_SHIFT) & 0x1FF] = addr | attrs;
+    }
+}
+
+static void build_tables(uint32_t el) {
+    uint64_t common = PT_BLOCK | PT_AF | PT_SH_INNER;
+    uint64_t xn = PT_XN;
+
+    if (el == 2) {
+        common |= PT_AP_RES1_EL2;
+    } else {
+        xn |= PT_PXN_EL1;
+    }
+
+    uint64_t normal_wb = common | PT_ATTR(MAIR_IDX_NORMAL_WB);
+    uint64_t device    = common | PT_ATTR(MAIR_IDX_DEVICE) | xn;
+#if AMP_SHARED_CACHEABLE
+    uint64_t shared    = common | PT_ATTR(MAIR_IDX_NORMAL_WB) | xn;
+#else
+    uint64_t shared    = common | PT_ATTR(MAIR_IDX_NORMAL_NC) | xn;
+#endif
+
+    for (int i = 0; i < 512; i++) {
+        g_l1_table[i] = PT_INVALID;
+        g_l2_table[i] = PT_INVALID;
+    }
+
+    /* AMP Code/Data: ausführbar, cacheable */
+    map_l2_range(AMP_CODE_BASE, AMP_CODE_SIZE, normal_wb);
+
+    /* Shared Memory: niemals ausführbar */
+    map_l2_range(SHARED_MEM_BASE, SHARED_MEM_SIZE, shared);
+
+    /* Peripherals 0x3F000000-0x3FFFFFFF */
+    map_l2_range(PERIPHERAL_BASE, 0x01000000, device);
+
+    g_l1_table[0] = (uintptr_t)g_l2_table | PT_TABLE;
+
+    /* ARM Local Peripherals: 1 GB Device Block ab 0x40000000 */
+    g_l1_table[ARM_LOCAL_BASE >> L1_BLOCK_SHIFT] = ARM_LOCAL_BASE | device;
+
+    DSB();
+}
+
+/*============================================================================
+ * MMU aktivieren
+ *============================================================================*/
+
+void mmu_init(void) {
+    uint32_t el = arch_current_el();
+    uint64_t sctlr;
+
+    build_tables(el);
+
+    if (el == 2) {
+        WRITE_SYSREG(mair_el2, MAIR_VALUE);
+        WRITE_SYSREG(tcr_el2, TCR_COMMON | TCR_EL2_RES1);
+        WRITE_SYSREG(ttbr0_el2, (uintptr_t)g_l1_table);
+        ISB();
+        asm volatile("tlbi alle2" ::: "memory");
+    } else {
+        WRITE_SYSREG(mair_el1, MAIR_VALUE);
+        WRITE_SYSREG(tcr_el1, TCR_COMMON | TCR_EL1_EPD1);
+        WRITE_SYSREG(ttbr0_el1, (uintptr_t)g_l1_table);
+        ISB();
+        asm volatile("tlbi vmalle1" ::: "memory");
+    }
+    asm volatile("ic iallu" ::: "memory");
+    DSB();
+    ISB();
+
+    if (el == 2) {
+        sctlr = READ_SYSREG(sctlr_el2);
+    } else {
+        sctlr = READ_SYSREG(sctlr_el1);
+    }
+
+    sctlr |= SCTLR_M | SCTLR_C | SCTLR_I;
+    sctlr &= ~(SCTLR_A | SCTLR_WXN);
+
+    if (el == 2) {
+        WRITE_SYSREG(sctlr_el2, sctlr);
+    } else {
+        WRITE_SYSREG(sctlr_el1, sctlr);
+    }
+    ISB();
+
+    g_mmu_flags = MMU_FLAG_ENABLED | MMU_FLAG_DCACHE | MMU_FLAG_ICACHE;
+#if AMP_SHARED_CACHEABLE
+    g_mmu_flags |= MMU_FLAG_SHARED_CACHED;
+#endif
+}
+
+uint32_t mmu_get_flags(void) {
+    return g_mmu_flags;
+}
+
+bool mmu_is_cacheable(uintptr_t addr) {
+    if (!(g_mmu_flags & MMU_FLAG_DCACHE)) {
+        return false;
+    }
+    if (addr >= AMP_CODE_BASE && addr < AMP_CODE_BASE + AMP_CODE_SIZE) {
+        return true;
+    }
+#if AMP_SHARED_CACHEABLE
+    if (addr >= SHARED_MEM_BASE && addr < SHARED_MEM_BASE + SHARED_MEM_SIZE) {
+        return true;
+    }
+#endif
+    return false;
+}
+
+/*============================================================================
+ * Cache Maintenance
+ *============================================================================*/
+
+void dcache_clean_range(uintptr_t addr, uint32_t size) {
+    uint32_t line = arch_dcache_line_size();
+    uintptr_t end = addr + size;
+
+    for (addr &= ~(uintptr_t)(line - 1); addr < end; addr += line) {
+        asm volatile("dc cvac, %0" :: "r"(addr) : "memory");
+    }
+    DSB();
+}
+
+void dcache_invalidate_range(uintptr_t addr, uint32_t size) {
+    uint32_t line = arch_dcache_line_size();
+    uintptr_t end = addr + size;
+
+    for (addr &= ~(uintptr_t)(line - 1); addr < end; addr += line) {
+        asm volatile("dc ivac, %0" :: "r"(addr) : "memory");
+    }
+    DSB();
+}
+
+void dcache_clean_invalidate_range(uintptr_t addr, uint32_t size) {
+    uint32_t line = arch_dcache_line_size();
+    uintptr_t end = addr + size;
+
+    for (addr &= ~(uintptr_t)(line - 1); addr < end; addr += line) {
+        asm volatile("dc civac, %0" :: "r"(addr) : "memory");
+    }
+    DSB();
+}
+
+/*============================================================================
+ * Performance-Messung
+ *============================================================================*/
+
+/* 10 Instruktionen pro Iteration: 8x add + subs + b.ne */
+static void __attribute__((noinline)) perf_alu_loop(uint32_t iters) {
+    asm volatile(
+        "1:\n"
+        "    add x9, x9, #1\n"
+        "    add x10, x10, #1\n"
+        "    add x9, x9, #1\n"
+        "    add x10, x10, #1\n"
+        "    add x9, x9, #1\n"
+        "    add x10, x10, #1\n"
+        "    add x9, x9, #1\n"
+        "    add x10, x10, #1\n"
+        "    subs %w0, %w0, #1\n"
+        "    b.ne 1b\n"
+        : "+r"(iters) :: "x9", "x10", "cc");
+}
+
+static void perf_mem_loop(void) {
+    volatile uint64_t *buf = g_perf_buf;
+    uint64_t sum = 0;
+
+    for (uint32_t round = 0; round < PERF_MEM_ROUNDS; round++) {
+        for (uint32_t i = 0; i < PERF_BUF_SIZE / 8; i++) {
+            buf[i] = i;
+        }
+        for (uint32_t i = 0; i < PERF_BUF_SIZE / 8; i++) {
+            sum += buf[i];
+        }
+    }
+
+    /* Ergebnis "benutzen", damit nichts wegoptimiert wird */
+    asm volatile("" :: "r"(sum));
+}
+
+void mmu_measure_perf(mmu_perf_t *perf) {
+    uint64_t start, elapsed;
+
+    start = timer_get_ticks();
+    perf_alu_loop(PERF_ALU_ITERS);
+    elapsed = timer_get_ticks() - start;
+    if (elapsed == 0) elapsed = 1;
+    /* Instruktionen / µs = MIPS -> x1000 = kIPS */
+    perf->kips = (uint32_t)((PERF_ALU_ITERS * 10ULL * 1000ULL) / elapsed);
+
+    start = timer_get_ticks();
+    perf_mem_loop();
+    elapsed = timer_get_ticks() - start;
+    if (elapsed == 0) elapsed = 1;
+    /* Bytes / µs = MB/s */
+    perf->mem_mbps = (uint32_t)((2ULL * PERF_BUF_SIZE * PERF_MEM_ROUNDS) / elapsed);
+}
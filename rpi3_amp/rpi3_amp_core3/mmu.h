@@ -0,0 +1,102 @@
+/**
+ * @file mmu.h
+ * @brief MMU und Cache Setup für Core 3 (Identity Mapping)
+ *
+ * Baut eine Identity-Mapped Page Table (4 KB Granule, 32-bit VA,
+ * 2 MB Blöcke) für die Memory-Map aus memory_print_map():
+ *
+ *   AMP Code/Data   0x20000000  Normal, Write-Back cacheable
+ *   Shared Memory   0x20A00000  Normal Non-Cacheable (Default) oder
+ *                               Normal Write-Back Inner-Shareable
+ *                               (AMP_SHARED_CACHEABLE=1)
+ *   Peripherals     0x3F000000  Device-nGnRE
+ *   ARM Local       0x40000000  Device-nGnRE
+ *
+ * Linux RAM (0x00000000-0x1FFFFFFF) wird bewusst NICHT gemappt, damit
+ * ein verirrter Pointer auf Core 3 einen Fault auslöst statt Linux-Speicher
+ * zu überschreiben.
+ */
+
+#ifndef MMU_H
+#define MMU_H
+
+#include "common.h"
+
+/*============================================================================
+ * Konfiguration
+ *============================================================================*/
+
+/*
+ * Shared Memory cacheable mappen?
+ * 0 = Normal Non-Cacheable (sicher, Linux mappt /dev/mem mit O_SYNC uncached)
+ * 1 = Normal Write-Back Inner-Shareable (nur wenn Linux ebenfalls cacheable
+ *     mappt, sonst sieht Linux veraltete Daten!)
+ */
+#ifndef AMP_SHARED_CACHEABLE
+#define AMP_SHARED_CACHEABLE    0
+#endif
+
+/* mmu_flags Bits im shared_status_t */
+#define MMU_FLAG_ENABLED        (1 << 0)    /* MMU aktiv */
+#define MMU_FLAG_DCACHE         (1 << 1)    /* D-Cache aktiv */
+#define MMU_FLAG_ICACHE         (1 << 2)    /* I-Cache aktiv */
+#define MMU_FLAG_SHARED_CACHED  (1 << 3)    /* Shared Memory cacheable */
+
+/*============================================================================
+ * Performance-Messung (vorher/nachher)
+ *============================================================================*/
+
+typedef struct {
+    uint32_t kips;      /* Instruktionen pro Sekunde / 1000 */
+    uint32_t mem_mbps;  /* Speicher-Durchsatz (Schreiben + Lesen) in MB/s */
+} mmu_perf_t;
+
+/*============================================================================
+ * Funktionen
+ *============================================================================*/
+
+/**
+ * @brief Baut die Page Tables und aktiviert MMU, D-Cache und I-Cache
+ */
+void mmu_init(void);
+
+/**
+ * @brief Gibt die aktuellen MMU_FLAG_* Bits zurück
+ */
+uint32_t mmu_get_flags(void);
+
+/**
+ * @brief Misst Instruktions- und Speicher-Durchsatz im aktuellen Modus
+ * @param perf Output für die Messwerte
+ */
+void mmu_measure_perf(mmu_perf_t *perf);
+
+/**
+ * @brief Prüft ob eine Adresse als Normal Write-Back gemappt ist
+ * @param addr Physikalische (= virtuelle) Adresse
+ * @return true wenn cacheable
+ */
+bool mmu_is_cacheable(uintptr_t addr);
+
+/**
+ * @brief Schreibt D-Cache Lines zurück in den Speicher (DC CVAC)
+ * @param addr Startadresse
+ * @param size Größe in Bytes
+ */
+void dcache_clean_range(uintptr_t addr, uint32_t size);
+
+/**
+ * @brief Verwirft D-Cache Lines (DC IVAC) - vorher gecachte Daten gehen verloren!
+ * @param addr Startadresse
+ * @param size Größe in Bytes
+ */
+void dcache_invalidate_range(uintptr_t addr, uint32_t size);
+
+/**
+ * @brief Schreibt D-Cache Lines zurück und verwirft sie (DC CIVAC)
+ * @param addr Startadresse
+ * @param size Größe in Bytes
+ */
+void dcache_clean_invalidate_range(uintptr_t addr, uint32_t size);
+
+#endif /* MMU_H */
@@ -0,0 +1,328 @@
+/**
+ * @file pool.c
+ * @brief Zero-Copy Buffer-Pool Implementierung
+ */
+
+#include "pool.h"
+#include "memory.h"
+#include "timer.h"
+
+_Static_assert(sizeof(pool_desc_t) == 16, "pool_desc_t Layout");
+_Static_assert(sizeof(pool_shared_t) <= POOL_CTRL_SIZE,
+               "pool_shared_t passt nicht in POOL_CTRL_SIZE");
+_Static_assert(POOL_LARGE_OFFSET + POOL_LARGE_SIZE * POOL_LARGE_COUNT <= SHARED_POOL_SIZE,
+               "Puffer passen nicht in SHARED_POOL");
+_Static_assert((POOL_SUBMIT_SLOTS & (POOL_SUBMIT_SLOTS - 1)) == 0 &&
+               ((POOL_SMALL_COUNT / 2) & (POOL_SMALL_COUNT / 2 - 1)) == 0 &&
+               ((POOL_LARGE_COUNT / 2) & (POOL_LARGE_COUNT / 2 - 1)) == 0,
+               "Ring-Größen müssen Zweierpotenzen sein");
+/* Alle Puffer einer Richtung passen gleichzeitig in submit -> submit wird nie voll */
+_Static_assert(POOL_SUBMIT_SLOTS >= (POOL_SMALL_COUNT + POOL_LARGE_COUNT) / 2,
+               "POOL_SUBMIT_SLOTS zu klein");
+
+/*============================================================================
+ * Private Variablen
+ *============================================================================*/
+
+static pool_shared_t *g_pool = NULL;
+
+/* Core 3 -> Linux: Core 3 produziert submit, konsumiert free */
+static ipc_ring_t g_tx_submit;
+static ipc_ring_t g_tx_free[POOL_CLASSES];
+
+/* Linux -> Core 3: Core 3 konsumiert submit, produziert free */
+static ipc_ring_t g_rx_submit;
+static ipc_ring_t g_rx_free[POOL_CLASSES];
+
+static const uint32_t g_buf_size[POOL_CLASSES]  = { POOL_SMALL_SIZE, POOL_LARGE_SIZE };
+static const uint32_t g_buf_count[POOL_CLASSES] = { POOL_SMALL_COUNT, POOL_LARGE_COUNT };
+static const uint32_t g_buf_offset[POOL_CLASSES] = { POOL_SMALL_OFFSET, POOL_LARGE_OFFSET };
+
+/* Statistik */
+static uint32_t g_rx_bufs = 0;
+static uint64_t g_rx_bytes = 0;
+static uint32_t g_rx_errors = 0;
+static uint32_t g_tx_bufs = 0;
+static uint64_t g_tx_bytes = 0;
+static uint32_t g_tx_seq = 0;
+
+/*============================================================================
+ * Hilfsfunktionen
+ *============================================================================*/
+
+static void publish_stats(void) {
+    shared_mem_set_pool(g_rx_bufs, (uint32_t)(g_rx_bytes >> 10), g_rx_errors,
+                        g_tx_bufs, (uint32_t)(g_tx_bytes >> 10));
+}
+
+/* Richtung, der ein Puffer gehört: untere Hälfte to_core3, obere to_linux */
+static bool buf_valid(uint32_t buf, uint32_t dir) {
+    uint32_t cls = POOL_BUF_CLASS(buf);
+    uint32_t idx = POOL_BUF_INDEX(buf);
+
+    if (cls >= POOL_CLASSES || idx >= g_buf_count[cls]) {
+        return false;
+    }
+    return (idx >= g_buf_count[cls] / 2) == (dir == POOL_DIR_TO_LINUX);
+}
+
+/*
+ * Summe der 32-bit Wörter mit 64-bit Loads: halbiert die Zugriffe auf
+ * den (per Default nicht gecachten) Pool. len muss Vielfaches von 4 sein.
+ */
+static uint32_t buf_sum(const void *buf, uint32_t len) {
+    const uint64_t *p = (const uint64_t *)buf;
+    uint32_t sum = 0;
+    uint32_t n = len / 8;
+
+    for (uint32_t i = 0; i < n; i++) {
+        uint64_t w = p[i];
+        sum += (uint32_t)w + (uint32_t)(w >> 32);
+    }
+    if (len & 4) {
+        sum += ((const uint32_t *)buf)[len / 4 - 1];
+    }
+    return sum;
+}
+
+/* Füllt Wort i mit seq ^ i und gibt die Summe zurück */
+static uint32_t buf_fill(void *buf, uint32_t len, uint32_t seq) {
+    uint64_t *p = (uint64_t *)buf;
+    uint32_t sum = 0;
+    uint32_t n = len / 8;
+
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t lo = seq ^ (2 * i);
+        uint32_t hi = seq ^ (2 * i + 1);
+        p[i] = ((uint64_t)hi << 32) | lo;
+        sum += lo + hi;
+    }
+    return sum;
+}
+
+static void ring_init(ipc_ring_t *ring, ipc_ring_ctrl_t *ctrl, pool_desc_t *slots,
+                      uint32_t count) {
+    ipc_ring_init(ring, ctrl, slots, sizeof(pool_desc_t), count);
+}
+
+/*============================================================================
+ * Öffentliche Funktionen
+ *============================================================================*/
+
+void pool_init(void) {
+    pool_shared_t *p = (pool_shared_t *)SHARED_POOL_ADDR;
+    pool_dir_t *to_core3 = &p->dir[POOL_DIR_TO_CORE3];
+    pool_dir_t *to_linux = &p->dir[POOL_DIR_TO_LINUX];
+
+    g_pool = NULL;
+    p->magic = 0;
+    p->class_count = POOL_CLASSES;
+    for (uint32_t cls = 0; cls < POOL_CLASSES; cls++) {
+        p->buf_size[cls] = g_buf_size[cls];
+        p->buf_count[cls] = g_buf_count[cls];
+        p->buf_offset[cls] = (uint32_t)(SHARED_POOL_ADDR + g_buf_offset[cls] - SHARED_MEM_BASE);
+    }
+
+    ring_init(&g_rx_submit, &to_core3->submit, p->submit_slots[POOL_DIR_TO_CORE3],
+              POOL_SUBMIT_SLOTS);
+    ring_init(&g_tx_submit, &to_linux->submit, p->submit_slots[POOL_DIR_TO_LINUX],
+              POOL_SUBMIT_SLOTS);
+    ring_init(&g_rx_free[POOL_CLASS_SMALL], &to_core3->free[POOL_CLASS_SMALL],
+              p->small_free_slots[POOL_DIR_TO_CORE3], POOL_SMALL_COUNT / 2);
+    ring_init(&g_tx_free[POOL_CLASS_SMALL], &to_linux->free[POOL_CLASS_SMALL],
+              p->small_free_slots[POOL_DIR_TO_LINUX], POOL_SMALL_COUNT / 2);
+    ring_init(&g_rx_free[POOL_CLASS_LARGE], &to_core3->free[POOL_CLASS_LARGE],
+              p->large_free_slots[POOL_DIR_TO_CORE3], POOL_LARGE_COUNT / 2);
+    ring_init(&g_tx_free[POOL_CLASS_LARGE], &to_linux->free[POOL_CLASS_LARGE],
+              p->large_free_slots[POOL_DIR_TO_LINUX], POOL_LARGE_COUNT / 2);
+
+    for (uint32_t cls = 0; cls < POOL_CLASSES; cls++) {
+        uint32_t half = g_buf_count[cls] / 2;
+
+        /* to_core3: Core 3 ist Producer des free-Rings -> normal einreihen */
+        for (uint32_t i = 0; i < half; i++) {
+            pool_desc_t *d = (pool_desc_t *)ipc_ring_reserve(&g_rx_free[cls]);
+            d->buf = POOL_BUF_ID(cls, i);
+            d->length = 0;
+            d->tag = 0;
+            d->flags = 0;
+            ipc_ring_commit(&g_rx_free[cls]);
+        }
+
+        /* to_linux: Linux ist Producer - Slots direkt füllen, head vorsetzen */
+        pool_desc_t *slots = (pool_desc_t *)g_tx_free[cls].slots;
+        for (uint32_t i = 0; i < half; i++) {
+            slots[i].buf = POOL_BUF_ID(cls, half + i);
+            slots[i].length = 0;
+            slots[i].tag = 0;
+            slots[i].flags = 0;
+        }
+        STORE_RELEASE(&g_tx_free[cls].ctrl->head, half);
+    }
+
+    g_rx_bufs = 0;
+    g_rx_bytes = 0;
+    g_rx_errors = 0;
+    g_tx_bufs = 0;
+    g_tx_bytes = 0;
+    publish_stats();
+
+    /* Magic zuletzt: Linux benutzt den Pool erst wenn alle Ringe stehen */
+    STORE_RELEASE(&p->magic, POOL_MAGIC);
+    g_pool = p;
+}
+
+void* pool_buf(uint32_t buf) {
+    uint32_t cls = POOL_BUF_CLASS(buf);
+    uint32_t idx = POOL_BUF_INDEX(buf);
+
+    if (cls >= POOL_CLASSES || idx >= g_buf_count[cls]) {
+        return NULL;
+    }
+    return (void *)(SHARED_POOL_ADDR + g_buf_offset[cls] + (uintptr_t)idx * g_buf_size[cls]);
+}
+
+uint32_t pool_buf_size(uint32_t buf) {
+    uint32_t cls = POOL_BUF_CLASS(buf);
+
+    if (cls >= POOL_CLASSES || POOL_BUF_INDEX(buf) >= g_buf_count[cls]) {
+        return 0;
+    }
+    return g_buf_size[cls];
+}
+
+bool pool_alloc(uint32_t cls, uint32_t *buf) {
+    pool_desc_t *d;
+
+    if (!g_pool || cls >= POOL_CLASSES) {
+        return false;
+    }
+
+    while ((d = (pool_desc_t *)ipc_ring_peek(&g_tx_free[cls])) != NULL) {
+        uint32_t id = d->buf;
+        ipc_ring_release(&g_tx_free[cls]);
+
+        /* Kaputte Rückgaben von Linux verwerfen statt fremde Puffer zu benutzen */
+        if (POOL_BUF_CLASS(id) == cls && buf_valid(id, POOL_DIR_TO_LINUX)) {
+            *buf = id;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool pool_submit(uint32_t buf, uint32_t length, uint32_t tag) {
+    pool_desc_t *d;
+
+    if (!g_pool || !buf_valid(buf, POOL_DIR_TO_LINUX) || length > pool_buf_size(buf)) {
+        return false;
+    }
+
+    d = (pool_desc_t *)ipc_ring_reserve(&g_tx_submit);
+    if (!d) {
+        return false;
+    }
+    d->buf = buf;
+    d->length = length;
+    d->tag = tag;
+    d->flags = 0;
+    ipc_ring_commit(&g_tx_submit);
+
+    g_tx_bufs++;
+    g_tx_bytes += length;
+    return true;
+}
+
+bool pool_rx_pending(void) {
+    return g_pool && ipc_ring_peek(&g_rx_submit) != NULL;
+}
+
+bool pool_receive(pool_desc_t *desc) {
+    pool_desc_t *d;
+
+    if (!g_pool) {
+        return false;
+    }
+
+    d = (pool_desc_t *)ipc_ring_peek(&g_rx_submit);
+    if (!d) {
+        return false;
+    }
+    *desc = *d;
+    ipc_ring_release(&g_rx_submit);
+    return true;
+}
+
+void pool_release(uint32_t buf) {
+    pool_desc_t *d;
+    uint32_t cls = POOL_BUF_CLASS(buf);
+
+    if (!g_pool || !buf_valid(buf, POOL_DIR_TO_CORE3)) {
+        return;
+    }
+
+    /* Kann nicht voll sein: der Ring fasst alle Puffer der Klasse */
+    d = (pool_desc_t *)ipc_ring_reserve(&g_rx_free[cls]);
+    if (!d) {
+        return;
+    }
+    d->buf = buf;
+    d->length = 0;
+    d->tag = 0;
+    d->flags = 0;
+    ipc_ring_commit(&g_rx_free[cls]);
+}
+
+uint32_t pool_poll(void) {
+    uint32_t processed = 0;
+    pool_desc_t desc;
+
+    while (pool_receive(&desc)) {
+        if (!buf_valid(desc.buf, POOL_DIR_TO_CORE3)) {
+            g_rx_errors++;  /* Unbekannter Puffer - nicht zurückgeben */
+            continue;
+        }
+
+        if (desc.length > pool_buf_size(desc.buf) || (desc.length & 3) ||
+            buf_sum(pool_buf(desc.buf), desc.length) != desc.tag) {
+            g_rx_errors++;
+        }
+        g_rx_bufs++;
+        g_rx_bytes += desc.length;
+        pool_release(desc.buf);
+        processed++;
+    }
+
+    if (processed) {
+        publish_stats();
+    }
+    return processed;
+}
+
+uint32_t pool_bulk_tx(uint32_t cls, uint32_t count, uint32_t *elapsed_us) {
+    uint64_t start = timer_get_ticks();
+    uint64_t last_progress = start;
+    uint32_t sent = 0;
+    uint32_t buf;
+
+    while (sent < count && cls < POOL_CLASSES) {
+        if (!pool_alloc(cls, &buf)) {
+            if (timer_get_ticks() - last_progress > POOL_BULK_TX_TIMEOUT_US) {
+                break;  /* Linux gibt keine Puffer mehr zurück */
+            }
+            continue;
+        }
+
+        uint32_t len = pool_buf_size(buf);
+        uint32_t tag = buf_fill(pool_buf(buf), len, g_tx_seq++);
+        pool_submit(buf, len, tag);
+        sent++;
+        last_progress = timer_get_ticks();
+    }
+
+    if (elapsed_us) {
+        *elapsed_us = (uint32_t)(timer_get_ticks() - start);
+    }
+    publish_stats();
+    return sent;
+}
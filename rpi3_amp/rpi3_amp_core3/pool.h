@@ -0,0 +1,185 @@
+/**
+ * @file pool.h
+ * @brief Zero-Copy Buffer-Pool für große Transfers (SHARED_POOL_ADDR)
+ *
+ * Die IPC Ringe (ipc.h) kopieren jede Nachricht in einen 128 Byte Slot -
+ * für Bulk-Daten zu klein und zu teuer. Der Pool teilt einen eigenen
+ * Bereich in Puffer fester Größe (zwei Klassen: 2 KB und 64 KB). Über
+ * Deskriptor-Ringe wandert nur der Puffer-Index, die Nutzdaten bleiben
+ * wo sie sind - Sender schreibt direkt in den Puffer, Empfänger liest
+ * direkt daraus.
+ *
+ * Pro Richtung (to_core3, to_linux):
+ *
+ *   submit       : Sender -> Empfänger, Deskriptor {buf, length, tag}
+ *   free[klasse] : Empfänger -> Sender, freigegebene Puffer zurück
+ *
+ * Jeder Puffer gehört fest zu einer Richtung (die Hälfte jeder Klasse)
+ * und ist immer in genau einem Ring oder bei genau einer Seite - so
+ * bleiben alle Ringe SPSC. Der Sender holt Puffer aus seinem free-Ring
+ * (pool_alloc), schreibt, und reicht sie über submit weiter; der
+ * Empfänger liest und gibt sie über free zurück (pool_release).
+ *
+ * Core 3 legt alles an und füllt beide free-Ringe vorab; magic im
+ * Steuerblock wird zuletzt gesetzt. Auf Linux-Seite darf immer nur ein
+ * Prozess den Pool benutzen (linux_tools/amp_ipc.h: amp_pool_open).
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+#include "common.h"
+#include "ipc.h"
+
+/*============================================================================
+ * Konfiguration
+ *============================================================================*/
+
+#define POOL_MAGIC          0x4C4F4F50  /* "POOL" */
+
+#define POOL_CLASSES        2
+#define POOL_CLASS_SMALL    0
+#define POOL_CLASS_LARGE    1
+
+#define POOL_SMALL_SIZE     0x800       /* 2 KB */
+#define POOL_SMALL_COUNT    128         /* Beide Richtungen zusammen */
+#define POOL_LARGE_SIZE     0x10000     /* 64 KB */
+#define POOL_LARGE_COUNT    16
+
+/* Aufteilung von SHARED_POOL_ADDR */
+#define POOL_CTRL_SIZE      0x2000      /* Steuerblock + Deskriptor-Slots */
+#define POOL_SMALL_OFFSET   POOL_CTRL_SIZE
+#define POOL_LARGE_OFFSET   (POOL_SMALL_OFFSET + POOL_SMALL_SIZE * POOL_SMALL_COUNT)
+
+/* Deskriptoren im submit-Ring einer Richtung (Zweierpotenz) */
+#define POOL_SUBMIT_SLOTS   128
+
+#define POOL_DIR_TO_CORE3   0
+#define POOL_DIR_TO_LINUX   1
+
+/* Puffer-ID: Klasse im oberen, Index innerhalb der Klasse im unteren Halbwort */
+#define POOL_BUF_ID(cls, idx)   (((uint32_t)(cls) << 16) | (uint32_t)(idx))
+#define POOL_BUF_CLASS(id)      ((id) >> 16)
+#define POOL_BUF_INDEX(id)      ((id) & 0xFFFF)
+
+/* Timeout wenn Linux während IPC_MSG_BULK_TX keine Puffer zurückgibt */
+#define POOL_BULK_TX_TIMEOUT_US 1000000
+
+/*============================================================================
+ * Shared Memory Strukturen (MÜSSEN mit linux_tools/amp_shared.h übereinstimmen!)
+ *============================================================================*/
+
+/* Ein Slot in submit- und free-Ringen */
+typedef struct {
+    uint32_t buf;           /* POOL_BUF_ID */
+    uint32_t length;        /* Belegte Bytes (submit), 0 in free-Ringen */
+    uint32_t tag;           /* Frei für den Sender (bulk: Prüfsumme) */
+    uint32_t flags;         /* Reserviert, 0 */
+} pool_desc_t;
+
+/* Ringe einer Richtung */
+typedef struct {
+    ipc_ring_ctrl_t submit;
+    ipc_ring_ctrl_t free[POOL_CLASSES];
+} pool_dir_t;
+
+/* Layout von SHARED_POOL_ADDR (POOL_CTRL_SIZE), danach die Puffer */
+typedef struct {
+    /* Cache-Line 0: Geometrie, nach dem Init read-only */
+    uint32_t magic;                     /* POOL_MAGIC, wird zuletzt gesetzt */
+    uint32_t class_count;               /* POOL_CLASSES */
+    uint32_t buf_size[POOL_CLASSES];    /* Bytes pro Puffer */
+    uint32_t buf_count[POOL_CLASSES];   /* Puffer pro Klasse (beide Richtungen) */
+    uint32_t buf_offset[POOL_CLASSES];  /* Offset ab SHARED_MEM_BASE */
+    uint8_t  _pad0[IPC_CACHE_LINE - 8 - 12 * POOL_CLASSES];
+
+    pool_dir_t dir[2];                  /* [POOL_DIR_*] */
+
+    /* Slot-Speicher der Ringe */
+    pool_desc_t submit_slots[2][POOL_SUBMIT_SLOTS];
+    pool_desc_t small_free_slots[2][POOL_SMALL_COUNT / 2];
+    pool_desc_t large_free_slots[2][POOL_LARGE_COUNT / 2];
+} pool_shared_t;
+
+/*============================================================================
+ * Funktionen
+ *============================================================================*/
+
+/**
+ * @brief Legt Steuerblock, Ringe und free-Listen in SHARED_POOL_ADDR an
+ *
+ * Nach ipc_init() aufrufen. Puffer, die Linux noch hält, sind danach
+ * verloren - Linux muss amp_pool_open() neu aufrufen.
+ */
+void pool_init(void);
+
+/**
+ * @brief Adresse eines Puffers
+ * @return Pointer oder NULL bei ungültiger ID
+ */
+void* pool_buf(uint32_t buf);
+
+/**
+ * @brief Größe eines Puffers in Bytes (0 bei ungültiger ID)
+ */
+uint32_t pool_buf_size(uint32_t buf);
+
+/**
+ * @brief Holt einen freien Puffer für Core 3 -> Linux
+ * @param cls POOL_CLASS_*
+ * @param buf Output: Puffer-ID
+ * @return false wenn alle Puffer der Klasse bei Linux liegen
+ */
+bool pool_alloc(uint32_t cls, uint32_t *buf);
+
+/**
+ * @brief Übergibt einen mit pool_alloc() geholten Puffer an Linux
+ * @param buf Puffer-ID
+ * @param length Belegte Bytes (max. pool_buf_size)
+ * @param tag Frei verwendbar
+ * @return false wenn der submit-Ring voll ist (Puffer bleibt bei Core 3)
+ */
+bool pool_submit(uint32_t buf, uint32_t length, uint32_t tag);
+
+/**
+ * @brief Prüft ob Linux Puffer übergeben hat
+ */
+bool pool_rx_pending(void);
+
+/**
+ * @brief Holt den nächsten Deskriptor von Linux
+ * @param desc Output
+ * @return false wenn keiner ansteht
+ */
+bool pool_receive(pool_desc_t *desc);
+
+/**
+ * @brief Gibt einen von Linux empfangenen Puffer zurück
+ */
+void pool_release(uint32_t buf);
+
+/**
+ * @brief Verarbeitet alle von Linux übergebenen Puffer
+ *
+ * Standard-Verbraucher: bildet die Summe der 32-bit Wörter, vergleicht
+ * sie mit tag (Fehler -> pool_rx_errors) und gibt den Puffer zurück.
+ * Aus der Hauptschleife aufrufen.
+ *
+ * @return Anzahl verarbeiteter Puffer
+ */
+uint32_t pool_poll(void);
+
+/**
+ * @brief Schickt count gefüllte Puffer an Linux (IPC_MSG_BULK_TX)
+ *
+ * Muster: Wort i = seq ^ i, tag = Summe der Wörter. Wartet auf freie
+ * Puffer, bricht nach POOL_BULK_TX_TIMEOUT_US ohne Fortschritt ab.
+ *
+ * @param cls POOL_CLASS_*
+ * @param count Anzahl Puffer
+ * @param elapsed_us Output: Laufzeit
+ * @return Anzahl gesendeter Puffer
+ */
+uint32_t pool_bulk_tx(uint32_t cls, uint32_t count, uint32_t *elapsed_us);
+
+#endif /* POOL_H */
@@ -0,0 +1,118 @@
+/**
+ * @file probe.c
+ * @brief Zyklen-Messpunkte Implementierung
+ */
+
+#include "probe.h"
+#include "irq.h"
+
+_Static_assert(sizeof(probe_entry_t) == 48, "probe_entry_t Layout");
+_Static_assert(sizeof(probe_shared_t) <= SHARED_PROBE_SIZE,
+               "probe_shared_t passt nicht in SHARED_PROBE");
+
+/*============================================================================
+ * Private Variablen
+ *============================================================================*/
+
+static probe_shared_t *g_probe = NULL;
+static uint32_t g_used = 0;
+static uint32_t g_dropped = 0;
+
+/*============================================================================
+ * Hilfsfunktionen
+ *============================================================================*/
+
+/* Neuer Eintrag für eine Stelle, 0 wenn die Tabelle voll ist */
+static uint32_t alloc_entry(const char *name) {
+    probe_entry_t *e;
+    uint32_t i;
+
+    if (g_used >= PROBE_MAX_SITES) {
+        return 0;
+    }
+
+    e = &g_probe->entries[g_used];
+    for (i = 0; i < PROBE_NAME_LEN - 1 && name[i]; i++) {
+        e->name[i] = name[i];
+    }
+    e->name[i] = '\0';
+    e->seq = 0;
+    e->count = 0;
+    e->total = 0;
+    e->min = 0xFFFFFFFF;
+    e->max = 0;
+
+    g_used++;
+    STORE_RELEASE(&g_probe->used, g_used);
+    return g_used;
+}
+
+/*============================================================================
+ * Implementierung
+ *============================================================================*/
+
+void probe_init(void) {
+#if PROBE_ENABLE
+    probe_shared_t *p = (probe_shared_t *)SHARED_PROBE_ADDR;
+    uint64_t best = ~0ULL;
+
+    arch_cycles_init();
+
+    p->magic = 0;
+    p->entry_size = sizeof(probe_entry_t);
+    p->max_entries = PROBE_MAX_SITES;
+    p->used = 0;
+    p->dropped = 0;
+    g_used = 0;
+    g_dropped = 0;
+
+    /* Leeres Paar, Minimum über ein paar Durchläufe */
+    for (uint32_t i = 0; i < 16; i++) {
+        uint64_t t0 = arch_cycles();
+        uint64_t dt = arch_cycles() - t0;
+        if (dt < best) {
+            best = dt;
+        }
+    }
+    p->overhead_cycles = (uint32_t)best;
+
+    /* Magic zuletzt: Linux liest erst wenn die Geometrie steht */
+    STORE_RELEASE(&p->magic, PROBE_MAGIC);
+    g_probe = p;
+#endif
+}
+
+void probe_record(uint32_t *slot, const char *name, uint64_t cycles) {
+    probe_entry_t *e;
+    uint32_t c = cycles > 0xFFFFFFFFULL ? 0xFFFFFFFF : (uint32_t)cycles;
+    uint64_t flags;
+
+    if (!g_probe) {
+        return;
+    }
+
+    flags = irq_save();
+    if (*slot == 0) {
+        *slot = alloc_entry(name);
+    }
+    if (*slot == 0) {
+        STORE_RELEASE(&g_probe->dropped, ++g_dropped);
+        irq_restore(flags);
+        return;
+    }
+
+    e = &g_probe->entries[*slot - 1];
+    e->seq++;
+    DMB();  /* seq ungerade, bevor die Daten geschrieben werden */
+    e->count++;
+    e->total += cycles;
+    if (c < e->min) {
+        e->min = c;
+    }
+    if (c > e->max) {
+        e->max = c;
+    }
+    DMB();  /* Daten vollständig, bevor seq wieder gerade wird */
+    e->seq++;
+    irq_restore(flags);
+}
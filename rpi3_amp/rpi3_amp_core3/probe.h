@@ -0,0 +1,117 @@
+/**
+ * @file probe.h
+ * @brief Zyklen-Messpunkte (PMCCNTR_EL0) mit Statistik pro Stelle
+ *
+ * PROBE_BEGIN/PROBE_END klammern einen Code-Bereich und zählen die
+ * CPU-Zyklen dazwischen. Jede Stelle (id) bekommt beim ersten Durchlauf
+ * einen Eintrag in der Tabelle im Shared Memory (SHARED_PROBE_ADDR) mit
+ * Anzahl, Summe, min und max. linux_tools/probe_dump gibt sie nach
+ * Gesamtzyklen sortiert aus.
+ *
+ *   void foo(void) {
+ *       PROBE_BEGIN(foo);
+ *       ...
+ *       PROBE_END(foo);
+ *   }
+ *
+ * Die id ist ein C-Bezeichner und zugleich der Name in der Tabelle;
+ * BEGIN und END müssen im selben Block stehen. Bei mehreren Ausgängen
+ * vor jedem return PROBE_END aufrufen.
+ *
+ * Schreiben pro Eintrag mit eigenem Seqlock (seq ungerade = Update läuft),
+ * Linux kopiert und prüft seq vorher/nachher. Läuft mit maskierten IRQs.
+ *
+ * Die Kosten eines leeren BEGIN/END Paars misst probe_init() einmal
+ * (overhead_cycles), sie sind in den Werten enthalten.
+ *
+ * Mit PROBE_ENABLE=0 (Default, make PROBE=1 zum Einschalten) werden die
+ * Makros zu nichts.
+ */
+
+#ifndef PROBE_H
+#define PROBE_H
+
+#include "common.h"
+#include "arch.h"
+
+/*============================================================================
+ * Konfiguration
+ *============================================================================*/
+
+#ifndef PROBE_ENABLE
+#define PROBE_ENABLE        0
+#endif
+
+#define PROBE_MAGIC         0x424F5250  /* "PROB" */
+#define PROBE_MAX_SITES     64
+#define PROBE_NAME_LEN      24
+
+/*============================================================================
+ * Shared Memory Strukturen (MÜSSEN mit linux_tools/amp_shared.h übereinstimmen!)
+ *============================================================================*/
+
+typedef struct {
+    char     name[PROBE_NAME_LEN];  /* id aus PROBE_BEGIN, 0-terminiert */
+    uint32_t seq;                   /* Seqlock, ungerade = Update läuft */
+    uint32_t count;                 /* Durchläufe */
+    uint64_t total;                 /* Summe der Zyklen */
+    uint32_t min;
+    uint32_t max;
+} probe_entry_t;
+
+typedef struct {
+    uint32_t magic;                 /* PROBE_MAGIC, wird zuletzt gesetzt */
+    uint32_t entry_size;            /* sizeof(probe_entry_t) */
+    uint32_t max_entries;           /* PROBE_MAX_SITES */
+    volatile uint32_t used;         /* Belegte Einträge */
+    volatile uint32_t dropped;      /* Messungen ohne freien Eintrag */
+    uint32_t overhead_cycles;       /* Leeres BEGIN/END Paar */
+    uint8_t  _pad0[40];
+
+    probe_entry_t entries[PROBE_MAX_SITES];
+} probe_shared_t;
+
+/*============================================================================
+ * Makros
+ *============================================================================*/
+
+#if PROBE_ENABLE
+
+#define PROBE_BEGIN(id) \
+    uint64_t _probe_t0_##id = arch_cycles()
+
+#define PROBE_END(id)                                                       \
+    do {                                                                    \
+        uint64_t _probe_dt = arch_cycles() - _probe_t0_##id;                \
+        static uint32_t _probe_slot;                                        \
+        probe_record(&_probe_slot, #id, _probe_dt);                         \
+    } while (0)
+
+#else
+
+#define PROBE_BEGIN(id)     do { } while (0)
+#define PROBE_END(id)       do { } while (0)
+
+#endif
+
+/*============================================================================
+ * Funktionen
+ *============================================================================*/
+
+/**
+ * @brief Startet den Zyklenzähler, legt die Tabelle an und misst den Overhead
+ *
+ * Vorher gemessene Stellen werden verworfen. Ohne PROBE_ENABLE leer.
+ */
+void probe_init(void);
+
+/**
+ * @brief Trägt eine Messung ein (nur über PROBE_END aufrufen)
+ *
+ * @param slot Statischer Merker der Stelle: 0 = noch kein Eintrag, sonst Index + 1
+ * @param name Name der Stelle
+ * @param cycles Gemessene Zyklen
+ */
+void probe_record(uint32_t *slot, const char *name, uint64_t cycles);
+
+#endif /* PROBE_H */
@@ -0,0 +1,173 @@
+/**
+ * @file prof.c
+ * @brief PC-Sampling Profiler Implementierung
+ */
+
+#include "prof.h"
+#include "arch.h"
+#include "irq.h"
+
+/* CNTV_CTL_EL0 Bits */
+#define CNTV_CTL_ENABLE     (1UL << 0)
+#define CNTV_CTL_IMASK      (1UL << 1)
+
+/* Bit im Core Timer Interrupt Control Register: nCNTVIRQ -> IRQ */
+#define TIMER_INT_CNTV_IRQ  (1U << 3)
+
+_Static_assert((PROF_SAMPLES & (PROF_SAMPLES - 1)) == 0,
+               "PROF_SAMPLES muss eine Zweierpotenz sein");
+_Static_assert(sizeof(prof_sample_t) == 64, "prof_sample_t Layout");
+_Static_assert(sizeof(prof_shared_t) <= SHARED_PROF_SIZE,
+               "prof_shared_t passt nicht in SHARED_PROF");
+
+/* Linker-Symbole: der Stack liegt in .bss (boot.S) */
+extern char __bss_start[];
+extern char __bss_end[];
+
+/*============================================================================
+ * Private Variablen
+ *============================================================================*/
+
+static uint32_t g_head = 0;
+
+#if PROF_HZ > 0
+static prof_shared_t *g_prof = NULL;
+static uint64_t g_period = 0;       /* Counter-Ticks zwischen zwei Samples */
+static uint64_t g_next = 0;         /* Nächste Deadline (CNTV_CVAL_EL0) */
+static uint64_t g_start = 0;        /* PMCCNTR beim Start */
+static uint64_t g_busy = 0;
+static uint32_t g_max = 0;
+static uint32_t g_rand = 0x2545F491;
+
+/*============================================================================
+ * Hilfsfunktionen
+ *============================================================================*/
+
+/* xorshift32: Jitter für die Abstände */
+static uint32_t next_rand(void) {
+    uint32_t x = g_rand;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_rand = x;
+    return x;
+}
+
+/* Periode ± 1/16, mindestens ein Tick */
+static uint64_t next_period(void) {
+    uint64_t span = g_period / 8;
+    uint64_t p = g_period - g_period / 16;
+
+    if (span) {
+        p += next_rand() % span;
+    }
+    return p ? p : 1;
+}
+
+#if PROF_STACKS
+/* Frame Record {x29, x30} aufsteigend im Stack, 8-Byte aligned */
+static uint32_t walk_stack(uint64_t fp, uint64_t *out) {
+    uintptr_t lo = (uintptr_t)__bss_start;
+    uintptr_t hi = (uintptr_t)__bss_end;
+    uint64_t prev = 0;
+    uint32_t n = 0;
+
+    while (n < PROF_STACK_DEPTH && fp > prev && (fp & 7) == 0 &&
+           fp >= lo && fp + 16 <= hi) {
+        const uint64_t *rec = (const uint64_t *)(uintptr_t)fp;
+        if (rec[1] == 0) {
+            break;
+        }
+        out[n++] = rec[1];
+        prev = fp;
+        fp = rec[0];
+    }
+    return n;
+}
+#endif
+
+/*============================================================================
+ * IRQ Handler
+ *============================================================================*/
+
+static void prof_irq(exception_frame_t *frame) {
+    uint64_t t0 = arch_cycles();
+    uint64_t now = READ_SYSREG(cntvct_el0);
+    prof_sample_t *s;
+    uint32_t idx;
+
+    /* Nächste Deadline; liegt sie schon hinten (IRQs lange maskiert), neu aufsetzen */
+    g_next += next_period();
+    if ((int64_t)(g_next - now) <= 0) {
+        g_next = now + next_period();
+    }
+    WRITE_SYSREG(cntv_cval_el0, g_next);
+
+    idx = g_head++;
+    s = &g_prof->samples[idx & (PROF_SAMPLES - 1)];
+    s->pc = frame->elr;
+#if PROF_STACKS
+    s->depth = walk_stack(frame->x[29], s->stack);
+#else
+    s->depth = 0;
+#endif
+    STORE_RELEASE(&s->seq, idx);
+    STORE_RELEASE(&g_prof->head, idx + 1);
+
+    uint64_t t1 = arch_cycles();
+    uint32_t dt = (uint32_t)(t1 - t0);
+    g_busy += dt;
+    if (dt > g_max) {
+        g_max = dt;
+        g_prof->handler_max_cycles = dt;
+    }
+    g_prof->busy_cycles = g_busy;
+    g_prof->elapsed_cycles = t1 - g_start;
+}
+
+#endif /* PROF_HZ > 0 */
+
+/*============================================================================
+ * Implementierung
+ *============================================================================*/
+
+void prof_init(void) {
+#if PROF_HZ > 0
+    prof_shared_t *p = (prof_shared_t *)SHARED_PROF_ADDR;
+
+    arch_cycles_init();
+    WRITE_SYSREG(cntv_ctl_el0, CNTV_CTL_IMASK);
+
+    p->magic = 0;
+    p->head = 0;
+    p->handler_max_cycles = 0;
+    p->busy_cycles = 0;
+    p->elapsed_cycles = 0;
+    p->sample_size = sizeof(prof_sample_t);
+    p->sample_count = PROF_SAMPLES;
+    p->rate_hz = PROF_HZ;
+    p->stack_depth = PROF_STACKS ? PROF_STACK_DEPTH : 0;
+    g_head = 0;
+    g_busy = 0;
+    g_max = 0;
+
+    /* Magic zuletzt: Linux liest erst wenn die Geometrie steht */
+    STORE_RELEASE(&p->magic, PROF_MAGIC);
+    g_prof = p;
+
+    g_period = arch_counter_freq() / PROF_HZ;
+    irq_register(IRQ_SRC_CNTV, prof_irq);
+    REG32(ARM_LOCAL_TIMER_INT_CTRL(CORE3_ID)) |= TIMER_INT_CNTV_IRQ;
+    DSB();
+
+    g_start = arch_cycles();
+    g_next = READ_SYSREG(cntvct_el0) + next_period();
+    WRITE_SYSREG(cntv_cval_el0, g_next);
+    WRITE_SYSREG(cntv_ctl_el0, CNTV_CTL_ENABLE);
+    ISB();
+#endif
+}
+
+uint32_t prof_count(void) {
+    return g_head;
+}
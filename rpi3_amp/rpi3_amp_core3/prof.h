@@ -0,0 +1,99 @@
+/**
+ * @file prof.h
+ * @brief Statistischer PC-Sampling Profiler (SHARED_PROF_ADDR)
+ *
+ * Der Virtual Timer (CNTV, der Physical Timer CNTP gehört gtimer.c) feuert
+ * PROF_HZ mal pro Sekunde. Der IRQ Handler legt die Rücksprungadresse aus
+ * dem Exception Frame (ELR_EL2 bzw. ELR_EL1) als Sample in einen Ring im
+ * Shared Memory. linux_tools/prof_dump ordnet die Adressen den Symbolen
+ * aus kernel8.elf zu und gibt ein flaches Profil aus.
+ *
+ * Mit PROF_STACKS=1 (make PROF_FP=1, baut mit Frame Pointern) folgt der
+ * Handler zusätzlich der x29-Kette und speichert bis zu PROF_STACK_DEPTH
+ * Rücksprungadressen - prof_dump -f macht daraus Folded Stacks für
+ * flamegraph.pl / speedscope.
+ *
+ * Schreiben/Lesen wie beim Trace-Ring (trace.h): Sample füllen, seq =
+ * Index zuletzt, dann head = Index + 1 (Release).
+ *
+ * Die Abstände bekommen etwas Jitter (bis ±1/16 Periode), damit das
+ * Sampling nicht im Takt des 1 ms Schedulers einrastet. Code mit
+ * maskierten IRQs (irq_save .. irq_restore, andere IRQ Handler) sieht der
+ * Profiler nicht, seine Samples landen auf dem ersten Befehl danach.
+ *
+ * Kosten: busy_cycles zählt die Zyklen im Handler, elapsed_cycles die
+ * Zyklen seit dem Start - prof_dump zeigt den Anteil. Mit PROF_HZ=0
+ * (Default, make PROF_HZ=n zum Einschalten) läuft kein Timer.
+ */
+
+#ifndef PROF_H
+#define PROF_H
+
+#include "common.h"
+
+/*============================================================================
+ * Konfiguration
+ *============================================================================*/
+
+/* Samples pro Sekunde (0 = aus) */
+#ifndef PROF_HZ
+#define PROF_HZ             0
+#endif
+
+/* Aufrufkette über Frame Pointer (nur sinnvoll mit -fno-omit-frame-pointer) */
+#ifndef PROF_STACKS
+#define PROF_STACKS         0
+#endif
+
+#define PROF_MAGIC          0x464F5250  /* "PROF" */
+#define PROF_SAMPLES        1024        /* Zweierpotenz, 1 s bei 1 kHz */
+#define PROF_STACK_DEPTH    6
+
+/*============================================================================
+ * Shared Memory Strukturen (MÜSSEN mit linux_tools/amp_shared.h übereinstimmen!)
+ *============================================================================*/
+
+typedef struct {
+    uint64_t pc;                        /* ELR: unterbrochener Befehl */
+    uint64_t stack[PROF_STACK_DEPTH];   /* Rücksprungadressen, [0] = direkter Aufrufer */
+    uint32_t depth;                     /* Gültige Einträge in stack */
+    uint32_t seq;                       /* Index des Samples, zuletzt geschrieben */
+} prof_sample_t;
+
+typedef struct {
+    /* Cache-Line 0: nur von Core 3 geschrieben */
+    volatile uint32_t head;             /* Anzahl geschriebener Samples (läuft über) */
+    volatile uint32_t handler_max_cycles;
+    volatile uint64_t busy_cycles;      /* Summe der Zyklen im Handler */
+    volatile uint64_t elapsed_cycles;   /* Zyklen seit prof_init() */
+    uint8_t  _pad0[40];
+
+    /* Cache-Line 1: Geometrie, nach dem Init read-only */
+    uint32_t magic;                     /* PROF_MAGIC, wird zuletzt gesetzt */
+    uint32_t sample_size;               /* sizeof(prof_sample_t) */
+    uint32_t sample_count;              /* PROF_SAMPLES */
+    uint32_t rate_hz;                   /* PROF_HZ */
+    uint32_t stack_depth;               /* 0 ohne PROF_STACKS */
+    uint8_t  _pad1[44];
+
+    prof_sample_t samples[PROF_SAMPLES];
+} prof_shared_t;
+
+/*============================================================================
+ * Funktionen
+ *============================================================================*/
+
+/**
+ * @brief Legt den Ring an und startet den Sampling-Timer
+ *
+ * Nach gtimer_init() aufrufen, die Samples kommen ab irq_enable().
+ * Ohne PROF_HZ leer.
+ */
+void prof_init(void);
+
+/**
+ * @brief Anzahl bisher genommener Samples
+ */
+uint32_t prof_count(void);
+
+#endif /* PROF_H */
@@ -0,0 +1,83 @@
+#!/bin/sh
+# =============================================================================
+# RPi3 AMP - Boot-Benchmark unter QEMU (make qemu-bench)
+# =============================================================================
+#
+# Bootet die Firmware (gebaut mit AMP_BENCH_BOOT=1) auf qemu-system-aarch64
+# -M raspi3b, wartet auf BENCH_DONE_MARKER (bench.h) im UART0 Log, dumpt
+# den Status-Block über den QEMU Monitor und wandelt ihn mit status_json
+# (linux_tools) in JSON um.
+#
+# Usage:
+#   qemu/qemu_bench.sh <qemu> <release.bin> <kernel8.img> <out_dir> <timeout_s> <status_json>
+#
+# Ergebnis in <out_dir>:
+#   uart0.log    UART0 Ausgabe
+#   status.bin   Roher Status-Block (SHARED_STATUS_ADDR, 4 KB)
+#   bench.json   Maschinenlesbare Ergebnisse
+#
+# =============================================================================
+
+set -u
+
+if [ $# -ne 6 ]; then
+    echo "Usage: $0 <qemu> <release.bin> <kernel8.img> <out_dir> <timeout_s> <status_json>" >&2
+    exit 2
+fi
+
+QEMU=$1
+RELEASE=$2
+IMAGE=$3
+OUT=$4
+TIMEOUT=$5
+STATUS_JSON=$6
+
+# Müssen zu common.h / bench.h passen
+AMP_CODE_BASE=0x20000000
+SHARED_STATUS_ADDR=0x20A00000
+SHARED_STATUS_SIZE=4096
+MARKER="BENCH DONE"
+
+LOG=$OUT/uart0.log
+DUMP=$OUT/status.bin
+JSON=$OUT/bench.json
+
+mkdir -p "$OUT"
+rm -f "$LOG" "$DUMP" "$JSON"
+
+# Monitor-Befehle über stdin: erst wenn der Marker im Log steht dumpen,
+# dann beenden. Der Monitor arbeitet die Befehle der Reihe nach ab.
+(
+    t=0
+    while ! grep -q "$MARKER" "$LOG" 2>/dev/null; do
+        if [ "$t" -ge "$TIMEOUT" ]; then
+            echo "qemu_bench: no '$MARKER' after ${TIMEOUT}s, see $LOG" >&2
+            break
+        fi
+        sleep 1
+        t=$((t + 1))
+    done
+    echo "pmemsave $SHARED_STATUS_ADDR $SHARED_STATUS_SIZE $DUMP"
+    echo "quit"
+) | "$QEMU" -M raspi3b -display none \
+        -monitor stdio -serial file:"$LOG" \
+        -kernel "$RELEASE" \
+        -device loader,file="$IMAGE",addr=$AMP_CODE_BASE,force-raw=on \
+        > "$OUT/monitor.log"
+
+if [ ! -s "$DUMP" ]; then
+    echo "qemu_bench: no status dump, see $OUT/monitor.log" >&2
+    exit 1
+fi
+
+"$STATUS_JSON" -f "$DUMP" > "$JSON" || {
+    echo "qemu_bench: invalid status block (firmware did not start?)" >&2
+    exit 1
+}
+
+grep -q '"bench_done": true' "$JSON" || {
+    echo "qemu_bench: benchmark did not finish, partial results in $JSON" >&2
+    exit 1
+}
+
+echo "Results: $JSON"
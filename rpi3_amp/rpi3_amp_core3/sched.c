@@ -0,0 +1,204 @@
+/**
+ * @file sched.c
+ * @brief Periodischer Scheduler Implementierung
+ */
+
+#include "sched.h"
+#include "gtimer.h"
+#include "memory.h"
+#include "trace.h"
+
+/*============================================================================
+ * Private Typen und Variablen
+ *============================================================================*/
+
+typedef struct {
+    sched_fn_t fn;
+    void *arg;
+    uint64_t period;            /* Ticks */
+    uint64_t deadline;          /* Ticks, relativ zum Release */
+    uint64_t next_release;      /* Absoluter Counter-Wert */
+    uint64_t exec_sum;          /* Ticks, für den Durchschnitt */
+    sched_stats_t stats;
+} sched_task_t;
+
+static sched_task_t g_tasks[SCHED_MAX_TASKS];
+static uint32_t g_task_count = 0;
+
+/*============================================================================
+ * Hilfsfunktionen
+ *============================================================================*/
+
+static uint32_t ticks_to_ns32(uint64_t ticks) {
+    uint64_t ns = gtimer_ticks_to_ns(ticks);
+    return (ns > 0xFFFFFFFFULL) ? 0xFFFFFFFF : (uint32_t)ns;
+}
+
+static void publish(uint32_t id) {
+    shared_mem_set_sched_task(id, &g_tasks[id].stats);
+}
+
+/* Fällige Task mit der höchsten Priorität, -1 wenn keine */
+static int pick_ready(uint64_t now) {
+    int best = -1;
+
+    for (uint32_t i = 0; i < g_task_count; i++) {
+        if (g_tasks[i].next_release > now) {
+            continue;
+        }
+        if (best < 0 ||
+            g_tasks[i].stats.priority < g_tasks[best].stats.priority ||
+            (g_tasks[i].stats.priority == g_tasks[best].stats.priority &&
+             g_tasks[i].next_release < g_tasks[best].next_release)) {
+            best = (int)i;
+        }
+    }
+    return best;
+}
+
+static void run_task(sched_task_t *t) {
+    uint64_t release = t->next_release;
+    uint32_t id = (uint32_t)(t - g_tasks);
+    uint64_t start = gtimer_count();
+
+    TRACE_BEGIN(TRACE_EV_TASK, id);
+    t->fn(t->arg);
+    TRACE_END(TRACE_EV_TASK, id);
+
+    uint64_t end = gtimer_count();
+    uint64_t exec = end - start;
+    uint32_t exec_ns = ticks_to_ns32(exec);
+
+    t->stats.runs++;
+    t->exec_sum += exec;
+    if (t->stats.runs == 1 || exec_ns < t->stats.exec_min_ns) t->stats.exec_min_ns = exec_ns;
+    if (exec_ns > t->stats.exec_max_ns) t->stats.exec_max_ns = exec_ns;
+    t->stats.exec_avg_ns = ticks_to_ns32(t->exec_sum / t->stats.runs);
+
+    if (end > release + t->deadline) {
+        t->stats.misses++;
+    }
+
+    /* Nächster Release; verpasste Perioden zählen als Miss statt nachzuholen */
+    t->next_release = release + t->period;
+    while (t->next_release <= end) {
+        t->next_release += t->period;
+        t->stats.misses++;
+    }
+}
+
+/*============================================================================
+ * Implementierung
+ *============================================================================*/
+
+void sched_init(void) {
+    g_task_count = 0;
+}
+
+int sched_add(const char *name, sched_fn_t fn, void *arg,
+              uint32_t period_us, uint32_t priority, uint32_t deadline_us) {
+    if (g_task_count >= SCHED_MAX_TASKS || !fn || period_us == 0) {
+        return -1;
+    }
+
+    uint32_t id = g_task_count;
+    sched_task_t *t = &g_tasks[id];
+    uint32_t i;
+
+    if (deadline_us == 0) {
+        deadline_us = period_us;
+    }
+
+    t->fn = fn;
+    t->arg = arg;
+    t->period = gtimer_us_to_ticks(period_us);
+    t->deadline = gtimer_us_to_ticks(deadline_us);
+    t->next_release = SCHED_NEVER;
+    t->exec_sum = 0;
+
+    for (i = 0; i < SCHED_NAME_LEN - 1 && name && name[i]; i++) {
+        t->stats.name[i] = name[i];
+    }
+    for (; i < SCHED_NAME_LEN; i++) {
+        t->stats.name[i] = '\0';
+    }
+    t->stats.period_us = period_us;
+    t->stats.deadline_us = deadline_us;
+    t->stats.priority = priority;
+    t->stats.runs = 0;
+    t->stats.misses = 0;
+    t->stats.exec_min_ns = 0;
+    t->stats.exec_avg_ns = 0;
+    t->stats.exec_max_ns = 0;
+
+    g_task_count++;
+    publish(id);
+    return (int)id;
+}
+
+int sched_find(const char *name) {
+    for (uint32_t i = 0; i < g_task_count; i++) {
+        const char *a = g_tasks[i].stats.name;
+        uint32_t k = 0;
+
+        while (k < SCHED_NAME_LEN && a[k] && a[k] == name[k]) {
+            k++;
+        }
+        if (k == SCHED_NAME_LEN || a[k] == name[k]) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+bool sched_set_period(int id, uint32_t period_us) {
+    sched_task_t *t;
+
+    if (id < 0 || (uint32_t)id >= g_task_count || period_us == 0) {
+        return false;
+    }
+
+    t = &g_tasks[id];
+    if (t->stats.deadline_us == t->stats.period_us) {
+        t->deadline = gtimer_us_to_ticks(period_us);
+        t->stats.deadline_us = period_us;
+    }
+    t->period = gtimer_us_to_ticks(period_us);
+    t->stats.period_us = period_us;
+    if (t->next_release != SCHED_NEVER) {
+        t->next_release = gtimer_count() + t->period;
+    }
+    publish((uint32_t)id);
+    return true;
+}
+
+void sched_start(void) {
+    uint64_t now = gtimer_count();
+
+    for (uint32_t i = 0; i < g_task_count; i++) {
+        g_tasks[i].next_release = now;
+    }
+}
+
+uint32_t sched_run(void) {
+    uint32_t count = 0;
+    int id;
+
+    while ((id = pick_ready(gtimer_count())) >= 0) {
+        run_task(&g_tasks[id]);
+        publish((uint32_t)id);
+        count++;
+    }
+    return count;
+}
+
+uint64_t sched_next_release(void) {
+    uint64_t next = SCHED_NEVER;
+
+    for (uint32_t i = 0; i < g_task_count; i++) {
+        if (g_tasks[i].next_release < next) {
+            next = g_tasks[i].next_release;
+        }
+    }
+    return next;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file sched.h
+ * @brief Periodischer Run-to-Completion Scheduler für Core 3
+ *
+ * Tasks werden einmal registriert (Periode, Priorität, relative Deadline)
+ * und laufen immer bis zum Ende - kein Preemption, kein eigener Stack.
+ * sched_run() wird aus der Hauptschleife aufgerufen und führt alle fälligen
+ * Tasks nach Priorität aus. sched_next_release() liefert den nächsten
+ * Release-Zeitpunkt, auf den die Hauptschleife den Generic Timer (CNTP)
+ * programmiert - der Compare-IRQ weckt Core 3 genau dann aus dem WFI.
+ *
+ * Pro Task werden Läufe, Deadline-Misses und Ausführungszeit (min/avg/max)
+ * gezählt und in shared_status_t.sched_tasks[] veröffentlicht.
+ */
+
+#ifndef SCHED_H
+#define SCHED_H
+
+#include "common.h"
+
+/*============================================================================
+ * Konfiguration
+ *============================================================================*/
+
+#define SCHED_MAX_TASKS     8
+#define SCHED_NAME_LEN      16
+
+/* Keine Task fällig */
+#define SCHED_NEVER         0xFFFFFFFFFFFFFFFFULL
+
+/*============================================================================
+ * Typen
+ *============================================================================*/
+
+typedef void (*sched_fn_t)(void *arg);
+
+/* Statistik einer Task (Shared Memory, MUSS mit linux_tools/amp_shared.h übereinstimmen!) */
+typedef struct {
+    char     name[SCHED_NAME_LEN];
+    uint32_t period_us;
+    uint32_t deadline_us;       /* Relativ zum Release */
+    uint32_t priority;          /* 0 = höchste */
+    uint32_t runs;
+    uint32_t misses;            /* Fertig nach Deadline oder Release übersprungen */
+    uint32_t exec_min_ns;
+    uint32_t exec_avg_ns;
+    uint32_t exec_max_ns;
+} sched_stats_t;
+
+/*============================================================================
+ * Funktionen
+ *============================================================================*/
+
+/**
+ * @brief Setzt alle Tasks zurück (benötigt gtimer_init())
+ */
+void sched_init(void);
+
+/**
+ * @brief Registriert eine periodische Task
+ * @param name Name (max. SCHED_NAME_LEN - 1 Zeichen)
+ * @param fn Task-Funktion, läuft bis zum Ende
+ * @param arg Argument für fn
+ * @param period_us Periode in µs
+ * @param priority 0 = höchste; bei gleichzeitigem Release läuft die kleinere zuerst
+ * @param deadline_us Relative Deadline in µs (0 = Periode)
+ * @return Task-ID oder -1 wenn kein Platz
+ */
+int sched_add(const char *name, sched_fn_t fn, void *arg,
+              uint32_t period_us, uint32_t priority, uint32_t deadline_us);
+
+/**
+ * @brief Sucht eine Task über ihren Namen
+ * @return Task-ID oder -1
+ */
+int sched_find(const char *name);
+
+/**
+ * @brief Ändert die Periode einer Task zur Laufzeit
+ *
+ * Der nächste Release ist jetzt + neue Periode. Eine Deadline gleich der
+ * alten Periode (sched_add mit deadline_us = 0) wandert mit.
+ *
+ * @param id Task-ID
+ * @param period_us Neue Periode in µs (> 0)
+ * @return false bei ungültiger ID oder Periode
+ */
+bool sched_set_period(int id, uint32_t period_us);
+
+/**
+ * @brief Erster Release aller Tasks = jetzt
+ */
+void sched_start(void);
+
+/**
+ * @brief Führt alle fälligen Tasks aus (höchste Priorität zuerst)
+ * @return Anzahl ausgeführter Tasks
+ */
+uint32_t sched_run(void);
+
+/**
+ * @brief Nächster Release-Zeitpunkt (Generic Timer Ticks)
+ * @return Counter-Wert oder SCHED_NEVER wenn keine Task registriert ist
+ */
+uint64_t sched_next_release(void);
+
+#endif /* SCHED_H */
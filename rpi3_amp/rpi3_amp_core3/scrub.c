@@ -0,0 +1,242 @@
+/**
+ * @file scrub.c
+ * @brief Inkrementeller Memory Scrubber Implementierung
+ */
+
+#include "scrub.h"
+#include "memory.h"
+#include "mmu.h"
+
+_Static_assert(sizeof(scrub_shared_t) <= SHARED_SCRUB_SIZE,
+               "scrub_shared_t passt nicht in SHARED_SCRUB");
+_Static_assert((SCRUB_BITMAP_PAGES % 32) == 0, "Bitmap Größe");
+
+/* Aus link.ld */
+extern char __image_end[];
+
+#define WORDS_PER_PAGE  (SCRUB_PAGE_SIZE / sizeof(uint64_t))
+#define ONES            0xFFFFFFFFFFFFFFFFULL
+
+/*============================================================================
+ * Private Variablen
+ *============================================================================*/
+
+typedef struct {
+    uintptr_t start;
+    uintptr_t end;
+} scrub_range_t;
+
+static scrub_range_t g_ranges[SCRUB_MAX_RANGES];
+static uint32_t g_range_count = 0;
+
+/* Position */
+static uint32_t g_range_idx = 0;
+static uintptr_t g_cur = 0;
+
+/* Fortschritt */
+static uint32_t g_pass = 0;
+static uint32_t g_pass_bytes = 0;
+static uint32_t g_done = 0;
+static uint32_t g_errors = 0;
+static uint32_t g_bad_pages = 0;
+
+/*============================================================================
+ * Hilfsfunktionen
+ *============================================================================*/
+
+static bool overlaps(uintptr_t s1, uintptr_t e1, uintptr_t s2, uintptr_t e2) {
+    return s1 < e2 && s2 < e1;
+}
+
+/* Markiert eine Seite als fehlerhaft (nur beim ersten Fehler zählen) */
+static void mark_bad(uintptr_t page) {
+    scrub_shared_t *shm = (scrub_shared_t *)SHARED_SCRUB_ADDR;
+    uint32_t bit = (uint32_t)((page - SCRUB_BITMAP_BASE) / SCRUB_PAGE_SIZE);
+    uint32_t mask = 1U << (bit % 32);
+
+    if (bit >= SCRUB_BITMAP_PAGES) {
+        return;
+    }
+    if (!(shm->bitmap[bit / 32] & mask)) {
+        shm->bitmap[bit / 32] |= mask;
+        g_bad_pages++;
+    }
+}
+
+/* Nach jedem March-Element: Reads des nächsten Elements aus dem DRAM */
+static void element_done(uintptr_t page, bool cached) {
+    if (cached) {
+        dcache_clean_invalidate_range(page, SCRUB_PAGE_SIZE);
+    } else {
+        DSB();
+    }
+}
+
+/* March C- über eine Seite, gibt die Anzahl fehlerhafter Wörter zurück */
+static uint32_t march_page(uintptr_t page) {
+    volatile uint64_t *w = (volatile uint64_t *)page;
+    bool cached = mmu_is_cacheable(page);
+    uint32_t errors = 0;
+    int32_t i;
+
+    /* M0: ⇕ w0 */
+    for (i = 0; i < (int32_t)WORDS_PER_PAGE; i++) {
+        w[i] = 0;
+    }
+    element_done(page, cached);
+
+    /* M1: ⇑ r0, w1 */
+    for (i = 0; i < (int32_t)WORDS_PER_PAGE; i++) {
+        if (w[i] != 0) errors++;
+        w[i] = ONES;
+    }
+    element_done(page, cached);
+
+    /* M2: ⇑ r1, w0 */
+    for (i = 0; i < (int32_t)WORDS_PER_PAGE; i++) {
+        if (w[i] != ONES) errors++;
+        w[i] = 0;
+    }
+    element_done(page, cached);
+
+    /* M3: ⇓ r0, w1 */
+    for (i = WORDS_PER_PAGE - 1; i >= 0; i--) {
+        if (w[i] != 0) errors++;
+        w[i] = ONES;
+    }
+    element_done(page, cached);
+
+    /* M4: ⇓ r1, w0 */
+    for (i = WORDS_PER_PAGE - 1; i >= 0; i--) {
+        if (w[i] != ONES) errors++;
+        w[i] = 0;
+    }
+    element_done(page, cached);
+
+    /* M5: ⇕ r0 */
+    for (i = 0; i < (int32_t)WORDS_PER_PAGE; i++) {
+        if (w[i] != 0) errors++;
+    }
+
+    return errors;
+}
+
+static void publish(void) {
+    shared_mem_set_scrub(g_pass, g_done, g_pass_bytes, g_errors, g_bad_pages,
+                         (uint32_t)g_cur);
+}
+
+/*============================================================================
+ * Implementierung
+ *============================================================================*/
+
+void scrub_init(void) {
+    scrub_shared_t *shm = (scrub_shared_t *)SHARED_SCRUB_ADDR;
+
+    shm->magic = 0;
+    shm->base = SCRUB_BITMAP_BASE;
+    shm->page_size = SCRUB_PAGE_SIZE;
+    shm->page_count = SCRUB_BITMAP_PAGES;
+    for (uint32_t i = 0; i < SCRUB_BITMAP_PAGES / 32; i++) {
+        shm->bitmap[i] = 0;
+    }
+    DMB();
+    shm->magic = SCRUB_MAGIC;
+
+    g_range_count = 0;
+    g_range_idx = 0;
+    g_cur = 0;
+    g_pass = 0;
+    g_pass_bytes = 0;
+    g_done = 0;
+    g_errors = 0;
+    g_bad_pages = 0;
+    publish();
+}
+
+bool scrub_add_range(uintptr_t start, uint32_t size) {
+    uintptr_t s = (start + SCRUB_PAGE_SIZE - 1) & ~(uintptr_t)(SCRUB_PAGE_SIZE - 1);
+    uintptr_t e = (start + size) & ~(uintptr_t)(SCRUB_PAGE_SIZE - 1);
+    uintptr_t image_end = (uintptr_t)__image_end;
+
+    if (g_range_count >= SCRUB_MAX_RANGES || s >= e) {
+        return false;
+    }
+
+    /* Nur AMP-Bereich und Shared Memory */
+    if (s < AMP_CODE_BASE || e > SHARED_MEM_BASE + SHARED_MEM_SIZE) {
+        return false;
+    }
+
+    /* Firmware-Image (Code, Daten, Stack, Page Tables) */
+    if (overlaps(s, e, AMP_CODE_BASE, image_end)) {
+        return false;
+    }
+
+    /* Benutztes Shared Memory, außer dem Memtest-Fenster */
+    if (overlaps(s, e, SHARED_MEM_BASE, SHARED_MEMTEST_ADDR) ||
+        overlaps(s, e, SHARED_MEMTEST_ADDR + SHARED_MEMTEST_SIZE, SHARED_FREE_ADDR)) {
+        return false;
+    }
+
+    g_ranges[g_range_count].start = s;
+    g_ranges[g_range_count].end = e;
+    if (g_range_count == 0) {
+        g_cur = s;
+        g_pass = 1;
+    }
+    g_range_count++;
+    g_pass_bytes += (uint32_t)(e - s);
+
+    publish();
+    return true;
+}
+
+void scrub_add_default_ranges(void) {
+    uintptr_t image_end = (uintptr_t)__image_end;
+
+    scrub_add_range(image_end, (uint32_t)(AMP_CODE_BASE + AMP_CODE_SIZE - image_end));
+    scrub_add_range(SHARED_MEMTEST_ADDR, SHARED_MEMTEST_SIZE);
+    scrub_add_range(SHARED_FREE_ADDR,
+                    (uint32_t)(SHARED_MEM_BASE + SHARED_MEM_SIZE - SHARED_FREE_ADDR));
+}
+
+uint32_t scrub_step(uint32_t budget) {
+    uint32_t tested = 0;
+
+    if (g_range_count == 0) {
+        return 0;
+    }
+
+    while (tested < budget) {
+        if (g_cur >= g_ranges[g_range_idx].end) {
+            /* Nächster Bereich, nach dem letzten beginnt ein neuer Pass */
+            g_range_idx++;
+            if (g_range_idx >= g_range_count) {
+                g_range_idx = 0;
+                g_pass++;
+                g_done = 0;
+            }
+            g_cur = g_ranges[g_range_idx].start;
+            continue;
+        }
+
+        uint32_t errors = march_page(g_cur);
+        if (errors) {
+            g_errors += errors;
+            mark_bad(g_cur);
+        }
+
+        g_cur += SCRUB_PAGE_SIZE;
+        g_done += SCRUB_PAGE_SIZE;
+        tested += SCRUB_PAGE_SIZE;
+    }
+
+    publish();
+    return tested;
+}
+
+void scrub_task(void *arg) {
+    (void)arg;
+    scrub_step(SCRUB_KB_PER_STEP * 1024);
+}
@@ -0,0 +1,96 @@
+/**
+ * @file scrub.h
+ * @brief Inkrementeller Memory Scrubber (March C- pro 4 KB Seite)
+ *
+ * Statt memory_test_full() den ganzen Bereich am Stück testen zu lassen,
+ * testet scrub_step() pro Aufruf nur ein paar Seiten und merkt sich die
+ * Position. Aufgerufen wird es als Scheduler-Task, die Hauptschleife wird
+ * also nie länger als ein Schritt blockiert.
+ *
+ * Jede Seite bekommt einen vollständigen March C- Durchlauf:
+ *
+ *   ⇕(w0) ⇑(r0,w1) ⇑(r1,w0) ⇓(r0,w1) ⇓(r1,w0) ⇕(r0)
+ *
+ * Auf cacheable Seiten wird nach jedem Element clean+invalidate gemacht,
+ * damit die Reads des nächsten Elements aus dem DRAM kommen.
+ *
+ * Der Test ist destruktiv: erlaubt sind nur Bereiche hinter dem
+ * Firmware-Image, das Memtest-Fenster und das freie Shared Memory ab
+ * SHARED_FREE_ADDR. Fehlerhafte Seiten werden in einer Bitmap in
+ * SHARED_SCRUB_ADDR markiert (Bit = (addr - AMP_CODE_BASE) / 4 KB).
+ */
+
+#ifndef SCRUB_H
+#define SCRUB_H
+
+#include "common.h"
+
+/*============================================================================
+ * Konfiguration
+ *============================================================================*/
+
+#define SCRUB_PAGE_SIZE     4096
+#define SCRUB_MAX_RANGES    4
+#define SCRUB_MAGIC         0x42524353  /* "SCRB" */
+
+/* Bitmap deckt AMP-Bereich + Shared Memory ab (zusammenhängend) */
+#define SCRUB_BITMAP_BASE   AMP_CODE_BASE
+#define SCRUB_BITMAP_PAGES  ((AMP_CODE_SIZE + SHARED_MEM_SIZE) / SCRUB_PAGE_SIZE)
+
+/* Getestete KB pro scrub_step() aus dem Scheduler (0 = Scrubber aus) */
+#ifndef SCRUB_KB_PER_STEP
+#define SCRUB_KB_PER_STEP   16
+#endif
+
+/* Periode der Scrub-Task */
+#define SCRUB_PERIOD_MS     5
+
+/*============================================================================
+ * Shared Memory Struktur (MUSS mit linux_tools/amp_shared.h übereinstimmen!)
+ *============================================================================*/
+
+typedef struct {
+    uint32_t magic;             /* SCRUB_MAGIC */
+    uint32_t base;              /* Adresse von Bit 0 */
+    uint32_t page_size;
+    uint32_t page_count;        /* Gültige Bits */
+    uint32_t bitmap[SCRUB_BITMAP_PAGES / 32];   /* 1 = Seite hatte Fehler */
+} scrub_shared_t;
+
+/*============================================================================
+ * Funktionen
+ *============================================================================*/
+
+/**
+ * @brief Initialisiert die Bitmap und setzt alle Bereiche zurück
+ */
+void scrub_init(void);
+
+/**
+ * @brief Fügt einen zu testenden Bereich hinzu
+ *
+ * Der Bereich wird auf ganze Seiten gekürzt. Überschneidungen mit dem
+ * Firmware-Image oder benutztem Shared Memory werden abgelehnt.
+ *
+ * @return true wenn übernommen
+ */
+bool scrub_add_range(uintptr_t start, uint32_t size);
+
+/**
+ * @brief Standard-Bereiche: AMP-Bereich hinter dem Image, Memtest-Fenster,
+ *        freies Shared Memory
+ */
+void scrub_add_default_ranges(void);
+
+/**
+ * @brief Testet bis zu budget Bytes ab der aktuellen Position
+ * @return Anzahl getesteter Bytes
+ */
+uint32_t scrub_step(uint32_t budget);
+
+/**
+ * @brief Scheduler-Task: scrub_step(SCRUB_KB_PER_STEP * 1024)
+ */
+void scrub_task(void *arg);
+
+#endif /* SCRUB_H */
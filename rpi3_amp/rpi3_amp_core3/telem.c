@@ -0,0 +1,115 @@
+/**
+ * @file telem.c
+ * @brief SoC-Telemetrie Implementierung
+ */
+
+#include "telem.h"
+#include "mbox.h"
+#include "timer.h"
+
+_Static_assert((TELEM_SAMPLES & (TELEM_SAMPLES - 1)) == 0,
+               "TELEM_SAMPLES muss eine Zweierpotenz sein");
+_Static_assert(sizeof(telem_sample_t) == 32, "telem_sample_t Layout");
+_Static_assert(sizeof(telem_shared_t) <= SHARED_TELEM_SIZE,
+               "telem_shared_t passt nicht in SHARED_TELEM");
+
+/*============================================================================
+ * Private Variablen
+ *============================================================================*/
+
+static telem_shared_t *g_telem = NULL;
+static uint32_t g_head = 0;     /* Lokale Kopie, head im Shared Memory nur schreiben */
+static uint32_t g_errors = 0;
+
+/*============================================================================
+ * Implementierung
+ *============================================================================*/
+
+void telem_init(void) {
+    telem_shared_t *t = (telem_shared_t *)SHARED_TELEM_ADDR;
+    uint32_t values[2] = { 0, 0 };
+
+    t->magic = 0;
+    t->head = 0;
+    t->errors = 0;
+    t->sample_size = sizeof(telem_sample_t);
+    t->sample_count = TELEM_SAMPLES;
+    t->period_ms = TELEM_PERIOD_MS;
+#if TELEM_PERIOD_MS > 0
+    t->source = TELEM_SOURCE_CORE3;
+    t->max_temp_mc = mbox_property(MBOX_TAG_GET_MAX_TEMP, values, 2) ? values[1] : 0;
+#else
+    /* Die Mailbox gehört Linux: telem_feed trägt Grenze und Periode ein */
+    (void)values;
+    t->source = TELEM_SOURCE_LINUX;
+    t->max_temp_mc = 0;
+#endif
+    g_head = 0;
+    g_errors = 0;
+
+    /* Magic zuletzt: Linux liest erst wenn die Geometrie steht */
+    STORE_RELEASE(&t->magic, TELEM_MAGIC);
+    g_telem = t;
+}
+
+bool telem_sample(void) {
+    telem_shared_t *t = g_telem;
+    telem_sample_t *s;
+    mbox_tag_t tags[4] = {
+        { MBOX_TAG_GET_CLOCK_RATE, { MBOX_CLOCK_ARM, 0 }, false },
+        { MBOX_TAG_GET_CLOCK_RATE, { MBOX_CLOCK_CORE, 0 }, false },
+        { MBOX_TAG_GET_TEMP, { 0, 0 }, false },
+        { MBOX_TAG_GET_THROTTLED, { 0, 0 }, false },
+    };
+    bool ok;
+    uint32_t idx;
+
+    if (!t) {
+        return false;
+    }
+
+    ok = mbox_property_batch(tags, 4);
+    if (!ok) {
+        STORE_RELEASE(&t->errors, ++g_errors);
+    }
+
+    idx = g_head++;
+    s = &t->samples[idx & (TELEM_SAMPLES - 1)];
+    s->ts_us = timer_get_ticks();
+    s->valid = 0;
+    s->arm_hz = 0;
+    s->core_hz = 0;
+    s->temp_mc = 0;
+    s->throttled = 0;
+    if (tags[0].ok && tags[0].value[0] == MBOX_CLOCK_ARM) {
+        s->arm_hz = tags[0].value[1];
+        s->valid |= TELEM_VALID_ARM;
+    }
+    if (tags[1].ok && tags[1].value[0] == MBOX_CLOCK_CORE) {
+        s->core_hz = tags[1].value[1];
+        s->valid |= TELEM_VALID_CORE;
+    }
+    if (tags[2].ok) {
+        s->temp_mc = tags[2].value[1];
+        s->valid |= TELEM_VALID_TEMP;
+    }
+    if (tags[3].ok) {
+        s->throttled = tags[3].value[0];
+        s->valid |= TELEM_VALID_THROTTLED;
+    }
+    STORE_RELEASE(&s->seq, idx);
+    STORE_RELEASE(&t->head, idx + 1);
+    return ok;
+}
+
+void telem_task(void *arg) {
+    (void)arg;
+    telem_sample();
+}
+
+const telem_sample_t *telem_last(void) {
+    if (!g_telem || g_head == 0) {
+        return NULL;
+    }
+    return &g_telem->samples[(g_head - 1) & (TELEM_SAMPLES - 1)];
+}
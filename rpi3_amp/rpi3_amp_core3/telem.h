@@ -0,0 +1,109 @@
+/**
+ * @file telem.h
+ * @brief SoC-Telemetrie: ARM/Core Takt, Temperatur, Throttling (SHARED_TELEM_ADDR)
+ *
+ * Ein Ring von Samples im Shared Memory. Damit sieht man, ob Core 3
+ * gerade langsamer läuft, weil Linux-Last den SoC aufheizt. Wer schreibt,
+ * steht in source:
+ *
+ *   TELEM_SOURCE_LINUX (Default, TELEM_PERIOD_MS = 0): linux_tools/telem_feed
+ *       fragt die GPU-Firmware über /dev/vcio und schreibt die Samples,
+ *       dazu period_ms und max_temp_mc. Core 3 fasst die Mailbox nicht an.
+ *   TELEM_SOURCE_CORE3 (make TELEM_MS=n): eine Scheduler-Task fragt per
+ *       mbox_property_batch(). Verfälscht Firmware-Aufrufe von Linux und
+ *       wartet bis zu MBOX_TIMEOUT_US (siehe mbox.h) - nur ohne Linux.
+ *
+ * Schreiben/Lesen wie beim Trace-Ring (trace.h): Sample füllen, seq =
+ * Index zuletzt, dann head = Index + 1 (Release). Linux kopiert Sample i
+ * und prüft danach seq == i und head - i < TELEM_SAMPLES.
+ *
+ * Beantwortet die GPU einen Tag nicht, fehlt das Bit in valid und der
+ * Wert ist 0.
+ */
+
+#ifndef TELEM_H
+#define TELEM_H
+
+#include "common.h"
+
+/*============================================================================
+ * Konfiguration
+ *============================================================================*/
+
+/* Abtastperiode der Mailbox-Task auf Core 3 (0 = aus, Linux liefert) */
+#ifndef TELEM_PERIOD_MS
+#define TELEM_PERIOD_MS     0
+#endif
+
+#define TELEM_MAGIC         0x4D4C4554  /* "TELM" */
+#define TELEM_SAMPLES       256         /* Zweierpotenz, 4 min bei 1 s */
+
+/* telem_shared_t.source: wer den Ring schreibt */
+#define TELEM_SOURCE_LINUX  0           /* linux_tools/telem_feed */
+#define TELEM_SOURCE_CORE3  1           /* telem_task() */
+
+/* telem_sample_t.valid */
+#define TELEM_VALID_ARM     (1U << 0)
+#define TELEM_VALID_CORE    (1U << 1)
+#define TELEM_VALID_TEMP    (1U << 2)
+#define TELEM_VALID_THROTTLED (1U << 3)
+
+/*============================================================================
+ * Shared Memory Strukturen (MÜSSEN mit linux_tools/amp_shared.h übereinstimmen!)
+ *============================================================================*/
+
+typedef struct {
+    uint64_t ts_us;         /* timer_get_ticks() bzw. CNTVCT in µs (telem_feed) */
+    uint32_t arm_hz;        /* ARM Takt (GET_CLOCK_RATE) */
+    uint32_t core_hz;       /* VPU/L2 Takt */
+    uint32_t temp_mc;       /* SoC Temperatur in milli-°C */
+    uint32_t throttled;     /* MBOX_THROTTLED_* Bits */
+    uint32_t valid;         /* TELEM_VALID_* */
+    uint32_t seq;           /* Index des Samples, zuletzt geschrieben */
+} telem_sample_t;
+
+typedef struct {
+    /* Cache-Line 0: nur vom Schreiber (source) */
+    volatile uint32_t head;         /* Anzahl geschriebener Samples (läuft über) */
+    volatile uint32_t errors;       /* Mailbox ohne Antwort */
+    uint8_t  _pad0[56];
+
+    /* Cache-Line 1: Geometrie, nach dem Init read-only */
+    uint32_t magic;                 /* TELEM_MAGIC, wird zuletzt gesetzt */
+    uint32_t sample_size;           /* sizeof(telem_sample_t) */
+    uint32_t sample_count;          /* TELEM_SAMPLES */
+    uint32_t period_ms;             /* Abtastperiode des Schreibers (0 = noch keiner) */
+    uint32_t max_temp_mc;           /* Abschaltgrenze der Firmware (0 = unbekannt) */
+    uint32_t source;                /* TELEM_SOURCE_* */
+    uint8_t  _pad1[40];
+
+    telem_sample_t samples[TELEM_SAMPLES];
+} telem_shared_t;
+
+/*============================================================================
+ * Funktionen
+ *============================================================================*/
+
+/**
+ * @brief Legt den Ring in SHARED_TELEM_ADDR an; mit TELEM_PERIOD_MS > 0 auch
+ *        die Temperaturgrenze per Mailbox
+ */
+void telem_init(void);
+
+/**
+ * @brief Nimmt ein Sample (ein Mailbox-Umlauf)
+ * @return true wenn die GPU geantwortet hat
+ */
+bool telem_sample(void);
+
+/**
+ * @brief Scheduler-Task: telem_sample()
+ */
+void telem_task(void *arg);
+
+/**
+ * @brief Letztes Sample, NULL wenn es noch keins gibt
+ */
+const telem_sample_t *telem_last(void);
+
+#endif /* TELEM_H */
@@ -1,11 +1,14 @@
 /**
  * @file timer.c
- * @brief System Timer Implementierung für RPi3
- * 
- * BCM2837 System Timer @ 1 MHz
+ * @brief Zeitbasis Implementierung (System Timer / CNTPCT_EL0)
  */
 
 #include "timer.h"
+#include "arch.h"
+
+#ifdef AMP_HOST
+#include "host.h"
+#endif
 
 /*============================================================================
  * System Timer Register
@@ -19,13 +22,86 @@
 #define SYSTIMER_C2     REG32(SYSTIMER_BASE + 0x14)  /* Compare 2 */
 #define SYSTIMER_C3     REG32(SYSTIMER_BASE + 0x18)  /* Compare 3 */
 
+/*============================================================================
+ * Private Variablen
+ *============================================================================*/
+
+static uint32_t g_freq = TIMER_SYSTIMER_FREQ;
+static timer_conv_t g_to_us;
+static timer_conv_t g_to_ms;
+static timer_conv_t g_to_s;
+
+#ifdef AMP_HOST
+/* Host: Counter ab Prozessstart zählen, wie der nachgeführte System Timer */
+static uint64_t g_counter_base = 0;
+#endif
+
 /*============================================================================
  * Implementierung
  *============================================================================*/
 
-uint64_t timer_get_ticks(void) {
+void timer_conv_init(timer_conv_t *conv, uint32_t from_hz, uint32_t to_hz) {
+    conv->mult = 0;
+    conv->shift = 0;
+    if (from_hz == 0) {
+        return;
+    }
+
+    for (uint32_t shift = 63; shift > 0; shift--) {
+        if ((uint64_t)to_hz > (~0ULL >> shift)) {
+            continue;
+        }
+        uint64_t mult = ((uint64_t)to_hz << shift) / from_hz;
+        if (mult <= 0xFFFFFFFFULL) {
+            conv->mult = (uint32_t)mult;
+            conv->shift = shift;
+            return;
+        }
+    }
+}
+
+void timer_init(void) {
+#if TIMER_SOURCE == TIMER_SOURCE_COUNTER
+    g_freq = arch_counter_freq();
+    if (g_freq == 0) {
+        g_freq = TIMER_COUNTER_FREQ_DEFAULT;
+    }
+#else
+    g_freq = TIMER_SYSTIMER_FREQ;
+#endif
+#ifdef AMP_HOST
+    g_counter_base = arch_counter();
+#endif
+
+    timer_conv_init(&g_to_us, g_freq, 1000000);
+    timer_conv_init(&g_to_ms, g_freq, 1000);
+    timer_conv_init(&g_to_s, g_freq, 1);
+}
+
+uint32_t timer_freq(void) {
+    return g_freq;
+}
+
+const char *timer_source_name(void) {
+    return TIMER_SOURCE == TIMER_SOURCE_COUNTER ? "cntpct" : "systimer";
+}
+
+uint64_t timer_read_counter(void) {
+#ifdef AMP_HOST
+    return arch_counter() - g_counter_base;
+#else
+    return arch_counter();
+#endif
+}
+
+uint64_t timer_read_systimer(void) {
     uint32_t hi, lo, hi_check;
     
+#ifdef AMP_HOST
+    /* Host-Build: CLO/CHI liegen im memfd und werden hier nachgeführt */
+    host_systimer_update();
+#endif
+    
     /* 
      * Lese High und Low Teil atomar.
      * Da der Zähler während des Lesens weiterlaufen kann,
@@ -40,12 +116,29 @@ uint64_t timer_get_ticks(void) {
     return ((uint64_t)hi << 32) | lo;
 }
 
+uint64_t timer_read(void) {
+#if TIMER_SOURCE == TIMER_SOURCE_COUNTER
+    return timer_read_counter();
+#else
+    return timer_read_systimer();
+#endif
+}
+
+uint64_t timer_get_ticks(void) {
+#if TIMER_SOURCE == TIMER_SOURCE_COUNTER
+    return timer_conv(&g_to_us, timer_read_counter());
+#else
+    /* System Timer zählt bereits in µs */
+    return timer_read_systimer();
+#endif
+}
+
 uint32_t timer_get_seconds(void) {
-    return (uint32_t)(timer_get_ticks() / 1000000ULL);
+    return (uint32_t)timer_conv(&g_to_s, timer_read());
 }
 
 uint32_t timer_get_millis(void) {
-    return (uint32_t)(timer_get_ticks() / 1000ULL);
+    return (uint32_t)timer_conv(&g_to_ms, timer_read());
 }
 
 void timer_delay_us(uint32_t us) {
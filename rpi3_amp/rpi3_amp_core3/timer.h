@@ -1,11 +1,21 @@
 /**
  * @file timer.h
- * @brief System Timer Treiber für RPi3
+ * @brief Zeitbasis für Core 3: System Timer oder ARM Generic Timer
  * 
- * Der BCM2837 System Timer läuft mit 1 MHz (1 µs pro Tick).
- * Er ist ein 64-bit freier Zähler, der nie überläuft (in der Praxis).
+ * Zwei Zeitquellen, Auswahl beim Bauen (make TIMER_SRC=...):
  * 
- * Bei 1 MHz: 584.942 Jahre bis zum Überlauf!
+ *   TIMER_SOURCE_SYSTIMER : BCM2837 System Timer, 1 MHz, 64-bit über
+ *                           CHI/CLO - bis zu drei ungecachte MMIO Reads
+ *   TIMER_SOURCE_COUNTER  : CNTPCT_EL0 (Default), ein Systemregister-Read,
+ *                           RPi3: 19.2 MHz (CNTFRQ_EL0)
+ * 
+ * timer_get_ticks() liefert unabhängig von der Quelle Mikrosekunden seit
+ * Boot. Die Umrechnung läuft über vorberechnete Multiplikator/Shift-Paare
+ * (timer_conv_t) statt 64-bit Division; timer_init() setzt sie auf und
+ * muss vor allen anderen timer_* Aufrufen laufen.
+ * 
+ * Beide Zähler laufen 64-bit und seit dem Einschalten - ein Überlauf
+ * kommt in der Praxis nicht vor (19.2 MHz: 30.000 Jahre).
  */
 
 #ifndef TIMER_H
@@ -13,13 +23,86 @@
 
 #include "common.h"
 
+/*============================================================================
+ * Konfiguration
+ *============================================================================*/
+
+#define TIMER_SOURCE_SYSTIMER   0
+#define TIMER_SOURCE_COUNTER    1
+
+#ifndef TIMER_SOURCE
+#define TIMER_SOURCE            TIMER_SOURCE_COUNTER
+#endif
+
+#define TIMER_SYSTIMER_FREQ     1000000     /* Hz */
+#define TIMER_COUNTER_FREQ_DEFAULT 19200000 /* Falls CNTFRQ_EL0 nicht gesetzt ist */
+
+/*============================================================================
+ * Umrechnung
+ *============================================================================*/
+
+/* value * to_hz / from_hz als (value * mult) >> shift */
+typedef struct {
+    uint32_t mult;
+    uint32_t shift;
+} timer_conv_t;
+
+/**
+ * @brief Berechnet mult/shift für from_hz -> to_hz (einmalig, mit Division)
+ *
+ * Wählt den größten Shift, bei dem mult noch in 32 Bit passt. Das Produkt
+ * wird in zwei 32x32-bit Hälften gerechnet (exakt wie 128-bit, aber ohne
+ * libgcc), value darf also den vollen 64-bit Bereich haben.
+ */
+void timer_conv_init(timer_conv_t *conv, uint32_t from_hz, uint32_t to_hz);
+
+/**
+ * @brief Rechnet um (Multiplikation + Shift, keine Division)
+ */
+static inline uint64_t timer_conv(const timer_conv_t *conv, uint64_t value) {
+    uint64_t lo = (value & 0xFFFFFFFFULL) * conv->mult;
+    uint64_t hi = (value >> 32) * conv->mult;
+
+    /* (hi << 32 + lo) >> shift */
+    if (conv->shift >= 32) {
+        return (hi + (lo >> 32)) >> (conv->shift - 32);
+    }
+    return (hi << (32 - conv->shift)) + (lo >> conv->shift);
+}
+
 /*============================================================================
  * Funktionen
  *============================================================================*/
 
+/**
+ * @brief Liest die Frequenz der Zeitquelle und berechnet die Faktoren
+ */
+void timer_init(void);
+
+/**
+ * @brief Rohwert der gewählten Zeitquelle
+ */
+uint64_t timer_read(void);
+
+/**
+ * @brief Frequenz der gewählten Zeitquelle in Hz
+ */
+uint32_t timer_freq(void);
+
+/**
+ * @brief Name der gewählten Zeitquelle ("systimer" oder "cntpct")
+ */
+const char *timer_source_name(void);
+
+/**
+ * @brief Rohwerte beider Quellen, unabhängig von TIMER_SOURCE (Benchmark)
+ */
+uint64_t timer_read_systimer(void);
+uint64_t timer_read_counter(void);
+
 /**
  * @brief Gibt den aktuellen Timer-Wert zurück (64-bit)
- * @return Timer-Wert in Mikrosekunden seit Boot
+ * @return Mikrosekunden seit Boot
  */
 uint64_t timer_get_ticks(void);
 
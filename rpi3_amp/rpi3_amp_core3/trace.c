@@ -0,0 +1,67 @@
+/**
+ * @file trace.c
+ * @brief Trace-Ring Implementierung
+ */
+
+#include "trace.h"
+#include "arch.h"
+#include "irq.h"
+
+_Static_assert((TRACE_RECORDS & (TRACE_RECORDS - 1)) == 0,
+               "TRACE_RECORDS muss eine Zweierpotenz sein");
+_Static_assert(sizeof(trace_rec_t) == 24, "trace_rec_t Layout");
+_Static_assert(sizeof(trace_shared_t) <= SHARED_TRACE_SIZE,
+               "trace_shared_t passt nicht in SHARED_TRACE");
+
+/*============================================================================
+ * Private Variablen
+ *============================================================================*/
+
+static trace_shared_t *g_trace = NULL;
+static uint32_t g_head = 0;     /* Lokale Kopie, head im Shared Memory nur schreiben */
+
+/*============================================================================
+ * Implementierung
+ *============================================================================*/
+
+void trace_init(void) {
+    trace_shared_t *t = (trace_shared_t *)SHARED_TRACE_ADDR;
+
+    t->magic = 0;
+    t->head = 0;
+    t->rec_size = sizeof(trace_rec_t);
+    t->rec_count = TRACE_RECORDS;
+    t->counter_freq = arch_counter_freq();
+    g_head = 0;
+
+    /* Magic zuletzt: Linux liest erst wenn die Geometrie steht */
+    STORE_RELEASE(&t->magic, TRACE_MAGIC);
+    g_trace = t;
+}
+
+void trace_emit(uint16_t id, uint16_t type, uint32_t arg0, uint32_t arg1) {
+    trace_shared_t *t = g_trace;
+    trace_rec_t *rec;
+    uint64_t flags;
+    uint32_t idx;
+
+    if (!t) {
+        return;
+    }
+
+    flags = irq_save();
+    idx = g_head++;
+    rec = &t->rec[idx & (TRACE_RECORDS - 1)];
+    rec->ts = arch_counter();
+    rec->id = id;
+    rec->type = type;
+    rec->arg0 = arg0;
+    rec->arg1 = arg1;
+    STORE_RELEASE(&rec->seq, idx);
+    STORE_RELEASE(&t->head, idx + 1);
+    irq_restore(flags);
+}
+
+uint32_t trace_count(void) {
+    return g_head;
+}
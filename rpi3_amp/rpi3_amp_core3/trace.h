@@ -0,0 +1,125 @@
+/**
+ * @file trace.h
+ * @brief Binärer Trace-Ring im Shared Memory (SHARED_TRACE_ADDR)
+ *
+ * Flight Recorder für die Core 3 Timeline: jedes Event ist ein Record
+ * fester Größe mit Zeitstempel (Generic Timer), Event-ID, Typ und zwei
+ * Argumenten. Core 3 schreibt immer weiter und überschreibt die ältesten
+ * Records - der Ring blockiert nie. Linux (linux_tools/trace_dump) liest
+ * mit eigenem tail hinterher, erkennt Überläufe an head und exportiert
+ * als Chrome/Perfetto JSON.
+ *
+ * Schreiben (trace_emit):
+ *   Record füllen, seq = Index zuletzt, dann head = Index + 1 (Release).
+ *   Läuft mit maskierten IRQs, damit auch IRQ Handler tracen dürfen.
+ *
+ * Lesen (Linux):
+ *   head lesen (Acquire), Record i kopieren, danach head erneut lesen.
+ *   Gültig nur wenn rec.seq == i und head - i < TRACE_RECORDS - sonst
+ *   hat Core 3 den Slot inzwischen überschrieben (Überlauf).
+ *
+ * Zeitstempel sind CNTPCT_EL0 - derselbe Counter, den Linux als
+ * CNTVCT_EL0 liest (CNTVOFF = 0), die Timelines lassen sich also direkt
+ * übereinanderlegen.
+ *
+ * Mit TRACE_ENABLE=0 (make TRACE=0) werden alle TRACE_* Makros zu nichts.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "common.h"
+
+/*============================================================================
+ * Konfiguration
+ *============================================================================*/
+
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE        1
+#endif
+
+#define TRACE_MAGIC         0x45435254  /* "TRCE" */
+#define TRACE_RECORDS       2048        /* Zweierpotenz */
+
+/* Event-Typen (Chrome Trace "ph": B, E, i, C) */
+#define TRACE_TYPE_BEGIN    0
+#define TRACE_TYPE_END      1
+#define TRACE_TYPE_INSTANT  2
+#define TRACE_TYPE_COUNTER  3
+
+/* Event-IDs (Namen in linux_tools/trace_dump.c) */
+#define TRACE_EV_TASK       1   /* Scheduler-Task, arg0 = Task-ID */
+#define TRACE_EV_IPC_POLL   2   /* ipc_poll mit Nachrichten, END: arg0 = verarbeitet */
+#define TRACE_EV_IDLE       3   /* WFI in idle_wait */
+#define TRACE_EV_DOORBELL   4   /* Doorbell IRQ, arg0 = Bits, arg1 = Wake-Latenz ns */
+#define TRACE_EV_BENCH      5   /* Boot-Benchmark, arg0 = Phase */
+#define TRACE_EV_USER       0x100   /* Ab hier frei für eigene Events */
+
+/*============================================================================
+ * Shared Memory Strukturen (MÜSSEN mit linux_tools/amp_shared.h übereinstimmen!)
+ *============================================================================*/
+
+typedef struct {
+    uint64_t ts;            /* CNTPCT_EL0 */
+    uint16_t id;            /* TRACE_EV_* */
+    uint16_t type;          /* TRACE_TYPE_* */
+    uint32_t arg0;
+    uint32_t arg1;
+    uint32_t seq;           /* Index des Records, zuletzt geschrieben */
+} trace_rec_t;
+
+typedef struct {
+    /* Cache-Line 0: nur von Core 3 geschrieben */
+    volatile uint32_t head;         /* Anzahl geschriebener Records (läuft über) */
+    uint8_t  _pad0[60];
+
+    /* Cache-Line 1: Geometrie, nach dem Init read-only */
+    uint32_t magic;                 /* TRACE_MAGIC, wird zuletzt gesetzt */
+    uint32_t rec_size;              /* sizeof(trace_rec_t) */
+    uint32_t rec_count;             /* TRACE_RECORDS */
+    uint32_t counter_freq;          /* Hz der Zeitstempel */
+    uint8_t  _pad1[48];
+
+    trace_rec_t rec[TRACE_RECORDS];
+} trace_shared_t;
+
+/*============================================================================
+ * Makros
+ *============================================================================*/
+
+#if TRACE_ENABLE
+#define TRACE_BEGIN(id, a0)         trace_emit((id), TRACE_TYPE_BEGIN, (a0), 0)
+#define TRACE_END(id, a0)           trace_emit((id), TRACE_TYPE_END, (a0), 0)
+#define TRACE_INSTANT(id, a0, a1)   trace_emit((id), TRACE_TYPE_INSTANT, (a0), (a1))
+#define TRACE_COUNTER(id, value)    trace_emit((id), TRACE_TYPE_COUNTER, (value), 0)
+#else
+#define TRACE_BEGIN(id, a0)         ((void)(id), (void)(a0))
+#define TRACE_END(id, a0)           ((void)(id), (void)(a0))
+#define TRACE_INSTANT(id, a0, a1)   ((void)(id), (void)(a0), (void)(a1))
+#define TRACE_COUNTER(id, value)    ((void)(id), (void)(value))
+#endif
+
+/*============================================================================
+ * Funktionen
+ *============================================================================*/
+
+/**
+ * @brief Legt den Ring in SHARED_TRACE_ADDR an (head = 0)
+ *
+ * Vorher ausgelöste Events werden verworfen.
+ */
+void trace_init(void);
+
+/**
+ * @brief Schreibt ein Event (ein paar Dutzend Zyklen, auch aus IRQs)
+ *
+ * Direkt nur für eigene Typen aufrufen, sonst über die TRACE_* Makros.
+ */
+void trace_emit(uint16_t id, uint16_t type, uint32_t arg0, uint32_t arg1);
+
+/**
+ * @brief Anzahl bisher geschriebener Events
+ */
+uint32_t trace_count(void);
+
+#endif /* TRACE_H */
@@ -3,10 +3,17 @@
  * @brief UART0 (PL011) Implementierung für RPi3
  * 
  * Hinweis: Kein stdarg.h verfügbar in bare-metal!
- * Wir verwenden ein vereinfachtes printf ohne va_list.
+ * Varargs über die GCC Builtins (__builtin_va_*), formatiert wird in fmt.c.
  */
 
 #include "uart.h"
+#include "fmt.h"
+#include "mbox.h"
+#include "probe.h"
+
+#ifdef AMP_HOST
+#include "host.h"
+#endif
 
 /*============================================================================
  * UART0 Register
@@ -26,9 +33,41 @@
 #define GPPUDCLK0       REG32(GPIO_BASE + 0x98)
 
 /* Flag Register Bits */
+#define UART_FR_TXFE    (1 << 7)  /* TX FIFO Empty */
+#define UART_FR_BUSY    (1 << 3)  /* Sendet noch (Schieberegister) */
 #define UART_FR_TXFF    (1 << 5)  /* TX FIFO Full */
 #define UART_FR_RXFE    (1 << 4)  /* RX FIFO Empty */
 
+/* Tiefe des PL011 TX-FIFO */
+#define UART_FIFO_DEPTH 16
+
+/* Line Control: 8 Bit, keine Parity, 1 Stop Bit, FIFO an */
+#define UART_LCRH_8N1_FIFO  ((3 << 5) | (1 << 4))
+
+/* Control: UART, TX und RX an */
+#define UART_CR_ENABLE      ((1 << 0) | (1 << 8) | (1 << 9))
+
+/* Mindestabstand der FIFO-Refills (Wake-Timer) */
+#define UART_REFILL_MIN_US  10
+
+#define TX_MASK         (UART_TX_BUF_SIZE - 1)
+
+_Static_assert((UART_TX_BUF_SIZE & TX_MASK) == 0,
+               "UART_TX_BUF_SIZE muss eine Zweierpotenz sein");
+
+/*============================================================================
+ * TX-Ring
+ *============================================================================*/
+
+static char g_tx_buf[UART_TX_BUF_SIZE];
+static uint32_t g_tx_head = 0;      /* Schreibindex (frei laufend) */
+static uint32_t g_tx_tail = 0;      /* Leseindex (frei laufend) */
+static uart_tx_policy_t g_tx_policy = UART_TX_BLOCK;
+static uint32_t g_tx_dropped = 0;
+static uint32_t g_tx_peak = 0;
+static uint32_t g_clock = UART_CLOCK_DEFAULT;
+static uint32_t g_baud = UART_BAUD_115200;
+
 /*============================================================================
  * Private Hilfsfunktionen
  *============================================================================*/
@@ -39,6 +78,81 @@ static void delay_cycles(uint32_t count) {
     }
 }
 
+/* Ein Byte in den Ring - bei vollem Ring je nach Policy verwerfen oder warten */
+static void tx_push(char c) {
+    while (g_tx_head - g_tx_tail >= UART_TX_BUF_SIZE) {
+        if (g_tx_policy == UART_TX_DROP) {
+            g_tx_dropped++;
+            return;
+        }
+        uart_tx_pump();
+    }
+
+    g_tx_buf[g_tx_head & TX_MASK] = c;
+    g_tx_head++;
+
+    uint32_t used = g_tx_head - g_tx_tail;
+    if (used > g_tx_peak) {
+        g_tx_peak = used;
+    }
+}
+
+/*
+ * Block in den Ring, '\n' wird zu "\r\n". Passt der Block auch im
+ * schlechtesten Fall (nur '\n') komplett, ohne Prüfung pro Byte kopieren.
+ */
+static void tx_write(const char *s, uint32_t len) {
+    if (2 * len <= UART_TX_BUF_SIZE - (g_tx_head - g_tx_tail)) {
+        uint32_t head = g_tx_head;
+        for (uint32_t i = 0; i < len; i++) {
+            if (s[i] == '\n') {
+                g_tx_buf[head++ & TX_MASK] = '\r';
+            }
+            g_tx_buf[head++ & TX_MASK] = s[i];
+        }
+        g_tx_head = head;
+
+        uint32_t used = head - g_tx_tail;
+        if (used > g_tx_peak) {
+            g_tx_peak = used;
+        }
+        return;
+    }
+
+    for (uint32_t i = 0; i < len; i++) {
+        if (s[i] == '\n') {
+            tx_push('\r');
+        }
+        tx_push(s[i]);
+    }
+}
+
+/*
+ * Teiler für baud: Takt / (16 * baud) mit 6 Bit Nachkomma, also
+ * 4 * Takt / baud gerundet. IBRD muss 1..65535 sein.
+ * Gibt die tatsächliche Rate zurück, 0 wenn nicht erreichbar.
+ */
+static uint32_t baud_divisor(uint32_t baud, uint32_t *ibrd, uint32_t *fbrd) {
+    if (baud == 0) {
+        return 0;
+    }
+
+    uint64_t div = ((uint64_t)g_clock * 4 + baud / 2) / baud;
+    if (div < 64 || div > (0xFFFFULL << 6) + 63) {
+        return 0;
+    }
+
+    uint32_t actual = (uint32_t)(((uint64_t)g_clock * 4 + div / 2) / div);
+    uint32_t diff = actual > baud ? actual - baud : baud - actual;
+    if ((uint64_t)diff * 1000000ULL > (uint64_t)baud * UART_BAUD_MAX_ERR_PPM) {
+        return 0;
+    }
+
+    *ibrd = (uint32_t)(div >> 6);
+    *fbrd = (uint32_t)(div & 63);
+    return actual;
+}
+
 /*============================================================================
  * Öffentliche Funktionen
  *============================================================================*/
@@ -65,39 +179,160 @@ void uart_init(void) {
     /* 4. Alle Interrupts clearen */
     UART0_ICR = 0x7FF;
 
-    /* 5. Baudrate: 115200 @ 48 MHz UART Clock
-     * Divider = 48000000 / (16 * 115200) = 26.041666...
-     * IBRD = 26, FBRD = 0.041666 * 64 = 2.666 ≈ 3
+    /* 5. Baudrate: Takt von der GPU-Firmware, z.B. 48 MHz
+     * 115200: Divider = 48000000 / (16 * 115200) = 26.041666...
+     *         IBRD = 26, FBRD = 0.041666 * 64 = 2.666 ≈ 3
+     * 3 Mbaud: Divider = 1.0, IBRD = 1, FBRD = 0
      */
-    UART0_IBRD = 26;
-    UART0_FBRD = 3;
+    uint32_t clock = mbox_get_clock_rate(MBOX_CLOCK_UART);
+    uint32_t ibrd, fbrd, baud;
+    if (clock) {
+        g_clock = clock;
+    }
+    baud = baud_divisor(UART_BAUD, &ibrd, &fbrd);
+    if (!baud) {
+        baud = baud_divisor(UART_BAUD_115200, &ibrd, &fbrd);
+    }
+    if (!baud) {
+        /* Unplausibler Takt: alte feste Teiler für 48 MHz */
+        ibrd = 26;
+        fbrd = 3;
+        baud = UART_BAUD_115200;
+    }
+    g_baud = baud;
+    UART0_IBRD = ibrd;
+    UART0_FBRD = fbrd;
 
     /* 6. Line Control: 8 Bit, keine Parity, 1 Stop Bit, FIFO aktivieren */
-    UART0_LCRH = (3 << 5) | (1 << 4);  /* 8N1 + FIFO enable */
+    UART0_LCRH = UART_LCRH_8N1_FIFO;
 
     /* 7. UART aktivieren (TX + RX) */
-    UART0_CR = (1 << 0) | (1 << 8) | (1 << 9);
+    UART0_CR = UART_CR_ENABLE;
     
     DSB();
 }
 
+uint32_t uart_set_baud(uint32_t baud) {
+    uint32_t ibrd, fbrd;
+    uint32_t actual = baud_divisor(baud, &ibrd, &fbrd);
+
+    if (!actual) {
+        return 0;
+    }
+
+    /* Alles mit der alten Rate senden, dann erst umstellen */
+    uart_flush();
+    while (UART0_FR & UART_FR_BUSY) {
+    }
+
+    /* PL011: Teiler werden erst mit dem LCRH-Schreibzugriff übernommen */
+    UART0_CR = 0;
+    UART0_IBRD = ibrd;
+    UART0_FBRD = fbrd;
+    UART0_LCRH = UART_LCRH_8N1_FIFO;
+    UART0_CR = UART_CR_ENABLE;
+    DSB();
+
+    g_baud = actual;
+    return actual;
+}
+
+uint32_t uart_get_baud(void) {
+    return g_baud;
+}
+
+uint32_t uart_get_clock(void) {
+    return g_clock;
+}
+
+uint32_t uart_tx_refill_us(void) {
+    /* 10 Bit pro Zeichen (8N1), davon 3/4 */
+    uint32_t us = (uint32_t)(UART_FIFO_DEPTH * 10ULL * 1000000ULL * 3 / 4 / g_baud);
+
+    return us < UART_REFILL_MIN_US ? UART_REFILL_MIN_US : us;
+}
+
+uint32_t uart_tx_pump(void) {
+    uint32_t count = 0;
+
+    while (g_tx_tail != g_tx_head) {
+        /* FIFO leer: ganzen Burst ohne weitere Flag-Abfrage schreiben */
+        uint32_t fr = UART0_FR;
+        uint32_t room;
+        if (fr & UART_FR_TXFE) {
+            room = UART_FIFO_DEPTH;
+        } else if (!(fr & UART_FR_TXFF)) {
+            room = 1;
+        } else {
+            break;
+        }
+
+        while (room-- && g_tx_tail != g_tx_head) {
+            UART0_DR = g_tx_buf[g_tx_tail & TX_MASK];
+#ifdef AMP_HOST
+            host_uart_tx(g_tx_buf[g_tx_tail & TX_MASK]);
+#endif
+            g_tx_tail++;
+            count++;
+        }
+    }
+    return count;
+}
+
+bool uart_tx_pending(void) {
+    return g_tx_tail != g_tx_head;
+}
+
+void uart_flush(void) {
+    while (uart_tx_pending()) {
+        uart_tx_pump();
+    }
+}
+
+void uart_set_tx_policy(uart_tx_policy_t policy) {
+    g_tx_policy = policy;
+}
+
+uint32_t uart_get_tx_dropped(void) {
+    return g_tx_dropped;
+}
+
+uint32_t uart_get_tx_peak(void) {
+    return g_tx_peak;
+}
+
 void uart_putc(char c) {
-    /* Warten bis TX FIFO nicht voll ist */
-    while (UART0_FR & UART_FR_TXFF);
-    UART0_DR = c;
+    tx_push(c);
+    uart_tx_pump();
 }
 
 void uart_puts(const char *str) {
-    while (*str) {
-        if (*str == '\n') {
-            uart_putc('\r');
-        }
-        uart_putc(*str++);
+    uint32_t len = 0;
+
+    while (str[len]) {
+        len++;
     }
+    tx_write(str, len);
+    uart_tx_pump();
+}
+
+void uart_write(const void *data, uint32_t len) {
+    const char *p = (const char *)data;
+
+    /* Ganz oder gar nicht, ein halber Binär-Frame nützt niemandem */
+    if (g_tx_policy == UART_TX_DROP &&
+        len > UART_TX_BUF_SIZE - (g_tx_head - g_tx_tail)) {
+        g_tx_dropped += len;
+        return;
+    }
+    for (uint32_t i = 0; i < len; i++) {
+        tx_push(p[i]);
+    }
+    uart_tx_pump();
 }
 
 void uart_newline(void) {
-    uart_putc('\r');
+    tx_push('\r');
     uart_putc('\n');
 }
 
@@ -105,16 +340,18 @@ void uart_put_hex32(uint32_t val) {
     static const char hex[] = "0123456789ABCDEF";
     uart_puts("0x");
     for (int i = 28; i >= 0; i -= 4) {
-        uart_putc(hex[(val >> i) & 0xF]);
+        tx_push(hex[(val >> i) & 0xF]);
     }
+    uart_tx_pump();
 }
 
 void uart_put_hex64(uint64_t val) {
     static const char hex[] = "0123456789ABCDEF";
     uart_puts("0x");
     for (int i = 60; i >= 0; i -= 4) {
-        uart_putc(hex[(val >> i) & 0xF]);
+        tx_push(hex[(val >> i) & 0xF]);
     }
+    uart_tx_pump();
 }
 
 void uart_put_uint(uint32_t val) {
@@ -132,15 +369,38 @@ void uart_put_uint(uint32_t val) {
     }
     
     while (i > 0) {
-        uart_putc(buf[--i]);
+        tx_push(buf[--i]);
     }
+    uart_tx_pump();
 }
 
 /*============================================================================
- * Printf Implementierung mit GCC __builtin_va_* (kein stdarg.h nötig)
+ * Printf
  *============================================================================*/
 
+/* fmt_out_t voll: Puffer in den TX-Ring */
+static void printf_flush(fmt_out_t *out) {
+    tx_write(out->buf, out->len);
+    out->len = 0;
+}
+
 void uart_printf(const char *fmt, ...) {
+    PROBE_BEGIN(uart_printf);
+    char buf[UART_PRINTF_BUF_SIZE];
+    fmt_out_t out = { buf, sizeof(buf), 0, 0, printf_flush };
+    __builtin_va_list args;
+
+    __builtin_va_start(args, fmt);
+    fmt_vformat(&out, fmt, args);
+    __builtin_va_end(args);
+
+    printf_flush(&out);
+    uart_tx_pump();
+    PROBE_END(uart_printf);
+}
+
+/* Bisherige Implementierung: zeichenweise, nur 32-bit Argumente */
+void uart_printf_legacy(const char *fmt, ...) {
     /* 
      * Vereinfachte Implementierung ohne echtes varargs:
      * Verwendet GCC built-in für aarch64 zur Argument-Extraktion
@@ -160,7 +420,7 @@ void uart_printf(const char *fmt, ...) {
                 case 'd': {
                     int32_t v = __builtin_va_arg(args, int32_t);
                     if (v < 0) {
-                        uart_putc('-');
+                        tx_push('-');
                         v = -v;
                     }
                     uart_put_uint((uint32_t)v);
@@ -178,21 +438,22 @@ void uart_printf(const char *fmt, ...) {
                     break;
                 }
                 case '%':
-                    uart_putc('%');
+                    tx_push('%');
                     break;
                 default:
-                    uart_putc('%');
-                    if (*fmt) uart_putc(*fmt);
+                    tx_push('%');
+                    if (*fmt) tx_push(*fmt);
                     break;
             }
             if (*fmt) fmt++;
         } else {
             if (*fmt == '\n') {
-                uart_putc('\r');
+                tx_push('\r');
             }
-            uart_putc(*fmt++);
+            tx_push(*fmt++);
         }
     }
     
     __builtin_va_end(args);
+    uart_tx_pump();
 }
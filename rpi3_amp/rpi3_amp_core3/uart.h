@@ -4,6 +4,14 @@
  * 
  * Verwendet UART0 auf GPIO 14/15 für Debug-Ausgaben.
  * Hinweis: Wenn Linux läuft, muss die Console auf UART0 deaktiviert sein!
+ *
+ * Senden läuft über einen TX-Ringpuffer: uart_putc/puts/printf legen nur
+ * Bytes in den Ring und füllen den 16 Byte HW-FIFO soweit Platz ist.
+ * Den Rest schiebt uart_tx_pump() aus der Hauptschleife nach. Der PL011
+ * TX-Interrupt hängt am GPU Interrupt Controller, dessen Routing Linux
+ * gehört - Core 3 bekommt ihn nicht, daher FIFO-Refill per Polling.
+ *
+ * Nicht aus IRQ Handlern aufrufen (Ring hat nur einen Producer).
  */
 
 #ifndef UART_H
@@ -11,15 +19,90 @@
 
 #include "common.h"
 
+/*============================================================================
+ * Konfiguration
+ *============================================================================*/
+
+/* Größe des TX-Rings in Bytes (Zweierpotenz) */
+#ifndef UART_TX_BUF_SIZE
+#define UART_TX_BUF_SIZE    4096
+#endif
+
+/* Ring voll: Bytes verwerfen oder warten bis der FIFO Platz macht */
+typedef enum {
+    UART_TX_DROP = 0,
+    UART_TX_BLOCK = 1
+} uart_tx_policy_t;
+
+/* Policy in der Hauptschleife (während der Init gilt immer BLOCK) */
+#ifndef UART_TX_POLICY
+#define UART_TX_POLICY      UART_TX_DROP
+#endif
+
+/* Stack-Puffer von uart_printf, wird bei Bedarf mehrfach geleert */
+#ifndef UART_PRINTF_BUF_SIZE
+#define UART_PRINTF_BUF_SIZE 128
+#endif
+
+/* Baudraten-Presets (UART_BAUD, IPC_MSG_SET_BAUD) */
+#define UART_BAUD_115200    115200
+#define UART_BAUD_921600    921600
+#define UART_BAUD_2M        2000000
+#define UART_BAUD_3M        3000000
+
+/* Baudrate nach uart_init() (make UART_BAUD=...) */
+#ifndef UART_BAUD
+#define UART_BAUD           UART_BAUD_115200
+#endif
+
+/* UART-Takt, falls die Mailbox nicht antwortet (config.txt init_uart_clock) */
+#define UART_CLOCK_DEFAULT  48000000
+
+/* Maximale Abweichung der tatsächlichen Baudrate (ppm), sonst abgelehnt */
+#define UART_BAUD_MAX_ERR_PPM   20000
+
 /*============================================================================
  * Funktionen
  *============================================================================*/
 
 /**
- * @brief Initialisiert UART0 mit 115200 Baud, 8N1
+ * @brief Initialisiert UART0 mit UART_BAUD, 8N1
+ *
+ * Fragt den UART-Takt per VideoCore Mailbox ab (mbox.h) und rechnet die
+ * Teiler daraus. Ist UART_BAUD nicht erreichbar, gilt 115200.
  */
 void uart_init(void);
 
+/**
+ * @brief Stellt die Baudrate um
+ *
+ * Leert vorher den TX-Ring (blockiert, bis alles mit der alten Rate
+ * draußen ist). Teiler = Takt / (16 * baud) in 1/64 Schritten; der
+ * PL011 braucht Takt >= 16 * baud.
+ *
+ * @param baud Gewünschte Rate, z.B. UART_BAUD_3M
+ * @return Tatsächliche Rate, 0 wenn nicht erreichbar (Rate bleibt)
+ */
+uint32_t uart_set_baud(uint32_t baud);
+
+/**
+ * @brief Aktuelle (tatsächliche) Baudrate
+ */
+uint32_t uart_get_baud(void);
+
+/**
+ * @brief UART-Takt in Hz (Mailbox oder UART_CLOCK_DEFAULT)
+ */
+uint32_t uart_get_clock(void);
+
+/**
+ * @brief Abstand für FIFO-Refills, solange der TX-Ring nicht leer ist
+ *
+ * Etwa 3/4 der Zeit, in der der 16 Byte FIFO bei der aktuellen Rate
+ * leerläuft (115200: ~1 ms, 3 Mbaud: 40 µs).
+ */
+uint32_t uart_tx_refill_us(void);
+
 /**
  * @brief Sendet ein einzelnes Zeichen
  * @param c Das zu sendende Zeichen
@@ -32,6 +115,17 @@ void uart_putc(char c);
  */
 void uart_puts(const char *str);
 
+/**
+ * @brief Sendet rohe Bytes ohne '\n' -> "\r\n" Umsetzung
+ *
+ * Bei UART_TX_DROP und zu wenig Platz im Ring wird der ganze Block
+ * verworfen, nicht nur sein Ende (Binär-Frames, binlog.h).
+ *
+ * @param data Daten
+ * @param len Anzahl Bytes
+ */
+void uart_write(const void *data, uint32_t len);
+
 /**
  * @brief Sendet eine 32-bit Zahl als Hex
  * @param val Der Wert
@@ -51,25 +145,66 @@ void uart_put_hex64(uint64_t val);
 void uart_put_uint(uint32_t val);
 
 /**
- * @brief Sendet einen formatierten String (vereinfachtes printf)
+ * @brief Sendet einen formatierten String
  * 
- * Unterstützte Formate:
- *   %s - String
- *   %d - Dezimal (signed)
- *   %u - Dezimal (unsigned)
- *   %x - Hex (lowercase)
- *   %X - Hex (uppercase)
- *   %% - Prozentzeichen
+ * Formatiert zuerst in einen Stack-Puffer (UART_PRINTF_BUF_SIZE) und legt
+ * ihn am Stück in den TX-Ring. Formate siehe fmt.h, u.a.:
+ *   %d %u %x %X %c %s %p %%, %ld %lu %lx, %llu %llx, %zu
+ *   Breite und Füllung: %8u, %-16s, %08x, %#x
+ * 
+ * %x gibt wie in C keinen "0x" Prefix aus.
  * 
  * @param fmt Format-String
  * @param ... Argumente
  */
-void uart_printf(const char *fmt, ...);
+void uart_printf(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+/**
+ * @brief Bisheriges zeichenweises printf (nur %s %d %u %x, 32-bit)
+ *
+ * Nur noch als Vergleich für den Boot-Benchmark (bench.c).
+ */
+void uart_printf_legacy(const char *fmt, ...);
 
 /**
  * @brief Sendet eine neue Zeile
  */
 void uart_newline(void);
 
+/*============================================================================
+ * TX-Ring
+ *============================================================================*/
+
+/**
+ * @brief Füllt den HW-FIFO aus dem TX-Ring nach (blockiert nie)
+ * @return Anzahl in den FIFO geschriebener Bytes
+ */
+uint32_t uart_tx_pump(void);
+
+/**
+ * @brief Prüft ob noch Bytes im TX-Ring auf den FIFO warten
+ */
+bool uart_tx_pending(void);
+
+/**
+ * @brief Wartet bis der TX-Ring leer ist
+ */
+void uart_flush(void);
+
+/**
+ * @brief Setzt das Verhalten bei vollem TX-Ring
+ */
+void uart_set_tx_policy(uart_tx_policy_t policy);
+
+/**
+ * @brief Anzahl wegen vollem Ring verworfener Bytes (UART_TX_DROP)
+ */
+uint32_t uart_get_tx_dropped(void);
+
+/**
+ * @brief Höchster Füllstand des TX-Rings in Bytes
+ */
+uint32_t uart_get_tx_peak(void);
+
 #endif /* UART_H */
 